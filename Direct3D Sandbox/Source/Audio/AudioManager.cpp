@@ -1,6 +1,8 @@
 #include "PrecompiledHeader.h"
+#include "AssetStreamer.h"
 #include "AudioManager.h"
 #include "CoInitializeWrapper.h"
+#include "RiffFile.h"
 #include "Sound.h"
 #include "Tools.h"
 
@@ -24,8 +26,14 @@ AudioManager& AudioManager::GetInstance()
 	return *s_Instance;
 }
 
-AudioManager::AudioManager()
+AudioManager::AudioManager() :
+	m_MasteringVoice(nullptr)
 {
+#if HEADLESS
+	// There may be no audio device to play to. Sounds still get loaded, they just never play
+	return;
+#endif
+
 	// Init XAudio2
 
 	auto result = XAudio2Create(&m_XAudio2);
@@ -82,7 +90,10 @@ AudioManager::~AudioManager()
 		m_MasteringVoice->DestroyVoice();
 	}
 
-	m_XAudio2->StopEngine();
+	if (m_XAudio2 != nullptr)
+	{
+		m_XAudio2->StopEngine();
+	}
 }
 
 IXAudio2SubmixVoice* AudioManager::CreateSubmixVoice(const WAVEFORMATEXTENSIBLE& waveFormat)
@@ -198,9 +209,33 @@ Sound& AudioManager::GetCachedSound(const wstring& path, bool loopForever, bool
 
 	if (sound == s_Instance->m_CachedSounds.end())
 	{
-		s_Instance->m_CachedSounds.emplace(key, Sound(path, loopForever, hasReverb));
+		auto& prefetchedWaveFiles = s_Instance->m_PrefetchedWaveFiles;
+		auto waveFile = prefetchedWaveFiles.find(Tools::ToLower(path));
+
+		if (waveFile != prefetchedWaveFiles.end())
+		{
+			// The sound takes the data out of the wave file, so it can't be shared with sounds that have different settings
+			s_Instance->m_CachedSounds.emplace(key, Sound(*waveFile->second.Wait(), loopForever, hasReverb));
+			prefetchedWaveFiles.erase(waveFile);
+		}
+		else
+		{
+			s_Instance->m_CachedSounds.emplace(key, Sound(path, loopForever, hasReverb));
+		}
+
 		sound = s_Instance->m_CachedSounds.find(key);
 	}
 
 	return sound->second;
+}
+
+// Reads and parses the wave file on a worker thread, so that the first GetCachedSound call for it doesn't have to
+void AudioManager::PrefetchSound(const wstring& path)
+{
+	auto waveFile = AssetStreamer::Load<shared_ptr<RiffFile>>([path]()
+	{
+		return make_shared<RiffFile>(RiffFile::Create(path));
+	});
+
+	s_Instance->m_PrefetchedWaveFiles.emplace(Tools::ToLower(path), waveFile);
 }
\ No newline at end of file
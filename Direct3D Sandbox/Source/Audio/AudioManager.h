@@ -1,7 +1,9 @@
 #pragma once
 
+#include "AssetHandle.h"
 #include "SoundCacheKey.h"
 
+class RiffFile;
 class Sound;
 class AudioManager
 {
@@ -16,6 +18,7 @@ private:
 	unique_ptr<FLOAT32[]> m_3DAudioMatrixCoeficients;
 
 	unordered_map<SoundCacheKey, Sound> m_CachedSounds;
+	unordered_map<wstring, AssetHandle<shared_ptr<RiffFile>>> m_PrefetchedWaveFiles;
 	static unique_ptr<AudioManager> s_Instance;
 
 	AudioManager();
@@ -26,6 +29,7 @@ public:
 
 	static void Initialize();
 	static AudioManager& GetInstance();	
+	inline bool HasOutput() const { return m_MasteringVoice != nullptr; }
 	
 	IXAudio2SubmixVoice* CreateSubmixVoice(const WAVEFORMATEXTENSIBLE& waveFormat);
 	IXAudio2SourceVoice* CreateSourceVoice(const WAVEFORMATEX* waveFormat, IXAudio2VoiceCallback* voiceCallback, IXAudio2SubmixVoice* submixVoice);
@@ -36,4 +40,5 @@ public:
 		IXAudio2SubmixVoice* submixVoice);
 
 	static Sound& GetCachedSound(const wstring& path, bool loopForever, bool hasReverb);
+	static void PrefetchSound(const wstring& path);
 };
\ No newline at end of file
@@ -10,6 +10,19 @@ Sound::Sound(const wstring& waveFilePath, bool loopForever, bool hasReverb) :
 	m_SubmixVoice(nullptr)
 {
 	auto waveFile = RiffFile::Create(waveFilePath);
+	Initialize(waveFile, loopForever, hasReverb);
+}
+
+// Takes the sound data out of the wave file
+Sound::Sound(RiffFile& waveFile, bool loopForever, bool hasReverb) :
+	m_SoundCallbacks(this),
+	m_SubmixVoice(nullptr)
+{
+	Initialize(waveFile, loopForever, hasReverb);
+}
+
+void Sound::Initialize(RiffFile& waveFile, bool loopForever, bool hasReverb)
+{
 	Assert(waveFile.GetFormat() == RiffFourCC::WAVE);
 
 	ZeroMemory(&m_WaveFormat, sizeof(m_WaveFormat));
@@ -27,7 +40,7 @@ Sound::Sound(const wstring& waveFilePath, bool loopForever, bool hasReverb) :
 	m_AudioBuffer.Flags = XAUDIO2_END_OF_STREAM;
 	m_AudioBuffer.LoopCount = loopForever ? XAUDIO2_LOOP_INFINITE : 0;
 
-	if (hasReverb)
+	if (hasReverb && AudioManager::GetInstance().HasOutput())
 	{
 		m_SubmixVoice = AudioManager::GetInstance().CreateSubmixVoice(m_WaveFormat);
 	}
@@ -106,12 +119,23 @@ void Sound::PlayImpl(Voice& voiceToPlay)
 
 void Sound::Play()
 {
+	if (!AudioManager::GetInstance().HasOutput())
+	{
+		return;
+	}
+
 	PlayImpl(GetVoiceForPlayback());
 }
 
 void Sound::Play3D(const AudioEmitter& audioEmitter, float volume)
 {
 	auto& audioManager = AudioManager::GetInstance();
+
+	if (!audioManager.HasOutput())
+	{
+		return;
+	}
+
 	auto& voice = GetVoiceForPlayback();
 	
 	voice.sourceVoice->SetVolume(volume);
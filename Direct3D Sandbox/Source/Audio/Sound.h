@@ -3,6 +3,7 @@
 #include "Tools.h"
 
 class AudioEmitter;
+class RiffFile;
 class Sound
 {
 private:
@@ -62,12 +63,14 @@ private:
 	size_t CreateVoice();
 	Voice& GetVoiceForPlayback();
 	void PlayImpl(Voice& voiceToPlay);
+	void Initialize(RiffFile& waveFile, bool loopForever, bool hasReverb);
 
 	friend class SoundCallbacks;
 	Sound(const Sound& other);
 
 public:
 	Sound(const wstring& waveFilePath, bool loopForever, bool hasReverb);
+	Sound(RiffFile& waveFile, bool loopForever, bool hasReverb);
 	Sound(Sound&& other);
 	~Sound();
 
@@ -19,6 +19,7 @@ public:
 	AnimationStateMachine(States startingState) :
 		m_CurrentState(startingState),
 		m_NextState(startingState),
+		m_TargetState(startingState),
 		m_IsTransitioningAnimationStates(false),
 		m_TransitionProgress(0.0f)
 	{
@@ -37,7 +38,7 @@ public:
 		m_AnimationProgress[i] = progress;
 	}
 
-	inline void Update(const RenderParameters& renderParameters, States targetState)
+	inline void Update(float frameTime, States targetState)
 	{
 		m_TargetState = targetState;
 
@@ -57,7 +58,7 @@ public:
 					m_TransitionProgress = 1.0f - m_TransitionProgress;
 				}
 
-				m_TransitionProgress += renderParameters.frameTime / kAnimationTransitionLength;
+				m_TransitionProgress += frameTime / kAnimationTransitionLength;
 
 				if (m_TransitionProgress >= 1.0f)
 				{
@@ -73,11 +74,11 @@ public:
 
 			if (kDoesAnimationLoop[m_CurrentState])
 			{
-				m_AnimationProgress[m_CurrentState] += renderParameters.frameTime / kAnimationLengths[m_CurrentState];
+				m_AnimationProgress[m_CurrentState] += frameTime / kAnimationLengths[m_CurrentState];
 			}
 			else if (m_AnimationProgress[m_CurrentState] < 1.0f)
 			{
-				m_AnimationProgress[m_CurrentState] += renderParameters.frameTime / kAnimationLengths[m_CurrentState];
+				m_AnimationProgress[m_CurrentState] += frameTime / kAnimationLengths[m_CurrentState];
 
 				if (m_AnimationProgress[m_CurrentState] > 1.0f)
 				{
@@ -87,7 +88,7 @@ public:
 		}
 	}
 
-	inline void SetRenderParameters(RenderParameters& renderParameters)
+	inline void SetRenderParameters(RenderParameters& renderParameters) const
 	{
 		renderParameters.targetAnimationState = m_TargetState;
 		renderParameters.targetStateAnimationProgress = m_AnimationProgress[m_TargetState] - floor(m_AnimationProgress[m_TargetState]);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <future>
+#include "Tools.h"
+
+// Asset that's being loaded on a worker thread. Until loading finishes it resolves to the placeholder,
+// so the main thread only ever waits for it when it asks to
+template <typename T>
+class AssetHandle
+{
+private:
+	shared_future<T> m_Asset;
+	T m_Placeholder;
+	mutable bool m_IsReady;
+
+public:
+	AssetHandle() : m_IsReady(false) {}
+	AssetHandle(shared_future<T> asset, T placeholder) : m_Asset(std::move(asset)), m_Placeholder(std::move(placeholder)), m_IsReady(false) {}
+
+	bool IsReady() const
+	{
+		if (!m_IsReady && m_Asset.valid())
+		{
+			m_IsReady = m_Asset.wait_for(chrono::seconds(0)) == future_status::ready;
+		}
+
+		return m_IsReady;
+	}
+
+	inline const T& Resolve() const { return IsReady() ? m_Asset.get() : m_Placeholder; }
+	inline const T& Wait() const { Assert(m_Asset.valid()); return m_Asset.get(); }
+};
\ No newline at end of file
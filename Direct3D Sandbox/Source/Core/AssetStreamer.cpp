@@ -0,0 +1,32 @@
+#include "PrecompiledHeader.h"
+#include "AssetStreamer.h"
+
+volatile long AssetStreamer::s_PendingLoadCount = 0;
+double AssetStreamer::s_FirstLoadTime = 0.0;
+bool AssetStreamer::s_HasReportedReady = true;
+
+void AssetStreamer::OnLoadStarted()
+{
+	if (s_HasReportedReady && IsIdle())
+	{
+		s_FirstLoadTime = Tools::GetTime();
+		s_HasReportedReady = false;
+	}
+
+	InterlockedIncrement(&s_PendingLoadCount);
+}
+
+void AssetStreamer::OnLoadFinished()
+{
+	InterlockedDecrement(&s_PendingLoadCount);
+}
+
+// Called every frame on the main thread. Reports how long it took for a burst of loads to become ready
+void AssetStreamer::Update()
+{
+	if (!s_HasReportedReady && IsIdle())
+	{
+		Tools::Report(L"All streamed assets ready in " + to_wstring(1000.0 * (Tools::GetTime() - s_FirstLoadTime)) + L" ms");
+		s_HasReportedReady = true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "AssetHandle.h"
+#include "Profiler.h"
+#include "Tools.h"
+
+// Loads assets on the worker threads of the standard library's thread pool.
+// Loaders may read files and create Direct3D resources, but must leave the device context and other main thread state alone
+class AssetStreamer
+{
+private:
+	static volatile long s_PendingLoadCount;
+	static double s_FirstLoadTime;
+	static bool s_HasReportedReady;
+
+	static void OnLoadStarted();
+	static void OnLoadFinished();
+
+	AssetStreamer();	// Static class
+
+public:
+	template <typename T, typename Loader>
+	static AssetHandle<T> Load(Loader loader, T placeholder = T())
+	{
+		OnLoadStarted();
+
+		auto asset = async(launch::async, [loader]() -> T
+		{
+			PROFILE_SCOPE("Load asset");
+			auto result = loader();
+			OnLoadFinished();
+
+			return result;
+		});
+
+		return AssetHandle<T>(asset.share(), std::move(placeholder));
+	}
+
+	static inline bool IsIdle() { return s_PendingLoadCount == 0; }
+	static void Update();
+};
\ No newline at end of file
@@ -6,6 +6,8 @@
 Camera::Camera(bool usePerspective, float fovY, float aspectRatio, float orthoWidth, float orthoHeight) :
 	m_Position(0.0f, 0.0f, 0.0f),
 	m_Rotation(0.0f, 0.0f, 0.0f),
+	m_PreviousTickPosition(0.0f, 0.0f, 0.0f),
+	m_TickInterpolation(1.0f),
 	m_DirtyViewMatrix(true),
 	m_DirtyViewProjectionMatrix(true)
 {
@@ -45,17 +47,42 @@ void Camera::RecalculateFrustumPlanes()
 	}
 }
 
+// The simulation moves the camera in fixed ticks, while frames land anywhere between them.
+// Drawing it between its last two positions keeps the motion smooth when frames outnumber ticks
+DirectX::XMFLOAT3 Camera::GetInterpolatedPosition() const
+{
+	if (m_TickInterpolation >= 1.0f)
+	{
+		return m_Position;
+	}
+
+	DirectX::XMFLOAT3 position;
+	DirectX::XMStoreFloat3(&position, DirectX::XMVectorLerp(DirectX::XMLoadFloat3(&m_PreviousTickPosition), DirectX::XMLoadFloat3(&m_Position), m_TickInterpolation));
+
+	return position;
+}
+
+void Camera::SetTickInterpolation(float tickInterpolation)
+{
+	if (m_TickInterpolation != tickInterpolation)
+	{
+		m_TickInterpolation = tickInterpolation;
+		m_DirtyViewMatrix = true;
+	}
+}
+
 const DirectX::XMMATRIX& Camera::GetViewMatrix()
 {
 	if (m_DirtyViewMatrix)
 	{
+		auto cameraPosition = GetInterpolatedPosition();
 		DirectX::XMMATRIX rotationMatrix = DirectX::XMMatrixRotationRollPitchYaw(m_Rotation.x, m_Rotation.y, m_Rotation.z);
 		DirectX::XMVECTOR up = DirectX::XMVector3Transform(DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 1.0f), rotationMatrix);
 		DirectX::XMVECTOR lookAt = DirectX::XMVector3Transform(DirectX::XMVectorSet(0.0f, 0.0f, -1.0f, 1.0f), rotationMatrix);
 
-		lookAt = DirectX::XMVectorAdd(lookAt, DirectX::XMVectorSet(m_Position.x, m_Position.y, m_Position.z, 1.0f));
+		lookAt = DirectX::XMVectorAdd(lookAt, DirectX::XMVectorSet(cameraPosition.x, cameraPosition.y, cameraPosition.z, 1.0f));
 	
-		DirectX::XMVECTOR position = DirectX::XMVectorSet(m_Position.x, m_Position.y, m_Position.z, 1.0f);
+		DirectX::XMVECTOR position = DirectX::XMVectorSet(cameraPosition.x, cameraPosition.y, cameraPosition.z, 1.0f);
 		m_ViewMatrix = DirectX::XMMatrixTranspose(DirectX::XMMatrixLookAtRH(position, lookAt, up));
 		m_DirtyViewMatrix = false;
 		m_DirtyViewProjectionMatrix = true;
@@ -84,5 +111,5 @@ void Camera::SetRenderParameters(RenderParameters& renderParameters)
 	memcpy(&renderParameters.viewProjectionMatrix, &GetViewProjectionMatrix(), sizeof(DirectX::XMMATRIX));
 	memcpy(renderParameters.frustumPlanes, m_FrustumPlanes, 6 * sizeof(DirectX::XMVECTOR));
 
-	renderParameters.cameraPosition = m_Position;
+	renderParameters.cameraPosition = GetInterpolatedPosition();
 }
\ No newline at end of file
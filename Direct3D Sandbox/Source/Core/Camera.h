@@ -14,12 +14,15 @@ protected:
 	DirectX::XMVECTOR m_FrustumPlanes[6];
 	DirectX::XMFLOAT3 m_Position;
 	DirectX::XMFLOAT3 m_Rotation;
+	DirectX::XMFLOAT3 m_PreviousTickPosition;
+	float m_TickInterpolation;		// How far between the previous and the current tick the camera is drawn
 	
 	bool m_DirtyViewMatrix;
 	bool m_DirtyViewProjectionMatrix;
 
 	void CheckRotationBounds();
 	void RecalculateFrustumPlanes();
+	DirectX::XMFLOAT3 GetInterpolatedPosition() const;
 
 	Camera(const Camera&);
 
@@ -35,6 +38,9 @@ public:
 	inline const DirectX::XMFLOAT3& GetPosition() const { return m_Position; }
 	inline const DirectX::XMFLOAT3& GetRotation() const { return m_Rotation; }
 
+	inline void BeginTick() { m_PreviousTickPosition = m_Position; }
+	void SetTickInterpolation(float tickInterpolation);
+
 	const DirectX::XMMATRIX& GetViewMatrix();
 	const DirectX::XMMATRIX& GetViewProjectionMatrix();
 	
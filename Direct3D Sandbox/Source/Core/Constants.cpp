@@ -12,7 +12,8 @@ const bool Constants::VSyncEnabled = true;
 const int Constants::MultiSampingAntiAliasing = 1;
 #endif
 
-const UINT Constants::D3DDeviceFlags = D3D11_CREATE_DEVICE_SINGLETHREADED;
+// Textures and fonts get created on asset streaming worker threads, so the device has to be thread safe
+const UINT Constants::D3DDeviceFlags = 0;
 
 const D3D11_FILL_MODE Constants::D3DFillMode = D3D11_FILL_SOLID;
 
@@ -28,6 +29,11 @@ const float Constants::DefaultMouseSensitivity = 0.5f;
 
 const float Constants::GravityConstant = -9.81f;
 
+// Simulation steps per second, independent of the frame rate. Frames that take longer than 
+// MaxTicksPerFrame ticks drop the rest of their time, so that a stall doesn't snowball into longer ones
+const float Constants::SimulationTickRate = 60.0f;
+const int Constants::MaxTicksPerFrame = 8;
+
 const int Constants::StartingZombieCount = 10;
 #if WINDOWS_PHONE
 const int Constants::MaxZombies = 50;
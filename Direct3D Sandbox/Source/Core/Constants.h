@@ -23,6 +23,9 @@ public:
 	static const float DefaultMouseSensitivity;
 
 	static const float GravityConstant;
+
+	static const float SimulationTickRate;
+	static const int MaxTicksPerFrame;
 	
 	static const int StartingZombieCount;
 	static const int MaxZombies;
@@ -0,0 +1,188 @@
+#include "PrecompiledHeader.h"
+#include "FrameDeltaCoding.h"
+#include "VertexPacking.h"
+
+// Packed vertex values that change between frames, in the order they're stored
+static const unsigned int kChannelCount = 9;
+
+static inline uint16_t& GetChannel(PackedVertexParameters& vertex, unsigned int channel)
+{
+	switch (channel)
+	{
+	case 0: case 1: case 2:
+		return vertex.position[channel];
+	case 3: case 4:
+		return reinterpret_cast<uint16_t&>(vertex.normal[channel - 3]);
+	case 5: case 6:
+		return reinterpret_cast<uint16_t&>(vertex.tangent[channel - 5]);
+	default:
+		return reinterpret_cast<uint16_t&>(vertex.binormal[channel - 7]);
+	}
+}
+
+static inline uint16_t GetChannel(const PackedVertexParameters& vertex, unsigned int channel)
+{
+	return GetChannel(const_cast<PackedVertexParameters&>(vertex), channel);
+}
+
+// Maps small negative differences to small unsigned values: 0, -1, 1, -2, 2...
+static inline uint16_t ZigZagEncode(uint16_t value)
+{
+	auto signedValue = static_cast<int16_t>(value);
+	return static_cast<uint16_t>((signedValue << 1) ^ (signedValue >> 15));
+}
+
+static inline uint16_t ZigZagDecode(uint16_t value)
+{
+	return static_cast<uint16_t>((value >> 1) ^ (0 - (value & 1)));
+}
+
+static inline unsigned int GetBitWidth(uint16_t value)
+{
+	unsigned int width = 0;
+
+	while (value != 0)
+	{
+		width++;
+		value >>= 1;
+	}
+
+	return width;
+}
+
+static inline size_t GetPackedBlockSize(unsigned int valueCount, unsigned int bitWidth)
+{
+	return (valueCount * bitWidth + 7) / 8;
+}
+
+static void EncodeBlock(const uint16_t values[], unsigned int valueCount, vector<uint8_t>& output)
+{
+	uint16_t combinedBits = 0;
+
+	for (auto i = 0u; i < valueCount; i++)
+	{
+		combinedBits |= values[i];
+	}
+
+	auto bitWidth = GetBitWidth(combinedBits);
+	output.push_back(static_cast<uint8_t>(bitWidth));
+
+	auto byteOffset = output.size();
+	output.resize(byteOffset + GetPackedBlockSize(valueCount, bitWidth));
+
+	auto bitOffset = 0u;
+
+	for (auto i = 0u; i < valueCount; i++)
+	{
+		for (auto bit = 0u; bit < bitWidth; bit++, bitOffset++)
+		{
+			if (values[i] & (1 << bit))
+			{
+				output[byteOffset + bitOffset / 8] |= static_cast<uint8_t>(1 << (bitOffset % 8));
+			}
+		}
+	}
+}
+
+static bool DecodeBlock(const uint8_t*& data, const uint8_t* dataEnd, unsigned int valueCount, uint16_t values[])
+{
+	if (data >= dataEnd)
+	{
+		return false;
+	}
+
+	auto bitWidth = *data++;
+
+	if (bitWidth > 16 || static_cast<size_t>(dataEnd - data) < GetPackedBlockSize(valueCount, bitWidth))
+	{
+		return false;
+	}
+
+	// Read the bit stream 32 bits at a time, which always covers a whole value of up to 16 bits
+	uint32_t bitBuffer = 0;
+	auto bufferedBits = 0u;
+	const uint16_t mask = static_cast<uint16_t>((1 << bitWidth) - 1);
+
+	for (auto i = 0u; i < valueCount; i++)
+	{
+		while (bufferedBits < bitWidth)
+		{
+			bitBuffer |= static_cast<uint32_t>(*data++) << bufferedBits;
+			bufferedBits += 8;
+		}
+
+		values[i] = ZigZagDecode(static_cast<uint16_t>(bitBuffer & mask));
+		bitBuffer >>= bitWidth;
+		bufferedBits -= bitWidth;
+	}
+
+	return true;
+}
+
+uint64_t FrameDeltaCoding::GetMinimumEncodedSize(size_t vertexCount, size_t frameCount)
+{
+	return static_cast<uint64_t>(frameCount) * kChannelCount * ((vertexCount + kBlockSize - 1) / kBlockSize);
+}
+
+void FrameDeltaCoding::Encode(const PackedVertexParameters vertices[], size_t vertexCount, size_t frameCount, vector<uint8_t>& output)
+{
+	vector<uint16_t> deltas(vertexCount);
+
+	for (auto frame = 0u; frame < frameCount; frame++)
+	{
+		auto frameVertices = vertices + frame * vertexCount;
+		auto previousFrameVertices = frameVertices - vertexCount;
+
+		for (auto channel = 0u; channel < kChannelCount; channel++)
+		{
+			for (auto i = 0u; i < vertexCount; i++)
+			{
+				auto previousValue = frame > 0 ? GetChannel(previousFrameVertices[i], channel) : 0;
+				deltas[i] = ZigZagEncode(static_cast<uint16_t>(GetChannel(frameVertices[i], channel) - previousValue));
+			}
+
+			for (auto i = 0u; i < vertexCount; i += kBlockSize)
+			{
+				EncodeBlock(&deltas[i], static_cast<unsigned int>(min<size_t>(kBlockSize, vertexCount - i)), output);
+			}
+		}
+	}
+}
+
+bool FrameDeltaCoding::Decode(const uint8_t data[], size_t dataSize, size_t vertexCount, size_t frameCount, PackedVertexParameters vertices[])
+{
+	auto dataEnd = data + dataSize;
+	vector<uint16_t> deltas(vertexCount);
+	vector<uint16_t> values(kChannelCount * vertexCount, 0);	// Running values of every channel, stored channel after channel
+
+	for (auto frame = 0u; frame < frameCount; frame++)
+	{
+		auto frameVertices = vertices + frame * vertexCount;
+
+		for (auto channel = 0u; channel < kChannelCount; channel++)
+		{
+			for (auto i = 0u; i < vertexCount; i += kBlockSize)
+			{
+				if (!DecodeBlock(data, dataEnd, static_cast<unsigned int>(min<size_t>(kBlockSize, vertexCount - i)), &deltas[i]))
+				{
+					return false;
+				}
+			}
+
+			// Plain loop over contiguous arrays, which the compiler vectorizes to SSE2 or NEON
+			auto channelValues = &values[channel * vertexCount];
+
+			for (auto i = 0u; i < vertexCount; i++)
+			{
+				channelValues[i] = static_cast<uint16_t>(channelValues[i] + deltas[i]);
+			}
+
+			for (auto i = 0u; i < vertexCount; i++)
+			{
+				GetChannel(frameVertices[i], channel) = channelValues[i];
+			}
+		}
+	}
+
+	return data == dataEnd;
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+struct PackedVertexParameters;
+
+// Compression of animation frames made of packed vertices.
+// Texture coordinates don't change between frames, so they're left out and have to be stored once by the caller.
+// Every other packed value is stored as the difference from the same value in the previous frame,
+// bit packed in blocks of kBlockSize values that share the bit width of their largest difference
+namespace FrameDeltaCoding
+{
+	const unsigned int kBlockSize = 16;
+
+	// Every block takes at least a byte, even if nothing changes
+	uint64_t GetMinimumEncodedSize(size_t vertexCount, size_t frameCount);
+
+	void Encode(const PackedVertexParameters vertices[], size_t vertexCount, size_t frameCount, vector<uint8_t>& output);
+
+	// Fills everything but texture coordinates. Returns false if the data ends before all frames are decoded
+	bool Decode(const uint8_t data[], size_t dataSize, size_t vertexCount, size_t frameCount, PackedVertexParameters vertices[]);
+}
\ No newline at end of file
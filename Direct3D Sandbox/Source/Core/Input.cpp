@@ -70,4 +70,42 @@ void Input::IgnoreDisplacements()
 	m_MouseY = 0;
 	m_PinchDisplacement = 0;
 	m_MouseWheelDisplacement = 0;
+}
+
+void Input::GetState(InputState& state) const
+{
+	memcpy(state.keyMap, m_KeyMap, sizeof(m_KeyMap));
+	memcpy(state.mouseButtonMap, m_MouseButtonMap, sizeof(m_MouseButtonMap));
+
+	state.mouseX = m_MouseX;
+	state.mouseY = m_MouseY;
+	state.pinchDisplacement = m_PinchDisplacement;
+	state.mouseWheelDisplacement = m_MouseWheelDisplacement;
+}
+
+// Keys the application handles rather than the game keep their live state, so that replays and scenarios can still be quit and profiled
+static const int kApplicationKeys[] = { VK_ESCAPE, VK_F9, VK_F10 };
+
+void Input::SetState(const InputState& state)
+{
+	bool applicationKeys[ARRAYSIZE(kApplicationKeys)];
+
+	for (size_t i = 0; i < ARRAYSIZE(kApplicationKeys); i++)
+	{
+		applicationKeys[i] = m_KeyMap[kApplicationKeys[i]];
+	}
+
+	memcpy(m_KeyMap, state.keyMap, sizeof(m_KeyMap));
+
+	for (size_t i = 0; i < ARRAYSIZE(kApplicationKeys); i++)
+	{
+		m_KeyMap[kApplicationKeys[i]] = applicationKeys[i];
+	}
+
+	memcpy(m_MouseButtonMap, state.mouseButtonMap, sizeof(m_MouseButtonMap));
+
+	m_MouseX = state.mouseX;
+	m_MouseY = state.mouseY;
+	m_PinchDisplacement = state.pinchDisplacement;
+	m_MouseWheelDisplacement = state.mouseWheelDisplacement;
 }
\ No newline at end of file
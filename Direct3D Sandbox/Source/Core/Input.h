@@ -1,4 +1,21 @@
 #pragma once
+
+// Everything the simulation reads from Input, other than whether to quit
+struct InputState
+{
+	static const int kKeyCount = 256;
+	static const int kMouseButtonCount = 6;
+
+	bool keyMap[kKeyCount];
+	bool mouseButtonMap[kMouseButtonCount];
+
+	long mouseX, mouseY;
+	long pinchDisplacement;
+	long mouseWheelDisplacement;
+
+	InputState() { ZeroMemory(this, sizeof(InputState)); }
+};
+
 class Input
 {
 private:
@@ -6,8 +23,8 @@ private:
 	
 	bool m_Paused;
 	bool m_Quit;
-	bool m_KeyMap[256];
-	bool m_MouseButtonMap[6];
+	bool m_KeyMap[InputState::kKeyCount];
+	bool m_MouseButtonMap[InputState::kMouseButtonCount];
 
 	long m_MouseX, m_MouseY;
 	long m_PinchDisplacement;
@@ -37,6 +54,9 @@ public:
 
 	void IgnoreDisplacements();
 
+	void GetState(InputState& state) const;
+	void SetState(const InputState& state);
+
 	inline void Quit() { m_Quit = true;}
 	inline bool ShouldQuit() const { return m_Quit; }
 
@@ -0,0 +1,193 @@
+#include "PrecompiledHeader.h"
+#include "InputRecording.h"
+#include "Tools.h"
+
+#include <cfloat>
+
+const uint32_t InputRecording::kMagic = 0x43455249;		// "IREC"
+const uint32_t InputRecording::kVersion = 1;
+
+InputRecording::InputRecording(Mode mode, const wstring& path) :
+	m_Mode(mode),
+	m_File(path, (mode == Mode::Recording ? ios::out | ios::trunc : ios::in) | ios::binary),
+	m_FirstTick(0),
+	m_LastTick(0),
+	m_HasStarted(false),
+	m_HasNextEntry(false),
+	m_IsFinished(false)
+{
+	ZeroMemory(&m_Header, sizeof(m_Header));
+	ZeroMemory(&m_NextEntry, sizeof(m_NextEntry));
+}
+
+// An entry without changes or displacements marks where the recording ended, so that replays last just as long
+InputRecording::~InputRecording()
+{
+	if (m_Mode == Mode::Recording && m_HasStarted)
+	{
+		TickEntry entry;
+
+		ZeroMemory(&entry, sizeof(entry));
+		entry.tickIndex = m_LastTick + 1;
+
+		m_File.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+	}
+}
+
+unique_ptr<InputRecording> InputRecording::StartRecording(const wstring& path, unsigned int seed, float tickRate)
+{
+	unique_ptr<InputRecording> recording(new InputRecording(Mode::Recording, path));
+
+	if (!recording->m_File.is_open())
+	{
+		return nullptr;
+	}
+
+	recording->m_Header.magic = kMagic;
+	recording->m_Header.version = kVersion;
+	recording->m_Header.seed = seed;
+	recording->m_Header.tickRate = tickRate;
+
+	recording->m_File.write(reinterpret_cast<const char*>(&recording->m_Header), sizeof(Header));
+	return recording;
+}
+
+unique_ptr<InputRecording> InputRecording::StartReplaying(const wstring& path)
+{
+	unique_ptr<InputRecording> recording(new InputRecording(Mode::Replaying, path));
+
+	if (!recording->m_File.is_open())
+	{
+		return nullptr;
+	}
+
+	recording->m_File.read(reinterpret_cast<char*>(&recording->m_Header), sizeof(Header));
+
+	if (!recording->m_File.good() || recording->m_Header.magic != kMagic || recording->m_Header.version != kVersion)
+	{
+		return nullptr;
+	}
+
+	// The tick rate gets used as is, so a damaged one mustn't stop the game from ticking
+	auto tickRate = recording->m_Header.tickRate;
+
+	if (!(tickRate > 0.0f && tickRate <= FLT_MAX))
+	{
+		return nullptr;
+	}
+
+	recording->ReadNextEntry();
+	return recording;
+}
+
+void InputRecording::ReadNextEntry()
+{
+	m_File.read(reinterpret_cast<char*>(&m_NextEntry), sizeof(m_NextEntry));
+
+	// Every key and button changes at most once a tick, anything more means the file is damaged and the replay ends here
+	m_HasNextEntry = m_File.good() && m_NextEntry.changeCount <= InputState::kKeyCount + InputState::kMouseButtonCount;
+}
+
+void InputRecording::Update(Input& input, unsigned int tickIndex)
+{
+	if (!m_HasStarted)
+	{
+		m_FirstTick = tickIndex;
+		m_HasStarted = true;
+	}
+
+	m_LastTick = tickIndex - m_FirstTick;
+
+	if (m_Mode == Mode::Recording)
+	{
+		InputState state;
+		input.GetState(state);
+		m_Changes.clear();
+
+		for (uint16_t i = 0; i < InputState::kKeyCount; i++)
+		{
+			if (state.keyMap[i] != m_State.keyMap[i])
+			{
+				Change change = { i, state.keyMap[i] };
+				m_Changes.push_back(change);
+			}
+		}
+
+		for (uint16_t i = 0; i < InputState::kMouseButtonCount; i++)
+		{
+			if (state.mouseButtonMap[i] != m_State.mouseButtonMap[i])
+			{
+				Change change = { static_cast<uint16_t>(InputState::kKeyCount + i), state.mouseButtonMap[i] };
+				m_Changes.push_back(change);
+			}
+		}
+
+		if (m_Changes.empty() && state.mouseX == 0 && state.mouseY == 0 && state.pinchDisplacement == 0 && state.mouseWheelDisplacement == 0)
+		{
+			return;
+		}
+
+		TickEntry entry;
+
+		entry.tickIndex = m_LastTick;
+		entry.changeCount = static_cast<uint32_t>(m_Changes.size());
+		entry.mouseX = state.mouseX;
+		entry.mouseY = state.mouseY;
+		entry.pinchDisplacement = state.pinchDisplacement;
+		entry.mouseWheelDisplacement = state.mouseWheelDisplacement;
+
+		m_File.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+
+		if (!m_Changes.empty())
+		{
+			m_File.write(reinterpret_cast<const char*>(m_Changes.data()), m_Changes.size() * sizeof(Change));
+		}
+
+		m_State = state;
+	}
+	else
+	{
+		if (m_IsFinished)
+		{
+			return;
+		}
+
+		// Displacements only ever last a tick
+		m_State.mouseX = 0;
+		m_State.mouseY = 0;
+		m_State.pinchDisplacement = 0;
+		m_State.mouseWheelDisplacement = 0;
+
+		while (m_HasNextEntry && m_NextEntry.tickIndex <= m_LastTick)
+		{
+			m_Changes.resize(m_NextEntry.changeCount);
+
+			if (!m_Changes.empty())
+			{
+				m_File.read(reinterpret_cast<char*>(m_Changes.data()), m_Changes.size() * sizeof(Change));
+			}
+
+			for (const auto& change : m_Changes)
+			{
+				if (change.code < InputState::kKeyCount)
+				{
+					m_State.keyMap[change.code] = change.isDown != 0;
+				}
+				else if (change.code < InputState::kKeyCount + InputState::kMouseButtonCount)
+				{
+					m_State.mouseButtonMap[change.code - InputState::kKeyCount] = change.isDown != 0;
+				}
+			}
+
+			m_State.mouseX = m_NextEntry.mouseX;
+			m_State.mouseY = m_NextEntry.mouseY;
+			m_State.pinchDisplacement = m_NextEntry.pinchDisplacement;
+			m_State.mouseWheelDisplacement = m_NextEntry.mouseWheelDisplacement;
+
+			ReadNextEntry();
+		}
+
+		input.SetState(m_State);
+		m_IsFinished = !m_HasNextEntry;
+	}
+}
\ No newline at end of file
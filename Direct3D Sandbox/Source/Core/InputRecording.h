@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Input.h"
+
+// Input as the simulation saw it at the start of every tick, along with the random seed and tick rate the game ran at.
+// The simulation only reads input during ticks and steps them at a fixed length, so replaying a recording on the same build
+// plays the same game, however fast frames were. Only ticks where something changed are stored
+class InputRecording
+{
+private:
+	enum Mode
+	{
+		Recording,
+		Replaying
+	};
+
+	// Written once at the start of the file
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t seed;
+		float tickRate;
+	};
+
+	// Followed by changeCount codes of keys and mouse buttons that changed, each with whether it's down now
+	struct TickEntry
+	{
+		uint32_t tickIndex;
+		uint32_t changeCount;
+		int32_t mouseX, mouseY;
+		int32_t pinchDisplacement;
+		int32_t mouseWheelDisplacement;
+	};
+
+	struct Change
+	{
+		uint16_t code;		// Keys first, then mouse buttons
+		uint16_t isDown;
+	};
+
+	static const uint32_t kMagic;
+	static const uint32_t kVersion;
+
+	Mode m_Mode;
+	fstream m_File;
+	Header m_Header;
+	InputState m_State;				// Last state recorded, or the state being replayed
+	vector<Change> m_Changes;
+	unsigned int m_FirstTick;		// Tick indices are stored counting from the first tick the recording was updated on
+	unsigned int m_LastTick;
+	bool m_HasStarted;
+	TickEntry m_NextEntry;
+	bool m_HasNextEntry;
+	bool m_IsFinished;
+
+	InputRecording(Mode mode, const wstring& path);
+	void ReadNextEntry();
+
+	InputRecording(const InputRecording& other);				// Not implemented (no copying allowed)
+	InputRecording& operator=(const InputRecording& other);		// Not implemented (no copying allowed)
+
+public:
+	~InputRecording();
+
+	// Both return null if the file can't be opened, or isn't a valid recording
+	static unique_ptr<InputRecording> StartRecording(const wstring& path, unsigned int seed, float tickRate);
+	static unique_ptr<InputRecording> StartReplaying(const wstring& path);
+
+	// Call at the start of every tick, before anything reads input. Replaying overwrites whatever came from the window
+	void Update(Input& input, unsigned int tickIndex);
+
+	inline unsigned int GetSeed() const { return m_Header.seed; }
+	inline float GetTickRate() const { return m_Header.tickRate; }
+	inline bool IsFinished() const { return m_IsFinished; }
+};
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <ppl.h>
+
+// Splits per frame work across the Concurrency Runtime's work stealing scheduler, the same one the standard library's
+// thread pool runs on. ParallelFor only returns once every item is done, so consecutive calls act as fences between phases.
+// Every caller runs its phases in order from one thread, so there's no dependency graph to express beyond that order
+namespace JobSystem
+{
+	// Runs body(i) for every i in [0, count), in jobs of at least minItemsPerJob items.
+	// Work that doesn't fill two jobs runs on the calling thread, as handing it over would cost more than it saves
+	template <typename Body>
+	inline void ParallelFor(size_t count, size_t minItemsPerJob, const Body& body)
+	{
+		if (count < 2 * minItemsPerJob)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				body(i);
+			}
+
+			return;
+		}
+
+		concurrency::parallel_for(size_t(0), count, body, concurrency::simple_partitioner(minItemsPerJob));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "PrecompiledHeader.h"
+#include "MappedFile.h"
+#include "Tools.h"
+
+MappedFile::MappedFile(const wstring& path) :
+	m_File(INVALID_HANDLE_VALUE),
+#if !WINDOWS_PHONE
+	m_Mapping(nullptr),
+#endif
+	m_Data(nullptr),
+	m_Size(0)
+{
+#if !WINDOWS_PHONE
+	m_File = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+#else
+	m_File = CreateFile2(path.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+#endif
+
+	if (m_File == INVALID_HANDLE_VALUE)
+	{
+		Tools::FatalError(L"Failed to open file: \"" + path + L"\"");
+	}
+
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx(m_File, &fileSize);
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+
+	// Mapping an empty file fails, but there's nothing to read from it anyway
+	if (m_Size == 0)
+	{
+		return;
+	}
+
+#if !WINDOWS_PHONE
+	m_Mapping = CreateFileMappingW(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	
+	if (m_Mapping == nullptr)
+	{
+		Tools::FatalError(L"Failed to map file: \"" + path + L"\"");
+	}
+
+	m_Data = static_cast<const char*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+	
+	if (m_Data == nullptr)
+	{
+		Tools::FatalError(L"Failed to map view of file: \"" + path + L"\"");
+	}
+#else
+	m_Buffer = unique_ptr<char[]>(new char[m_Size]);
+	
+	for (size_t bytesRead = 0; bytesRead < m_Size; )
+	{
+		DWORD chunkSize;
+
+		if (!ReadFile(m_File, m_Buffer.get() + bytesRead, static_cast<DWORD>(min<size_t>(m_Size - bytesRead, 0x40000000)), &chunkSize, nullptr) || chunkSize == 0)
+		{
+			Tools::FatalError(L"Failed to read file: \"" + path + L"\"");
+		}
+
+		bytesRead += chunkSize;
+	}
+
+	m_Data = m_Buffer.get();
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if !WINDOWS_PHONE
+	if (m_Data != nullptr)
+	{
+		UnmapViewOfFile(m_Data);
+	}
+
+	if (m_Mapping != nullptr)
+	{
+		CloseHandle(m_Mapping);
+	}
+#endif
+
+	if (m_File != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_File);
+	}
+}
\ No newline at end of file
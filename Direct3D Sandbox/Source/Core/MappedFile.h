@@ -0,0 +1,26 @@
+#pragma once
+
+// Read only view of a whole file, mapped into the address space instead of being copied into a buffer.
+// Windows Phone can't map files, so there the file gets read into memory instead
+class MappedFile
+{
+private:
+	HANDLE m_File;
+#if !WINDOWS_PHONE
+	HANDLE m_Mapping;
+#else
+	unique_ptr<char[]> m_Buffer;
+#endif
+	const char* m_Data;
+	size_t m_Size;
+
+	MappedFile(const MappedFile& other);				// Not implemented (no copying allowed)
+	MappedFile& operator=(const MappedFile& other);		// Not implemented (no copying allowed)
+
+public:
+	MappedFile(const wstring& path);
+	~MappedFile();
+
+	inline const char* GetData() const { return m_Data; }
+	inline size_t GetSize() const { return m_Size; }
+};
\ No newline at end of file
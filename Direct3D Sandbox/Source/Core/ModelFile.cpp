@@ -0,0 +1,104 @@
+#include "PrecompiledHeader.h"
+#include "ModelFile.h"
+#include "Tools.h"
+#include "VertexPacking.h"
+
+static const uint32_t kAdlerModulo = 65521;
+
+// Largest number of bytes that can be summed before the 32-bit sums might overflow
+static const size_t kAdlerBlockSize = 5552;
+
+uint32_t ModelFile::CalculateChecksum(const void* data, size_t size)
+{
+	auto bytes = static_cast<const uint8_t*>(data);
+	uint32_t a = 1, b = 0;
+
+	while (size > 0)
+	{
+		auto blockSize = min(size, kAdlerBlockSize);
+
+		for (auto i = 0u; i < blockSize; i++)
+		{
+			a += bytes[i];
+			b += a;
+		}
+
+		a %= kAdlerModulo;
+		b %= kAdlerModulo;
+
+		bytes += blockSize;
+		size -= blockSize;
+	}
+
+	return (b << 16) | a;
+}
+
+wstring ModelFile::Validate(const char data[], size_t size)
+{
+	if (size < sizeof(Header))
+	{
+		return L"the file is truncated.";
+	}
+
+	const auto& header = *reinterpret_cast<const Header*>(data);
+
+	if (header.magic != kMagic)
+	{
+		return L"not a model file.";
+	}
+
+	if (header.version != kVersion)
+	{
+		return L"model format version " + to_wstring(header.version) + L" is not supported, expected version " + to_wstring(kVersion) + 
+			L". Rebuild the assets.";
+	}
+
+	if (CalculateHeaderChecksum(header) != header.headerChecksum)
+	{
+		return L"the header is corrupted.";
+	}
+
+	if (header.modelType >= ModelType::ModelTypeCount || header.vertexEncoding >= VertexEncoding::VertexEncodingCount || header.frameCount == 0)
+	{
+		return L"the header describes an unknown kind of model.";
+	}
+
+	for (auto i = 0u; i < SectionType::SectionTypeCount; i++)
+	{
+		const auto& section = header.sections[i];
+
+		if (section.offset % kSectionAlignment != 0)
+		{
+			return L"section " + to_wstring(i) + L" is misaligned.";
+		}
+
+		if (section.offset > size || section.size > size - section.offset)
+		{
+			return L"the file is truncated.";
+		}
+
+		if (CalculateChecksum(data + section.offset, section.size) != section.checksum)
+		{
+			return L"section " + to_wstring(i) + L" is corrupted.";
+		}
+	}
+
+	const auto& indexSection = header.sections[SectionType::Indices];
+
+	if (indexSection.size != static_cast<uint64_t>(header.indexCount) * sizeof(uint32_t))
+	{
+		return L"index data size doesn't match the index count.";
+	}
+
+	auto indices = reinterpret_cast<const uint32_t*>(data + indexSection.offset);
+
+	for (auto i = 0u; i < header.indexCount; i++)
+	{
+		if (indices[i] >= header.vertexCount)
+		{
+			return L"index data refers to vertices that don't exist.";
+		}
+	}
+
+	return wstring();
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+// On disk layout of .model and .animatedModel files.
+// The header is followed by sections aligned to kSectionAlignment bytes, so that arrays in them can be used in place
+// once the file is mapped. Every field has a fixed size, so files don't depend on the bitness of the tool that wrote them
+namespace ModelFile
+{
+	const uint32_t kMagic = 0x4C444D53;		// "SMDL"
+	const uint32_t kVersion = 1;
+	const uint32_t kSectionAlignment = 16;
+
+	enum SectionType
+	{
+		StateData = 0,		// StateRecord for every animation state, empty for still models
+		Vertices,			// Laid out according to the vertex encoding
+		Indices,			// 32-bit indices
+		SectionTypeCount
+	};
+
+	struct Section
+	{
+		uint32_t offset;
+		uint32_t size;
+		uint32_t checksum;
+	};
+
+	struct StateRecord
+	{
+		uint32_t frameCount;
+		uint32_t frameOffset;
+	};
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t modelType;
+		uint32_t vertexEncoding;
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t frameCount;
+		uint32_t stateCount;
+		float radius;
+		Section sections[SectionType::SectionTypeCount];
+		uint32_t headerChecksum;	// Covers every field above
+	};
+
+	// Checks the header, every section's bounds, alignment and checksum, and that indices only refer to vertices that exist,
+	// so that nothing reading the file afterwards can go past its end. Returns an empty string if the file is fine, otherwise what's wrong with it
+	wstring Validate(const char data[], size_t size);
+
+	// Adler-32
+	uint32_t CalculateChecksum(const void* data, size_t size);
+	inline uint32_t CalculateHeaderChecksum(const Header& header) { return CalculateChecksum(&header, offsetof(Header, headerChecksum)); }
+	inline uint32_t AlignSectionOffset(uint32_t offset) { return (offset + kSectionAlignment - 1) & ~(kSectionAlignment - 1); }
+}
\ No newline at end of file
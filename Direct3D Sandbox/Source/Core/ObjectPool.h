@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Tools.h"
+
+// Reference to an object in an ObjectPool that can outlive it. Freeing an object bumps the generation of its slot,
+// so handles to it stop resolving instead of pointing at whatever gets allocated in the slot next
+struct PoolHandle
+{
+	uint32_t index;
+	uint32_t generation;
+
+	PoolHandle() : index(0xFFFFFFFF), generation(0) {}
+	PoolHandle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+};
+
+struct ObjectPoolStatistics
+{
+	size_t liveCount;
+	size_t highWaterMark;
+	size_t slabCount;
+};
+
+// Fixed size slots carved out of slabs, which are kept until the pool is destroyed.
+// Free slots are linked into a list, so allocating and freeing are O(1) and only touch the heap when every slab is full.
+// Classes route their operator new and delete through a pool; kObjectSize lets one pool hold several classes of a hierarchy
+template <typename T, size_t kObjectSize = sizeof(T)>
+class ObjectPool
+{
+private:
+	// Sits right before the object, so that freeing and looking up handles doesn't have to search for the slot
+	struct SlotHeader
+	{
+		uint32_t index;
+		uint32_t generation;
+		uint32_t nextFree;
+		uint32_t isAlive;
+	};
+
+	static const size_t kSlotsPerSlab = 64;
+	static const size_t kHeaderSize = 16;		// Keeps objects 16 byte aligned for DirectXMath members
+	static const size_t kSlotSize = (kHeaderSize + kObjectSize + 15) & ~static_cast<size_t>(15);
+	static const uint32_t kNoSlot = 0xFFFFFFFF;
+
+	vector<uint8_t*> m_Slabs;
+	uint32_t m_FirstFree;
+	size_t m_LiveCount;
+	size_t m_HighWaterMark;
+
+	inline SlotHeader& GetHeader(uint32_t index) const 
+	{ 
+		return *reinterpret_cast<SlotHeader*>(m_Slabs[index / kSlotsPerSlab] + (index % kSlotsPerSlab) * kSlotSize); 
+	}
+
+	static inline SlotHeader& GetHeader(const void* object)
+	{
+		return *reinterpret_cast<SlotHeader*>(static_cast<uint8_t*>(const_cast<void*>(object)) - kHeaderSize);
+	}
+
+	void AddSlab()
+	{
+		auto slab = static_cast<uint8_t*>(_aligned_malloc(kSlotsPerSlab * kSlotSize, 16));
+
+		if (slab == nullptr)
+		{
+			throw bad_alloc();
+		}
+
+		auto firstIndex = static_cast<uint32_t>(m_Slabs.size() * kSlotsPerSlab);
+		m_Slabs.push_back(slab);
+
+		// Link the new slots in index order, so that they get handed out front to back
+		for (auto i = kSlotsPerSlab; i > 0; i--)
+		{
+			auto index = firstIndex + static_cast<uint32_t>(i - 1);
+			auto& header = GetHeader(index);
+
+			header.index = index;
+			header.generation = 0;
+			header.nextFree = m_FirstFree;
+			header.isAlive = 0;
+			m_FirstFree = index;
+		}
+	}
+
+	ObjectPool(const ObjectPool& other);				// Not implemented (no copying allowed)
+	ObjectPool& operator=(const ObjectPool& other);		// Not implemented (no copying allowed)
+
+public:
+	ObjectPool() :
+		m_FirstFree(kNoSlot),
+		m_LiveCount(0),
+		m_HighWaterMark(0)
+	{
+		static_assert(sizeof(SlotHeader) <= kHeaderSize, "Slot header has to fit before the object");
+	}
+
+	~ObjectPool()
+	{
+		for (auto slab : m_Slabs)
+		{
+			_aligned_free(slab);
+		}
+	}
+
+	void* Allocate(size_t size)
+	{
+		Assert(size <= kObjectSize);
+
+		if (m_FirstFree == kNoSlot)
+		{
+			AddSlab();
+		}
+
+		auto& header = GetHeader(m_FirstFree);
+		m_FirstFree = header.nextFree;
+		header.isAlive = 1;
+
+		m_LiveCount++;
+
+		if (m_LiveCount > m_HighWaterMark)
+		{
+			m_HighWaterMark = m_LiveCount;
+		}
+
+		return reinterpret_cast<uint8_t*>(&header) + kHeaderSize;
+	}
+
+	void Free(void* object)
+	{
+		if (object == nullptr)
+		{
+			return;
+		}
+
+		auto& header = GetHeader(object);
+		Assert(header.isAlive != 0);
+
+		header.isAlive = 0;
+		header.generation++;
+		header.nextFree = m_FirstFree;
+		m_FirstFree = header.index;
+
+		m_LiveCount--;
+	}
+
+	inline PoolHandle GetHandle(const T* object) const
+	{
+		const auto& header = GetHeader(object);
+		return PoolHandle(header.index, header.generation);
+	}
+
+	// Returns nullptr if the object has been freed since the handle was taken
+	inline T* Resolve(const PoolHandle& handle) const
+	{
+		if (handle.index >= m_Slabs.size() * kSlotsPerSlab)
+		{
+			return nullptr;
+		}
+
+		auto& header = GetHeader(handle.index);
+
+		if (header.isAlive == 0 || header.generation != handle.generation)
+		{
+			return nullptr;
+		}
+
+		return reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(&header) + kHeaderSize);
+	}
+
+	ObjectPoolStatistics GetStatistics() const
+	{
+		ObjectPoolStatistics statistics;
+
+		statistics.liveCount = m_LiveCount;
+		statistics.highWaterMark = m_HighWaterMark;
+		statistics.slabCount = m_Slabs.size();
+
+		return statistics;
+	}
+};
\ No newline at end of file
@@ -1,2 +1,69 @@
 #include "PrecompiledHeader.h"
-#include "Parameters.h"
\ No newline at end of file
+#include "Parameters.h"
+#include "Tools.h"
+
+typedef unordered_map<string, ParameterFieldDescription> ParameterFieldTable;
+
+#define FIELD(type, name) \
+	{ \
+		ParameterFieldDescription description = \
+		{ \
+			static_cast<unsigned int>(offsetof(PARAMETERS_TYPE, name)), \
+			static_cast<unsigned int>(sizeof(type)), \
+			ParameterFieldTraits<type>::kShaderSize, \
+			ParameterFieldTraits<type>::kType \
+		}; \
+		table.emplace(Tools::ToLower(#name), description); \
+	}
+
+static ParameterFieldTable CreateRenderParameterFieldTable()
+{
+	ParameterFieldTable table;
+
+#define PARAMETERS_TYPE RenderParameters
+	RENDER_PARAMETERS
+#undef PARAMETERS_TYPE
+
+	return table;
+}
+
+static ParameterFieldTable CreateVertexParameterFieldTable()
+{
+	ParameterFieldTable table;
+
+#define PARAMETERS_TYPE VertexParameters
+	VERTEX_PARAMETERS
+#undef PARAMETERS_TYPE
+
+	return table;
+}
+
+#undef FIELD
+
+// Built during static initialization, before any shader gets reflected on, so lookups never race with the construction
+static const ParameterFieldTable s_RenderParameterFields = CreateRenderParameterFieldTable();
+static const ParameterFieldTable s_VertexParameterFields = CreateVertexParameterFieldTable();
+
+static const ParameterFieldDescription* FindField(const ParameterFieldTable& table, const string& fieldName)
+{
+	auto field = table.find(Tools::ToLower(fieldName));
+	return field != table.end() ? &field->second : nullptr;
+}
+
+const ParameterFieldDescription* RenderParameters::GetFieldDescription(const string& fieldName)
+{
+	return FindField(s_RenderParameterFields, fieldName);
+}
+
+unsigned int RenderParameters::GetFieldByteOffset(const string& fieldName, ParameterFieldType type, unsigned int size)
+{
+	auto description = GetFieldDescription(fieldName);
+	Assert(description != nullptr && description->type == type && description->size == size);
+
+	return description->offset;
+}
+
+const ParameterFieldDescription* VertexParameters::GetFieldDescription(const string& fieldName)
+{
+	return FindField(s_VertexParameterFields, fieldName);
+}
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "PrecompiledHeader.h"
 
+typedef DirectX::XMVECTOR FrustumPlanes[6];
+
 #define RENDER_PARAMETERS \
 			FIELD(DirectX::XMMATRIX, projectionMatrix) \
 			FIELD(DirectX::XMMATRIX, viewMatrix) \
@@ -9,9 +11,10 @@
 			FIELD(DirectX::XMMATRIX, inversedTransposedWorldMatrix) \
 			FIELD(DirectX::XMMATRIX, worldViewProjectionMatrix) \
 			FIELD(DirectX::XMMATRIX, viewProjectionMatrix) \
-			FIELD(DirectX::XMVECTOR, frustumPlanes[6]) \
+			FIELD(FrustumPlanes, frustumPlanes) \
 			FIELD(float, time) \
 			FIELD(float, frameTime) \
+			FIELD(float, tickInterpolation) \
 			FIELD(DirectX::XMFLOAT4, color) \
 			FIELD(DirectX::XMFLOAT3, lightDirection) \
 			FIELD(DirectX::XMFLOAT3, lightColor) \
@@ -43,6 +46,73 @@
 			FIELD(DirectX::XMFLOAT3, binormal)
 
 
+enum class ParameterFieldType
+{
+	Matrix,
+	Vector,
+	Float4,
+	Float3,
+	Float2,
+	Float,
+	Int,
+	Bool,
+	ShaderResource
+};
+
+// Type of every parameter field and how many bytes of it shaders can read. Fields of types without a specialization don't compile.
+// C++ bools are narrower than HLSL ones and shaders can't read pointers, so they are hidden from shaders
+template <typename T>
+struct ParameterFieldTraits;
+
+#define PARAMETER_FIELD_TRAITS(cppType, fieldType, hlslSize) \
+	template <> \
+	struct ParameterFieldTraits<cppType> \
+	{ \
+		static const ParameterFieldType kType = ParameterFieldType::fieldType; \
+		static const unsigned int kShaderSize = hlslSize; \
+	};
+
+PARAMETER_FIELD_TRAITS(DirectX::XMMATRIX, Matrix, 64)
+PARAMETER_FIELD_TRAITS(DirectX::XMVECTOR, Vector, 16)
+PARAMETER_FIELD_TRAITS(DirectX::XMFLOAT4, Float4, 16)
+PARAMETER_FIELD_TRAITS(DirectX::XMFLOAT3, Float3, 12)
+PARAMETER_FIELD_TRAITS(DirectX::XMFLOAT2, Float2, 8)
+PARAMETER_FIELD_TRAITS(float, Float, 4)
+PARAMETER_FIELD_TRAITS(int, Int, 4)
+PARAMETER_FIELD_TRAITS(bool, Bool, 0)
+PARAMETER_FIELD_TRAITS(ID3D11ShaderResourceView*, ShaderResource, 0)
+
+#undef PARAMETER_FIELD_TRAITS
+
+template <typename T, size_t N>
+struct ParameterFieldTraits<T[N]>
+{
+	static const ParameterFieldType kType = ParameterFieldTraits<T>::kType;
+	static const unsigned int kShaderSize = static_cast<unsigned int>(N) * ParameterFieldTraits<T>::kShaderSize;
+};
+
+struct ParameterFieldDescription
+{
+	unsigned int offset;
+	unsigned int size;
+	unsigned int shaderSize;
+	ParameterFieldType type;
+};
+
+// Lets the renderer read a field it only knew by name at load time, without looking the name up again
+template <typename Parameters, typename T>
+class ParameterField
+{
+private:
+	unsigned int m_Offset;
+
+public:
+	explicit ParameterField(unsigned int offset) : m_Offset(offset) {}
+
+	inline const T& Get(const Parameters& parameters) const { return *reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(&parameters) + m_Offset); }
+};
+
+
 struct RenderParameters
 {
 #define FIELD(type, name) type name;
@@ -51,22 +121,14 @@ struct RenderParameters
 
 	RenderParameters() {}
 
-	inline const uint8_t* GetField(const string& fieldName) const
-	{
-#define FIELD(type, name) if (_stricmp(fieldName.c_str(), #name) == 0) return reinterpret_cast<const uint8_t*>(&name);
-		RENDER_PARAMETERS
-#undef FIELD
-
-		return nullptr;
-	}
+	// Looks fields up by name, ignoring case. Returns nullptr if there's no such field
+	static const ParameterFieldDescription* GetFieldDescription(const string& fieldName);
+	static unsigned int GetFieldByteOffset(const string& fieldName, ParameterFieldType type, unsigned int size);
 
-	inline static unsigned int GetFieldByteOffset(const string& fieldName)
+	template <typename T>
+	inline static ParameterField<RenderParameters, T> GetField(const string& fieldName)
 	{
-#define FIELD(type, name) if (_stricmp(fieldName.c_str(), #name) == 0) return static_cast<unsigned int>(offsetof(RenderParameters, name));
-		RENDER_PARAMETERS
-#undef FIELD
-
-		return 0xFFFFFFFF;
+		return ParameterField<RenderParameters, T>(GetFieldByteOffset(fieldName, ParameterFieldTraits<T>::kType, sizeof(T)));
 	}
 
 private:
@@ -82,23 +144,8 @@ struct VertexParameters
 
 	VertexParameters() {}
 
-	inline const uint8_t* GetField(const string& fieldName) const
-	{
-#define FIELD(type, name) if (_stricmp(fieldName.c_str(), #name) == 0) return reinterpret_cast<const uint8_t*>(&name);
-		VERTEX_PARAMETERS
-#undef FIELD
-
-		return nullptr;
-	}
-
-	inline static unsigned int GetFieldByteOffset(const string& fieldName)
-	{
-#define FIELD(type, name) if (_stricmp(fieldName.c_str(), #name) == 0) return offsetof(VertexParameters, name);
-		VERTEX_PARAMETERS
-#undef FIELD
-
-		return 0xFFFFFFFF;
-	}
+	// Looks fields up by name, ignoring case. Returns nullptr if there's no such field
+	static const ParameterFieldDescription* GetFieldDescription(const string& fieldName);
 
 	inline bool operator==(const VertexParameters& other) const
 	{
@@ -114,6 +161,12 @@ private:
 	VertexParameters& operator=(const VertexParameters& other);
 };
 
+// Shaders never read more of a field than it holds
+#define FIELD(type, name) static_assert(ParameterFieldTraits<type>::kShaderSize <= sizeof(type), "HLSL size of " #name " is bigger than its C++ size");
+RENDER_PARAMETERS
+VERTEX_PARAMETERS
+#undef FIELD
+
 template<> 
 struct hash<DirectX::XMFLOAT2>
 {	
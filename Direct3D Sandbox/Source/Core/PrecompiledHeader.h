@@ -14,7 +14,6 @@
 #include <iostream>
 #include <map>
 #include <memory>
-#include <random>
 #include <set>
 #include <sstream>
 #include <string>
@@ -37,6 +36,7 @@
 #endif
 
 #include <D3D11.h>
+#include <d3d11_1.h>
 #include <DirectXMath.h>
 
 #if !WINDOWS_PHONE
@@ -56,8 +56,20 @@ using namespace std;
 #undef DrawText
 #endif
 
+// Builds that run without a display, GPU or audio device. Draws are only counted, and sounds don't play
+#ifndef HEADLESS
+#define HEADLESS 0
+#endif
+
 #define ENABLE_FRUSTUM_CULLING 1
 
+#ifndef ENABLE_PROFILER
+#define ENABLE_PROFILER 1
+#endif
+
+// Logs every device context call and compares it against the bound state, which release builds shouldn't pay for. Headless builds record regardless
+#define ENABLE_DEVICE_CONTEXT_RECORDING DEBUG
+
 #define WIDE2(x) L##x
 #define WIDE1(x) WIDE2(x)
 #define __WFILE__ WIDE1(__FILE__)
@@ -0,0 +1,254 @@
+#include "PrecompiledHeader.h"
+#include "Profiler.h"
+
+#if ENABLE_PROFILER
+
+static const unsigned int kMaxThreads = 64;
+static const unsigned int kThreadBufferSize = 4096;		// Scopes a thread can close before the main thread drains them
+static const unsigned int kFrameHistorySize = 512;		// Frames the frame time percentiles are taken over
+static const unsigned int kTimelineFrameCount = 120;	// Frames an exported timeline covers
+static const unsigned int kMeasuredScopeCount = 10000;
+
+struct ProfilerEvent
+{
+	const char* name;
+	long long startTime;
+	long long endTime;
+	unsigned int depth;
+	unsigned int threadIndex;
+};
+
+struct ProfilerThreadBuffer
+{
+	ProfilerEvent events[kThreadBufferSize];
+	volatile long writeCount;		// Only advanced by the owning thread, after the event is written
+	long readCount;					// Only touched by the main thread
+	unsigned int depth;
+	unsigned int index;
+};
+
+static ProfilerThreadBuffer* volatile s_ThreadBuffers[kMaxThreads];
+static volatile long s_ThreadCount = 0;
+static __declspec(thread) ProfilerThreadBuffer* s_CurrentThreadBuffer = nullptr;
+
+static long long s_FrameStartTime = 0;
+static float s_FrameTimes[kFrameHistorySize];
+static float s_SortedFrameTimes[kFrameHistorySize];
+static unsigned int s_FrameCount = 0;
+static vector<ProfilerEvent> s_Timeline[kTimelineFrameCount];
+
+static unsigned int s_ScopesThisSecond = 0;
+static unsigned int s_FramesThisSecond = 0;
+static volatile long s_DroppedScopes = 0;		// Also counted by threads past the limit
+static double s_ScopeCost = 0.0;		// In milliseconds
+
+static double GetRawTimePerMillisecond()
+{
+	LARGE_INTEGER frequency;
+
+	QueryPerformanceFrequency(&frequency);
+	return static_cast<double>(frequency.QuadPart) / 1000.0;
+}
+
+static const double s_RawTimePerMillisecond = GetRawTimePerMillisecond();
+
+// Buffers are taken from the process heap rather than the CRT one and never freed: worker threads of the pool 
+// may still record scopes while the program shuts down, and leak checks shouldn't report them
+static ProfilerThreadBuffer& GetThreadBuffer()
+{
+	if (s_CurrentThreadBuffer == nullptr)
+	{
+		auto buffer = static_cast<ProfilerThreadBuffer*>(HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(ProfilerThreadBuffer)));
+
+		if (buffer == nullptr)
+		{
+			Tools::FatalError(L"Failed to allocate profiler buffer.");
+		}
+
+		auto index = static_cast<unsigned int>(InterlockedIncrement(&s_ThreadCount) - 1);
+
+		buffer->index = index;
+		s_CurrentThreadBuffer = buffer;
+
+		// Nobody reads the buffers of threads past the limit, so their scopes only get counted as dropped
+		if (index < kMaxThreads)
+		{
+			InterlockedExchangePointer(reinterpret_cast<void* volatile*>(&s_ThreadBuffers[index]), buffer);
+		}
+	}
+
+	return *s_CurrentThreadBuffer;
+}
+
+void Profiler::BeginScope()
+{
+	GetThreadBuffer().depth++;
+}
+
+void Profiler::EndScope(const char* name, long long startTime)
+{
+	auto endTime = Tools::GetRawTime();
+	auto& buffer = *s_CurrentThreadBuffer;
+
+	buffer.depth--;
+
+	if (buffer.index >= kMaxThreads)
+	{
+		InterlockedIncrement(&s_DroppedScopes);
+		return;
+	}
+
+	auto& event = buffer.events[buffer.writeCount % kThreadBufferSize];
+
+	event.name = name;
+	event.startTime = startTime;
+	event.endTime = endTime;
+	event.depth = buffer.depth;
+	event.threadIndex = buffer.index;
+
+	// Interlocked operations are full barriers, so the main thread never sees the count before the event
+	InterlockedIncrement(&buffer.writeCount);
+}
+
+// Times a burst of empty scopes, so that the statistics can tell how much of a frame went to the profiler itself
+void Profiler::Initialize()
+{
+	auto startTime = Tools::GetRawTime();
+
+	for (auto i = 0u; i < kMeasuredScopeCount; i++)
+	{
+		PROFILE_SCOPE("Profiler overhead");
+	}
+
+	s_ScopeCost = static_cast<double>(Tools::GetRawTime() - startTime) / s_RawTimePerMillisecond / kMeasuredScopeCount;
+
+	auto& buffer = GetThreadBuffer();
+	buffer.readCount = buffer.writeCount;
+	s_FrameStartTime = Tools::GetRawTime();
+}
+
+// Called on the main thread after every frame. Moves the scopes every thread closed since the last call into the timeline.
+// A thread that got more than half a buffer ahead loses its oldest scopes, so that they can't get overwritten while they're read
+void Profiler::EndFrame()
+{
+	auto frameEndTime = Tools::GetRawTime();
+
+	s_FrameTimes[s_FrameCount % kFrameHistorySize] = static_cast<float>((frameEndTime - s_FrameStartTime) / s_RawTimePerMillisecond);
+	s_FrameStartTime = frameEndTime;
+
+	auto& timelineFrame = s_Timeline[s_FrameCount % kTimelineFrameCount];
+	auto threadCount = min(static_cast<unsigned int>(s_ThreadCount), kMaxThreads);
+	timelineFrame.clear();
+
+	for (auto i = 0u; i < threadCount; i++)
+	{
+		auto buffer = s_ThreadBuffers[i];
+
+		if (buffer == nullptr)
+		{
+			continue;
+		}
+
+		auto writeCount = InterlockedCompareExchange(&buffer->writeCount, 0, 0);
+
+		if (writeCount - buffer->readCount > static_cast<long>(kThreadBufferSize / 2))
+		{
+			InterlockedExchangeAdd(&s_DroppedScopes, static_cast<long>(writeCount - buffer->readCount - kThreadBufferSize / 2));
+			buffer->readCount = writeCount - kThreadBufferSize / 2;
+		}
+
+		s_ScopesThisSecond += writeCount - buffer->readCount;
+
+		for (; buffer->readCount < writeCount; buffer->readCount++)
+		{
+			timelineFrame.push_back(buffer->events[buffer->readCount % kThreadBufferSize]);
+		}
+	}
+
+	s_FrameCount++;
+	s_FramesThisSecond++;
+}
+
+ProfilerStatistics Profiler::ConsumeStatistics()
+{
+	ProfilerStatistics statistics;
+	auto frameCount = min(s_FrameCount, kFrameHistorySize);
+
+	if (frameCount > 0)
+	{
+		auto sortedEnd = s_SortedFrameTimes + frameCount;
+		memcpy(s_SortedFrameTimes, s_FrameTimes, frameCount * sizeof(float));
+
+		auto p50 = s_SortedFrameTimes + frameCount * 50 / 100;
+		auto p95 = s_SortedFrameTimes + frameCount * 95 / 100;
+		auto p99 = s_SortedFrameTimes + frameCount * 99 / 100;
+
+		nth_element(s_SortedFrameTimes, p50, sortedEnd);
+		nth_element(p50, p95, sortedEnd);
+		nth_element(p95, p99, sortedEnd);
+
+		statistics.frameTimeP50 = *p50;
+		statistics.frameTimeP95 = *p95;
+		statistics.frameTimeP99 = *p99;
+	}
+	else
+	{
+		statistics.frameTimeP50 = statistics.frameTimeP95 = statistics.frameTimeP99 = 0.0f;
+	}
+
+	statistics.scopesPerFrame = s_FramesThisSecond > 0 ? s_ScopesThisSecond / s_FramesThisSecond : 0;
+	statistics.overheadPerFrame = static_cast<float>(statistics.scopesPerFrame * s_ScopeCost);
+	statistics.droppedScopes = static_cast<unsigned int>(InterlockedExchange(&s_DroppedScopes, 0));
+
+	s_ScopesThisSecond = 0;
+	s_FramesThisSecond = 0;
+
+	return statistics;
+}
+
+// Writes the last frames in Chrome's trace event format. Scope names are string literals, so they need no escaping
+bool Profiler::ExportTimeline(const wstring& path)
+{
+	ofstream out(path);
+
+	if (!out.is_open())
+	{
+		return false;
+	}
+
+	auto frameCount = min(s_FrameCount, kTimelineFrameCount);
+	auto firstFrame = s_FrameCount - frameCount;
+	auto baseTime = s_FrameStartTime;
+
+	for (auto frame = firstFrame; frame < s_FrameCount; frame++)
+	{
+		for (const auto& event : s_Timeline[frame % kTimelineFrameCount])
+		{
+			baseTime = min(baseTime, event.startTime);
+		}
+	}
+
+	out << "{\"traceEvents\":[" << endl;
+	out.setf(ios::fixed);
+	out.precision(3);
+
+	auto isFirstEvent = true;
+
+	for (auto frame = firstFrame; frame < s_FrameCount; frame++)
+	{
+		for (const auto& event : s_Timeline[frame % kTimelineFrameCount])
+		{
+			out << (isFirstEvent ? "" : ",\n") 
+				<< "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadIndex
+				<< ",\"ts\":" << 1000.0 * (event.startTime - baseTime) / s_RawTimePerMillisecond
+				<< ",\"dur\":" << 1000.0 * (event.endTime - event.startTime) / s_RawTimePerMillisecond << "}";
+
+			isFirstEvent = false;
+		}
+	}
+
+	out << endl << "]}" << endl;
+	return out.good();
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Tools.h"
+
+// PROFILE_SCOPE("Name") times the rest of the enclosing scope. Names have to be string literals, as only the pointer is kept.
+// With ENABLE_PROFILER off, scopes compile to nothing and Profiler doesn't exist
+#if ENABLE_PROFILER
+#define PROFILE_SCOPE_VARIABLE2(line) profileScope##line
+#define PROFILE_SCOPE_VARIABLE(line) PROFILE_SCOPE_VARIABLE2(line)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_SCOPE_VARIABLE(__LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+#if ENABLE_PROFILER
+
+struct ProfilerStatistics
+{
+	float frameTimeP50;		// In milliseconds
+	float frameTimeP95;
+	float frameTimeP99;
+	unsigned int scopesPerFrame;
+	float overheadPerFrame;	// Estimated time spent in the profiler itself, in milliseconds
+	unsigned int droppedScopes;
+};
+
+// Every thread records the scopes it closes into its own ring buffer, without locks or allocations.
+// Once a frame the main thread drains all the buffers into a timeline of the last few frames, 
+// which can be written out in Chrome's trace event format and opened with chrome://tracing
+class Profiler
+{
+private:
+	Profiler();		// Static class
+
+public:
+	static void Initialize();
+	static void EndFrame();
+
+	static void BeginScope();
+	static void EndScope(const char* name, long long startTime);
+
+	static ProfilerStatistics ConsumeStatistics();
+	static bool ExportTimeline(const wstring& path);
+};
+
+class ProfileScope
+{
+private:
+	const char* m_Name;
+	long long m_StartTime;
+
+	ProfileScope(const ProfileScope& other);				// Not implemented (no copying allowed)
+	ProfileScope& operator=(const ProfileScope& other);		// Not implemented (no copying allowed)
+
+public:
+	inline ProfileScope(const char* name) :
+		m_Name(name)
+	{
+		Profiler::BeginScope();
+		m_StartTime = Tools::GetRawTime();
+	}
+
+	inline ~ProfileScope()
+	{
+		Profiler::EndScope(m_Name, m_StartTime);
+	}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "PrecompiledHeader.h"
+#include "RandomGenerator.h"
+
+RandomGenerator::RandomGenerator(uint64_t seed, uint64_t stream)
+{
+	Seed(seed, stream);
+}
+
+void RandomGenerator::Seed(uint64_t seed, uint64_t stream)
+{
+	m_State = 0;
+	m_Increment = (stream << 1) | 1;
+	NextUInt();
+
+	m_State += seed;
+	NextUInt();
+}
+
+// Converts the top 24 bits of four numbers to floats in [0, 1) at once and scales them into range,
+// with the same multiply and add NextReal does, so both give bit identical results
+void RandomGenerator::FillReals(float* values, size_t count, float lowerBound, float higherBound)
+{
+	auto scale = DirectX::XMVectorReplicate(higherBound - lowerBound);
+	auto offset = DirectX::XMVectorReplicate(lowerBound);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// Generated one statement at a time, as the order function arguments get evaluated in is unspecified
+		auto x = NextUInt() >> 8;
+		auto y = NextUInt() >> 8;
+		auto z = NextUInt() >> 8;
+		auto w = NextUInt() >> 8;
+
+		auto zeroToOne = DirectX::XMConvertVectorUIntToFloat(DirectX::XMVectorSetInt(x, y, z, w), 24);
+		DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(values + i), DirectX::XMVectorMultiplyAdd(zeroToOne, scale, offset));
+	}
+
+	for (; i < count; i++)
+	{
+		values[i] = NextReal(lowerBound, higherBound);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Tools.h"
+
+// PCG32 (pcg-random.org): 64 bits of state and 32 bits of output per step, with 2^63 independent streams picked by the increment.
+// It's a fraction of the size and cost of mt19937. Numbers are made from its output here rather than by the standard distributions,
+// whose results differ between standard library implementations, so a seeded game plays out the same whatever it was built with.
+// Generators aren't thread safe: every thread that needs random numbers should use its own
+class RandomGenerator
+{
+private:
+	uint64_t m_State;
+	uint64_t m_Increment;
+
+public:
+	RandomGenerator(uint64_t seed = 0, uint64_t stream = 0);
+	void Seed(uint64_t seed, uint64_t stream);
+
+	inline uint32_t NextUInt()
+	{
+		auto oldState = m_State;
+		m_State = oldState * 6364136223846793005ULL + m_Increment;
+
+		auto xorShifted = static_cast<uint32_t>(((oldState >> 18) ^ oldState) >> 27);
+		auto rotation = static_cast<uint32_t>(oldState >> 59);
+
+		return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+	}
+
+	// Lemire's method: the top half of a 64 bit product lands in [0, bound), and the few low halves that would favour some results are retried
+	inline uint32_t NextUInt(uint32_t bound)
+	{
+		Assert(bound > 0);
+		auto product = static_cast<uint64_t>(NextUInt()) * bound;
+
+		if (static_cast<uint32_t>(product) < bound)
+		{
+			auto threshold = (0u - bound) % bound;
+
+			while (static_cast<uint32_t>(product) < threshold)
+			{
+				product = static_cast<uint64_t>(NextUInt()) * bound;
+			}
+		}
+
+		return static_cast<uint32_t>(product >> 32);
+	}
+
+	// In [0, 1), from the top 24 bits, as many as a float holds exactly. FillReals makes the same numbers
+	inline float NextFloat() { return static_cast<float>(NextUInt() >> 8) * (1.0f / 16777216.0f); }
+	inline float NextReal(float lowerBound, float higherBound) { return lowerBound + (higherBound - lowerBound) * NextFloat(); }
+
+	// Both bounds are included
+	inline int NextInteger(int lowerBound, int higherBound)
+	{
+		Assert(lowerBound <= higherBound);
+		auto range = static_cast<uint32_t>(higherBound) - static_cast<uint32_t>(lowerBound) + 1;
+
+		return static_cast<int>(static_cast<uint32_t>(lowerBound) + (range != 0 ? NextUInt(range) : NextUInt()));
+	}
+
+	// Fills values with numbers in [lowerBound, higherBound), four at a time. They're the numbers as many NextReal calls would return
+	void FillReals(float* values, size_t count, float lowerBound, float higherBound);
+};
\ No newline at end of file
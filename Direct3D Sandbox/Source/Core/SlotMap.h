@@ -0,0 +1,157 @@
+#pragma once
+
+#include "Tools.h"
+
+// Stable reference to a value in a SlotMap. Removing the value bumps the generation of its slot, 
+// so ids that outlive it stop resolving instead of referring to whatever reuses the slot
+struct SlotMapId
+{
+	uint32_t index;
+	uint32_t generation;
+
+	SlotMapId() : index(0xFFFFFFFF), generation(0) {}
+	SlotMapId(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+
+	inline bool IsValid() const { return index != 0xFFFFFFFF; }
+};
+
+// Values are kept packed in one array for iteration, in no particular order.
+// Ids go through a table of slots that point into that array, so adding, removing and looking values up are all O(1):
+// removal moves the last value into the hole and repoints its slot.
+// An id can be reserved before its value is inserted, so that code can refer to values that are only queued to be added
+template <typename T>
+class SlotMap
+{
+private:
+	struct Slot
+	{
+		uint32_t valueIndex;
+		uint32_t generation;
+		uint32_t nextFree;
+	};
+
+	static const uint32_t kNoIndex = 0xFFFFFFFF;
+
+	vector<T> m_Values;
+	vector<uint32_t> m_ValueSlots;		// Slot of every value, to repoint it when the value moves
+	vector<Slot> m_Slots;
+	uint32_t m_FirstFree;
+
+	inline bool IsCurrent(const SlotMapId& id) const
+	{
+		return id.index < m_Slots.size() && m_Slots[id.index].generation == id.generation;
+	}
+
+	SlotMap(const SlotMap& other);					// Not implemented (no copying allowed)
+	SlotMap& operator=(const SlotMap& other);		// Not implemented (no copying allowed)
+
+public:
+	typedef typename vector<T>::iterator iterator;
+	typedef typename vector<T>::const_iterator const_iterator;
+
+	SlotMap() :
+		m_FirstFree(kNoIndex)
+	{
+	}
+
+	~SlotMap()
+	{
+	}
+
+	SlotMapId Reserve()
+	{
+		uint32_t index;
+
+		if (m_FirstFree != kNoIndex)
+		{
+			index = m_FirstFree;
+			m_FirstFree = m_Slots[index].nextFree;
+		}
+		else
+		{
+			index = static_cast<uint32_t>(m_Slots.size());
+
+			Slot slot;
+			slot.generation = 0;
+			m_Slots.push_back(slot);
+		}
+
+		auto& slot = m_Slots[index];
+		slot.valueIndex = kNoIndex;
+		slot.nextFree = kNoIndex;
+
+		return SlotMapId(index, slot.generation);
+	}
+
+	void Insert(const SlotMapId& id, T&& value)
+	{
+		Assert(IsCurrent(id) && m_Slots[id.index].valueIndex == kNoIndex);
+
+		m_Slots[id.index].valueIndex = static_cast<uint32_t>(m_Values.size());
+		m_Values.push_back(move(value));
+		m_ValueSlots.push_back(id.index);
+	}
+
+	SlotMapId Add(T&& value)
+	{
+		auto id = Reserve();
+		Insert(id, move(value));
+		return id;
+	}
+
+	// Returns false if the id is stale. The value is destroyed after the map is consistent again, so its destructor may use the map
+	bool Remove(const SlotMapId& id)
+	{
+		if (!IsCurrent(id))
+		{
+			return false;
+		}
+
+		auto& slot = m_Slots[id.index];
+		auto valueIndex = slot.valueIndex;
+
+		slot.generation++;
+		slot.valueIndex = kNoIndex;
+		slot.nextFree = m_FirstFree;
+		m_FirstFree = id.index;
+
+		if (valueIndex == kNoIndex)
+		{
+			return true;	// Only reserved
+		}
+
+		T removedValue(move(m_Values[valueIndex]));
+		auto lastIndex = static_cast<uint32_t>(m_Values.size() - 1);
+
+		if (valueIndex != lastIndex)
+		{
+			m_Values[valueIndex] = move(m_Values[lastIndex]);
+			m_ValueSlots[valueIndex] = m_ValueSlots[lastIndex];
+			m_Slots[m_ValueSlots[valueIndex]].valueIndex = valueIndex;
+		}
+
+		m_Values.pop_back();
+		m_ValueSlots.pop_back();
+		return true;
+	}
+
+	// Returns nullptr if the id is stale or its value hasn't been inserted yet
+	inline T* Get(const SlotMapId& id)
+	{
+		if (!IsCurrent(id) || m_Slots[id.index].valueIndex == kNoIndex)
+		{
+			return nullptr;
+		}
+
+		return &m_Values[m_Slots[id.index].valueIndex];
+	}
+
+	inline size_t GetCount() const { return m_Values.size(); }
+	inline T& operator[](size_t valueIndex) { return m_Values[valueIndex]; }
+	inline const T& operator[](size_t valueIndex) const { return m_Values[valueIndex]; }
+	
+	inline iterator begin() { return m_Values.begin(); }
+	inline iterator end() { return m_Values.end(); }
+	inline const_iterator begin() const { return m_Values.begin(); }
+	inline const_iterator end() const { return m_Values.end(); }
+};
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "PrecompiledHeader.h"
+#include "SphereCuller.h"
+#include "Tools.h"
+
+const float SphereCuller::kDefaultCellSize = 8.0f;
+
+// Four wide loads starting at the last value read up to three values past it
+template <typename T>
+static inline void ResizePadded(vector<T>& values, size_t count)
+{
+	values.resize(count + 3);
+}
+
+SphereCuller::SphereCuller(float cellSize) :
+	m_CellSize(cellSize)
+{
+}
+
+SphereCuller::~SphereCuller()
+{
+}
+
+// Keeps the memory around, as the next frame is going to cull about as many spheres
+void SphereCuller::Clear()
+{
+	m_Spheres.clear();
+}
+
+unsigned int SphereCuller::Add(const DirectX::XMFLOAT3& center, float radius)
+{
+	m_Spheres.push_back(DirectX::XMFLOAT4(center.x, center.y, center.z, radius));
+	return static_cast<unsigned int>(m_Spheres.size() - 1);
+}
+
+// Sorts spheres by the XZ grid cell of their center, so that every cell's spheres are next to each other, and becomes a cluster
+void SphereCuller::BuildClusters()
+{
+	auto sphereCount = static_cast<unsigned int>(m_Spheres.size());
+
+	m_SortEntries.resize(sphereCount);
+
+	for (auto i = 0u; i < sphereCount; i++)
+	{
+		auto cellX = static_cast<int>(floor(m_Spheres[i].x / m_CellSize));
+		auto cellZ = static_cast<int>(floor(m_Spheres[i].z / m_CellSize));
+
+		m_SortEntries[i].first = (static_cast<uint64_t>(static_cast<unsigned int>(cellX)) << 32) | static_cast<unsigned int>(cellZ);
+		m_SortEntries[i].second = i;
+	}
+
+	sort(begin(m_SortEntries), end(m_SortEntries));
+
+	ResizePadded(m_SphereX, sphereCount);
+	ResizePadded(m_SphereY, sphereCount);
+	ResizePadded(m_SphereZ, sphereCount);
+	ResizePadded(m_SphereRadius, sphereCount);
+	m_Clusters.clear();
+
+	for (auto i = 0u; i < sphereCount; i++)
+	{
+		const auto& sphere = m_Spheres[m_SortEntries[i].second];
+
+		m_SphereX[i] = sphere.x;
+		m_SphereY[i] = sphere.y;
+		m_SphereZ[i] = sphere.z;
+		m_SphereRadius[i] = sphere.w;
+
+		if (i > 0 && m_SortEntries[i].first == m_SortEntries[i - 1].first)
+		{
+			m_Clusters.back().sphereCount++;
+		}
+		else
+		{
+			Cluster cluster;
+			cluster.firstSphere = i;
+			cluster.sphereCount = 1;
+
+			m_Clusters.push_back(cluster);
+		}
+	}
+
+	auto clusterCount = m_Clusters.size();
+
+	ResizePadded(m_ClusterX, clusterCount);
+	ResizePadded(m_ClusterY, clusterCount);
+	ResizePadded(m_ClusterZ, clusterCount);
+	ResizePadded(m_ClusterRadius, clusterCount);
+
+	for (auto i = 0u; i < clusterCount; i++)
+	{
+		DirectX::XMFLOAT4 bounds;
+		CalculateClusterBounds(m_Clusters[i], bounds);
+
+		m_ClusterX[i] = bounds.x;
+		m_ClusterY[i] = bounds.y;
+		m_ClusterZ[i] = bounds.z;
+		m_ClusterRadius[i] = bounds.w;
+	}
+}
+
+// Sphere around the box that holds every sphere of the cluster
+void SphereCuller::CalculateClusterBounds(const Cluster& cluster, DirectX::XMFLOAT4& bounds) const
+{
+	using namespace DirectX;
+
+	auto first = cluster.firstSphere;
+	auto end = cluster.firstSphere + cluster.sphereCount;
+	XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+	XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+
+	for (auto i = first; i < end; i++)
+	{
+		XMVECTOR center = XMVectorSet(m_SphereX[i], m_SphereY[i], m_SphereZ[i], 0.0f);
+		XMVECTOR radius = XMVectorReplicate(m_SphereRadius[i]);
+
+		minimum = XMVectorMin(minimum, center - radius);
+		maximum = XMVectorMax(maximum, center + radius);
+	}
+
+	XMStoreFloat4(&bounds, (minimum + maximum) * 0.5f);
+	bounds.w = XMVectorGetX(XMVector3Length(maximum - minimum)) * 0.5f;
+}
+
+// Classifies count spheres, four at a time. Reads up to three values past count, which the padding keeps inside the arrays.
+// A sphere is outside if it is entirely behind any plane, and inside if it is entirely in front of all of them
+void SphereCuller::Classify(const float* x, const float* y, const float* z, const float* radius, unsigned int count,
+		const FrustumPlanes& planes, uint8_t* classes)
+{
+	using namespace DirectX;
+
+	XMVECTOR planeX[6], planeY[6], planeZ[6], planeW[6];
+	XMVECTOR zero = XMVectorZero();
+
+	for (int i = 0; i < 6; i++)
+	{
+		planeX[i] = XMVectorSplatX(planes[i]);
+		planeY[i] = XMVectorSplatY(planes[i]);
+		planeZ[i] = XMVectorSplatZ(planes[i]);
+		planeW[i] = XMVectorSplatW(planes[i]);
+	}
+
+	for (auto i = 0u; i < count; i += 4)
+	{
+		XMVECTOR sphereX = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(x + i));
+		XMVECTOR sphereY = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(y + i));
+		XMVECTOR sphereZ = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(z + i));
+		XMVECTOR sphereRadius = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(radius + i));
+		XMVECTOR isOutside = XMVectorFalseInt();
+		XMVECTOR isCrossing = XMVectorFalseInt();
+
+		for (int j = 0; j < 6; j++)
+		{
+			XMVECTOR distance = XMVectorMultiplyAdd(sphereX, planeX[j], planeW[j]);
+			distance = XMVectorMultiplyAdd(sphereY, planeY[j], distance);
+			distance = XMVectorMultiplyAdd(sphereZ, planeZ[j], distance);
+
+			isOutside = XMVectorOrInt(isOutside, XMVectorLess(distance + sphereRadius, zero));
+			isCrossing = XMVectorOrInt(isCrossing, XMVectorLess(distance, sphereRadius));
+		}
+
+		uint32_t outside[4], crossing[4];
+		XMStoreInt4(outside, isOutside);
+		XMStoreInt4(crossing, isCrossing);
+
+		auto lanes = min(4u, count - i);
+
+		for (auto lane = 0u; lane < lanes; lane++)
+		{
+			classes[i + lane] = static_cast<uint8_t>(outside[lane] != 0 ? SphereClass::Outside : 
+				(crossing[lane] != 0 ? SphereClass::Crossing : SphereClass::Inside));
+		}
+	}
+}
+
+void SphereCuller::Cull(const FrustumPlanes& planes)
+{
+	auto sphereCount = static_cast<unsigned int>(m_Spheres.size());
+	m_Visibility.resize(sphereCount);
+
+	if (sphereCount == 0)
+	{
+		return;
+	}
+
+	BuildClusters();
+
+	auto clusterCount = static_cast<unsigned int>(m_Clusters.size());
+	m_ClusterClasses.resize(clusterCount);
+	m_SphereClasses.resize(sphereCount);
+
+	Classify(m_ClusterX.data(), m_ClusterY.data(), m_ClusterZ.data(), m_ClusterRadius.data(), clusterCount, planes, m_ClusterClasses.data());
+
+	for (auto i = 0u; i < clusterCount; i++)
+	{
+		const auto& cluster = m_Clusters[i];
+
+		if (m_ClusterClasses[i] == SphereClass::Crossing)
+		{
+			auto first = cluster.firstSphere;
+			Classify(&m_SphereX[first], &m_SphereY[first], &m_SphereZ[first], &m_SphereRadius[first], cluster.sphereCount, planes, &m_SphereClasses[first]);
+		}
+		else
+		{
+			memset(&m_SphereClasses[cluster.firstSphere], m_ClusterClasses[i], cluster.sphereCount);
+		}
+	}
+
+	for (auto i = 0u; i < sphereCount; i++)
+	{
+		m_Visibility[m_SortEntries[i].second] = m_SphereClasses[i] != SphereClass::Outside;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Parameters.h"
+
+// Culls bounding spheres against the six frustum planes, four spheres per SIMD instruction.
+// Spheres get grouped into clusters by the grid cell their center falls in. Cluster bounds enclose every sphere of the cluster,
+// so they are loose and may overlap neighbouring cells. Clusters are tested first: ones entirely outside the frustum reject all of their spheres,
+// ones entirely inside accept them, and only spheres of clusters crossing a plane get tested themselves
+class SphereCuller
+{
+private:
+	enum SphereClass
+	{
+		Outside = 0,
+		Crossing,
+		Inside
+	};
+
+	struct Cluster
+	{
+		unsigned int firstSphere;
+		unsigned int sphereCount;
+	};
+
+	// Spheres in the order they were added
+	vector<DirectX::XMFLOAT4> m_Spheres;
+	vector<uint8_t> m_Visibility;
+
+	// Spheres and clusters as structures of arrays, spheres sorted by cluster. Arrays are padded, so that four wide loads never read past their end
+	vector<pair<uint64_t, unsigned int>> m_SortEntries;
+	vector<float> m_SphereX, m_SphereY, m_SphereZ, m_SphereRadius;
+	vector<float> m_ClusterX, m_ClusterY, m_ClusterZ, m_ClusterRadius;
+	vector<Cluster> m_Clusters;
+	vector<uint8_t> m_SphereClasses;
+	vector<uint8_t> m_ClusterClasses;
+
+	float m_CellSize;
+
+	void BuildClusters();
+	void CalculateClusterBounds(const Cluster& cluster, DirectX::XMFLOAT4& bounds) const;
+
+	static void Classify(const float* x, const float* y, const float* z, const float* radius, unsigned int count,
+		const FrustumPlanes& planes, uint8_t* classes);
+
+	SphereCuller(const SphereCuller& other);				// Not implemented (no copying allowed)
+	SphereCuller& operator=(const SphereCuller& other);		// Not implemented (no copying allowed)
+
+public:
+	static const float kDefaultCellSize;
+
+	SphereCuller(float cellSize = kDefaultCellSize);
+	~SphereCuller();
+
+	void Clear();
+	unsigned int Add(const DirectX::XMFLOAT3& center, float radius);
+	void Cull(const FrustumPlanes& planes);
+
+	inline bool IsVisible(unsigned int sphere) const { return m_Visibility[sphere] != 0; }
+	inline size_t GetClusterCount() const { return m_Clusters.size(); }
+};
\ No newline at end of file
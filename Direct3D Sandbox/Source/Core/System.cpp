@@ -1,18 +1,31 @@
 #include "PrecompiledHeader.h"
+#include "AssetStreamer.h"
 #include "Constants.h"
 #include "Camera.h"
+#include "InputRecording.h"
+#include "Profiler.h"
+#include "RandomGenerator.h"
 #include "Source\Audio\AudioManager.h"
+#include "Source\Games\ZombieSurvival\Scenario.h"
+#include "Source\Graphics\AnimatedModel.h"
+#include "Source\Graphics\ConstantBuffer.h"
+#include "Source\Graphics\ConstantRingBuffer.h"
 #include "Source\Graphics\Font.h"
+#include "Source\Graphics\IModel.h"
 #include "Source\Graphics\IShader.h"
+#include "Source\Graphics\RecordingDeviceContext.h"
 #include "Source\Graphics\SamplerState.h"
 #include "Source\Graphics\Texture.h"
 #include "Source\Models\InfiniteGroundModelInstance.h"
+#include "Source\Models\LaserProjectileInstance.h"
+#include "Source\Models\ModelInstance2D.h"
 #include "Source\Models\PlayerInstance.h"
 #include "Source\Models\ZombieInstance.h"
 #include "System.h"
 #include "Tools.h"
 
 System* System::s_Instance;
+const unsigned int System::kNoSphere = 0xFFFFFFFF;
 
 System::System() :
 	m_Input(Input::GetInstance()),
@@ -21,40 +34,72 @@ System::System() :
 	m_Fps(0), 
 	m_LastFrameFps(0),
 	m_LastFpsTime(m_CurrentTime),
+	m_TickLength(1.0f / Constants::SimulationTickRate),
+	m_TickAccumulator(0.0),
+	m_SimulationTime(0.0),
+	m_TickIndex(0),
+	m_Player(nullptr),
+	m_ScenarioStartTime(0.0),
 	m_MouseSensitivity(Constants::DefaultMouseSensitivity),
 	m_Camera(new Camera(true, Constants::VerticalFieldOfView, m_Windowing.GetAspectRatio(), 0, 0)),
 	m_OrthoCamera(new Camera(false, 0.0f, 0.0f, static_cast<float>(m_Windowing.GetWidth()), static_cast<float>(m_Windowing.GetHeight()))),
-	m_Light(DirectX::XMFLOAT3(3.0f, -2.0f, -1.0f), DirectX::XMFLOAT3(0.4f, 0.2f, 0.2f), DirectX::XMFLOAT3(0.15f, 0.15f, 0.15f), 32)
+	m_Light(DirectX::XMFLOAT3(3.0f, -2.0f, -1.0f), DirectX::XMFLOAT3(0.4f, 0.2f, 0.2f), DirectX::XMFLOAT3(0.15f, 0.15f, 0.15f), 32),
+	m_IsDestroyingScene(false)
 {
 	s_Instance = this;
 
+	// Games are random unless input replays or benchmark scenarios seed them
+	Tools::Random::Seed(static_cast<unsigned int>(Tools::GetRawTime()));
+
+#if ENABLE_PROFILER
+	// Initialize profiler
+	Profiler::Initialize();
+#endif
+
 	// Initialize audio manager
 	AudioManager::Initialize();
 
 	// Initialize sample states
 	SamplerState::Initialize();
 
+	// Initialize constant ring buffer
+	ConstantRingBuffer::Initialize();
+
 	// Load shaders
 	IShader::LoadShaders();
 	
-	// Load textures
+	// Start loading textures, normal maps and fonts on worker threads. Textures are drawn with placeholders until they're ready
 	for (const auto& texture : Tools::GetFilesInDirectory(L"Assets\\Textures", L"*.dds", true))
 	{
-		Texture::LoadTexture(texture);
+		Texture::LoadTexture(texture, TextureKind::ColorTexture);
 	}
 
-	// Load normal maps
 	for (const auto& texture : Tools::GetFilesInDirectory(L"Assets\\Normal Maps", L"*.dds", true))
 	{
-		Texture::LoadTexture(texture);
+		Texture::LoadTexture(texture, TextureKind::NormalMapTexture);
 	}
 
-	// Load fonts
 	for (const auto& font : Tools::GetFilesInDirectory(L"Assets\\Fonts", L"*.font", true))
 	{
 		Font::LoadFont(font);
 	}
 
+	// Models and sounds are only needed once something uses them, such as when the first zombie spawns
+	for (const auto& model : Tools::GetFilesInDirectory(L"Assets\\Models", L"*.model", true))
+	{
+		IModel::Prefetch(model);
+	}
+
+	for (const auto& model : Tools::GetFilesInDirectory(L"Assets\\Animated Models", L"*.animatedModel", true))
+	{
+		IModel::Prefetch(model);
+	}
+
+	for (const auto& sound : Tools::GetFilesInDirectory(L"Assets\\Sounds", L"*.wav", true))
+	{
+		AudioManager::PrefetchSound(sound);
+	}
+
 	Font::SetDefault(L"Assets\\Fonts\\Segoe UI Light.font");
 
 	// Create scene
@@ -65,22 +110,37 @@ System::System() :
 	ModelParameters modelParameters;	
 	modelParameters.scale = DirectX::XMFLOAT3(5000.0f, 5000.0f, 5000.0f);
 
-	m_Models.emplace_back(new CameraPositionLockedModelInstance(textureShader, L"Assets\\Models\\skybox.model", modelParameters, 
-		L"Assets\\Textures\\SkyboxRed.dds", TypedDimensions<bool>(true, true, true)));
+	AddModel(unique_ptr<IModelInstance>(new CameraPositionLockedModelInstance(textureShader, L"Assets\\Models\\skybox.model", modelParameters, 
+		L"Assets\\Textures\\SkyboxRed.dds", TypedDimensions<bool>(true, true, true))));
 	
 	modelParameters.position = DirectX::XMFLOAT3(10.0f, 0.0f, 10.0f);
 	modelParameters.scale = DirectX::XMFLOAT3(4000.0f, 4000.0f, 4000.0f);
-	m_Models.emplace_back(new InfiniteGroundModelInstance(modelParameters, L"Assets\\Textures\\Lava.dds", L"Assets\\Normal Maps\\Lava.dds",
-		DirectX::XMFLOAT2(2000.0f, 2000.0f)));
+	AddModel(unique_ptr<IModelInstance>(new InfiniteGroundModelInstance(modelParameters, L"Assets\\Textures\\Lava.dds", L"Assets\\Normal Maps\\Lava.dds",
+		DirectX::XMFLOAT2(2000.0f, 2000.0f))));
 	
 	m_Camera->SetPosition(0.0f, 1.5f, 0.0f);
 	m_OrthoCamera->SetPosition(0.0f, 0.0f, 1.0f);
 
-	m_Models.emplace_back(new PlayerInstance(*m_Camera));
+	m_Player = new PlayerInstance(*m_Camera);
+	AddModel(unique_ptr<IModelInstance>(m_Player));
+	AddAndRemoveModels();
 }
 
 System::~System()
 {
+	// Models remove each other as they're destroyed, which doesn't matter anymore once the whole scene goes away
+	m_IsDestroyingScene = true;
+
+	// Models that were queued but never added are still owned by the queue
+	for (const auto& addRemoveModel : m_AddRemoveModelQueue)
+	{
+		if (addRemoveModel.operation == AddRemoveModelItem::AddRemoveOperation::ADD)
+		{
+			delete addRemoveModel.modelToAdd;
+		}
+	}
+
+	m_AddRemoveModelQueue.clear();
 }
 
 void System::Run()
@@ -90,10 +150,31 @@ void System::Run()
 		auto currentTime = Tools::GetTime();
 		m_FrameTime = static_cast<float>(currentTime - m_CurrentTime);
 		m_CurrentTime = currentTime;
-		m_Windowing.DispatchMessages();
 
-		UpdateAndDraw();
+		{
+			PROFILE_SCOPE("Frame");
+			m_Windowing.DispatchMessages();
+
+			// The simulation advances in fixed ticks however long frames take, so it behaves the same at any frame rate
+			m_TickAccumulator += m_FrameTime;
 
+			for (int i = 0; i < Constants::MaxTicksPerFrame && m_TickAccumulator >= m_TickLength; i++)
+			{
+				Tick();
+				m_TickAccumulator -= m_TickLength;
+			}
+
+			if (m_TickAccumulator >= m_TickLength)
+			{
+				m_TickAccumulator = 0.0;
+			}
+
+			DrawFrame();
+		}
+
+#if ENABLE_PROFILER
+		Profiler::EndFrame();
+#endif
 		IncrementFpsCounter();
 
 #if DEBUG
@@ -102,24 +183,270 @@ void System::Run()
 	}
 }
 
-void System::UpdateAndDraw()
+// Runs the simulation alone as fast as it goes, to measure its cost apart from drawing and presenting.
+// Windows messages aren't dispatched, so unless a replay drives input, enter is held down for the game to start and restart after the player dies
+void System::Simulate(unsigned int tickCount)
+{
+	auto startTime = Tools::GetTime();
+
+	for (auto i = 0u; i < tickCount; i++)
+	{
+		if (m_InputRecording == nullptr)
+		{
+			m_Input.KeyDown(VK_RETURN);
+		}
+
+		Tick();
+	}
+
+	auto elapsedTime = Tools::GetTime() - startTime;
+	wstringstream output;
+
+	output << L"Simulated " << tickCount << L" ticks in " << elapsedTime << L" s (" << tickCount / elapsedTime << L" ticks per second), " 
+		   << m_Player->GetZombieCount() << L" zombies alive at the end";
+	Tools::Report(output.str());
+}
+
+// Runs frames of a single tick each back to back, as fast as they go, to measure the whole game loop.
+// Headless builds get through thousands of them a second, as their draws are only counted
+void System::RunFrames(unsigned int frameCount)
+{
+	auto startTime = Tools::GetTime();
+	auto framesRun = 0u;
+
+	m_FrameTime = m_TickLength;
+
+	for (; framesRun < frameCount && !m_Input.ShouldQuit(); framesRun++)
+	{
+		RunUncappedFrame();
+	}
+
+	auto elapsedTime = Tools::GetTime() - startTime;
+	wstringstream output;
+
+	output << L"Ran " << framesRun << L" frames in " << elapsedTime << L" s (" << framesRun / elapsedTime << L" frames per second)";
+	Tools::Report(output.str());
+}
+
+static float GetPercentile(const vector<float>& sortedValues, float percentile)
+{
+	auto index = static_cast<size_t>(percentile * sortedValues.size());
+	return sortedValues[min(index, sortedValues.size() - 1)];
+}
+
+static wstring EscapeJsonString(const wstring& value)
+{
+	wstring escaped;
+
+	for (auto character : value)
+	{
+		if (character == L'\\' || character == L'"')
+		{
+			escaped += L'\\';
+		}
+
+		escaped += character;
+	}
+
+	return escaped;
+}
+
+// Plays a scenario with frames running back to back and writes how long they took as JSON, for runs to be compared against each other.
+// Ticks keep their fixed length, so the scenario plays out the same however long its frames take. Returns false if it ran no frames or the results couldn't be written
+bool System::RunBenchmark(const wstring& scenarioPath, const wstring& outputPath)
+{
+	m_Scenario = Scenario::Load(scenarioPath);
+	m_InputRecording = nullptr;
+	m_ScenarioStartTime = m_SimulationTime;
+	m_FrameTime = m_TickLength;
+	Tools::Random::Seed(m_Scenario->GetSeed());
+
+	vector<float> frameTimes;
+	double totalFrameTime = 0.0;
+	unsigned long long drawCount = 0;
+	auto startTime = Tools::GetTime();
+	auto startTick = m_TickIndex;
+
+	frameTimes.reserve(static_cast<size_t>(m_Scenario->GetDuration() / m_TickLength) + 1);
+
+	while (!m_Scenario->IsFinished(GetScenarioTime()) && !m_Input.ShouldQuit())
+	{
+		auto frameStartTime = Tools::GetTime();
+		RunUncappedFrame();
+		frameTimes.push_back(static_cast<float>(1000.0 * (Tools::GetTime() - frameStartTime)));
+		totalFrameTime += frameTimes.back();
+
+#if ENABLE_DEVICE_CONTEXT_RECORDING || HEADLESS
+		drawCount += Direct3D::GetRecordingContext()->GetLastFrameStatistics().GetDrawCount();
+#endif
+	}
+
+	auto elapsedTime = Tools::GetTime() - startTime;
+	auto frameCount = frameTimes.size();
+	auto zombiePoolStatistics = ZombieInstanceBase::GetPoolStatistics();
+	auto seed = m_Scenario->GetSeed();
+	auto droppedSpawnCount = m_Scenario->GetDroppedSpawnCount();
+	m_Scenario = nullptr;
+
+	if (frameCount == 0)
+	{
+		Tools::Report(L"Benchmark of " + scenarioPath + L" ran no frames");
+		return false;
+	}
+
+	sort(begin(frameTimes), end(frameTimes));
+
+	wofstream output(outputPath);
+
+	output << L"{" << endl;
+	output << L"\t\"scenario\": \"" << EscapeJsonString(scenarioPath) << L"\"," << endl;
+	output << L"\t\"seed\": " << seed << L"," << endl;
+	output << L"\t\"frames\": " << frameCount << L"," << endl;
+	output << L"\t\"ticks\": " << m_TickIndex - startTick << L"," << endl;
+	output << L"\t\"seconds\": " << elapsedTime << L"," << endl;
+	output << L"\t\"framesPerSecond\": " << frameCount / elapsedTime << L"," << endl;
+	output << L"\t\"frameTimeMs\": {" << endl;
+	output << L"\t\t\"mean\": " << totalFrameTime / frameCount << L"," << endl;
+	output << L"\t\t\"min\": " << frameTimes.front() << L"," << endl;
+	output << L"\t\t\"p50\": " << GetPercentile(frameTimes, 0.5f) << L"," << endl;
+	output << L"\t\t\"p90\": " << GetPercentile(frameTimes, 0.9f) << L"," << endl;
+	output << L"\t\t\"p95\": " << GetPercentile(frameTimes, 0.95f) << L"," << endl;
+	output << L"\t\t\"p99\": " << GetPercentile(frameTimes, 0.99f) << L"," << endl;
+	output << L"\t\t\"max\": " << frameTimes.back() << endl;
+	output << L"\t}," << endl;
+#if ENABLE_DEVICE_CONTEXT_RECORDING || HEADLESS
+	output << L"\t\"drawsPerFrame\": " << static_cast<double>(drawCount) / frameCount << L"," << endl;
+#endif
+	output << L"\t\"mostZombies\": " << zombiePoolStatistics.highWaterMark << L"," << endl;
+	output << L"\t\"droppedSpawns\": " << droppedSpawnCount << endl;
+	output << L"}" << endl;
+
+	auto wroteResults = output.good();
+	wstringstream summary;
+
+	summary << L"Benchmark of " << scenarioPath << L" ran " << frameCount << L" frames in " << elapsedTime << L" s, "
+			<< GetPercentile(frameTimes, 0.5f) << L" ms median and " << GetPercentile(frameTimes, 0.99f) << L" ms 99th percentile frame time. "
+			<< (wroteResults ? L"Results written to " : L"Failed to write results to ") << outputPath;
+	Tools::Report(summary.str());
+	return wroteResults;
+}
+
+// Seeds the game with the time, which gets stored in the recording along with the tick rate
+bool System::RecordInput(const wstring& path)
 {
+	auto seed = static_cast<unsigned int>(Tools::GetRawTime());
+
+	m_InputRecording = InputRecording::StartRecording(path, seed, 1.0f / m_TickLength);
+
+	if (m_InputRecording == nullptr)
+	{
+		Tools::Report(L"Failed to start recording input to " + path);
+		return false;
+	}
+
+	Tools::Random::Seed(seed);
+	return true;
+}
+
+// Has to be called before the first tick, so that the game starts from the same state it was recorded from
+bool System::ReplayInput(const wstring& path)
+{
+	m_InputRecording = InputRecording::StartReplaying(path);
+
+	if (m_InputRecording == nullptr)
+	{
+		Tools::Report(L"Failed to replay input from " + path + L": it can't be opened or isn't a valid recording");
+		return false;
+	}
+
+	Tools::Random::Seed(m_InputRecording->GetSeed());
+	SetTickRate(m_InputRecording->GetTickRate());
+	return true;
+}
+
+void System::SetTickRate(float ticksPerSecond)
+{
+	Assert(ticksPerSecond > 0.0f);
+	m_TickLength = 1.0f / ticksPerSecond;
+}
+
+void System::Tick()
+{
+	PROFILE_SCOPE("Tick");
 	RenderParameters renderParameters;
 
-	renderParameters.time = static_cast<float>(m_CurrentTime);
-	renderParameters.frameTime = m_FrameTime;
+	m_TickIndex++;
+	m_SimulationTime += m_TickLength;
+	m_Camera->BeginTick();
+
+	// Scenarios and replays take over input before anything reads it
+	if (m_Scenario != nullptr)
+	{
+		m_Scenario->Update(GetScenarioTime(), m_Input, *m_Player);
+	}
+	else if (m_InputRecording != nullptr)
+	{
+		m_InputRecording->Update(m_Input, m_TickIndex);
+
+		if (m_InputRecording->IsFinished())
+		{
+			OutputDebugStringW((L"Replay finished on tick " + to_wstring(m_TickIndex) + L"\r\n").c_str());
+			m_InputRecording = nullptr;
+		}
+	}
+
+	renderParameters.time = static_cast<float>(m_SimulationTime);
+	renderParameters.frameTime = m_TickLength;
+	renderParameters.tickInterpolation = 1.0f;
 	renderParameters.screenWidth = m_Windowing.GetWidth();
 	renderParameters.screenHeight = m_Windowing.GetHeight();
 
 	Update(renderParameters);
+}
+
+// A frame running exactly one tick, however long the last one took
+void System::RunUncappedFrame()
+{
+	m_CurrentTime = Tools::GetTime();
+
+	{
+		PROFILE_SCOPE("Frame");
+		m_Windowing.DispatchMessages();
+		Tick();
+		DrawFrame();
+	}
+
+#if ENABLE_PROFILER
+	Profiler::EndFrame();
+#endif
+	IncrementFpsCounter();
+}
+
+void System::DrawFrame()
+{
+	RenderParameters renderParameters;
+
+	renderParameters.time = static_cast<float>(m_SimulationTime + m_TickAccumulator);
+	renderParameters.frameTime = m_FrameTime;
+	renderParameters.tickInterpolation = static_cast<float>(m_TickAccumulator / m_TickLength);
+	renderParameters.screenWidth = m_Windowing.GetWidth();
+	renderParameters.screenHeight = m_Windowing.GetHeight();
+
 	Draw(renderParameters);
 }
 
 void System::Update(const RenderParameters& renderParameters)
 {
+	PROFILE_SCOPE("Update");
+
 	AddAndRemoveModels();
+	AssetStreamer::Update();
 	UpdateInput();
 
+	// Model updates run serially, as they play sounds and queue scene changes for AddAndRemoveModels to apply next tick.
+	// Heavy simulation, such as the zombie crowd, splits its independent per entity work across threads by itself
+	PROFILE_SCOPE("Model updates");
+
 	for (auto& model : m_Models)
 	{
 		model->Update(renderParameters);
@@ -135,27 +462,63 @@ void System::UpdateInput()
 
 	if (m_Input.IsKeyDown(VK_ADD))
 	{
-		m_MouseSensitivity += m_FrameTime * m_MouseSensitivity;
+		m_MouseSensitivity += m_TickLength * m_MouseSensitivity;
 	}
 	if (m_Input.IsKeyDown(VK_SUBTRACT))
 	{
-		m_MouseSensitivity -= m_FrameTime * m_MouseSensitivity;
+		m_MouseSensitivity -= m_TickLength * m_MouseSensitivity;
 	}
+
+#if ENABLE_PROFILER
+	if (m_Input.IsKeyDown(VK_F9))
+	{
+		auto path = Tools::GetAppDataPath(Constants::ApplicationName) + L"\\Timeline.json";
+		auto exported = Profiler::ExportTimeline(path);
+
+		OutputDebugStringW(((exported ? L"Exported timeline to " : L"Failed to export timeline to ") + path + L"\r\n").c_str());
+		m_Input.KeyUp(VK_F9);
+	}
+#endif
+
+#if ENABLE_DEVICE_CONTEXT_RECORDING
+	if (m_Input.IsKeyDown(VK_F10))
+	{
+		auto path = Tools::GetAppDataPath(Constants::ApplicationName) + L"\\DeviceContextCalls.txt";
+		wofstream output(path);
+
+		Direct3D::GetRecordingContext()->WriteLastFrameLog(output);
+		OutputDebugStringW(((output.good() ? L"Wrote last frame's device context calls to " : L"Failed to write device context calls to ") + path + L"\r\n").c_str());
+		m_Input.KeyUp(VK_F10);
+	}
+#endif
 }
 
 void System::Draw(RenderParameters& renderParameters)
 {
+	PROFILE_SCOPE("Draw");
+
 	m_Direct3D.SetBackBufferAsRenderTarget();
 	m_Direct3D.TurnZBufferOn();
 	m_Direct3D.StartDrawing();
 	
+	m_Camera->SetTickInterpolation(renderParameters.tickInterpolation);
 	m_Camera->SetRenderParameters(renderParameters);
 	m_Light.SetRenderParameters(renderParameters);
 	
-	for (auto& model : m_Models)
+	CullModels(renderParameters);
+
+	for (auto i = 0u; i < m_Models.GetCount(); i++)
 	{
-		model->Render3D(renderParameters);
+		if (IsModelVisible(i))
+		{
+			m_Models[i]->Submit3D(m_RenderQueue, renderParameters);
+		}
 	}
+
+	m_RenderQueue.Submit(renderParameters);
+
+	// Animated models only queue their instances while rendering, so that models sharing frames get drawn together
+	AnimatedModel::RenderInstances(renderParameters);
 	
 	m_Direct3D.TurnZBufferOff();
 	m_OrthoCamera->SetRenderParameters(renderParameters);
@@ -168,7 +531,33 @@ void System::Draw(RenderParameters& renderParameters)
 		model->Render2D(renderParameters);
 	}
 
-	m_Direct3D.SwapBuffers();
+	{
+		PROFILE_SCOPE("Present");
+		m_Direct3D.SwapBuffers();
+	}
+}
+
+// Bounding spheres of all models get culled together, so models out of view aren't submitted at all
+void System::CullModels(const RenderParameters& renderParameters)
+{
+	PROFILE_SCOPE("Cull models");
+	DirectX::XMFLOAT3 center;
+	float radius;
+
+	m_SphereCuller.Clear();
+	m_ModelSpheres.resize(m_Models.GetCount());
+
+	for (auto i = 0u; i < m_Models.GetCount(); i++)
+	{
+		auto hasSphere = m_Models[i]->GetBoundingSphere(renderParameters, center, radius);
+		m_ModelSpheres[i] = hasSphere ? m_SphereCuller.Add(center, radius) : kNoSphere;
+	}
+
+#if ENABLE_FRUSTUM_CULLING
+	m_SphereCuller.Cull(renderParameters.frustumPlanes);
+#else
+	fill(begin(m_ModelSpheres), end(m_ModelSpheres), kNoSphere);
+#endif
 }
 
 void System::IncrementFpsCounter()
@@ -182,6 +571,48 @@ void System::IncrementFpsCounter()
 		debugOutput << L"FPS: " << m_Fps << endl;
 		debugOutput << L"Memory usage: " << Tools::GetMemoryUsage() << " MB" << endl;
 
+		auto constantBufferStatistics = ConstantBuffer::ConsumeTotalStatistics();
+		debugOutput << L"Constant buffer uploads: " << constantBufferStatistics.uploadCount << L" (" 
+					<< constantBufferStatistics.stagedByteCount / 1024 << L" KB changed, " 
+					<< constantBufferStatistics.uploadedByteCount / 1024 << L" KB uploaded)" << endl;
+
+		auto renderQueueStatistics = m_RenderQueue.ConsumeStatistics();
+		debugOutput << L"Queued draws: " << renderQueueStatistics.drawCount << L" (" 
+					<< renderQueueStatistics.shaderChanges << L" shader, " 
+					<< renderQueueStatistics.textureChanges << L" texture and " 
+					<< renderQueueStatistics.modelChanges << L" model changes, " 
+					<< renderQueueStatistics.avoidedStateChanges << L" avoided, " 
+					<< renderQueueStatistics.constantBatchCount << L" constant maps)" << endl;
+
+		auto zombiePoolStatistics = ZombieInstanceBase::GetPoolStatistics();
+		auto projectilePoolStatistics = LaserProjectileInstance::GetPoolStatistics();
+		auto crosshairPoolStatistics = ModelInstance2D::GetPoolStatistics();
+		debugOutput << L"Pooled instances: " 
+					<< zombiePoolStatistics.liveCount << L" zombies (" << zombiePoolStatistics.highWaterMark << L" at most), "
+					<< projectilePoolStatistics.liveCount << L" projectiles (" << projectilePoolStatistics.highWaterMark << L" at most), "
+					<< crosshairPoolStatistics.liveCount << L" crosshairs (" << crosshairPoolStatistics.highWaterMark << L" at most)" << endl;
+
+#if ENABLE_DEVICE_CONTEXT_RECORDING
+		auto deviceContextStatistics = Direct3D::GetRecordingContext()->ConsumeStatistics();
+		auto frameCount = max(deviceContextStatistics.frameCount, 1u);
+		debugOutput << L"Device context calls per frame: " 
+					<< deviceContextStatistics.GetDrawCount() / frameCount << L" draws, " 
+					<< deviceContextStatistics.GetStateCallCount() / frameCount << L" state changes (" 
+					<< deviceContextStatistics.GetRedundantCallCount() / frameCount << L" redundant), " 
+					<< deviceContextStatistics.callCounts[MAP] / frameCount << L" maps, " 
+					<< deviceContextStatistics.uploadedByteCount / frameCount / 1024 << L" KB uploaded" << endl;
+#endif
+
+#if ENABLE_PROFILER
+		auto profilerStatistics = Profiler::ConsumeStatistics();
+		debugOutput << L"Frame time: " << profilerStatistics.frameTimeP50 << L" ms median, " 
+					<< profilerStatistics.frameTimeP95 << L" ms 95th, " 
+					<< profilerStatistics.frameTimeP99 << L" ms 99th percentile (" 
+					<< profilerStatistics.scopesPerFrame << L" scopes per frame costing " 
+					<< profilerStatistics.overheadPerFrame << L" ms, " 
+					<< profilerStatistics.droppedScopes << L" dropped)" << endl;
+#endif
+
 		OutputDebugStringW(debugOutput.str().c_str());
 
 		m_LastFrameFps = m_Fps;
@@ -190,58 +621,60 @@ void System::IncrementFpsCounter()
 	}
 }
 
-void System::AddModel(shared_ptr<IModelInstance> model)
+void System::AddModel(unique_ptr<IModelInstance> model)
 {
 	AddRemoveModelItem addModel;
 
 	addModel.operation = AddRemoveModelItem::AddRemoveOperation::ADD;
-	addModel.modelToAdd = model;
+	addModel.id = m_Models.Reserve();
+	addModel.modelToAdd = model.release();
+	addModel.modelToAdd->m_ModelId = addModel.id;
 
 	m_AddRemoveModelQueue.push_back(addModel);
 }
 
-void System::AddModelImpl(shared_ptr<IModelInstance> model)
+void System::AddModelImpl(const ModelId& id, IModelInstance* model)
 {
-	m_Models.push_back(model);
+	m_Models.Insert(id, unique_ptr<IModelInstance>(model));
 }
 
+// Removing a model twice before the queue is applied does nothing, so a zombie removing itself and the player clearing the scene don't clash
 void System::RemoveModel(const IModelInstance* model)
-{	
+{
+	if (m_IsDestroyingScene)
+	{
+		return;
+	}
+
 	AddRemoveModelItem removeModel;
 
 	removeModel.operation = AddRemoveModelItem::AddRemoveOperation::REMOVE;
-	removeModel.modelToRemove = model;
+	removeModel.id = model->GetModelId();
+	removeModel.modelToAdd = nullptr;
 
 	m_AddRemoveModelQueue.push_back(removeModel);
 }
 
-void System::RemoveModelImpl(const IModelInstance* model)
+void System::RemoveModelImpl(const ModelId& id)
 {
-	for (auto i = 0u; i < m_Models.size(); i++)
-	{
-		if (m_Models[i].get() == model)
-		{
-			m_Models[i] = m_Models[m_Models.size() - 1];
-			m_Models.pop_back();
-			break;
-		}
-	}
+	m_Models.Remove(id);
 }
 
 void System::AddAndRemoveModels()
 {
+	// Destroyed models may queue more removals, which get applied in the same pass
 	for (auto i = 0u; i < m_AddRemoveModelQueue.size(); i++)
 	{
-		const auto& addRemoveModel = m_AddRemoveModelQueue[i];
+		auto addRemoveModel = m_AddRemoveModelQueue[i];
 
 		switch (addRemoveModel.operation)
 		{
 		case AddRemoveModelItem::AddRemoveOperation::ADD:
-			AddModelImpl(addRemoveModel.modelToAdd);
+			AddModelImpl(addRemoveModel.id, addRemoveModel.modelToAdd);
 			break;
 
 		case AddRemoveModelItem::AddRemoveOperation::REMOVE:
-			RemoveModelImpl(addRemoveModel.modelToRemove);
+			RemoveModelImpl(addRemoveModel.id);
 			break;
 		}
 	}
@@ -2,12 +2,18 @@
 
 #include "DirectionalLight.h"
 #include "Input.h"
+#include "SphereCuller.h"
 #include "Source\Graphics\Direct3D.h"
+#include "Source\Graphics\RenderQueue.h"
 #include "Source\Models\IModelInstance.h"
+#include "Source\PlatformSpecific\Headless\HeadlessWindowing.h"
 #include "Source\PlatformSpecific\Windows\DesktopWindowing.h"
 #include "Source\PlatformSpecific\WindowsPhone\PhoneWindowing.h"
 
 class Camera;
+class InputRecording;
+class PlayerInstance;
+class Scenario;
 
 class System
 {
@@ -24,14 +30,32 @@ private:
 	double m_LastFpsTime;
 	int m_Fps;
 	int m_LastFrameFps;
+
+	float m_TickLength;
+	double m_TickAccumulator;		// Real time the simulation is behind by, always less than a tick after a frame's ticks ran
+	double m_SimulationTime;
+	unsigned int m_TickIndex;
+
+	PlayerInstance* m_Player;			// Owned by the scene
+	unique_ptr<InputRecording> m_InputRecording;
+	unique_ptr<Scenario> m_Scenario;
+	double m_ScenarioStartTime;
 	
 	unique_ptr<Camera> m_Camera;	// Allocated on the heap for proper alignment
 	unique_ptr<Camera> m_OrthoCamera;
 	DirectionalLight m_Light;
+	RenderQueue m_RenderQueue;
+	SphereCuller m_SphereCuller;
+	vector<unsigned int> m_ModelSpheres;		// Sphere of every model in the culler, or kNoSphere
 	
-	void UpdateAndDraw();
+	void Tick();
+	void DrawFrame();
+	void RunUncappedFrame();
+	inline float GetScenarioTime() const { return static_cast<float>(m_SimulationTime - m_ScenarioStartTime); }
 	void Update(const RenderParameters& renderParameters);
 	void Draw(RenderParameters& renderParameters);
+	void CullModels(const RenderParameters& renderParameters);
+	inline bool IsModelVisible(size_t index) const { return m_ModelSpheres[index] == kNoSphere || m_SphereCuller.IsVisible(m_ModelSpheres[index]); }
 	void IncrementFpsCounter();
 
 	void UpdateInput();
@@ -45,17 +69,22 @@ private:
 		};
 
 		AddRemoveOperation operation;
-		shared_ptr<IModelInstance> modelToAdd;
-		const IModelInstance* modelToRemove;
+		ModelId id;
+		IModelInstance* modelToAdd;					// Owned by the queue until it's added
 	};
 
+	// Models are destroyed when the queue is applied at the start of the next frame, never while something may still use them.
+	// Their ids are reserved as soon as they're queued, so they can be removed again before they ever get added
 	vector<AddRemoveModelItem> m_AddRemoveModelQueue;
-	vector<shared_ptr<IModelInstance>> m_Models;
+	SlotMap<unique_ptr<IModelInstance>> m_Models;
+	bool m_IsDestroyingScene;
 
-	void AddModelImpl(shared_ptr<IModelInstance> model);
-	void RemoveModelImpl(const IModelInstance* model);
+	void AddModelImpl(const ModelId& id, IModelInstance* model);
+	void RemoveModelImpl(const ModelId& id);
 	void AddAndRemoveModels();
 
+	static const unsigned int kNoSphere;
+
 	System(const System& other);
 
 public:
@@ -63,10 +92,20 @@ public:
 	~System();
 
 	void Run();
+	void Simulate(unsigned int tickCount);
+	void RunFrames(unsigned int frameCount);
+	bool RunBenchmark(const wstring& scenarioPath, const wstring& outputPath);
+	void SetTickRate(float ticksPerSecond);
+
+	bool RecordInput(const wstring& path);
+	bool ReplayInput(const wstring& path);
+
 	inline static System& GetInstance() { return *s_Instance; }
 	inline float GetMouseSensitivity() const { return m_MouseSensitivity; }
+	inline float GetSimulationTime() const { return static_cast<float>(m_SimulationTime); }
+	inline unsigned int GetTickIndex() const { return m_TickIndex; }
 
-	void AddModel(shared_ptr<IModelInstance> model);
+	void AddModel(unique_ptr<IModelInstance> model);
 	void RemoveModel(const IModelInstance* model);
 };
 
@@ -1,6 +1,11 @@
 #include "PrecompiledHeader.h"
+#include "FrameDeltaCoding.h"
+#include "MappedFile.h"
+#include "ModelFile.h"
 #include "Parameters.h"
+#include "RandomGenerator.h"
 #include "Tools.h"
+#include "VertexPacking.h"
 
 inline static long long int InitPerformanceCounterFrequency()
 {
@@ -25,6 +30,22 @@ double Tools::GetTime()
 	return static_cast<double>(GetRawTime()) / static_cast<double>(s_PerformanceCounterFrequency);
 }
 
+static RandomGenerator s_RandomGenerators[Tools::Random::Stream::StreamCount];
+
+RandomGenerator& Tools::Random::GetGenerator(Stream stream)
+{
+	Assert(stream < Stream::StreamCount);
+	return s_RandomGenerators[stream];
+}
+
+void Tools::Random::Seed(unsigned int seed)
+{
+	for (int i = 0; i < Stream::StreamCount; i++)
+	{
+		s_RandomGenerators[i].Seed(seed, i);
+	}
+}
+
 vector<uint8_t> Tools::ReadFileToVector(const wstring& path)
 {
 	ifstream in(path, ios::binary);
@@ -41,43 +62,157 @@ vector<uint8_t> Tools::ReadFileToVector(const wstring& path)
 	return fileContents;
 }
 
-static void ReadModelData(istream& inputStream, ModelData& model, size_t frameCount = 1)
+static void UnpackVertices(const PackedVertexParameters packedVertices[], const VertexBounds& bounds, VertexParameters vertices[], size_t vertexCount)
+{
+	for (auto i = 0u; i < vertexCount; i++)
+	{
+		VertexPacking::Unpack(packedVertices[i], bounds, vertices[i]);
+	}
+}
+
+static void ModelFileError(const wstring& path, const wstring& message)
 {
-	inputStream.read(reinterpret_cast<char*>(&model.vertexCount), sizeof(int));
-	model.vertices = unique_ptr<VertexParameters[]>(new VertexParameters[frameCount * model.vertexCount]);
-	inputStream.read(reinterpret_cast<char*>(model.vertices.get()), frameCount * model.vertexCount * sizeof(VertexParameters));
-
-	inputStream.read(reinterpret_cast<char*>(&model.indexCount), sizeof(int));
-	model.indices = unique_ptr<unsigned int[]>(new unsigned int[model.indexCount]);
-	inputStream.read(reinterpret_cast<char*>(model.indices.get()), model.indexCount * sizeof(unsigned int));
-	
-	inputStream.read(reinterpret_cast<char*>(&model.radius), sizeof(float));
-
-	OutputDebugString((L"\tNumber of vertices: " + to_wstring(model.vertexCount) + L"\r\n").c_str());
-	OutputDebugString((L"\tNumber of indices: " + to_wstring(model.indexCount) + L"\r\n").c_str());
-	OutputDebugString((L"\tModel radius: " + to_wstring(model.radius) + L"\r\n").c_str());
+	Tools::FatalError(L"Failed to load model \"" + path + L"\": " + message);
 }
 
+static void ReadDeltaCodedFrames(const wstring& path, const uint8_t data[], size_t dataSize, VertexParameters vertices[], size_t vertexCount, size_t frameCount)
+{
+	auto headerSize = sizeof(VertexBounds) + 2 * vertexCount * sizeof(uint16_t);
+
+	if (dataSize < headerSize)
+	{
+		ModelFileError(path, L"vertex data is truncated.");
+	}
+
+	const auto& bounds = *reinterpret_cast<const VertexBounds*>(data);
+	auto textureCoordinates = reinterpret_cast<const uint16_t*>(data + sizeof(VertexBounds));
+
+	auto startTime = Tools::GetTime();
+	unique_ptr<PackedVertexParameters[]> packedVertices(new PackedVertexParameters[frameCount * vertexCount]);
+
+	for (auto frame = 0u; frame < frameCount; frame++)
+	{
+		for (auto i = 0u; i < vertexCount; i++)
+		{
+			auto& packedVertex = packedVertices[frame * vertexCount + i];
+			packedVertex.textureCoordinates[0] = textureCoordinates[2 * i];
+			packedVertex.textureCoordinates[1] = textureCoordinates[2 * i + 1];
+		}
+	}
+
+	if (!FrameDeltaCoding::Decode(data + headerSize, dataSize - headerSize, vertexCount, frameCount, packedVertices.get()))
+	{
+		ModelFileError(path, L"animation frames are corrupted.");
+	}
+
+	UnpackVertices(packedVertices.get(), bounds, vertices, frameCount * vertexCount);
+
+	auto decodingTime = Tools::GetTime() - startTime;
+	auto decodedMegabytes = static_cast<double>(frameCount * vertexCount * sizeof(VertexParameters)) / (1024.0 * 1024.0);
+
+	OutputDebugString((L"\tDecoded " + to_wstring(dataSize - headerSize) + L" bytes of animation frames in " + to_wstring(1000.0 * decodingTime) +
+		L" ms (" + to_wstring(decodedMegabytes / decodingTime) + L" MB/s of vertices)\r\n").c_str());
+}
+
+// Full precision vertices are used straight from the mapped file, other encodings get decoded into the model's own array
+static void ReadVertices(const wstring& path, const uint8_t data[], size_t dataSize, ModelData& model, size_t frameCount, VertexEncoding vertexEncoding)
+{
+	auto totalVertexCount = static_cast<uint64_t>(frameCount) * model.vertexCount;
+
+	if (vertexEncoding == VertexEncoding::FullPrecision)
+	{
+		if (dataSize != totalVertexCount * sizeof(VertexParameters))
+		{
+			ModelFileError(path, L"vertex data size doesn't match the vertex count.");
+		}
+
+		model.mappedVertices = reinterpret_cast<const VertexParameters*>(data);
+		return;
+	}
+
+	if (vertexEncoding == VertexEncoding::Packed && dataSize != sizeof(VertexBounds) + totalVertexCount * sizeof(PackedVertexParameters))
+	{
+		ModelFileError(path, L"vertex data size doesn't match the vertex count.");
+	}
+
+	// Checked before allocating, so that a damaged vertex count can't ask for more memory than the data could ever fill
+	if (vertexEncoding == VertexEncoding::PackedDeltaFrames &&
+		dataSize < sizeof(VertexBounds) + FrameDeltaCoding::GetMinimumEncodedSize(model.vertexCount, frameCount))
+	{
+		ModelFileError(path, L"vertex data is truncated.");
+	}
+
+	model.vertices = unique_ptr<VertexParameters[]>(new VertexParameters[static_cast<size_t>(totalVertexCount)]);
+
+	switch (vertexEncoding)
+	{
+	case VertexEncoding::Packed:
+		{
+			const auto& bounds = *reinterpret_cast<const VertexBounds*>(data);
+			auto packedVertices = reinterpret_cast<const PackedVertexParameters*>(data + sizeof(VertexBounds));
+
+			UnpackVertices(packedVertices, bounds, model.vertices.get(), static_cast<size_t>(totalVertexCount));
+		}
+		break;
+
+	case VertexEncoding::PackedDeltaFrames:
+		ReadDeltaCodedFrames(path, data, dataSize, model.vertices.get(), model.vertexCount, frameCount);
+		break;
+	}
+}
+
+static void ReadAnimationStates(const wstring& path, const ModelFile::Header& header, const uint8_t data[], size_t dataSize, AnimatedModelData& model)
+{
+	if (dataSize != static_cast<uint64_t>(header.stateCount) * sizeof(ModelFile::StateRecord))
+	{
+		ModelFileError(path, L"animation state data size doesn't match the state count.");
+	}
+
+	auto stateRecords = reinterpret_cast<const ModelFile::StateRecord*>(data);
+
+	model.totalFrameCount = header.frameCount;
+	model.stateCount = header.stateCount;
+	model.stateData = unique_ptr<AnimatedModelState[]>(new AnimatedModelState[model.stateCount]);
+
+	for (auto i = 0u; i < model.stateCount; i++)
+	{
+		if (static_cast<uint64_t>(stateRecords[i].frameOffset) + stateRecords[i].frameCount > header.frameCount)
+		{
+			ModelFileError(path, L"animation state " + to_wstring(i) + L" refers to frames that don't exist.");
+		}
+
+		model.stateData[i].frameCount = stateRecords[i].frameCount;
+		model.stateData[i].frameOffset = stateRecords[i].frameOffset;
+	}
+
+	OutputDebugString((L"\tTotal number of frames: " + to_wstring(model.totalFrameCount) + L"\r\n").c_str());
+	OutputDebugString((L"\tNumber of states: " + to_wstring(model.stateCount) + L"\r\n").c_str());
+}
+
+// The returned model keeps the file mapped for as long as it points into it
 unique_ptr<ModelData> Tools::LoadModel(const wstring& path)
 {
-	ModelType modelType;
-	unique_ptr<ModelData> model;
-	auto modelPath = path;
+	using namespace ModelFile;
 
-	ifstream in(modelPath, ios::binary);
-	Assert(in.is_open());
+	auto startTime = GetTime();
+	auto file = make_shared<MappedFile>(path);
+	auto error = ModelFile::Validate(file->GetData(), file->GetSize());
+
+	if (!error.empty())
+	{
+		ModelFileError(path, error);
+	}
 
-	in.read(reinterpret_cast<char*>(&modelType), sizeof(ModelType));
-	Assert(modelType < ModelType::ModelTypeCount);
+	const auto& header = *reinterpret_cast<const Header*>(file->GetData());
+	auto fileData = reinterpret_cast<const uint8_t*>(file->GetData());
+	unique_ptr<ModelData> model;
 
-	switch (modelType)
+	switch (header.modelType)
 	{
 	case ModelType::Still:
 		{
 			OutputDebugString((L"Loading model from " + path + L":\r\n").c_str());
 			model = unique_ptr<ModelData>(new ModelData);
-
-			ReadModelData(in, *model.get());
 		}
 		break;
 
@@ -86,22 +221,28 @@ unique_ptr<ModelData> Tools::LoadModel(const wstring& path)
 			OutputDebugString((L"Loading animated model from " + path + L":\r\n").c_str());
 			model = unique_ptr<ModelData>(new AnimatedModelData);
 
-			auto animatedModel = reinterpret_cast<AnimatedModelData*>(model.get());
-			in.read(reinterpret_cast<char*>(&animatedModel->totalFrameCount), sizeof(int));
-			in.read(reinterpret_cast<char*>(&animatedModel->stateCount), sizeof(int));
-			
-			animatedModel->stateData = unique_ptr<AnimatedModelState[]>(new AnimatedModelState[animatedModel->stateCount]);
-			in.read(reinterpret_cast<char*>(animatedModel->stateData.get()), animatedModel->stateCount * sizeof(AnimatedModelState));
-
-			OutputDebugString((L"\tTotal number of frames: " + to_wstring(animatedModel->totalFrameCount) + L"\r\n").c_str());
-			OutputDebugString((L"\tNumber of states: " + to_wstring(animatedModel->stateCount) + L"\r\n").c_str());
-
-			ReadModelData(in, *model.get(), animatedModel->totalFrameCount);
+			const auto& stateSection = header.sections[SectionType::StateData];
+			ReadAnimationStates(path, header, fileData + stateSection.offset, stateSection.size, *reinterpret_cast<AnimatedModelData*>(model.get()));
 		}
 		break;
 	}
-	
-	model->modelType = modelType;
+
+	model->modelType = static_cast<ModelType>(header.modelType);
+	model->vertexCount = header.vertexCount;
+	model->indexCount = header.indexCount;
+	model->radius = header.radius;
+
+	const auto& vertexSection = header.sections[SectionType::Vertices];
+	ReadVertices(path, fileData + vertexSection.offset, vertexSection.size, *model, header.frameCount, static_cast<VertexEncoding>(header.vertexEncoding));
+
+	model->mappedIndices = reinterpret_cast<const unsigned int*>(fileData + header.sections[SectionType::Indices].offset);
+	model->mappedFile = file;
+
+	OutputDebugString((L"\tNumber of vertices: " + to_wstring(model->vertexCount) + L"\r\n").c_str());
+	OutputDebugString((L"\tNumber of indices: " + to_wstring(model->indexCount) + L"\r\n").c_str());
+	OutputDebugString((L"\tModel radius: " + to_wstring(model->radius) + L"\r\n").c_str());
+	OutputDebugString((L"\tLoaded in " + to_wstring(1000.0 * (GetTime() - startTime)) + L" ms\r\n").c_str());
+
 	return model;
 }
 
@@ -282,6 +423,36 @@ void Tools::FatalError(const wstring& msg)
 	exit(-1);
 }
 
+// Results of measuring runs and command line errors go to standard output as well as the debugger, as build machines run without one attached.
+// The game is a windowed application, so it only has standard output when it was redirected or once it attaches to the console it was started from
+void Tools::Report(const wstring& msg)
+{
+	OutputDebugStringW((msg + L"\r\n").c_str());
+
+#if !WINDOWS_PHONE
+	auto output = GetStdHandle(STD_OUTPUT_HANDLE);
+
+	if ((output == nullptr || output == INVALID_HANDLE_VALUE) && AttachConsole(ATTACH_PARENT_PROCESS))
+	{
+		output = CreateFileW(L"CONOUT$", GENERIC_WRITE, FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+		SetStdHandle(STD_OUTPUT_HANDLE, output);
+	}
+
+	if (output == nullptr || output == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	auto line = msg + L"\r\n";
+	auto byteCount = WideCharToMultiByte(CP_UTF8, 0, line.c_str(), static_cast<int>(line.length()), nullptr, 0, nullptr, nullptr);
+	string utf8Line(byteCount, '\0');
+	DWORD bytesWritten;
+
+	WideCharToMultiByte(CP_UTF8, 0, line.c_str(), static_cast<int>(line.length()), &utf8Line[0], byteCount, nullptr, nullptr);
+	WriteFile(output, utf8Line.data(), static_cast<DWORD>(utf8Line.length()), &bytesWritten, nullptr);
+#endif
+}
+
 string Tools::BufferReader::ReadString(const vector<uint8_t>& buffer, unsigned int& position)
 {
 	string str = reinterpret_cast<const char*>(&buffer[position]);
@@ -3,6 +3,8 @@
 #include "Parameters.h"
 #include "PrecompiledHeader.h"
 
+class MappedFile;
+class RandomGenerator;
 struct ModelData;
 
 namespace Tools
@@ -32,6 +34,7 @@ namespace Tools
 
 
 	void FatalError(const wstring& msg);
+	void Report(const wstring& msg);
 
 	namespace BufferReader
 	{
@@ -41,15 +44,22 @@ namespace Tools
 		char ReadChar(const vector<uint8_t>& buffer, unsigned int& position);
 	}
 
+	// Every system draws from its own stream of the same seed, so that one of them taking more numbers doesn't change what the others get.
+	// Streams belong to the main thread. Parallel jobs that need random numbers use generators of their own, seeded from a stream
 	namespace Random
 	{
-		inline mt19937& GetRandomEngine() { static mt19937 engineInstance(static_cast<unsigned int>(Tools::GetRawTime())); return engineInstance; }
+		enum Stream
+		{
+			Spawning = 0,
+			Animation,
+			Damage,
+			StreamCount
+		};
 
-		template <typename T>
-		inline T GetNextReal(T lowerBound, T higherBound) { return uniform_real_distribution<T>(lowerBound, higherBound)(GetRandomEngine()); }
+		RandomGenerator& GetGenerator(Stream stream);
 
-		template <typename T>
-		inline T GetNextInteger(T lowerBound, T higherBound) { return uniform_int_distribution<T>(lowerBound, higherBound)(GetRandomEngine()); }
+		// Games started from the same seed with the same input play out the same
+		void Seed(unsigned int seed);
 	}
 
 	namespace Math
@@ -89,15 +99,24 @@ struct ModelData
 
 	float radius;
 
-	ModelData() : vertexCount(0), indexCount(0), radius(0.0f) {}
+	// Models loaded from files point straight into the mapped file instead of owning their arrays where the layout allows it
+	shared_ptr<MappedFile> mappedFile;
+	const VertexParameters* mappedVertices;
+	const unsigned int* mappedIndices;
+
+	ModelData() : vertexCount(0), indexCount(0), radius(0.0f), mappedVertices(nullptr), mappedIndices(nullptr) {}
 
 	ModelData(ModelData&& other) : 
 		vertices(std::move(other.vertices)), vertexCount(other.vertexCount), 
 		indices(std::move(other.indices)), indexCount(other.indexCount),
-		radius(other.radius)
+		radius(other.radius), mappedFile(std::move(other.mappedFile)),
+		mappedVertices(other.mappedVertices), mappedIndices(other.mappedIndices)
 	{
 	}
 
+	inline const VertexParameters* GetVertices() const { return mappedVertices != nullptr ? mappedVertices : vertices.get(); }
+	inline const unsigned int* GetIndices() const { return mappedIndices != nullptr ? mappedIndices : indices.get(); }
+
 	virtual ~ModelData() {}
 
 private:
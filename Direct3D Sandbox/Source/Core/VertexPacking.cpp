@@ -0,0 +1,163 @@
+#include "PrecompiledHeader.h"
+#include "Parameters.h"
+#include "VertexPacking.h"
+
+#include <cfloat>
+#include <DirectXPackedVector.h>
+
+static const float kUnorm16Max = 65535.0f;
+static const float kSnorm16Max = 32767.0f;
+
+static inline float SignNotZero(float value)
+{
+	return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+static inline int16_t QuantizeSnorm16(float value)
+{
+	value = max(-1.0f, min(1.0f, value));
+	return static_cast<int16_t>(floor(value * kSnorm16Max + 0.5f));
+}
+
+// Lengths of zero, infinity or NaN come out of degenerate triangles. Such vectors can't be normalized by shaders anyway,
+// so octahedral encoding turns them into +Z and 16-bit normalized encoding into zero
+static inline bool IsUsableLength(float length)
+{
+	return length > 0.0f && length <= FLT_MAX;
+}
+
+// Projects the unit sphere onto an octahedron, unfolds the octahedron onto a square and quantizes it
+static void PackOctahedral(const DirectX::XMFLOAT3& direction, int16_t packedDirection[2])
+{
+	auto l1Norm = abs(direction.x) + abs(direction.y) + abs(direction.z);
+
+	if (!IsUsableLength(l1Norm))
+	{
+		packedDirection[0] = packedDirection[1] = 0;
+		return;
+	}
+
+	auto x = direction.x / l1Norm;
+	auto y = direction.y / l1Norm;
+
+	if (direction.z < 0.0f)
+	{
+		auto foldedX = (1.0f - abs(y)) * SignNotZero(x);
+		auto foldedY = (1.0f - abs(x)) * SignNotZero(y);
+
+		x = foldedX;
+		y = foldedY;
+	}
+
+	packedDirection[0] = QuantizeSnorm16(x);
+	packedDirection[1] = QuantizeSnorm16(y);
+}
+
+static void UnpackOctahedral(const int16_t packedDirection[2], DirectX::XMFLOAT3& direction)
+{
+	auto x = packedDirection[0] / kSnorm16Max;
+	auto y = packedDirection[1] / kSnorm16Max;
+	auto z = 1.0f - abs(x) - abs(y);
+
+	if (z < 0.0f)
+	{
+		auto unfoldedX = (1.0f - abs(y)) * SignNotZero(x);
+		auto unfoldedY = (1.0f - abs(x)) * SignNotZero(y);
+
+		x = unfoldedX;
+		y = unfoldedY;
+	}
+
+	auto length = sqrt(x * x + y * y + z * z);
+	direction = DirectX::XMFLOAT3(x / length, y / length, z / length);
+}
+
+static inline uint16_t QuantizeAgainstBounds(float value, float minimum, float extent)
+{
+	if (extent <= 0.0f)
+	{
+		return 0;
+	}
+
+	auto normalized = max(0.0f, min(1.0f, (value - minimum) / extent));
+	return static_cast<uint16_t>(floor(normalized * kUnorm16Max + 0.5f));
+}
+
+VertexBounds VertexPacking::CalculateBounds(const VertexParameters vertices[], size_t vertexCount)
+{
+	VertexBounds bounds;
+	DirectX::XMFLOAT3 maximum;
+
+	if (vertexCount == 0)
+	{
+		bounds.minimum = bounds.extent = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+		return bounds;
+	}
+
+	bounds.minimum = maximum = DirectX::XMFLOAT3(vertices[0].position.x, vertices[0].position.y, vertices[0].position.z);
+
+	for (auto i = 1u; i < vertexCount; i++)
+	{
+		const auto& position = vertices[i].position;
+
+		bounds.minimum.x = min(bounds.minimum.x, position.x);
+		bounds.minimum.y = min(bounds.minimum.y, position.y);
+		bounds.minimum.z = min(bounds.minimum.z, position.z);
+
+		maximum.x = max(maximum.x, position.x);
+		maximum.y = max(maximum.y, position.y);
+		maximum.z = max(maximum.z, position.z);
+	}
+
+	bounds.extent = DirectX::XMFLOAT3(maximum.x - bounds.minimum.x, maximum.y - bounds.minimum.y, maximum.z - bounds.minimum.z);
+	return bounds;
+}
+
+void VertexPacking::Pack(const VertexParameters& vertex, const VertexBounds& bounds, PackedVertexParameters& packedVertex)
+{
+	using namespace DirectX::PackedVector;
+
+	packedVertex.position[0] = QuantizeAgainstBounds(vertex.position.x, bounds.minimum.x, bounds.extent.x);
+	packedVertex.position[1] = QuantizeAgainstBounds(vertex.position.y, bounds.minimum.y, bounds.extent.y);
+	packedVertex.position[2] = QuantizeAgainstBounds(vertex.position.z, bounds.minimum.z, bounds.extent.z);
+
+	packedVertex.textureCoordinates[0] = XMConvertFloatToHalf(vertex.textureCoordinates.x);
+	packedVertex.textureCoordinates[1] = XMConvertFloatToHalf(vertex.textureCoordinates.y);
+
+	PackOctahedral(vertex.normal, packedVertex.normal);
+	PackOctahedral(vertex.tangent, packedVertex.tangent);
+	PackOctahedral(vertex.binormal, packedVertex.binormal);
+}
+
+void VertexPacking::Unpack(const PackedVertexParameters& packedVertex, const VertexBounds& bounds, VertexParameters& vertex)
+{
+	using namespace DirectX::PackedVector;
+
+	vertex.position.x = bounds.minimum.x + packedVertex.position[0] / kUnorm16Max * bounds.extent.x;
+	vertex.position.y = bounds.minimum.y + packedVertex.position[1] / kUnorm16Max * bounds.extent.y;
+	vertex.position.z = bounds.minimum.z + packedVertex.position[2] / kUnorm16Max * bounds.extent.z;
+	vertex.position.w = 1.0f;
+
+	vertex.textureCoordinates.x = XMConvertHalfToFloat(packedVertex.textureCoordinates[0]);
+	vertex.textureCoordinates.y = XMConvertHalfToFloat(packedVertex.textureCoordinates[1]);
+
+	UnpackOctahedral(packedVertex.normal, vertex.normal);
+	UnpackOctahedral(packedVertex.tangent, vertex.tangent);
+	UnpackOctahedral(packedVertex.binormal, vertex.binormal);
+}
+
+void VertexPacking::PackDirectionSnorm(const DirectX::XMFLOAT3& direction, int16_t packedDirection[4])
+{
+	auto length = sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+
+	if (!IsUsableLength(length))
+	{
+		packedDirection[0] = packedDirection[1] = packedDirection[2] = packedDirection[3] = 0;
+		return;
+	}
+
+	packedDirection[0] = QuantizeSnorm16(direction.x / length);
+	packedDirection[1] = QuantizeSnorm16(direction.y / length);
+	packedDirection[2] = QuantizeSnorm16(direction.z / length);
+	packedDirection[3] = 0;
+}
\ No newline at end of file
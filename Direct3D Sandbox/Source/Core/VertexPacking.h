@@ -0,0 +1,41 @@
+#pragma once
+
+struct VertexParameters;
+
+// Compact encoding of VertexParameters, as stored in model files:
+// position is quantized against the model's bounding box, texture coordinates are half floats
+// and normal, tangent and binormal are octahedral encoded unit vectors
+struct PackedVertexParameters
+{
+	uint16_t position[3];
+	uint16_t textureCoordinates[2];
+	int16_t normal[2];
+	int16_t tangent[2];
+	int16_t binormal[2];
+};
+
+struct VertexBounds
+{
+	DirectX::XMFLOAT3 minimum;
+	DirectX::XMFLOAT3 extent;
+};
+
+enum VertexEncoding
+{
+	FullPrecision = 0,
+	Packed,
+	PackedDeltaFrames,		// Animated models only: texture coordinates stored once, frames coded with FrameDeltaCoding
+	VertexEncodingCount
+};
+
+namespace VertexPacking
+{
+	VertexBounds CalculateBounds(const VertexParameters vertices[], size_t vertexCount);
+
+	void Pack(const VertexParameters& vertex, const VertexBounds& bounds, PackedVertexParameters& packedVertex);
+	void Unpack(const PackedVertexParameters& packedVertex, const VertexBounds& bounds, VertexParameters& vertex);
+
+	// Direction as four 16-bit signed normalized values, for feeding float3 shader inputs through DXGI_FORMAT_R16G16B16A16_SNORM.
+	// Shaders normalize everything they read this way, so only the direction is kept
+	void PackDirectionSnorm(const DirectX::XMFLOAT3& direction, int16_t packedDirection[4]);
+}
\ No newline at end of file
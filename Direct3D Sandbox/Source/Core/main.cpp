@@ -1,9 +1,145 @@
 #include "PrecompiledHeader.h"
 #include "CoInitializeWrapper.h"
+#include "Constants.h"
 #include "System.h"
+#include "Tools.h"
+
+#include <cerrno>
+#include <cfloat>
+#include <climits>
 
 #if !WINDOWS_PHONE
 
+struct CommandLineOptions
+{
+	float tickRate;
+	unsigned int ticksToSimulate;
+	unsigned int framesToRun;
+	wstring recordPath;
+	wstring replayPath;
+	wstring scenarioPath;
+	wstring outputPath;
+
+	CommandLineOptions() :
+		tickRate(Constants::SimulationTickRate),
+		ticksToSimulate(0),
+		framesToRun(0)
+	{
+	}
+};
+
+// Values that aren't positive numbers are reported and leave the option at its default
+static bool ParseTickRate(const wstring& value, float& tickRate)
+{
+	wchar_t* end;
+	auto parsed = wcstod(value.c_str(), &end);
+
+	if (end == value.c_str() || *end != L'\0' || !(parsed > 0.0 && parsed <= FLT_MAX))
+	{
+		return false;
+	}
+
+	tickRate = static_cast<float>(parsed);
+	return true;
+}
+
+static bool ParseCount(const wstring& value, unsigned int& count)
+{
+	if (value.empty() || !iswdigit(value[0]))
+	{
+		return false;
+	}
+
+	wchar_t* end;
+	errno = 0;
+	auto parsed = wcstoul(value.c_str(), &end, 10);
+
+	if (*end != L'\0' || errno == ERANGE || parsed == 0 || parsed > UINT_MAX)
+	{
+		return false;
+	}
+
+	count = static_cast<unsigned int>(parsed);
+	return true;
+}
+
+static void ReportInvalidValue(const wstring& argument, const wstring& value)
+{
+	Tools::Report(L"Ignoring " + argument + L" " + value + L": it has to be a positive number");
+}
+
+// "-tickrate <ticks per second>" changes how often the simulation steps.
+// "-simulate <tick count>" runs that many ticks without drawing, as fast as possible, reports how long they took and quits.
+// "-frames <frame count>" does the same with a tick and a draw every frame.
+// "-record <path>" records input of the game played to a file, which "-replay <path>" plays back with the same seed and tick rate.
+// "-scenario <path>" plays a scripted benchmark scenario, writes its frame times to "-output <path>" and quits.
+// Paths with spaces have to be quoted
+static CommandLineOptions ParseCommandLine()
+{
+	CommandLineOptions options;
+	int argumentCount;
+	auto arguments = CommandLineToArgvW(GetCommandLineW(), &argumentCount);
+
+	if (arguments == nullptr)
+	{
+		return options;
+	}
+
+	// The first argument is the executable
+	for (int i = 1; i + 1 < argumentCount; i++)
+	{
+		wstring argument = arguments[i];
+		wstring value = arguments[i + 1];
+
+		if (argument == L"-tickrate")
+		{
+			if (!ParseTickRate(value, options.tickRate))
+			{
+				ReportInvalidValue(argument, value);
+			}
+		}
+		else if (argument == L"-simulate")
+		{
+			if (!ParseCount(value, options.ticksToSimulate))
+			{
+				ReportInvalidValue(argument, value);
+			}
+		}
+		else if (argument == L"-frames")
+		{
+			if (!ParseCount(value, options.framesToRun))
+			{
+				ReportInvalidValue(argument, value);
+			}
+		}
+		else if (argument == L"-record")
+		{
+			options.recordPath = value;
+		}
+		else if (argument == L"-replay")
+		{
+			options.replayPath = value;
+		}
+		else if (argument == L"-scenario")
+		{
+			options.scenarioPath = value;
+		}
+		else if (argument == L"-output")
+		{
+			options.outputPath = value;
+		}
+		else
+		{
+			continue;
+		}
+
+		i++;
+	}
+
+	LocalFree(arguments);
+	return options;
+}
+
 int CALLBACK WinMain(
   _In_ HINSTANCE hInstance,
   _In_opt_ HINSTANCE hPrevInstance,
@@ -14,8 +150,48 @@ int CALLBACK WinMain(
 #if DEBUG
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF | _CRTDBG_CHECK_ALWAYS_DF);
 #endif
+	auto options = ParseCommandLine();
+
 	System system;
-	system.Run();
+	system.SetTickRate(options.tickRate);
+
+	// Build machines check the exit code, so a run that can't do what it was asked to fails rather than playing an ordinary game
+	if (!options.replayPath.empty())
+	{
+		if (!system.ReplayInput(options.replayPath))
+		{
+			return -1;
+		}
+	}
+	else if (!options.recordPath.empty())
+	{
+		if (!system.RecordInput(options.recordPath))
+		{
+			return -1;
+		}
+	}
+
+	if (!options.scenarioPath.empty())
+	{
+		auto outputPath = options.outputPath.empty() ? Tools::GetAppDataPath(Constants::ApplicationName) + L"\\Benchmark.json" : options.outputPath;
+
+		if (!system.RunBenchmark(options.scenarioPath, outputPath))
+		{
+			return -1;
+		}
+	}
+	else if (options.ticksToSimulate > 0)
+	{
+		system.Simulate(options.ticksToSimulate);
+	}
+	else if (options.framesToRun > 0)
+	{
+		system.RunFrames(options.framesToRun);
+	}
+	else
+	{
+		system.Run();
+	}
 
 	return 0;
 }
@@ -0,0 +1,162 @@
+#include "PrecompiledHeader.h"
+#include "Input.h"
+#include "Scenario.h"
+#include "Tools.h"
+
+static wstring LineError(int lineNumber, const wstring& message)
+{
+	return L"line " + to_wstring(lineNumber) + L": " + message;
+}
+
+Scenario::Scenario() :
+	m_Seed(0),
+	m_Duration(0.0f),
+	m_IsPlayerInvulnerable(false),
+	m_NextSpawn(0),
+	m_DroppedSpawnCount(0)
+{
+}
+
+Scenario::~Scenario()
+{
+}
+
+unique_ptr<Scenario> Scenario::Load(const wstring& path)
+{
+	wifstream in(path);
+
+	if (!in.is_open())
+	{
+		Tools::FatalError(L"Failed to open scenario \"" + path + L"\"");
+	}
+
+	wstring error;
+	auto scenario = Parse(in, error);
+
+	if (scenario == nullptr)
+	{
+		Tools::FatalError(L"Failed to load scenario \"" + path + L"\": " + error);
+	}
+
+	return scenario;
+}
+
+unique_ptr<Scenario> Scenario::Parse(wistream& in, wstring& error)
+{
+	unique_ptr<Scenario> scenario(new Scenario);
+	wstring line;
+	int lineNumber = 0;
+
+	while (getline(in, line))
+	{
+		lineNumber++;
+
+		auto comment = line.find(L'#');
+
+		if (comment != wstring::npos)
+		{
+			line.erase(comment);
+		}
+
+		wistringstream arguments(line);
+		wstring command;
+
+		if (!(arguments >> command))
+		{
+			continue;
+		}
+
+		if (command == L"seed")
+		{
+			arguments >> scenario->m_Seed;
+		}
+		else if (command == L"duration")
+		{
+			arguments >> scenario->m_Duration;
+		}
+		else if (command == L"invulnerable")
+		{
+			scenario->m_IsPlayerInvulnerable = true;
+		}
+		else if (command == L"spawn")
+		{
+			Spawn spawn;
+			arguments >> spawn.time >> spawn.count;
+
+			if (!arguments.fail() && spawn.count <= 0)
+			{
+				error = LineError(lineNumber, L"spawn count has to be positive");
+				return nullptr;
+			}
+
+			scenario->m_Spawns.push_back(spawn);
+		}
+		else if (command == L"fire")
+		{
+			Fire fire;
+			arguments >> fire.startTime >> fire.interval;
+
+			if (!arguments.fail() && fire.interval <= 0.0f)
+			{
+				error = LineError(lineNumber, L"fire interval has to be positive");
+				return nullptr;
+			}
+
+			scenario->m_Fires.push_back(fire);
+		}
+		else if (command == L"hold")
+		{
+			Hold hold;
+			wstring key;
+			arguments >> hold.startTime >> hold.endTime >> key;
+
+			if (!arguments.fail() && (key.length() != 1 || key[0] >= InputState::kKeyCount))
+			{
+				error = LineError(lineNumber, L"keys are given by a single character");
+				return nullptr;
+			}
+
+			hold.key = arguments.fail() ? 0 : towupper(key[0]);
+			scenario->m_Holds.push_back(hold);
+		}
+		else if (command == L"look")
+		{
+			Look look;
+			arguments >> look.startTime >> look.endTime >> look.x >> look.y;
+			scenario->m_Looks.push_back(look);
+		}
+		else
+		{
+			error = LineError(lineNumber, L"unknown command \"" + command + L"\"");
+			return nullptr;
+		}
+
+		wstring extraArgument;
+
+		if (arguments.fail())
+		{
+			error = LineError(lineNumber, L"missing or malformed arguments to \"" + command + L"\"");
+			return nullptr;
+		}
+		else if (arguments >> extraArgument)
+		{
+			error = LineError(lineNumber, L"too many arguments to \"" + command + L"\"");
+			return nullptr;
+		}
+	}
+
+	if (!(scenario->m_Duration > 0.0f))
+	{
+		error = L"it has no duration";
+		return nullptr;
+	}
+
+	stable_sort(begin(scenario->m_Spawns), end(scenario->m_Spawns), [](const Spawn& left, const Spawn& right) { return left.time < right.time; });
+
+	for (const auto& fire : scenario->m_Fires)
+	{
+		scenario->m_NextFireTimes.push_back(fire.startTime);
+	}
+
+	return scenario;
+}
\ No newline at end of file
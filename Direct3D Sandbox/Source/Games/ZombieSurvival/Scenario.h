@@ -0,0 +1,79 @@
+#pragma once
+
+class Input;
+class PlayerInstance;
+
+// Scripted game played with generated input, so that benchmark runs of the same scenario are comparable.
+// Scenario files are text with one command per line, times in seconds since the scenario started and # starting a comment:
+//
+//	seed <seed>							Random seed the game is played with
+//	duration <seconds>					How long the scenario lasts
+//	invulnerable						Zombies can't kill the player, so crowds keep growing
+//	spawn <time> <count>				Spawns zombies on top of the ones the game spawns itself
+//	fire <start> <interval>				Fires the weapon every interval from then on
+//	hold <start> <end> <key>			Holds a key, given by its character, such as W
+//	look <start> <end> <x> <y>			Moves the mouse by this much every tick
+class Scenario
+{
+private:
+	struct Spawn
+	{
+		float time;
+		int count;
+	};
+
+	struct Fire
+	{
+		float startTime;
+		float interval;
+	};
+
+	struct Hold
+	{
+		float startTime, endTime;
+		int key;
+	};
+
+	struct Look
+	{
+		float startTime, endTime;
+		long x, y;
+	};
+
+	unsigned int m_Seed;
+	float m_Duration;
+	bool m_IsPlayerInvulnerable;
+
+	vector<Spawn> m_Spawns;			// Sorted by time
+	vector<Fire> m_Fires;
+	vector<Hold> m_Holds;
+	vector<Look> m_Looks;
+
+	size_t m_NextSpawn;
+	int m_DroppedSpawnCount;
+	vector<float> m_NextFireTimes;
+
+	Scenario();
+
+	Scenario(const Scenario& other);				// Not implemented (no copying allowed)
+	Scenario& operator=(const Scenario& other);		// Not implemented (no copying allowed)
+
+public:
+	~Scenario();
+
+	// Malformed scenarios are fatal errors
+	static unique_ptr<Scenario> Load(const wstring& path);
+
+	// Returns null if the scenario is malformed, with what's wrong with it in error
+	static unique_ptr<Scenario> Parse(wistream& in, wstring& error);
+
+	// Call at the start of every tick, before anything reads input. Input from the window is thrown away
+	void Update(float time, Input& input, PlayerInstance& player);
+
+	inline unsigned int GetSeed() const { return m_Seed; }
+	inline float GetDuration() const { return m_Duration; }
+	inline bool IsFinished(float time) const { return time >= m_Duration; }
+
+	// Zombies the scenario asked for that didn't fit under the zombie limit or around the player
+	inline int GetDroppedSpawnCount() const { return m_DroppedSpawnCount; }
+};
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "PrecompiledHeader.h"
+#include "Input.h"
+#include "Scenario.h"
+#include "Source\Models\PlayerInstance.h"
+
+// Playing needs the rest of the game, so it's kept apart from loading, which the tests build on its own
+void Scenario::Update(float time, Input& input, PlayerInstance& player)
+{
+	InputState state;
+
+	// The game gets started, and started over whenever the player dies
+	if (player.GetGameState() != GameState::Playing)
+	{
+		state.keyMap[VK_RETURN] = true;
+	}
+
+	for (auto i = 0u; i < m_Fires.size(); i++)
+	{
+		if (time >= m_NextFireTimes[i])
+		{
+			state.mouseButtonMap[1] = true;
+
+			while (m_NextFireTimes[i] <= time)
+			{
+				m_NextFireTimes[i] += m_Fires[i].interval;
+			}
+		}
+	}
+
+	for (const auto& hold : m_Holds)
+	{
+		if (time >= hold.startTime && time < hold.endTime)
+		{
+			state.keyMap[hold.key] = true;
+		}
+	}
+
+	for (const auto& look : m_Looks)
+	{
+		if (time >= look.startTime && time < look.endTime)
+		{
+			state.mouseX += look.x;
+			state.mouseY += look.y;
+		}
+	}
+
+	input.SetState(state);
+	player.SetInvulnerable(m_IsPlayerInvulnerable);
+
+	// Zombies can only be spawned once the game is on
+	if (player.GetGameState() == GameState::Playing)
+	{
+		for (; m_NextSpawn < m_Spawns.size() && m_Spawns[m_NextSpawn].time <= time; m_NextSpawn++)
+		{
+			auto count = m_Spawns[m_NextSpawn].count;
+			m_DroppedSpawnCount += count - player.SpawnZombies(count);
+		}
+	}
+}
\ No newline at end of file
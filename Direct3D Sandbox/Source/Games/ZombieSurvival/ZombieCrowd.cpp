@@ -0,0 +1,364 @@
+#include "PrecompiledHeader.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "RandomGenerator.h"
+#include "Tools.h"
+#include "ZombieCrowd.h"
+
+const unsigned int ZombieCrowd::kNoZombie = 0xFFFFFFFF;
+const float ZombieCrowd::kAnimationPeriods[ZombieStates::StateCount] = { 2.0f, 0.8f, 1.167f, 1.333f };
+const bool ZombieCrowd::kDoesAnimationLoop[ZombieStates::StateCount] = { true, true, true, false };
+const float ZombieCrowd::kAnimationTransitionLength = 0.5f;
+
+static const float kZombieDistancePerRunningAnimationTime = 1.5f;
+const float ZombieCrowd::kZombieSpeed = kZombieDistancePerRunningAnimationTime / ZombieCrowd::kAnimationPeriods[ZombieStates::Running];
+
+static const float kZombieBodyLastingTime = 20.0f;
+static const float kZombieHitInterval = 1.0f;
+static const float kNearPlayerSoundInterval = 5.0f;
+static const float kFootStepInterval = 0.4f;
+static const float kDespawnDistanceSqr = 100.0f * 100.0f;
+
+// Smaller crowds are cheaper to update on one thread than to split across several
+static const size_t kMinZombiesPerJob = 256;
+
+template <typename T>
+static inline void RemoveAt(vector<T>& values, unsigned int index)
+{
+	values[index] = values.back();
+	values.pop_back();
+}
+
+ZombieCrowd::ZombieCrowd() :
+	m_NextSpawnAnimationProgress(0),
+	m_DamageToPlayer(0.0f)
+{
+}
+
+ZombieCrowd::~ZombieCrowd()
+{
+}
+
+// Draws the random animation progress of the next count zombies in one go, rather than a few numbers as each of them gets added.
+// Batches come out of the generator exactly as single numbers do, so this doesn't change the game a seed plays
+void ZombieCrowd::PrepareToAdd(size_t count)
+{
+	m_SpawnAnimationProgress.erase(begin(m_SpawnAnimationProgress), begin(m_SpawnAnimationProgress) + m_NextSpawnAnimationProgress);
+	m_NextSpawnAnimationProgress = 0;
+
+	auto drawnCount = m_SpawnAnimationProgress.size();
+	auto neededCount = count * ZombieStates::Death;
+
+	if (drawnCount < neededCount)
+	{
+		m_SpawnAnimationProgress.resize(neededCount);
+		Tools::Random::GetGenerator(Tools::Random::Stream::Animation).FillReals(&m_SpawnAnimationProgress[drawnCount], neededCount - drawnCount, 0.0f, 1.0f);
+	}
+}
+
+unsigned int ZombieCrowd::Add(const DirectX::XMFLOAT2& position, float rotationY, float speed, bool isAnimated, float time)
+{
+	unsigned int id;
+	auto index = static_cast<unsigned int>(m_IndexToId.size());
+
+	if (m_FreeIds.size() > 0)
+	{
+		id = m_FreeIds.back();
+		m_FreeIds.pop_back();
+		m_IdToIndex[id] = index;
+	}
+	else
+	{
+		id = static_cast<unsigned int>(m_IdToIndex.size());
+		m_IdToIndex.push_back(index);
+	}
+
+	m_IndexToId.push_back(id);
+	m_PositionX.push_back(position.x);
+	m_PositionZ.push_back(position.y);
+	m_RotationY.push_back(rotationY);
+	m_Speed.push_back(speed);
+	m_Health.push_back(1.0f);
+	m_DeathTime.push_back(0.0f);
+	m_DistanceToPlayerSqr.push_back(kDespawnDistanceSqr);
+	m_LastHitPlayerAt.push_back(time);
+	m_LastMadeNearPlayerSound.push_back(-kNearPlayerSoundInterval);
+	m_LastFootStep.push_back(-kFootStepInterval);
+	m_TargetState.push_back(ZombieStates::Idle);
+	m_Flags.push_back(isAnimated ? ZombieFlags::IsAnimated : 0);
+	m_Events.push_back(ZombieEvents::NoEvents);
+	m_Animations.push_back(ZombieAnimation(ZombieStates::Idle));
+
+	auto& animation = m_Animations.back();
+
+	if (m_NextSpawnAnimationProgress + ZombieStates::Death > m_SpawnAnimationProgress.size())
+	{
+		PrepareToAdd(1);
+	}
+
+	for (int i = 0; i < ZombieStates::Death; i++)
+	{
+		animation.SetAnimationProgress(i, m_SpawnAnimationProgress[m_NextSpawnAnimationProgress++]);
+	}
+
+	animation.SetAnimationProgress(ZombieStates::Death, 0.145f);
+
+	m_Grid.Add(id, position);
+	return id;
+}
+
+void ZombieCrowd::Remove(unsigned int id)
+{
+	auto index = GetIndex(id);
+
+	if ((m_Flags[index] & ZombieFlags::HasDied) == 0)
+	{
+		m_Grid.Remove(id, GetPositionAt(index));
+	}
+
+	auto lastId = m_IndexToId.back();
+	m_IdToIndex[lastId] = index;
+	m_IdToIndex[id] = kNoZombie;
+	m_FreeIds.push_back(id);
+
+	RemoveAt(m_IndexToId, index);
+	RemoveAt(m_PositionX, index);
+	RemoveAt(m_PositionZ, index);
+	RemoveAt(m_RotationY, index);
+	RemoveAt(m_Speed, index);
+	RemoveAt(m_Health, index);
+	RemoveAt(m_DeathTime, index);
+	RemoveAt(m_DistanceToPlayerSqr, index);
+	RemoveAt(m_LastHitPlayerAt, index);
+	RemoveAt(m_LastMadeNearPlayerSound, index);
+	RemoveAt(m_LastFootStep, index);
+	RemoveAt(m_TargetState, index);
+	RemoveAt(m_Flags, index);
+	RemoveAt(m_Events, index);
+	RemoveAt(m_Animations, index);
+}
+
+// Takes every living zombie out of the game. Their instances still have to be removed from the scene by the owner.
+// Bodies of dead zombies are left alone, they expire on their own
+void ZombieCrowd::ExpireAll()
+{
+	for (auto& flags : m_Flags)
+	{
+		if ((flags & ZombieFlags::HasDied) == 0)
+		{
+			flags |= ZombieFlags::HasDied | ZombieFlags::IsExpired;
+		}
+	}
+
+	m_Grid.Clear();
+}
+
+void ZombieCrowd::Update(float frameTime, float time, const DirectX::XMFLOAT3& playerPosition, bool isPlaying)
+{
+	PROFILE_SCOPE("Zombie crowd");
+
+	fill(begin(m_Events), end(m_Events), static_cast<uint8_t>(ZombieEvents::NoEvents));
+
+	UpdateTargets(time, playerPosition, isPlaying);
+	UpdateMovement(frameTime, playerPosition);
+	UpdateAnimations(frameTime);
+	UpdateAttacks(time);
+}
+
+// Picks what every zombie wants to do this frame and turns it to face the player.
+// Zombies are decided on independently in parallel; the ones that wandered too far get taken off the grid afterwards
+void ZombieCrowd::UpdateTargets(float time, const DirectX::XMFLOAT3& playerPosition, bool isPlaying)
+{
+	auto count = m_IndexToId.size();
+
+	JobSystem::ParallelFor(count, kMinZombiesPerJob, [this, time, &playerPosition, isPlaying](size_t i)
+	{
+		auto flags = m_Flags[i];
+
+		if ((flags & ZombieFlags::IsAnimated) == 0 || (flags & ZombieFlags::IsExpired) != 0)
+		{
+			return;
+		}
+
+		if (flags & ZombieFlags::HasDied)
+		{
+			m_TargetState[i] = ZombieStates::Death;
+
+			if (time - m_DeathTime[i] > kZombieBodyLastingTime)
+			{
+				m_Flags[i] |= ZombieFlags::IsExpired;
+				m_Events[i] |= ZombieEvents::Expired;
+			}
+
+			return;
+		}
+
+		if (!isPlaying)
+		{
+			m_TargetState[i] = ZombieStates::Idle;
+		}
+		else
+		{
+			auto deltaX = playerPosition.x - m_PositionX[i];
+			auto deltaZ = playerPosition.z - m_PositionZ[i];
+			auto distanceToPlayerSqr = deltaX * deltaX + deltaZ * deltaZ;
+			m_DistanceToPlayerSqr[i] = distanceToPlayerSqr;
+
+			if (distanceToPlayerSqr > kDespawnDistanceSqr)
+			{
+				m_Flags[i] |= ZombieFlags::HasDied | ZombieFlags::IsExpired | ZombieFlags::IsDespawning;
+				m_Events[i] |= ZombieEvents::Expired;
+				return;
+			}
+			else if (distanceToPlayerSqr > 1.5f)
+			{
+				m_TargetState[i] = ZombieStates::Running;
+			}
+			else
+			{
+				m_TargetState[i] = ZombieStates::Hitting;
+
+				if (time - m_LastMadeNearPlayerSound[i] >= kNearPlayerSoundInterval)
+				{
+					m_LastMadeNearPlayerSound[i] = time;
+					m_Events[i] |= ZombieEvents::MadeNearPlayerSound;
+				}
+			}
+		}
+
+		m_RotationY[i] = -atan2(m_PositionZ[i] - playerPosition.z, m_PositionX[i] - playerPosition.x) - DirectX::XM_PI / 2.0f;
+	});
+
+	for (auto i = 0u; i < count; i++)
+	{
+		if (m_Flags[i] & ZombieFlags::IsDespawning)
+		{
+			m_Grid.Remove(m_IndexToId[i], GetPositionAt(i));
+			m_Flags[i] &= ~ZombieFlags::IsDespawning;
+		}
+	}
+}
+
+// Zombies that want to run move towards the player unless another zombie is in the way.
+// This has to stay serial, as every move is checked against the positions of zombies that moved before it
+void ZombieCrowd::UpdateMovement(float frameTime, const DirectX::XMFLOAT3& playerPosition)
+{
+	auto count = m_IndexToId.size();
+
+	for (auto i = 0u; i < count; i++)
+	{
+		if (m_TargetState[i] != ZombieStates::Running || (m_Flags[i] & ZombieFlags::HasDied) != 0)
+		{
+			continue;
+		}
+
+		DirectX::XMFLOAT2 oldPosition(m_PositionX[i], m_PositionZ[i]);
+		auto vectorMultiplier = m_Speed[i] * frameTime / sqrt(m_DistanceToPlayerSqr[i]);
+
+		DirectX::XMFLOAT2 newPosition(oldPosition.x + vectorMultiplier * (playerPosition.x - oldPosition.x), 
+			oldPosition.y + vectorMultiplier * (playerPosition.z - oldPosition.y));
+
+		if (m_Grid.IsFree(newPosition, m_IndexToId[i]))
+		{
+			m_Grid.Move(m_IndexToId[i], oldPosition, newPosition);
+			m_PositionX[i] = newPosition.x;
+			m_PositionZ[i] = newPosition.y;
+		}
+		else
+		{
+			m_TargetState[i] = ZombieStates::Idle;
+		}
+	}
+}
+
+void ZombieCrowd::UpdateAnimations(float frameTime)
+{
+	JobSystem::ParallelFor(m_IndexToId.size(), kMinZombiesPerJob, [this, frameTime](size_t i)
+	{
+		if ((m_Flags[i] & ZombieFlags::IsAnimated) != 0 && (m_Flags[i] & ZombieFlags::IsExpired) == 0)
+		{
+			m_Animations[i].Update(frameTime, static_cast<ZombieStates>(m_TargetState[i]));
+		}
+	});
+}
+
+// Which zombies hit the player or step is decided in parallel. The damage is added up serially afterwards,
+// so that the random number generator is only touched from this thread and in the same order every frame
+void ZombieCrowd::UpdateAttacks(float time)
+{
+	auto count = m_IndexToId.size();
+
+	JobSystem::ParallelFor(count, kMinZombiesPerJob, [this, time](size_t i)
+	{
+		if ((m_Flags[i] & ZombieFlags::IsAnimated) == 0 || (m_Flags[i] & ZombieFlags::IsExpired) != 0)
+		{
+			return;
+		}
+
+		const auto& animation = m_Animations[i];
+
+		if (animation.IsTransitioningAnimationStates())
+		{
+			return;
+		}
+
+		auto animationState = animation.GetCurrentAnimationState();
+
+		if (animationState == ZombieStates::Hitting &&
+			animation.GetCurrentStateAnimationProgress() > 0.1f &&
+			animation.GetCurrentStateAnimationProgress() < 0.2f &&
+			time - m_LastHitPlayerAt[i] >= kZombieHitInterval)
+		{
+			m_LastHitPlayerAt[i] = time;
+			m_Events[i] |= ZombieEvents::HitPlayer;
+		}
+		else if (animationState == ZombieStates::Running &&
+				 time - m_LastFootStep[i] >= kFootStepInterval &&
+				 m_DistanceToPlayerSqr[i] < 100.0f)
+		{
+			m_LastFootStep[i] = time;
+			m_Events[i] |= ZombieEvents::MadeFootStep;
+		}
+	});
+
+	auto& random = Tools::Random::GetGenerator(Tools::Random::Stream::Damage);
+
+	for (auto i = 0u; i < count; i++)
+	{
+		if (m_Events[i] & ZombieEvents::HitPlayer)
+		{
+			m_DamageToPlayer += random.NextReal(0.03f, 0.1f);
+		}
+	}
+}
+
+// Returns damage zombies dealt to the player since the last call
+float ZombieCrowd::ConsumeDamageToPlayer()
+{
+	auto damage = m_DamageToPlayer;
+	m_DamageToPlayer = 0.0f;
+
+	return damage;
+}
+
+// Returns whether the zombie is dead after taking damage
+bool ZombieCrowd::TakeDamage(unsigned int id, float damage, float time)
+{
+	auto index = GetIndex(id);
+
+	if (m_Flags[index] & ZombieFlags::HasDied)
+	{
+		return true;
+	}
+
+	m_Health[index] -= damage;
+
+	if (m_Health[index] <= 0.0f)
+	{
+		m_Grid.Remove(id, GetPositionAt(index));
+		m_DeathTime[index] = time;
+		m_Flags[index] |= ZombieFlags::HasDied;
+	}
+
+	return (m_Flags[index] & ZombieFlags::HasDied) != 0;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "AnimationStateMachine.h"
+#include "Tools.h"
+#include "ZombieGrid.h"
+
+// Simulation state of every zombie, stored as structure of arrays so the per frame update walks contiguous memory.
+// It doesn't touch Direct3D or audio: zombie instances only keep an id into the crowd,
+// copy their transform from it and react to the events it raises. Phases that only touch each zombie on its own run in parallel.
+class ZombieCrowd
+{
+public:
+	enum ZombieStates
+	{
+		Idle = 0,
+		Running,
+		Hitting,
+		Death,
+		StateCount
+	};
+
+	enum ZombieEvents
+	{
+		NoEvents = 0,
+		MadeNearPlayerSound = 1 << 0,
+		MadeFootStep = 1 << 1,
+		HitPlayer = 1 << 2,
+		Expired = 1 << 3
+	};
+
+	static const unsigned int kNoZombie;
+	static const float kAnimationPeriods[ZombieStates::StateCount];
+	static const bool kDoesAnimationLoop[ZombieStates::StateCount];
+	static const float kAnimationTransitionLength;
+	static const float kZombieSpeed;
+
+	typedef AnimationStateMachine<ZombieStates, ZombieStates::StateCount, kAnimationPeriods, kDoesAnimationLoop, kAnimationTransitionLength> ZombieAnimation;
+
+private:
+	enum ZombieFlags
+	{
+		HasDied = 1 << 0,
+		IsAnimated = 1 << 1,
+		IsExpired = 1 << 2,
+		IsDespawning = 1 << 3		// Has to be taken off the grid by the serial part of the update
+	};
+
+	vector<float> m_PositionX;
+	vector<float> m_PositionZ;
+	vector<float> m_RotationY;
+	vector<float> m_Speed;
+	vector<float> m_Health;
+	vector<float> m_DeathTime;
+	vector<float> m_DistanceToPlayerSqr;
+	vector<float> m_LastHitPlayerAt;
+	vector<float> m_LastMadeNearPlayerSound;
+	vector<float> m_LastFootStep;
+	vector<uint8_t> m_TargetState;
+	vector<uint8_t> m_Flags;
+	vector<uint8_t> m_Events;
+	vector<ZombieAnimation> m_Animations;
+
+	// Random animation progress drawn ahead for zombies about to be added, consumed in order
+	vector<float> m_SpawnAnimationProgress;
+	size_t m_NextSpawnAnimationProgress;
+
+	vector<unsigned int> m_IndexToId;
+	vector<unsigned int> m_IdToIndex;
+	vector<unsigned int> m_FreeIds;
+
+	ZombieGrid m_Grid;
+	float m_DamageToPlayer;
+
+	void UpdateTargets(float time, const DirectX::XMFLOAT3& playerPosition, bool isPlaying);
+	void UpdateMovement(float frameTime, const DirectX::XMFLOAT3& playerPosition);
+	void UpdateAnimations(float frameTime);
+	void UpdateAttacks(float time);
+
+	inline unsigned int GetIndex(unsigned int id) const { Assert(id < m_IdToIndex.size() && m_IdToIndex[id] != kNoZombie); return m_IdToIndex[id]; }
+	inline DirectX::XMFLOAT2 GetPositionAt(unsigned int index) const { return DirectX::XMFLOAT2(m_PositionX[index], m_PositionZ[index]); }
+
+	ZombieCrowd(const ZombieCrowd& other);				// Not implemented (no copying allowed)
+	ZombieCrowd& operator=(const ZombieCrowd& other);	// Not implemented (no copying allowed)
+
+public:
+	ZombieCrowd();
+	~ZombieCrowd();
+
+	void PrepareToAdd(size_t count);
+	unsigned int Add(const DirectX::XMFLOAT2& position, float rotationY, float speed, bool isAnimated, float time);
+	void Remove(unsigned int id);
+	void ExpireAll();
+
+	void Update(float frameTime, float time, const DirectX::XMFLOAT3& playerPosition, bool isPlaying);
+	float ConsumeDamageToPlayer();
+
+	bool TakeDamage(unsigned int id, float damage, float time);
+	inline bool CanMoveTo(const DirectX::XMFLOAT2& position, unsigned int id) const { return m_Grid.IsFree(position, id); }
+
+	inline size_t GetCount() const { return m_IndexToId.size(); }
+	inline bool IsDead(unsigned int id) const { return (m_Flags[GetIndex(id)] & ZombieFlags::HasDied) != 0; }
+	inline DirectX::XMFLOAT2 GetPosition(unsigned int id) const { return GetPositionAt(GetIndex(id)); }
+	inline float GetRotationY(unsigned int id) const { return m_RotationY[GetIndex(id)]; }
+	inline unsigned int GetEvents(unsigned int id) const { return m_Events[GetIndex(id)]; }
+	inline const ZombieAnimation& GetAnimation(unsigned int id) const { return m_Animations[GetIndex(id)]; }
+};
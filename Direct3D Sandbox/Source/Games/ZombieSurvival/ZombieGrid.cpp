@@ -0,0 +1,103 @@
+#include "PrecompiledHeader.h"
+#include "Tools.h"
+#include "ZombieGrid.h"
+
+// Zombies can't come closer to each other than this
+const float ZombieGrid::kCellSize = 1.0f;
+
+ZombieGrid::ZombieGrid() :
+	m_Buckets(kBucketCount),
+	m_Count(0)
+{
+	for (auto& bucket : m_Buckets)
+	{
+		bucket.reserve(kBucketCapacity);
+	}
+}
+
+ZombieGrid::~ZombieGrid()
+{
+}
+
+ZombieGrid::Bucket::iterator ZombieGrid::Find(Bucket& bucket, unsigned int id)
+{
+	return find_if(begin(bucket), end(bucket), [id](const Entry& entry) { return entry.id == id; });
+}
+
+void ZombieGrid::Add(unsigned int id, const DirectX::XMFLOAT2& position)
+{
+	m_Buckets[GetBucket(position)].emplace_back(id, position.x, position.y);
+	m_Count++;
+}
+
+void ZombieGrid::Remove(unsigned int id, const DirectX::XMFLOAT2& position)
+{
+	auto& bucket = m_Buckets[GetBucket(position)];
+	auto entry = Find(bucket, id);
+	Assert(entry != end(bucket));
+
+	*entry = bucket.back();
+	bucket.pop_back();
+	m_Count--;
+}
+
+void ZombieGrid::Move(unsigned int id, const DirectX::XMFLOAT2& oldPosition, const DirectX::XMFLOAT2& newPosition)
+{
+	auto oldIndex = GetBucket(oldPosition);
+	auto newIndex = GetBucket(newPosition);
+	auto& oldBucket = m_Buckets[oldIndex];
+	auto entry = Find(oldBucket, id);
+	Assert(entry != end(oldBucket));
+
+	if (oldIndex == newIndex)
+	{
+		entry->x = newPosition.x;
+		entry->z = newPosition.y;
+		return;
+	}
+
+	*entry = oldBucket.back();
+	oldBucket.pop_back();
+
+	m_Buckets[newIndex].emplace_back(id, newPosition.x, newPosition.y);
+}
+
+void ZombieGrid::Clear()
+{
+	// Keep the bucket vectors around, so that the next game doesn't have to reallocate them
+	for (auto& bucket : m_Buckets)
+	{
+		bucket.clear();
+	}
+
+	m_Count = 0;
+}
+
+bool ZombieGrid::IsFree(const DirectX::XMFLOAT2& position, unsigned int ignoredId) const
+{
+	const auto minDistanceSqr = kCellSize * kCellSize;
+	auto cellX = GetCellCoordinate(position.x);
+	auto cellZ = GetCellCoordinate(position.y);
+
+	for (int x = cellX - 1; x <= cellX + 1; x++)
+	{
+		for (int z = cellZ - 1; z <= cellZ + 1; z++)
+		{
+			for (const auto& entry : m_Buckets[GetBucket(x, z)])
+			{
+				if (entry.id != ignoredId)
+				{
+					auto deltaX = position.x - entry.x;
+					auto deltaZ = position.y - entry.z;
+
+					if (deltaX * deltaX + deltaZ * deltaZ < minDistanceSqr)
+					{
+						return false;
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
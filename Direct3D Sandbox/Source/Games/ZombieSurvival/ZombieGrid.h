@@ -0,0 +1,49 @@
+#pragma once
+
+// Uniform grid over the XZ plane, hashed by cell coordinates.
+// Cells are as big as the distance zombies keep from each other,
+// so collision queries only have to look at the 3x3 block of cells around the queried position.
+// Cells hash into a fixed number of buckets that are allocated up front, so zombies walking or spawning into cells
+// nobody has been in before don't allocate. Cells sharing a bucket only cost a few extra distance checks, as entries keep their positions
+class ZombieGrid
+{
+private:
+	struct Entry
+	{
+		unsigned int id;
+		float x, z;
+
+		Entry(unsigned int id, float x, float z) : id(id), x(x), z(z) {}
+	};
+
+	typedef vector<Entry> Bucket;
+
+	static const size_t kBucketCount = 4096;		// Power of two, several times the most zombies a game has
+	static const size_t kBucketCapacity = 4;		// As many zombies as fit in a cell while keeping their distance
+
+	vector<Bucket> m_Buckets;
+	size_t m_Count;
+
+	static inline int GetCellCoordinate(float value) { return static_cast<int>(floor(value / kCellSize)); }
+	static inline size_t GetBucket(int cellX, int cellZ) { return ((static_cast<unsigned int>(cellX) * 73856093u) ^ (static_cast<unsigned int>(cellZ) * 19349663u)) & (kBucketCount - 1); }
+	static inline size_t GetBucket(const DirectX::XMFLOAT2& position) { return GetBucket(GetCellCoordinate(position.x), GetCellCoordinate(position.y)); }
+
+	Bucket::iterator Find(Bucket& bucket, unsigned int id);
+
+	ZombieGrid(const ZombieGrid& other);				// Not implemented (no copying allowed)
+	ZombieGrid& operator=(const ZombieGrid& other);		// Not implemented (no copying allowed)
+
+public:
+	static const float kCellSize;
+
+	ZombieGrid();
+	~ZombieGrid();
+
+	void Add(unsigned int id, const DirectX::XMFLOAT2& position);
+	void Remove(unsigned int id, const DirectX::XMFLOAT2& position);
+	void Move(unsigned int id, const DirectX::XMFLOAT2& oldPosition, const DirectX::XMFLOAT2& newPosition);
+	void Clear();
+
+	bool IsFree(const DirectX::XMFLOAT2& position, unsigned int ignoredId) const;
+	inline size_t GetCount() const { return m_Count; }
+};
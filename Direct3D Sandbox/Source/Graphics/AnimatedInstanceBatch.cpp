@@ -0,0 +1,64 @@
+#include "PrecompiledHeader.h"
+#include "AnimatedInstanceBatch.h"
+#include "Tools.h"
+
+// Sort keys give frames 20 bits each and materials the 24 bits above them
+const unsigned int AnimatedInstanceBatch::kMaxFrameCount = 1 << 20;
+const unsigned int AnimatedInstanceBatch::kMaxMaterialCount = 1 << 24;
+
+AnimatedInstanceBatch::AnimatedInstanceBatch()
+{
+}
+
+AnimatedInstanceBatch::~AnimatedInstanceBatch()
+{
+}
+
+void AnimatedInstanceBatch::Add(unsigned int material, unsigned int currentFrame, unsigned int nextFrame, const AnimatedInstanceData& instance)
+{
+	Assert(material < kMaxMaterialCount);
+	Assert(currentFrame < kMaxFrameCount && nextFrame < kMaxFrameCount);
+
+	m_SortKeys.emplace_back(GetSortKey(material, currentFrame, nextFrame), static_cast<unsigned int>(m_Instances.size()));
+	m_Instances.push_back(instance);
+}
+
+// Instances within a bucket keep the order they were added in, so the same scene always packs the same way
+void AnimatedInstanceBatch::Build()
+{
+	sort(begin(m_SortKeys), end(m_SortKeys));
+
+	m_PackedInstances.resize(m_Instances.size());
+	m_Buckets.clear();
+
+	for (auto i = 0u; i < m_SortKeys.size(); i++)
+	{
+		auto key = m_SortKeys[i].first;
+		m_PackedInstances[i] = m_Instances[m_SortKeys[i].second];
+
+		if (i > 0 && key == m_SortKeys[i - 1].first)
+		{
+			m_Buckets.back().instanceCount++;
+			continue;
+		}
+
+		AnimatedInstanceBucket bucket;
+
+		bucket.material = static_cast<unsigned int>(key >> 40);
+		bucket.currentFrame = static_cast<unsigned int>(key >> 20) & (kMaxFrameCount - 1);
+		bucket.nextFrame = static_cast<unsigned int>(key) & (kMaxFrameCount - 1);
+		bucket.firstInstance = i;
+		bucket.instanceCount = 1;
+
+		m_Buckets.push_back(bucket);
+	}
+}
+
+// Keeps the memory around, as the next frame is going to draw about as many instances
+void AnimatedInstanceBatch::Clear()
+{
+	m_Instances.clear();
+	m_SortKeys.clear();
+	m_PackedInstances.clear();
+	m_Buckets.clear();
+}
\ No newline at end of file
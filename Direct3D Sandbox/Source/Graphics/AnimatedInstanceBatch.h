@@ -0,0 +1,55 @@
+#pragma once
+
+// Per instance vertex data of the instanced animation shader. Members have to match its INSTANCE inputs in order and size
+struct AnimatedInstanceData
+{
+	DirectX::XMFLOAT4 world[3];			// First three rows of the world matrix, as it is stored in render parameters
+	DirectX::XMFLOAT3 normal[3];		// First three rows of the inversed transposed world matrix, without w
+	float frameProgress;
+};
+
+// Instances that share a material and blend between the same two frames, laid out next to each other in the packed instances
+struct AnimatedInstanceBucket
+{
+	unsigned int material;
+	unsigned int currentFrame;
+	unsigned int nextFrame;
+	unsigned int firstInstance;
+	unsigned int instanceCount;
+};
+
+// Collects the instances of an animated model that get drawn during a frame and groups them by material and frame pair,
+// so that every group costs a single instanced draw call. Building the batch packs instances of the same group next to each other,
+// ready to be copied into an instance buffer as is. Doesn't touch Direct3D
+class AnimatedInstanceBatch
+{
+private:
+	vector<AnimatedInstanceData> m_Instances;
+	vector<pair<uint64_t, unsigned int>> m_SortKeys;
+	vector<AnimatedInstanceData> m_PackedInstances;
+	vector<AnimatedInstanceBucket> m_Buckets;
+
+	static inline uint64_t GetSortKey(unsigned int material, unsigned int currentFrame, unsigned int nextFrame)
+	{
+		return (static_cast<uint64_t>(material) << 40) | (static_cast<uint64_t>(currentFrame) << 20) | nextFrame;
+	}
+
+	AnimatedInstanceBatch(const AnimatedInstanceBatch& other);				// Not implemented (no copying allowed)
+	AnimatedInstanceBatch& operator=(const AnimatedInstanceBatch& other);	// Not implemented (no copying allowed)
+
+public:
+	static const unsigned int kMaxFrameCount;
+	static const unsigned int kMaxMaterialCount;
+
+	AnimatedInstanceBatch();
+	~AnimatedInstanceBatch();
+
+	void Add(unsigned int material, unsigned int currentFrame, unsigned int nextFrame, const AnimatedInstanceData& instance);
+	void Build();
+	void Clear();
+
+	inline bool IsEmpty() const { return m_Instances.empty(); }
+	inline size_t GetInstanceCount() const { return m_Instances.size(); }
+	inline const vector<AnimatedInstanceData>& GetPackedInstances() const { return m_PackedInstances; }
+	inline const vector<AnimatedInstanceBucket>& GetBuckets() const { return m_Buckets; }
+};
\ No newline at end of file
@@ -3,12 +3,17 @@
 #include "Direct3D.h"
 #include "IShader.h"
 
+vector<AnimatedModel*> AnimatedModel::s_ModelsWithQueuedInstances;
+const unsigned int AnimatedModel::kInstanceSlot = 3;
+
 AnimatedModel::AnimatedModel(IShader& shader, const wstring& modelPath) :
 	IModel(shader
 #if DEBUG
 	, modelPath
 #endif
-	)
+	),
+	m_InstancedShader(shader.GetInstancedVariant()),
+	m_InstanceBufferCapacity(0)
 {
 	auto& modelData = GetModelData(modelPath);
 	Assert(modelData.modelType == ModelType::Animated);
@@ -17,7 +22,9 @@ AnimatedModel::AnimatedModel(IShader& shader, const wstring& modelPath) :
 }
 
 AnimatedModel::AnimatedModel(AnimatedModel&& other) :
-	IModel(std::move(other))
+	IModel(std::move(other)),
+	m_InstancedShader(other.m_InstancedShader),
+	m_InstanceBufferCapacity(0)
 {
 }
 
@@ -27,18 +34,32 @@ AnimatedModel::~AnimatedModel()
 
 void AnimatedModel::CreateBuffers(const AnimatedModelData& modelData)
 {
-	m_TotalFrameCount = static_cast<unsigned int>(modelData.totalFrameCount);
+	auto totalFrameCount = static_cast<unsigned int>(modelData.totalFrameCount);
 	m_VertexCount = static_cast<unsigned int>(modelData.vertexCount);
 	
-	for (auto i = 0u; i < m_TotalFrameCount; i++)
+	// Both frame slots have to be laid out the same way to share the buffer
+	Assert(m_Shader.GetInputLayoutStrides()[0] == m_Shader.GetInputLayoutStrides()[1]);
+	auto frameByteSize = m_VertexCount * m_Shader.GetInputLayoutStrides()[0];
+
+	// The instanced shader reads the same vertex buffers, followed by instance data laid out as AnimatedInstanceData
+	if (m_InstancedShader != nullptr)
 	{
-		m_FromFrameVertexBuffers.push_back(m_Shader.CreateVertexBuffer(m_VertexCount, modelData.vertices.get() + m_VertexCount * i, 0));
-		m_ToFrameVertexBuffers.push_back(m_Shader.CreateVertexBuffer(m_VertexCount, modelData.vertices.get() + m_VertexCount * i, 1));
+		for (auto i = 0u; i < kInstanceSlot; i++)
+		{
+			Assert(m_Shader.GetInputLayoutStrides()[i] == m_InstancedShader->GetInputLayoutStrides()[i]);
+		}
+
+		Assert(m_InstancedShader->GetInputLayoutStrides()[kInstanceSlot] == sizeof(AnimatedInstanceData));
 	}
 
+	// Model data stores frames one after another, so packing all of them as one long run of vertices keeps every frame contiguous
+	m_FrameVertexBuffer = m_Shader.CreateVertexBuffer(m_VertexCount * totalFrameCount, modelData.GetVertices(), 0);
+	m_StaticVertexBuffer = m_Shader.CreateVertexBuffer(m_VertexCount, modelData.GetVertices(), 2);
+
 	m_StateCount = static_cast<unsigned int>(modelData.stateCount);
 	m_StateData = unique_ptr<AnimatedModelState[]>(new AnimatedModelState[modelData.stateCount]);
 	memcpy(m_StateData.get(), modelData.stateData.get(), m_StateCount * sizeof(AnimatedModelState));
+	m_FrameLayout = AnimationFrameLayout(m_StateData.get(), totalFrameCount, frameByteSize);
 
 	InitializeIndexBuffer(modelData);
 }
@@ -47,51 +68,195 @@ void AnimatedModel::SetRenderParametersAndApplyBuffers(RenderParameters& renderP
 {
 	static int s_LastFrameSet = -1;
 	int currentFrame, nextFrame;
+	bool shouldSetVertexBuffer;
 
-	Assert(renderParameters.currentStateAnimationProgress >= 0.0f && renderParameters.currentStateAnimationProgress <= 1.0f);
-	
-	bool shouldSetVertexBuffer = false;
-	
-	auto currentFrameFloat = renderParameters.currentStateAnimationProgress * m_StateData[renderParameters.currentAnimationState].frameCount;
-	currentFrame = static_cast<int>(currentFrameFloat);
+	m_FrameLayout.GetFrames(renderParameters, currentFrame, nextFrame);
 
 	if (!renderParameters.isTransitioningAnimationStates)
-	{	
-		nextFrame = (currentFrame + 1) % m_StateData[renderParameters.currentAnimationState].frameCount;
-	
-		renderParameters.currentFrameProgress = currentFrameFloat - currentFrame;
-		currentFrame += static_cast<int>(m_StateData[renderParameters.currentAnimationState].frameOffset);
-		nextFrame += static_cast<int>(m_StateData[renderParameters.currentAnimationState].frameOffset);
-
+	{
 		shouldSetVertexBuffer = !DidThisLastSet() || s_LastFrameSet != currentFrame;		
 		s_LastFrameSet = currentFrame;
 	}
 	else
 	{
-		auto targetFrameFloat = renderParameters.targetStateAnimationProgress * m_StateData[renderParameters.targetAnimationState].frameCount;
-		nextFrame = static_cast<int>(targetFrameFloat);
-		
-		renderParameters.currentFrameProgress = renderParameters.transitionProgress;
-		currentFrame += static_cast<int>(m_StateData[renderParameters.currentAnimationState].frameOffset);
-		nextFrame += static_cast<int>(m_StateData[renderParameters.targetAnimationState].frameOffset);		
-
 		shouldSetVertexBuffer = true;
 		s_LastFrameSet = -1;
 	}
 
 	if (shouldSetVertexBuffer)
 	{
-		const UINT offsets[] = { 0u, 0u };
+		const UINT offsets[] = { m_FrameLayout.GetFrameByteOffset(currentFrame), m_FrameLayout.GetFrameByteOffset(nextFrame), 0u };
 		auto deviceContext = GetD3D11DeviceContext();
 
 		ID3D11Buffer* buffers[] = 
 		{
-			m_FromFrameVertexBuffers[currentFrame].Get(),
-			m_ToFrameVertexBuffers[nextFrame].Get()
+			m_FrameVertexBuffer.Get(),
+			m_FrameVertexBuffer.Get(),
+			m_StaticVertexBuffer.Get()
 		};
 
-		deviceContext->IASetVertexBuffers(0, 2, buffers, m_Shader.GetInputLayoutStrides(), offsets);
+		deviceContext->IASetVertexBuffers(0, 3, buffers, m_Shader.GetInputLayoutStrides(), offsets);
 	}
 	
 	SetIndexBufferToDeviceContext();
+}
+
+// Queued instances get their constants when they're drawn, but the frames have to be worked out for the parameters to end up as Render leaves them
+void AnimatedModel::StageRenderParameters(RenderParameters& renderParameters)
+{
+	int currentFrame, nextFrame;
+	m_FrameLayout.GetFrames(renderParameters, currentFrame, nextFrame);
+
+	if (m_InstancedShader == nullptr)
+	{
+		m_Shader.StageRenderParameters(renderParameters);
+	}
+}
+
+void AnimatedModel::Render(RenderParameters& renderParameters)
+{
+	if (m_InstancedShader != nullptr)
+	{
+		QueueInstance(renderParameters);
+	}
+	else
+	{
+		IModel::Render(renderParameters);
+	}
+}
+
+// Instances that look the same apart from their transform and animation share a material
+unsigned int AnimatedModel::GetInstanceMaterial(const RenderParameters& renderParameters)
+{
+	const auto& color = renderParameters.color;
+
+	for (auto i = 0u; i < m_InstanceMaterials.size(); i++)
+	{
+		const auto& material = m_InstanceMaterials[i];
+
+		if (material.texture == renderParameters.texture && material.normalMap == renderParameters.normalMap &&
+			material.color.x == color.x && material.color.y == color.y && material.color.z == color.z && material.color.w == color.w)
+		{
+			return i;
+		}
+	}
+
+	InstanceMaterial material;
+	material.texture = renderParameters.texture;
+	material.normalMap = renderParameters.normalMap;
+	material.color = color;
+
+	m_InstanceMaterials.push_back(material);
+	return static_cast<unsigned int>(m_InstanceMaterials.size() - 1);
+}
+
+void AnimatedModel::QueueInstance(RenderParameters& renderParameters)
+{
+	int currentFrame, nextFrame;
+	AnimatedInstanceData instance;
+
+	m_FrameLayout.GetFrames(renderParameters, currentFrame, nextFrame);
+
+	for (int i = 0; i < 3; i++)
+	{
+		DirectX::XMStoreFloat4(&instance.world[i], renderParameters.worldMatrix.r[i]);
+		DirectX::XMStoreFloat3(&instance.normal[i], renderParameters.inversedTransposedWorldMatrix.r[i]);
+	}
+
+	instance.frameProgress = renderParameters.currentFrameProgress;
+
+	if (m_InstanceBatch.IsEmpty())
+	{
+		s_ModelsWithQueuedInstances.push_back(this);
+	}
+
+	m_InstanceBatch.Add(GetInstanceMaterial(renderParameters), currentFrame, nextFrame, instance);
+}
+
+// All instances of the frame go into the instance buffer with a single discarding map
+void AnimatedModel::UploadQueuedInstances()
+{
+	HRESULT result;
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	auto deviceContext = GetD3D11DeviceContext();
+	const auto& instances = m_InstanceBatch.GetPackedInstances();
+	auto instanceCount = static_cast<unsigned int>(instances.size());
+
+	if (instanceCount > m_InstanceBufferCapacity)
+	{
+		m_InstanceBufferCapacity = max(instanceCount, 2 * m_InstanceBufferCapacity);
+		m_InstanceBuffer = m_InstancedShader->CreateVertexBuffer(m_InstanceBufferCapacity, kInstanceSlot, D3D11_USAGE_DYNAMIC);
+	}
+
+	result = deviceContext->Map(m_InstanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	Assert(result == S_OK);
+
+	memcpy(mappedResource.pData, instances.data(), instanceCount * sizeof(AnimatedInstanceData));
+	deviceContext->Unmap(m_InstanceBuffer.Get(), 0);
+}
+
+void AnimatedModel::RenderQueuedInstances(RenderParameters& renderParameters)
+{
+	auto deviceContext = GetD3D11DeviceContext();
+	auto lastMaterial = 0xFFFFFFFF;
+
+	m_InstanceBatch.Build();
+	UploadQueuedInstances();
+	SetIndexBufferToDeviceContext(true);
+
+	for (const auto& bucket : m_InstanceBatch.GetBuckets())
+	{
+		if (bucket.material != lastMaterial)
+		{
+			const auto& material = m_InstanceMaterials[bucket.material];
+
+			renderParameters.texture = material.texture;
+			renderParameters.normalMap = material.normalMap;
+			renderParameters.color = material.color;
+			m_InstancedShader->SetRenderParameters(renderParameters);
+
+			lastMaterial = bucket.material;
+		}
+
+		const UINT offsets[] = 
+		{
+			m_FrameLayout.GetFrameByteOffset(bucket.currentFrame), 
+			m_FrameLayout.GetFrameByteOffset(bucket.nextFrame), 
+			0u, 
+			bucket.firstInstance * static_cast<UINT>(sizeof(AnimatedInstanceData))
+		};
+
+		ID3D11Buffer* buffers[] = 
+		{
+			m_FrameVertexBuffer.Get(),
+			m_FrameVertexBuffer.Get(),
+			m_StaticVertexBuffer.Get(),
+			m_InstanceBuffer.Get()
+		};
+
+		deviceContext->IASetVertexBuffers(0, 4, buffers, m_InstancedShader->GetInputLayoutStrides(), offsets);
+		deviceContext->DrawIndexedInstanced(m_IndexCount, bucket.instanceCount, 0, 0, 0);
+	}
+
+	m_InstanceBatch.Clear();
+	m_InstanceMaterials.clear();
+}
+
+// Draws everything animated models queued since the last call. Has to be called after all 3D models were rendered
+void AnimatedModel::RenderInstances(RenderParameters& renderParameters)
+{
+	if (s_ModelsWithQueuedInstances.empty())
+	{
+		return;
+	}
+
+	for (auto model : s_ModelsWithQueuedInstances)
+	{
+		model->RenderQueuedInstances(renderParameters);
+	}
+
+	s_ModelsWithQueuedInstances.clear();
+
+	// Vertex buffers bound here aren't what the non-instanced path of any model expects to find bound
+	IModel::InvalidateParameterSetter();
 }
\ No newline at end of file
@@ -1,22 +1,47 @@
 #pragma once
 
+#include "AnimatedInstanceBatch.h"
+#include "AnimationFrameLayout.h"
 #include "IModel.h"
 
+// With a shader that has an instanced variant, rendering only queues the instance. Queued instances get drawn
+// by RenderInstances, one instanced draw call for every group of instances sharing a material and a frame pair
 class AnimatedModel :
 	public IModel
 {
-	vector<ComPtr<ID3D11Buffer>> m_FromFrameVertexBuffers;
-	vector<ComPtr<ID3D11Buffer>> m_ToFrameVertexBuffers;
-	unsigned int m_TotalFrameCount;
+	struct InstanceMaterial
+	{
+		ID3D11ShaderResourceView* texture;
+		ID3D11ShaderResourceView* normalMap;
+		DirectX::XMFLOAT4 color;
+	};
+
+	ComPtr<ID3D11Buffer> m_FrameVertexBuffer;				// Every frame one after another, bound to the "from" and "to" slots at their offsets
+	ComPtr<ID3D11Buffer> m_StaticVertexBuffer;				// Vertex data shared by all frames
 
 	unsigned int m_StateCount;	
 	unique_ptr<AnimatedModelState[]> m_StateData;
+	AnimationFrameLayout m_FrameLayout;
+
+	IShader* m_InstancedShader;
+	ComPtr<ID3D11Buffer> m_InstanceBuffer;
+	unsigned int m_InstanceBufferCapacity;
+	AnimatedInstanceBatch m_InstanceBatch;
+	vector<InstanceMaterial> m_InstanceMaterials;
+
+	static vector<AnimatedModel*> s_ModelsWithQueuedInstances;
+	static const unsigned int kInstanceSlot;
 
 	AnimatedModel(IShader& shader, const wstring& modelPath);
 
 	void CreateBuffers(const AnimatedModelData& modelData);
 	virtual void SetRenderParametersAndApplyBuffers(RenderParameters& renderParameters);
 
+	unsigned int GetInstanceMaterial(const RenderParameters& renderParameters);
+	void QueueInstance(RenderParameters& renderParameters);
+	void UploadQueuedInstances();
+	void RenderQueuedInstances(RenderParameters& renderParameters);
+
 	AnimatedModel(const AnimatedModel& other);												// Not implemented (no copying allowed)
 	AnimatedModel& operator=(const AnimatedModel& other);									// Not implemented (no copying allowed)
 
@@ -25,4 +50,9 @@ class AnimatedModel :
 public:
 	AnimatedModel(AnimatedModel&& other);
 	virtual ~AnimatedModel();
+
+	virtual void StageRenderParameters(RenderParameters& renderParameters);
+	virtual void Render(RenderParameters& renderParameters);
+
+	static void RenderInstances(RenderParameters& renderParameters);
 };
\ No newline at end of file
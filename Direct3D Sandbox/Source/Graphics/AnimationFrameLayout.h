@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Parameters.h"
+#include "Tools.h"
+
+// Where the frames of an animated model are in its frame vertex buffer, which holds every frame of every animation state one after another.
+// Picks the two frames a model blends between and the offsets to bind them at. Doesn't own the state data
+class AnimationFrameLayout
+{
+private:
+	const AnimatedModelState* m_States;
+	unsigned int m_TotalFrameCount;
+	unsigned int m_FrameByteSize;
+
+public:
+	AnimationFrameLayout() : m_States(nullptr), m_TotalFrameCount(0), m_FrameByteSize(0) {}
+
+	AnimationFrameLayout(const AnimatedModelState states[], unsigned int totalFrameCount, unsigned int frameByteSize) :
+		m_States(states), m_TotalFrameCount(totalFrameCount), m_FrameByteSize(frameByteSize)
+	{
+	}
+
+	inline unsigned int GetFrameByteOffset(int frame) const 
+	{
+		Assert(frame >= 0 && static_cast<unsigned int>(frame) < m_TotalFrameCount);
+		return frame * m_FrameByteSize;
+	}
+
+	// Frames are counted from the start of the buffer. Also sets how far between them the model is
+	inline void GetFrames(RenderParameters& renderParameters, int& currentFrame, int& nextFrame) const
+	{
+		Assert(renderParameters.currentStateAnimationProgress >= 0.0f && renderParameters.currentStateAnimationProgress <= 1.0f);
+
+		const auto& currentState = m_States[renderParameters.currentAnimationState];
+		auto currentFrameFloat = renderParameters.currentStateAnimationProgress * currentState.frameCount;
+		currentFrame = static_cast<int>(currentFrameFloat);
+
+		if (!renderParameters.isTransitioningAnimationStates)
+		{
+			nextFrame = (currentFrame + 1) % currentState.frameCount;
+
+			renderParameters.currentFrameProgress = currentFrameFloat - currentFrame;
+			currentFrame += static_cast<int>(currentState.frameOffset);
+			nextFrame += static_cast<int>(currentState.frameOffset);
+		}
+		else
+		{
+			const auto& targetState = m_States[renderParameters.targetAnimationState];
+			nextFrame = static_cast<int>(renderParameters.targetStateAnimationProgress * targetState.frameCount);
+
+			renderParameters.currentFrameProgress = renderParameters.transitionProgress;
+			currentFrame += static_cast<int>(currentState.frameOffset);
+			nextFrame += static_cast<int>(targetState.frameOffset);
+		}
+	}
+};
\ No newline at end of file
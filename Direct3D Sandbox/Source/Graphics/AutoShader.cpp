@@ -1,9 +1,13 @@
 #include "PrecompiledHeader.h"
 #include "AutoShader.h"
+#include "ConstantRingBuffer.h"
+#include "Profiler.h"
 #include "Tools.h"
 
 AutoShader::AutoShader(wstring vertexShaderPath, wstring pixelShaderPath) :
-	m_VertexShader(vertexShaderPath), m_PixelShader(pixelShaderPath)
+	m_VertexShader(vertexShaderPath), m_PixelShader(pixelShaderPath),
+	m_ConstantRingSize(m_VertexShader.GetConstantRingSize() + m_PixelShader.GetConstantRingSize()),
+	m_StagedBatchIndex(0)
 {
 }
 
@@ -28,8 +32,66 @@ void AutoShader::UploadVertexData(ID3D11Buffer* vertexBuffer, unsigned int verte
 	m_VertexShader.UploadVertexData(vertexBuffer, vertexCount, vertices, semanticIndex);
 }
 
+// Constants of both stages get staged before any of them is written, and written with a single map
+void AutoShader::UploadConstantBuffers(const RenderParameters& renderParameters)
+{
+	auto ringSize = m_VertexShader.StageConstantBuffers(renderParameters) + m_PixelShader.StageConstantBuffers(renderParameters);
+
+	if (ringSize > 0)
+	{
+		unsigned int firstConstant;
+		auto destination = ConstantRingBuffer::Map(ringSize, firstConstant);
+
+		m_VertexShader.UploadConstantBuffers(destination, firstConstant);
+		m_PixelShader.UploadConstantBuffers(destination, firstConstant);
+
+		ConstantRingBuffer::Unmap();
+	}
+}
+
+// Draws whose constants were staged ahead only bind them. Otherwise room for all constants is reserved first,
+// as the ring buffer wrapping around in the middle would lose what this draw already wrote
 void AutoShader::SetRenderParameters(const RenderParameters& renderParameters)
 {
+	PROFILE_SCOPE("Shader parameters");
+
+	if (m_VertexShader.HasStagedDraws())
+	{
+		m_VertexShader.RestoreNextStagedDraw();
+		m_PixelShader.RestoreNextStagedDraw();
+	}
+	else
+	{
+		if (ConstantRingBuffer::IsSupported())
+		{
+			ConstantRingBuffer::Reserve(m_ConstantRingSize);
+		}
+
+		UploadConstantBuffers(renderParameters);
+	}
+
 	m_VertexShader.SetRenderParameters(renderParameters);
 	m_PixelShader.SetRenderParameters(renderParameters);
+}
+
+// Has to be called between ConstantRingBuffer::BeginBatch and EndBatch, and then SetRenderParameters once for every call, in the same order.
+// Draws staged in an earlier batch that never got made are dropped, as their constants may be gone
+void AutoShader::StageRenderParameters(const RenderParameters& renderParameters)
+{
+	if (!ConstantRingBuffer::IsSupported())
+	{
+		return;
+	}
+
+	if (m_StagedBatchIndex != ConstantRingBuffer::GetBatchIndex())
+	{
+		m_VertexShader.ClearStagedDraws();
+		m_PixelShader.ClearStagedDraws();
+		m_StagedBatchIndex = ConstantRingBuffer::GetBatchIndex();
+	}
+
+	UploadConstantBuffers(renderParameters);
+
+	m_VertexShader.SaveStagedDraw();
+	m_PixelShader.SaveStagedDraw();
 }
\ No newline at end of file
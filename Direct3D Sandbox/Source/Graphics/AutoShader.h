@@ -9,6 +9,10 @@ class AutoShader : public IShader
 private:
 	VertexShader m_VertexShader;
 	PixelShader m_PixelShader;
+	unsigned int m_ConstantRingSize;
+	unsigned int m_StagedBatchIndex;
+
+	void UploadConstantBuffers(const RenderParameters& renderParameters);
 
 public:
 	AutoShader(wstring vertexShaderPath, wstring pixelShaderPath);
@@ -21,5 +25,7 @@ public:
 	virtual void UploadVertexData(ID3D11Buffer* vertexBuffer, unsigned int vertexCount, const VertexParameters vertices[], unsigned int semanticIndex) const;
 
 	virtual void SetRenderParameters(const RenderParameters& renderParameters);
+	virtual void StageRenderParameters(const RenderParameters& renderParameters);
+	virtual unsigned int GetConstantRingSize() const { return m_ConstantRingSize; }
 	virtual const unsigned int* GetInputLayoutStrides() const { return m_VertexShader.GetInputLayoutStrides(); }
 };
\ No newline at end of file
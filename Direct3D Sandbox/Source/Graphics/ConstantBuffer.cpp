@@ -1,11 +1,18 @@
 #include "PrecompiledHeader.h"
 #include "Direct3D.h"
 #include "ConstantBuffer.h"
+#include "ConstantRingBuffer.h"
 #include "Parameters.h"
 #include "Tools.h"
 
+ConstantBufferStatistics ConstantBuffer::s_Statistics;
+
 ConstantBuffer::ConstantBuffer(const vector<uint8_t>& metadataBuffer, unsigned int& byteOffset) :
-	m_Size(0)
+	m_Size(0),
+	m_IsImageUploaded(false),
+	m_NeedsRingUpload(false),
+	m_RingGeneration(0),
+	m_FirstConstant(0)
 {
 	using namespace Tools::BufferReader;
 
@@ -24,6 +31,29 @@ ConstantBuffer::ConstantBuffer(const vector<uint8_t>& metadataBuffer, unsigned i
 	
 	sort(begin(m_Fields), end(m_Fields));
 
+	// Merge fields that follow each other in both places, so they get compared as one
+	auto fieldCount = 0u;
+
+	for (auto i = 0u; i < m_Fields.size(); i++)
+	{
+		if (fieldCount == 0 || !m_Fields[fieldCount - 1].TryAppend(m_Fields[i]))
+		{
+			m_Fields[fieldCount++] = m_Fields[i];
+		}
+	}
+
+	m_Fields.erase(begin(m_Fields) + fieldCount, end(m_Fields));
+
+	m_Image.reset(static_cast<uint8_t*>(_aligned_malloc(m_Size, 16)));
+	Assert(m_Image != nullptr);
+	memset(m_Image.get(), 0, m_Size);
+
+	// With the ring buffer available, the buffer gets its constants from there instead
+	if (ConstantRingBuffer::IsSupported())
+	{
+		return;
+	}
+
 	HRESULT result;
 	D3D11_BUFFER_DESC constantBufferDescription;
 
@@ -41,7 +71,13 @@ ConstantBuffer::ConstantBuffer(const vector<uint8_t>& metadataBuffer, unsigned i
 ConstantBuffer::ConstantBuffer(ConstantBuffer&& other) :
 	m_Buffer(other.m_Buffer),
 	m_Fields(std::move(other.m_Fields)),
-	m_Size(other.m_Size)
+	m_Image(std::move(other.m_Image)),
+	m_Size(other.m_Size),
+	m_IsImageUploaded(other.m_IsImageUploaded),
+	m_NeedsRingUpload(other.m_NeedsRingUpload),
+	m_RingGeneration(other.m_RingGeneration),
+	m_FirstConstant(other.m_FirstConstant),
+	m_Statistics(other.m_Statistics)
 {
 	other.m_Buffer = nullptr;
 }
@@ -50,22 +86,38 @@ ConstantBuffer::~ConstantBuffer()
 {
 }
 
-void ConstantBuffer::SetRenderParameters(const RenderParameters& renderParameters)
+// Writes the render parameters that changed into the image. Without the ring buffer it uploads the image right away,
+// otherwise returns whether it has to go to the ring buffer, either because it changed or because the ring buffer wrapped around
+bool ConstantBuffer::StageRenderParameters(const RenderParameters& renderParameters)
 {
-	bool shouldCopyToGPU = false;
+	auto parameters = reinterpret_cast<const uint8_t*>(&renderParameters);
+	auto image = m_Image.get();
+	auto changedByteCount = 0u;
 
-	for_each (begin(m_Fields), end(m_Fields), [&shouldCopyToGPU, &renderParameters](ConstantBufferField& field)
+	for (const auto& field : m_Fields)
 	{
-		shouldCopyToGPU |= field.SetValueIfNeeded(reinterpret_cast<const uint8_t*>(&renderParameters) + field.GetParameterOffset());
-	});
+		changedByteCount += field.CopyChangedBlocks(parameters, image);
+	}
+
+	m_Statistics.stagedByteCount += changedByteCount;
+	s_Statistics.stagedByteCount += changedByteCount;
 
-	if (shouldCopyToGPU)
+	if (!ConstantRingBuffer::IsSupported())
 	{
-		SetRenderParametersNoCheck();
+		if (changedByteCount > 0 || !m_IsImageUploaded)
+		{
+			Upload();
+		}
+
+		return false;
 	}
+
+	m_NeedsRingUpload = changedByteCount > 0 || !m_IsImageUploaded || m_RingGeneration != ConstantRingBuffer::GetGeneration();
+	return m_NeedsRingUpload;
 }
 
-void ConstantBuffer::SetRenderParametersNoCheck()
+// Discarding leaves the whole buffer undefined, so the whole image has to go up, but it's a single contiguous copy
+void ConstantBuffer::Upload()
 {
 	HRESULT result;
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
@@ -74,10 +126,53 @@ void ConstantBuffer::SetRenderParametersNoCheck()
 	result = deviceContext->Map(m_Buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
 	Assert(result == S_OK);
 	
-	for_each (begin(m_Fields), end(m_Fields), [&mappedResource](ConstantBufferField& field)
-	{
-		memcpy(reinterpret_cast<uint8_t*>(mappedResource.pData) + field.GetByteOffset(), field.GetValue(), field.GetSize());
-	});
+	memcpy(mappedResource.pData, m_Image.get(), m_Size);
 
 	deviceContext->Unmap(m_Buffer.Get(), 0);
+	OnUploaded();
+}
+
+// Copies the image to the mapped part of the ring buffer and moves both arguments past it
+void ConstantBuffer::UploadToRing(uint8_t*& destination, unsigned int& firstConstant)
+{
+	Assert(m_NeedsRingUpload);
+
+	memcpy(destination, m_Image.get(), m_Size);
+
+	m_FirstConstant = firstConstant;
+	m_RingGeneration = ConstantRingBuffer::GetGeneration();
+	m_NeedsRingUpload = false;
+
+	destination += GetRingSize();
+	firstConstant += GetConstantCount();
+	OnUploaded();
+}
+
+void ConstantBuffer::OnUploaded()
+{
+	m_IsImageUploaded = true;
+
+	m_Statistics.uploadCount++;
+	m_Statistics.uploadedByteCount += m_Size;
+	s_Statistics.uploadCount++;
+	s_Statistics.uploadedByteCount += m_Size;
+}
+
+unsigned int ConstantBuffer::GetRingSize() const
+{
+	return ConstantRingBuffer::Align(m_Size);
+}
+
+ID3D11Buffer* ConstantBuffer::GetPtr() const
+{
+	return m_Buffer != nullptr ? m_Buffer.Get() : ConstantRingBuffer::GetBuffer();
+}
+
+// Returns the statistics of all constant buffers since the last call
+ConstantBufferStatistics ConstantBuffer::ConsumeTotalStatistics()
+{
+	auto statistics = s_Statistics;
+	s_Statistics = ConstantBufferStatistics();
+
+	return statistics;
 }
\ No newline at end of file
@@ -4,14 +4,40 @@
 
 struct RenderParameters;
 
+struct ConstantBufferStatistics
+{
+	unsigned int uploadCount;
+	size_t stagedByteCount;		// Bytes that changed in buffer images
+	size_t uploadedByteCount;	// Bytes copied to the GPU
+
+	ConstantBufferStatistics() : uploadCount(0), stagedByteCount(0), uploadedByteCount(0) {}
+};
+
+// Keeps an image of what the GPU buffer holds. Render parameters only get written into it where they differ,
+// and the image is only uploaded when it has changed since the last upload. Where the constant ring buffer is supported,
+// the image goes there and gets bound by offset, otherwise into a buffer of its own
 class ConstantBuffer
 {
 private:
+	struct AlignedDeleter
+	{
+		void operator()(uint8_t* image) const { _aligned_free(image); }
+	};
+
 	ComPtr<ID3D11Buffer> m_Buffer;
 	vector<ConstantBufferField> m_Fields;
+	unique_ptr<uint8_t[], AlignedDeleter> m_Image;
 	int m_Size;
+	bool m_IsImageUploaded;
+	bool m_NeedsRingUpload;
+	unsigned int m_RingGeneration;
+	unsigned int m_FirstConstant;
+	ConstantBufferStatistics m_Statistics;
+
+	static ConstantBufferStatistics s_Statistics;
 	
-	void SetRenderParametersNoCheck();
+	void Upload();
+	void OnUploaded();
 
 	ConstantBuffer(const ConstantBuffer& other);
 
@@ -21,6 +47,15 @@ public:
 
 	~ConstantBuffer();
 
-	void SetRenderParameters(const RenderParameters& renderParameters);
-	ID3D11Buffer* GetPtr() const { return m_Buffer.Get(); }
+	bool StageRenderParameters(const RenderParameters& renderParameters);
+	void UploadToRing(uint8_t*& destination, unsigned int& firstConstant);
+
+	inline bool NeedsRingUpload() const { return m_NeedsRingUpload; }
+	unsigned int GetRingSize() const;
+	inline unsigned int GetFirstConstant() const { return m_FirstConstant; }
+	inline unsigned int GetConstantCount() const { return GetRingSize() / 16; }
+	ID3D11Buffer* GetPtr() const;
+
+	inline const ConstantBufferStatistics& GetStatistics() const { return m_Statistics; }
+	static ConstantBufferStatistics ConsumeTotalStatistics();
 };
\ No newline at end of file
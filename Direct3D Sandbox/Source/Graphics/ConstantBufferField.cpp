@@ -6,38 +6,53 @@
 ConstantBufferField::ConstantBufferField(unsigned int parameterOffset, unsigned int byteOffset, unsigned int size) : 
 	m_ParameterOffset(parameterOffset),
 	m_ByteOffset(byteOffset), 
-	m_Size(size), 
-	m_Value(new uint8_t[size])
+	m_Size(size)
 {
 	Assert(m_ParameterOffset != 0xFFFFFFFF);
+	Assert(m_Size % 4 == 0);	// HLSL packs everything in 4 byte components
 }
 
-ConstantBufferField::ConstantBufferField(ConstantBufferField&& other) :
-	m_ParameterOffset(other.m_ParameterOffset),
-	m_ByteOffset(other.m_ByteOffset),
-	m_Size(other.m_Size),
-	m_Value(std::move(other.m_Value))
+// Returns whether the next field continued this one, in which case it is now part of it
+bool ConstantBufferField::TryAppend(const ConstantBufferField& next)
 {
-}
+	if (next.m_ParameterOffset != m_ParameterOffset + m_Size || next.m_ByteOffset != m_ByteOffset + m_Size)
+	{
+		return false;
+	}
 
-ConstantBufferField& ConstantBufferField::operator=(ConstantBufferField&& other)
-{
-	m_ParameterOffset = other.m_ParameterOffset;
-	m_ByteOffset = other.m_ByteOffset;
-	m_Size = other.m_Size;
-	m_Value = std::move(other.m_Value);
-	
-	return *this;
+	m_Size += next.m_Size;
+	return true;
 }
 
-bool ConstantBufferField::SetValueIfNeeded(const void* value)
+// Compares the field with its copy in the buffer image 16 bytes at a time and only writes the blocks that differ.
+// Returns how many bytes of the image changed
+unsigned int ConstantBufferField::CopyChangedBlocks(const uint8_t* renderParameters, uint8_t* image) const
 {
-	auto shouldSet = memcmp(m_Value.get(), value, m_Size) != 0;
+	auto source = reinterpret_cast<const uint32_t*>(renderParameters + m_ParameterOffset);
+	auto destination = reinterpret_cast<uint32_t*>(image + m_ByteOffset);
+	auto wordCount = m_Size / 4;
+	auto changedByteCount = 0u;
+	auto i = 0u;
+
+	for (; i + 4 <= wordCount; i += 4)
+	{
+		auto sourceBlock = DirectX::XMLoadInt4(source + i);
+
+		if (!DirectX::XMVector4EqualInt(sourceBlock, DirectX::XMLoadInt4(destination + i)))
+		{
+			DirectX::XMStoreInt4(destination + i, sourceBlock);
+			changedByteCount += 16;
+		}
+	}
 
-	if (shouldSet)
+	for (; i < wordCount; i++)
 	{
-		memcpy(m_Value.get(), value, m_Size);
+		if (source[i] != destination[i])
+		{
+			destination[i] = source[i];
+			changedByteCount += 4;
+		}
 	}
 
-	return shouldSet;
+	return changedByteCount;
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "PrecompiledHeader.h"
+#include "ConstantRingBuffer.h"
+#include "Direct3D.h"
+#include "Tools.h"
+
+const unsigned int ConstantRingBuffer::kSize = 4 * 1024 * 1024;
+const unsigned int ConstantRingBuffer::kAlignment = 256;		// Offsets are counted in constants and have to be multiples of 16 of them
+ID3D11Buffer* const ConstantRingBuffer::kNullBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT] = { nullptr };
+
+ComPtr<ID3D11Buffer> ConstantRingBuffer::s_Buffer;
+unsigned int ConstantRingBuffer::s_WriteOffset = 0;
+unsigned int ConstantRingBuffer::s_Generation = 0;
+bool ConstantRingBuffer::s_ShouldDiscard = true;
+
+vector<uint8_t> ConstantRingBuffer::s_BatchMemory;
+unsigned int ConstantRingBuffer::s_BatchOffset = 0;
+unsigned int ConstantRingBuffer::s_BatchIndex = 0;
+bool ConstantRingBuffer::s_IsBatching = false;
+
+void ConstantRingBuffer::Initialize()
+{
+	Assert(s_Buffer == nullptr);
+
+	if (!Direct3D::SupportsConstantBufferOffsets())
+	{
+		return;
+	}
+
+	HRESULT result;
+	D3D11_BUFFER_DESC bufferDescription;
+
+	bufferDescription.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDescription.ByteWidth = kSize;
+	bufferDescription.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	bufferDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDescription.MiscFlags = 0;
+	bufferDescription.StructureByteStride = 0;
+
+	result = GetD3D11Device()->CreateBuffer(&bufferDescription, nullptr, &s_Buffer);
+	Assert(result == S_OK);
+}
+
+// Makes sure that the next size bytes fit before the end of the buffer. Call it with the most a draw can write before anything
+// of that draw gets written: wrapping around discards the buffer, and with it everything the draw already bound from it.
+// Constant buffers notice the generation change and upload again
+void ConstantRingBuffer::Reserve(unsigned int size)
+{
+	Assert(size <= kSize && !s_IsBatching);
+
+	if (s_WriteOffset + size > kSize)
+	{
+		s_WriteOffset = 0;
+		s_ShouldDiscard = true;
+		s_Generation++;
+	}
+}
+
+uint8_t* ConstantRingBuffer::MapBuffer()
+{
+	HRESULT result;
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	auto mapType = s_ShouldDiscard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+
+	result = GetD3D11DeviceContext()->Map(s_Buffer.Get(), 0, mapType, 0, &mappedResource);
+	Assert(result == S_OK);
+
+	s_ShouldDiscard = false;
+	return static_cast<uint8_t*>(mappedResource.pData);
+}
+
+// Returns where to write size bytes, which must have been reserved already, and the first constant they start at
+uint8_t* ConstantRingBuffer::Map(unsigned int size, unsigned int& firstConstant)
+{
+	Assert(s_WriteOffset + size <= kSize);
+
+	uint8_t* destination;
+	firstConstant = s_WriteOffset / 16;
+
+	if (s_IsBatching)
+	{
+		Assert(s_WriteOffset + size <= s_BatchOffset + s_BatchMemory.size());
+		destination = s_BatchMemory.data() + s_WriteOffset - s_BatchOffset;
+	}
+	else
+	{
+		destination = MapBuffer() + s_WriteOffset;
+	}
+
+	s_WriteOffset += size;
+	return destination;
+}
+
+void ConstantRingBuffer::Unmap()
+{
+	if (!s_IsBatching)
+	{
+		GetD3D11DeviceContext()->Unmap(s_Buffer.Get(), 0);
+	}
+}
+
+// Reserves size bytes for the maps up to EndBatch, which don't touch the buffer itself. Nothing written in the batch can be drawn with before EndBatch
+void ConstantRingBuffer::BeginBatch(unsigned int size)
+{
+	Reserve(size);
+
+	if (s_BatchMemory.size() < size)
+	{
+		s_BatchMemory.resize(size);
+	}
+
+	s_BatchOffset = s_WriteOffset;
+	s_BatchIndex++;
+	s_IsBatching = true;
+}
+
+// Copies everything written since BeginBatch to the buffer with a single map
+void ConstantRingBuffer::EndBatch()
+{
+	Assert(s_IsBatching);
+
+	auto size = s_WriteOffset - s_BatchOffset;
+	s_IsBatching = false;
+
+	if (size > 0)
+	{
+		memcpy(MapBuffer() + s_BatchOffset, s_BatchMemory.data(), size);
+		Unmap();
+	}
+}
\ No newline at end of file
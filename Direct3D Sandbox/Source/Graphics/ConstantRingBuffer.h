@@ -0,0 +1,44 @@
+#pragma once
+
+// One big dynamic constant buffer that the constants of every draw get written into, one after another.
+// Draws bind their part of it by offset, so instead of renaming a small buffer for every changed constant buffer,
+// the driver only renames this one when it wraps around, and each draw in between does a single no-overwrite map.
+// Between BeginBatch and EndBatch maps hand out memory of the ring buffer's own, which EndBatch writes with a single map,
+// so draws that get staged ahead share one map. Needs Direct3D 11.1 constant buffer offsetting; without it constant buffers upload into their own buffers
+class ConstantRingBuffer
+{
+private:
+	static ComPtr<ID3D11Buffer> s_Buffer;
+	static unsigned int s_WriteOffset;
+	static unsigned int s_Generation;
+	static bool s_ShouldDiscard;
+
+	static vector<uint8_t> s_BatchMemory;
+	static unsigned int s_BatchOffset;
+	static unsigned int s_BatchIndex;
+	static bool s_IsBatching;
+
+	static uint8_t* MapBuffer();
+
+	ConstantRingBuffer();	// Static class
+
+public:
+	static const unsigned int kSize;
+	static const unsigned int kAlignment;
+	static ID3D11Buffer* const kNullBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+
+	static void Initialize();
+
+	static inline bool IsSupported() { return s_Buffer != nullptr; }
+	static inline ID3D11Buffer* GetBuffer() { return s_Buffer.Get(); }
+	static inline unsigned int GetGeneration() { return s_Generation; }
+	static inline unsigned int GetBatchIndex() { return s_BatchIndex; }
+	static inline unsigned int Align(unsigned int size) { return (size + kAlignment - 1) & ~(kAlignment - 1); }
+
+	static void Reserve(unsigned int size);
+	static uint8_t* Map(unsigned int size, unsigned int& firstConstant);
+	static void Unmap();
+
+	static void BeginBatch(unsigned int size);
+	static void EndBatch();
+};
\ No newline at end of file
@@ -1,21 +1,45 @@
 #include "PrecompiledHeader.h"
 #include "Constants.h"
 #include "Direct3D.h"
+#include "Direct3DDeviceContext.h"
+#include "RecordingDeviceContext.h"
 #include "Tools.h"
 
 Direct3D* Direct3D::s_Instance;
 
-Direct3D::Direct3D(HWND hWnd, int width, int height, bool fullscreen)
+static const D3D_FEATURE_LEVEL kFeatureLevels[] = 
+{
+	D3D_FEATURE_LEVEL_11_1,
+	D3D_FEATURE_LEVEL_11_0,
+	D3D_FEATURE_LEVEL_10_1,
+	D3D_FEATURE_LEVEL_10_0,
+	D3D_FEATURE_LEVEL_9_3,
+	D3D_FEATURE_LEVEL_9_2,
+	D3D_FEATURE_LEVEL_9_1,
+};
+
+Direct3D::Direct3D(HWND hWnd, int width, int height, bool fullscreen) :
+	m_RecordingContext(nullptr)
 {
 	s_Instance = this;
 
 	ComPtr<IDXGIAdapter1> dxgiAdapter;
+
+#if !HEADLESS
 	ComPtr<IDXGIOutput> dxgiOutput;
 
 	GetDXGIAdapterAndOutput(dxgiAdapter, dxgiOutput);
 	auto refreshRate = GetRefreshRate(dxgiOutput, width, height);
 	auto featureLevel = CreateDeviceAndSwapChain(hWnd, width, height, refreshRate, fullscreen);
+	QueryConstantBufferOffsetting();
+	CreateContext();
 	CreateBackBufferResources(width, height);
+#else
+	auto featureLevel = CreateHeadlessDevice(dxgiAdapter);
+	QueryConstantBufferOffsetting();
+	CreateContext();
+#endif
+
 	CreateRasterizerAndBlendStates(width, height);
 
 	PrintAdapterInfo(dxgiAdapter, featureLevel);
@@ -46,16 +70,6 @@ D3D_FEATURE_LEVEL Direct3D::CreateDeviceAndSwapChain(HWND hWnd, int width, int h
 	DXGI_SWAP_CHAIN_DESC swapChainDescription;
 	UINT deviceFlags = Constants::D3DDeviceFlags;
 	D3D_FEATURE_LEVEL supportedFeatureLevel;
-	D3D_FEATURE_LEVEL featureLevels[] = 
-	{
-		D3D_FEATURE_LEVEL_11_1,
-		D3D_FEATURE_LEVEL_11_0,
-		D3D_FEATURE_LEVEL_10_1,
-		D3D_FEATURE_LEVEL_10_0,
-		D3D_FEATURE_LEVEL_9_3,
-		D3D_FEATURE_LEVEL_9_2,
-		D3D_FEATURE_LEVEL_9_1,
-	};
 
 #if DEBUG
 	deviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
@@ -64,13 +78,87 @@ D3D_FEATURE_LEVEL Direct3D::CreateDeviceAndSwapChain(HWND hWnd, int width, int h
 	GetSwapChainDescription(hWnd, width, height, refreshRate, fullscreen, swapChainDescription);
 
 	result = D3D11CreateDeviceAndSwapChain(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, deviceFlags, 
-		featureLevels, sizeof(featureLevels) / sizeof(D3D_FEATURE_LEVEL), D3D11_SDK_VERSION, &swapChainDescription, 
+		kFeatureLevels, sizeof(kFeatureLevels) / sizeof(D3D_FEATURE_LEVEL), D3D11_SDK_VERSION, &swapChainDescription, 
 		&m_SwapChain, &m_Device, &supportedFeatureLevel, &m_DeviceContext);
 	Assert(result == S_OK);
 
 	return supportedFeatureLevel;
 }
 
+#if HEADLESS
+
+// The software rasterizer is there on any Windows machine, GPU or not. Buffers, textures and shaders get created on it as usual,
+// but nothing is ever drawn with it: the context the renderer gets only records calls
+D3D_FEATURE_LEVEL Direct3D::CreateHeadlessDevice(ComPtr<IDXGIAdapter1>& dxgiAdapter)
+{
+	HRESULT result;
+	UINT deviceFlags = Constants::D3DDeviceFlags;
+	D3D_FEATURE_LEVEL supportedFeatureLevel;
+	ComPtr<IDXGIDevice> dxgiDevice;
+	ComPtr<IDXGIAdapter> adapter;
+
+#if DEBUG
+	deviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+
+	result = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, deviceFlags, 
+		kFeatureLevels, sizeof(kFeatureLevels) / sizeof(D3D_FEATURE_LEVEL), D3D11_SDK_VERSION, 
+		&m_Device, &supportedFeatureLevel, &m_DeviceContext);
+	Assert(result == S_OK);
+
+	result = m_Device.As(&dxgiDevice);
+	Assert(result == S_OK);
+
+	result = dxgiDevice->GetAdapter(&adapter);
+	Assert(result == S_OK);
+
+	result = adapter.As(&dxgiAdapter);
+	Assert(result == S_OK);
+
+	return supportedFeatureLevel;
+}
+
+#endif
+
+// Binding parts of a bigger constant buffer and appending to it without discarding it needs the Direct3D 11.1 runtime,
+// which older Windows versions might not have
+void Direct3D::QueryConstantBufferOffsetting()
+{
+	HRESULT result;
+	ComPtr<ID3D11DeviceContext1> deviceContext1;
+	D3D11_FEATURE_DATA_D3D11_OPTIONS options;
+
+	result = m_DeviceContext.As(&deviceContext1);
+
+	if (result != S_OK)
+	{
+		return;
+	}
+
+	result = m_Device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options));
+
+	if (result == S_OK && options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer)
+	{
+		m_DeviceContext1 = deviceContext1;
+	}
+}
+
+void Direct3D::CreateContext()
+{
+#if !HEADLESS
+	unique_ptr<IDeviceContext> context(new Direct3DDeviceContext(m_DeviceContext, m_DeviceContext1));
+#else
+	unique_ptr<IDeviceContext> context;		// Calls get recorded and go no further
+#endif
+
+#if ENABLE_DEVICE_CONTEXT_RECORDING || HEADLESS
+	m_RecordingContext = new RecordingDeviceContext(std::move(context));
+	context.reset(m_RecordingContext);
+#endif
+
+	m_Context = std::move(context);
+}
+
 void Direct3D::CreateBackBufferResources(int width, int height)
 {	
 	HRESULT result;
@@ -122,9 +210,9 @@ void Direct3D::CreateRasterizerAndBlendStates(int width, int height)
 	result = m_Device->CreateBlendState(&blendDescription, &m_BlendState);
 	Assert(result == S_OK);
 
-	m_DeviceContext->RSSetState(m_RasterizerState.Get());
-	m_DeviceContext->RSSetViewports(1, &viewport);
-	m_DeviceContext->OMSetBlendState(m_BlendState.Get(), blendFactor, 0xFFFFFFFF);
+	m_Context->RSSetState(m_RasterizerState.Get());
+	m_Context->RSSetViewports(1, &viewport);
+	m_Context->OMSetBlendState(m_BlendState.Get(), blendFactor, 0xFFFFFFFF);
 }
 
 void Direct3D::PrintAdapterInfo(ComPtr<IDXGIAdapter1> dxgiAdapter, D3D_FEATURE_LEVEL featureLevel) const
@@ -141,6 +229,7 @@ void Direct3D::PrintAdapterInfo(ComPtr<IDXGIAdapter1> dxgiAdapter, D3D_FEATURE_L
 	adapterInfoReport << "\tDedicated memory: \t\t" << adapterDescription.DedicatedVideoMemory / (1024 * 1024) << " MB" << endl;
 	adapterInfoReport << "\tShared system memory: \t" << adapterDescription.SharedSystemMemory / (1024 * 1024) << " MB" << endl;
 	adapterInfoReport << "\tDirect3D feature level:\t" << (featureLevel >> 12) << "." << ((featureLevel >> 8) & 0xF) << endl;
+	adapterInfoReport << "\tConstant buffer offsets:\t" << (m_DeviceContext1 != nullptr ? "supported" : "not supported") << endl;
 	adapterInfoReport << "---------------------------------------------------------------" << endl;
 
 	OutputDebugStringW(adapterInfoReport.str().c_str());
@@ -319,12 +408,13 @@ void Direct3D::StartDrawing(float red, float green, float blue, float alpha)
 {
 	float color[] = { red, green, blue, alpha };
 
-	m_DeviceContext->ClearRenderTargetView(m_RenderTargetView.Get(), color);
-	m_DeviceContext->ClearDepthStencilView(m_DepthStencilView.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
+	m_Context->ClearRenderTargetView(m_RenderTargetView.Get(), color);
+	m_Context->ClearDepthStencilView(m_DepthStencilView.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
 }
 
 void Direct3D::SwapBuffers()
 {
+#if !HEADLESS
 	HRESULT result;
 
 	if (Constants::VSyncEnabled)
@@ -337,19 +427,24 @@ void Direct3D::SwapBuffers()
 		result = m_SwapChain->Present(0, 0);
 		Assert(result == S_OK || result == 0x087A0001);
 	}
+#endif
+
+#if ENABLE_DEVICE_CONTEXT_RECORDING || HEADLESS
+	m_RecordingContext->EndFrame();
+#endif
 }
 
 void Direct3D::SetBackBufferAsRenderTarget()
 {
-	m_DeviceContext->OMSetRenderTargets(1, m_RenderTargetView.GetAddressOf(), m_DepthStencilView.Get());
+	m_Context->OMSetRenderTargets(1, m_RenderTargetView.GetAddressOf(), m_DepthStencilView.Get());
 }
 
 void Direct3D::TurnZBufferOn()
 {
-	m_DeviceContext->OMSetDepthStencilState(m_DepthStencilState.Get(), 1);
+	m_Context->OMSetDepthStencilState(m_DepthStencilState.Get(), 1);
 }
 
 void Direct3D::TurnZBufferOff()
 {
-	m_DeviceContext->OMSetDepthStencilState(m_DisabledDepthStencilState.Get(), 1);
+	m_Context->OMSetDepthStencilState(m_DisabledDepthStencilState.Get(), 1);
 }
\ No newline at end of file
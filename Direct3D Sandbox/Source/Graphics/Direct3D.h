@@ -1,5 +1,9 @@
 #pragma once
 
+#include "IDeviceContext.h"
+
+class RecordingDeviceContext;
+
 class Direct3D
 {
 private:
@@ -7,6 +11,9 @@ private:
 
 	ComPtr<ID3D11Device> m_Device;
 	ComPtr<ID3D11DeviceContext> m_DeviceContext;
+	ComPtr<ID3D11DeviceContext1> m_DeviceContext1;		// Only set if constant buffers can be bound by offset
+	unique_ptr<IDeviceContext> m_Context;				// What the renderer makes its calls through
+	RecordingDeviceContext* m_RecordingContext;			// Same as m_Context if calls get recorded, null otherwise. Always set when headless
 	ComPtr<IDXGISwapChain> m_SwapChain;
 	ComPtr<ID3D11RenderTargetView> m_RenderTargetView;
 	ComPtr<ID3D11Texture2D> m_DepthStencilBuffer;
@@ -18,6 +25,9 @@ private:
 
 	void Direct3D::GetDXGIAdapterAndOutput(ComPtr<IDXGIAdapter1>& dxgiAdapter, ComPtr<IDXGIOutput>& dxgiOutput) const;
 	D3D_FEATURE_LEVEL CreateDeviceAndSwapChain(HWND hWnd, int width, int height, const DXGI_RATIONAL& refreshRate, bool fullscreen);
+	D3D_FEATURE_LEVEL CreateHeadlessDevice(ComPtr<IDXGIAdapter1>& dxgiAdapter);
+	void QueryConstantBufferOffsetting();
+	void CreateContext();
 	void CreateBackBufferResources(int width, int height);
 	void CreateRasterizerAndBlendStates(int width, int height);
 
@@ -39,7 +49,9 @@ public:
 	~Direct3D();
 
 	static inline ID3D11Device* GetDevice() { return GetInstance().m_Device.Get(); }
-	static inline ID3D11DeviceContext* GetDeviceContext() { return GetInstance().m_DeviceContext.Get(); }
+	static inline IDeviceContext* GetDeviceContext() { return GetInstance().m_Context.get(); }
+	static inline RecordingDeviceContext* GetRecordingContext() { return GetInstance().m_RecordingContext; }
+	static inline bool SupportsConstantBufferOffsets() { return GetInstance().m_DeviceContext1 != nullptr; }
 	
 	void StartDrawing(float red = 0.0f, float green = 0.0f, float blue = 0.0f, float alpha = 1.0f);
 	void SwapBuffers();
@@ -51,4 +63,4 @@ public:
 };
 
 inline ID3D11Device* GetD3D11Device() { return Direct3D::GetDevice(); }
-inline ID3D11DeviceContext* GetD3D11DeviceContext() { return Direct3D::GetDeviceContext(); }
\ No newline at end of file
+inline IDeviceContext* GetD3D11DeviceContext() { return Direct3D::GetDeviceContext(); }
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "PrecompiledHeader.h"
+#include "Direct3DDeviceContext.h"
+#include "Tools.h"
+
+Direct3DDeviceContext::Direct3DDeviceContext(ComPtr<ID3D11DeviceContext> deviceContext, ComPtr<ID3D11DeviceContext1> deviceContext1) :
+	m_DeviceContext(deviceContext), m_DeviceContext1(deviceContext1)
+{
+}
+
+Direct3DDeviceContext::~Direct3DDeviceContext()
+{
+}
+
+void Direct3DDeviceContext::IASetInputLayout(ID3D11InputLayout* inputLayout)
+{
+	m_DeviceContext->IASetInputLayout(inputLayout);
+}
+
+void Direct3DDeviceContext::IASetVertexBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* vertexBuffers, const UINT* strides, const UINT* offsets)
+{
+	m_DeviceContext->IASetVertexBuffers(startSlot, bufferCount, vertexBuffers, strides, offsets);
+}
+
+void Direct3DDeviceContext::IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset)
+{
+	m_DeviceContext->IASetIndexBuffer(indexBuffer, format, offset);
+}
+
+void Direct3DDeviceContext::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+	m_DeviceContext->IASetPrimitiveTopology(topology);
+}
+
+void Direct3DDeviceContext::VSSetShader(ID3D11VertexShader* vertexShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount)
+{
+	m_DeviceContext->VSSetShader(vertexShader, classInstances, classInstanceCount);
+}
+
+void Direct3DDeviceContext::VSSetConstantBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers)
+{
+	m_DeviceContext->VSSetConstantBuffers(startSlot, bufferCount, constantBuffers);
+}
+
+void Direct3DDeviceContext::VSSetConstantBuffers1(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts)
+{
+	Assert(m_DeviceContext1 != nullptr);
+	m_DeviceContext1->VSSetConstantBuffers1(startSlot, bufferCount, constantBuffers, firstConstants, constantCounts);
+}
+
+void Direct3DDeviceContext::VSSetShaderResources(UINT startSlot, UINT viewCount, ID3D11ShaderResourceView* const* shaderResourceViews)
+{
+	m_DeviceContext->VSSetShaderResources(startSlot, viewCount, shaderResourceViews);
+}
+
+void Direct3DDeviceContext::VSSetSamplers(UINT startSlot, UINT samplerCount, ID3D11SamplerState* const* samplers)
+{
+	m_DeviceContext->VSSetSamplers(startSlot, samplerCount, samplers);
+}
+
+void Direct3DDeviceContext::PSSetShader(ID3D11PixelShader* pixelShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount)
+{
+	m_DeviceContext->PSSetShader(pixelShader, classInstances, classInstanceCount);
+}
+
+void Direct3DDeviceContext::PSSetConstantBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers)
+{
+	m_DeviceContext->PSSetConstantBuffers(startSlot, bufferCount, constantBuffers);
+}
+
+void Direct3DDeviceContext::PSSetConstantBuffers1(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts)
+{
+	Assert(m_DeviceContext1 != nullptr);
+	m_DeviceContext1->PSSetConstantBuffers1(startSlot, bufferCount, constantBuffers, firstConstants, constantCounts);
+}
+
+void Direct3DDeviceContext::PSSetShaderResources(UINT startSlot, UINT viewCount, ID3D11ShaderResourceView* const* shaderResourceViews)
+{
+	m_DeviceContext->PSSetShaderResources(startSlot, viewCount, shaderResourceViews);
+}
+
+void Direct3DDeviceContext::PSSetSamplers(UINT startSlot, UINT samplerCount, ID3D11SamplerState* const* samplers)
+{
+	m_DeviceContext->PSSetSamplers(startSlot, samplerCount, samplers);
+}
+
+void Direct3DDeviceContext::RSSetState(ID3D11RasterizerState* rasterizerState)
+{
+	m_DeviceContext->RSSetState(rasterizerState);
+}
+
+void Direct3DDeviceContext::RSSetViewports(UINT viewportCount, const D3D11_VIEWPORT* viewports)
+{
+	m_DeviceContext->RSSetViewports(viewportCount, viewports);
+}
+
+void Direct3DDeviceContext::OMSetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask)
+{
+	m_DeviceContext->OMSetBlendState(blendState, blendFactor, sampleMask);
+}
+
+void Direct3DDeviceContext::OMSetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef)
+{
+	m_DeviceContext->OMSetDepthStencilState(depthStencilState, stencilRef);
+}
+
+void Direct3DDeviceContext::OMSetRenderTargets(UINT viewCount, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView)
+{
+	m_DeviceContext->OMSetRenderTargets(viewCount, renderTargetViews, depthStencilView);
+}
+
+void Direct3DDeviceContext::ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT color[4])
+{
+	m_DeviceContext->ClearRenderTargetView(renderTargetView, color);
+}
+
+void Direct3DDeviceContext::ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil)
+{
+	m_DeviceContext->ClearDepthStencilView(depthStencilView, clearFlags, depth, stencil);
+}
+
+HRESULT Direct3DDeviceContext::Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource)
+{
+	return m_DeviceContext->Map(resource, subresource, mapType, mapFlags, mappedResource);
+}
+
+void Direct3DDeviceContext::Unmap(ID3D11Resource* resource, UINT subresource)
+{
+	m_DeviceContext->Unmap(resource, subresource);
+}
+
+void Direct3DDeviceContext::Draw(UINT vertexCount, UINT startVertexLocation)
+{
+	m_DeviceContext->Draw(vertexCount, startVertexLocation);
+}
+
+void Direct3DDeviceContext::DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation)
+{
+	m_DeviceContext->DrawIndexed(indexCount, startIndexLocation, baseVertexLocation);
+}
+
+void Direct3DDeviceContext::DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation)
+{
+	m_DeviceContext->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
+}
\ No newline at end of file
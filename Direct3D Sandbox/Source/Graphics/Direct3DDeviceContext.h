@@ -0,0 +1,48 @@
+#pragma once
+
+#include "IDeviceContext.h"
+
+// Passes every call straight on to the Direct3D immediate context
+class Direct3DDeviceContext : public IDeviceContext
+{
+private:
+	ComPtr<ID3D11DeviceContext> m_DeviceContext;
+	ComPtr<ID3D11DeviceContext1> m_DeviceContext1;		// Only set if constant buffers can be bound by offset
+
+public:
+	Direct3DDeviceContext(ComPtr<ID3D11DeviceContext> deviceContext, ComPtr<ID3D11DeviceContext1> deviceContext1);
+	virtual ~Direct3DDeviceContext();
+
+	virtual void IASetInputLayout(ID3D11InputLayout* inputLayout);
+	virtual void IASetVertexBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* vertexBuffers, const UINT* strides, const UINT* offsets);
+	virtual void IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset);
+	virtual void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
+
+	virtual void VSSetShader(ID3D11VertexShader* vertexShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount);
+	virtual void VSSetConstantBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers);
+	virtual void VSSetConstantBuffers1(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts);
+	virtual void VSSetShaderResources(UINT startSlot, UINT viewCount, ID3D11ShaderResourceView* const* shaderResourceViews);
+	virtual void VSSetSamplers(UINT startSlot, UINT samplerCount, ID3D11SamplerState* const* samplers);
+
+	virtual void PSSetShader(ID3D11PixelShader* pixelShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount);
+	virtual void PSSetConstantBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers);
+	virtual void PSSetConstantBuffers1(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts);
+	virtual void PSSetShaderResources(UINT startSlot, UINT viewCount, ID3D11ShaderResourceView* const* shaderResourceViews);
+	virtual void PSSetSamplers(UINT startSlot, UINT samplerCount, ID3D11SamplerState* const* samplers);
+
+	virtual void RSSetState(ID3D11RasterizerState* rasterizerState);
+	virtual void RSSetViewports(UINT viewportCount, const D3D11_VIEWPORT* viewports);
+	virtual void OMSetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask);
+	virtual void OMSetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef);
+	virtual void OMSetRenderTargets(UINT viewCount, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView);
+
+	virtual void ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT color[4]);
+	virtual void ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil);
+
+	virtual HRESULT Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource);
+	virtual void Unmap(ID3D11Resource* resource, UINT subresource);
+
+	virtual void Draw(UINT vertexCount, UINT startVertexLocation);
+	virtual void DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation);
+	virtual void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation);
+};
\ No newline at end of file
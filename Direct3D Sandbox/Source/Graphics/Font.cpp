@@ -1,4 +1,5 @@
 #include "PrecompiledHeader.h"
+#include "AssetStreamer.h"
 #include "Direct3D.h"
 #include "Font.h"
 #include "IShader.h"
@@ -6,7 +7,7 @@
 #include "MutableModel.h"
 #include "Tools.h"
 
-unordered_map<wstring, Font> Font::s_FontCache;
+unordered_map<wstring, AssetHandle<shared_ptr<Font>>> Font::s_FontCache;
 Font* Font::s_DefaultFont;
 
 Font::Font(const wstring& path)
@@ -74,25 +75,19 @@ Font::Font(const wstring& path)
 	m_LineSpacing = Tools::BufferReader::ReadUInt(font, position);
 }
 
-Font::Font(Font&& other) :
-	m_FontTextureWidth(other.m_FontTextureWidth),
-	m_FontTextureHeight(other.m_FontTextureHeight),
-	m_FontTexture(other.m_FontTexture),
-	m_CharacterMetadata(std::move(other.m_CharacterMetadata)),
-	m_LineSpacing(other.m_LineSpacing),
-	m_TextCache(std::move(other.m_TextCache))
-{
-	other.m_FontTexture = nullptr;
-}
-
-
 Font::~Font()
 {
 }
 
+// Fonts are read and their textures created on a worker thread. Get waits for them, as text can't be drawn with a placeholder
 void Font::LoadFont(const wstring& path)
 {
-	s_FontCache.emplace(Tools::ToLower(path), Font(path));
+	auto font = AssetStreamer::Load<shared_ptr<Font>>([path]()
+	{
+		return shared_ptr<Font>(new Font(path), [](Font* font) { delete font; });
+	});
+
+	s_FontCache.emplace(Tools::ToLower(path), font);
 }
 
 Font& Font::Get(const wstring& path)
@@ -101,7 +96,7 @@ Font& Font::Get(const wstring& path)
 	auto font = s_FontCache.find(fontPath);
 
 	Assert(font != s_FontCache.end());
-	return font->second;
+	return *font->second.Wait();
 }
 
 Font& Font::GetDefault()
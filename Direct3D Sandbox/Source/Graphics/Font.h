@@ -1,4 +1,5 @@
 #pragma once
+#include "AssetHandle.h"
 #include "Tools.h"
 #include "IShader.h"
 
@@ -43,7 +44,7 @@ private:
 		}
 	};
 
-	static unordered_map<wstring, Font> s_FontCache;
+	static unordered_map<wstring, AssetHandle<shared_ptr<Font>>> s_FontCache;
 	
 	int m_FontTextureWidth;
 	int m_FontTextureHeight;
@@ -58,16 +59,12 @@ private:
 	
 	Font(const Font& other);														// Not implemented (no copying allowed)
 	Font& operator=(const Font& other);												// Not implemented (no copying allowed)
-	Font(Font&& other);
 
 	ModelData CreateModelData(const string& text);
 	Model CreateTextModel(const string& text, IShader& shader);
 
 	static Font* s_DefaultFont;
 
-	template <typename _Ty1, typename _Ty2>
-	friend struct pair;
-
 public:	
 	static void LoadFont(const wstring& path);
 	static Font& Get(const wstring& path);
@@ -0,0 +1,49 @@
+#pragma once
+
+// The device context calls the renderer makes. Methods take the same arguments as their ID3D11DeviceContext counterparts,
+// so that calls can be counted, recorded or dropped without the code making them knowing
+class IDeviceContext
+{
+protected:
+	IDeviceContext() {}
+
+private:
+	IDeviceContext(const IDeviceContext& other);				// Not implemented (no copying allowed)
+	IDeviceContext& operator=(const IDeviceContext& other);		// Not implemented (no copying allowed)
+
+public:
+	virtual ~IDeviceContext() {}
+
+	virtual void IASetInputLayout(ID3D11InputLayout* inputLayout) = 0;
+	virtual void IASetVertexBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* vertexBuffers, const UINT* strides, const UINT* offsets) = 0;
+	virtual void IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset) = 0;
+	virtual void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) = 0;
+
+	virtual void VSSetShader(ID3D11VertexShader* vertexShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount) = 0;
+	virtual void VSSetConstantBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers) = 0;
+	virtual void VSSetConstantBuffers1(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts) = 0;
+	virtual void VSSetShaderResources(UINT startSlot, UINT viewCount, ID3D11ShaderResourceView* const* shaderResourceViews) = 0;
+	virtual void VSSetSamplers(UINT startSlot, UINT samplerCount, ID3D11SamplerState* const* samplers) = 0;
+
+	virtual void PSSetShader(ID3D11PixelShader* pixelShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount) = 0;
+	virtual void PSSetConstantBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers) = 0;
+	virtual void PSSetConstantBuffers1(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts) = 0;
+	virtual void PSSetShaderResources(UINT startSlot, UINT viewCount, ID3D11ShaderResourceView* const* shaderResourceViews) = 0;
+	virtual void PSSetSamplers(UINT startSlot, UINT samplerCount, ID3D11SamplerState* const* samplers) = 0;
+
+	virtual void RSSetState(ID3D11RasterizerState* rasterizerState) = 0;
+	virtual void RSSetViewports(UINT viewportCount, const D3D11_VIEWPORT* viewports) = 0;
+	virtual void OMSetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask) = 0;
+	virtual void OMSetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef) = 0;
+	virtual void OMSetRenderTargets(UINT viewCount, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView) = 0;
+
+	virtual void ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT color[4]) = 0;
+	virtual void ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil) = 0;
+
+	virtual HRESULT Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource) = 0;
+	virtual void Unmap(ID3D11Resource* resource, UINT subresource) = 0;
+
+	virtual void Draw(UINT vertexCount, UINT startVertexLocation) = 0;
+	virtual void DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) = 0;
+	virtual void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation) = 0;
+};
\ No newline at end of file
@@ -2,13 +2,15 @@
 
 #include "IModel.h"
 #include "AnimatedModel.h"
+#include "AssetStreamer.h"
 #include "Direct3D.h"
 #include "IShader.h"
 #include "Model.h"
 
-unordered_map<wstring, unique_ptr<const ModelData>> IModel::s_ModelDataCache;
+unordered_map<wstring, AssetHandle<shared_ptr<const ModelData>>> IModel::s_ModelDataCache;
 unordered_map<ModelId, shared_ptr<IModel>, ModelIdHash> IModel::s_ModelCache;
 const IModel* IModel::s_ModelWhichLastSetParameters;
+unsigned int IModel::s_NextSortId;
 
 IModel::IModel(IShader& shader
 #if DEBUG
@@ -17,7 +19,8 @@ IModel::IModel(IShader& shader
 		) :
 	m_Shader(shader),
 	m_VertexCount(0),
-	m_IndexCount(0)
+	m_IndexCount(0),
+	m_SortId(s_NextSortId++)
 #if DEBUG
 	, m_Key(modelPath)
 #endif
@@ -28,7 +31,8 @@ IModel::IModel(IModel&& other) :
 	m_Shader(other.m_Shader),
 	m_IndexBuffer(other.m_IndexBuffer),
 	m_VertexCount(other.m_VertexCount),
-	m_IndexCount(other.m_IndexCount)
+	m_IndexCount(other.m_IndexCount),
+	m_SortId(other.m_SortId)
 #if DEBUG
 	, m_Key(std::move(other.m_Key))
 #endif
@@ -61,6 +65,14 @@ void IModel::InitializeModel(IShader& shader, const wstring& modelPath)
 	}
 
 	s_ModelCache.emplace(ModelId(modelPath, shader), model);
+
+	// GPU buffers hold everything the model needs from now on. Another shader asking for the same model
+	// loads it again, which is cheap as the file is only mapped
+	s_ModelDataCache.erase(Tools::ToLower(modelPath));
+
+#if DEBUG
+	OutputDebugString((L"Released CPU copy of " + modelPath + L", memory usage: " + to_wstring(Tools::GetMemoryUsage()) + L" MB\r\n").c_str());
+#endif
 }
 
 IModel& IModel::Get(const wstring& modelPath, IShader& shader)
@@ -77,17 +89,28 @@ IModel& IModel::Get(const wstring& modelPath, IShader& shader)
 	return *model->second;
 }
 
-const ModelData& IModel::GetModelData(const wstring& modelPath)
-{	
-	auto cachedModel = s_ModelDataCache.find(modelPath);
+// Starts loading model data on a worker thread, so that creating the model later doesn't stall the frame on reading the file
+void IModel::Prefetch(const wstring& modelPath)
+{
+	auto key = Tools::ToLower(modelPath);
 
-	if (cachedModel == s_ModelDataCache.end())
+	if (s_ModelDataCache.find(key) != s_ModelDataCache.end())
 	{
-		s_ModelDataCache.emplace(modelPath, Tools::LoadModel(modelPath));
-		cachedModel = s_ModelDataCache.find(modelPath);
+		return;
 	}
 
-	return *cachedModel->second;
+	auto modelData = AssetStreamer::Load<shared_ptr<const ModelData>>([modelPath]()
+	{
+		return shared_ptr<const ModelData>(Tools::LoadModel(modelPath));
+	});
+
+	s_ModelDataCache.emplace(key, modelData);
+}
+
+const ModelData& IModel::GetModelData(const wstring& modelPath)
+{	
+	Prefetch(modelPath);
+	return *s_ModelDataCache[Tools::ToLower(modelPath)].Wait();
 }
 
 void IModel::InitializeIndexBuffer(const ModelData& modelData)
@@ -97,11 +120,11 @@ void IModel::InitializeIndexBuffer(const ModelData& modelData)
 	
 	if (m_IndexCount > 0)
 	{
-		m_IndexBuffer = CreateIndexBuffer(m_IndexCount, modelData.indices.get());
+		m_IndexBuffer = CreateIndexBuffer(m_IndexCount, modelData.GetIndices());
 	}
 }
 
-ComPtr<ID3D11Buffer> IModel::CreateIndexBuffer(unsigned int indexCount, unsigned int indices[])
+ComPtr<ID3D11Buffer> IModel::CreateIndexBuffer(unsigned int indexCount, const unsigned int indices[])
 {
 	D3D11_BUFFER_DESC indexBufferDescription;
 	D3D11_SUBRESOURCE_DATA indexData;
@@ -137,6 +160,12 @@ void IModel::SetIndexBufferToDeviceContext(bool forceReset)
 	}
 }
 
+// Writes the constants Render would, ahead of the draw. Changes render parameters the same way Render does
+void IModel::StageRenderParameters(RenderParameters& renderParameters)
+{
+	m_Shader.StageRenderParameters(renderParameters);
+}
+
 void IModel::Render(RenderParameters& renderParameters)
 {
 	auto deviceContext = GetD3D11DeviceContext();
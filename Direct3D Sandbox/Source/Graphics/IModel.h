@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AssetHandle.h"
 #include "Tools.h"
 
 class IShader;
@@ -31,8 +32,10 @@ protected:
 	ComPtr<ID3D11Buffer> m_IndexBuffer;
 	unsigned int m_IndexCount;
 	unsigned int m_VertexCount;
+	unsigned int m_SortId;
 
-	static unordered_map<wstring, unique_ptr<const ModelData>> s_ModelDataCache;
+	static unsigned int s_NextSortId;
+	static unordered_map<wstring, AssetHandle<shared_ptr<const ModelData>>> s_ModelDataCache;
 	static unordered_map<ModelId, shared_ptr<IModel>, ModelIdHash> s_ModelCache;	
 	static const IModel* s_ModelWhichLastSetParameters;
 
@@ -53,7 +56,7 @@ protected:
 
 	static void InitializeModel(IShader& shader, const wstring& modelPath);
 	static const ModelData& GetModelData(const wstring& key);
-	static ComPtr<ID3D11Buffer> CreateIndexBuffer(unsigned int indexCount, unsigned int indices[]);
+	static ComPtr<ID3D11Buffer> CreateIndexBuffer(unsigned int indexCount, const unsigned int indices[]);
 
 private:
 	IModel(const IModel& other);														// Not implemented (no copying allowed)
@@ -64,9 +67,13 @@ public:
 	virtual ~IModel();
 
 	static IModel& Get(const wstring& path, IShader& shader);
+	static void Prefetch(const wstring& path);
 	static void InvalidateParameterSetter() { s_ModelWhichLastSetParameters = nullptr; }
 	
 	inline float GetRadius() { return m_Radius; }
-	void Render(RenderParameters& renderParameters);
+	inline const IShader& GetShader() const { return m_Shader; }
+	inline unsigned int GetSortId() const { return m_SortId; }
+	virtual void StageRenderParameters(RenderParameters& renderParameters);
+	virtual void Render(RenderParameters& renderParameters);
 };
 
@@ -4,8 +4,11 @@
 #include "Tools.h"
 
 vector<shared_ptr<IShader>> IShader::s_Shaders;
+unsigned int IShader::s_NextSortId;
 
-IShader::IShader()
+IShader::IShader() :
+	m_InstancedVariant(nullptr),
+	m_SortId(s_NextSortId++)
 {
 }
 
@@ -22,9 +25,12 @@ void IShader::LoadShaders()
 	s_Shaders[ShaderType::LIGHTING_SHADER] = make_shared<AutoShader>(L"Shaders\\LightingVertexShader.cso", L"Shaders\\LightingPixelShader.cso");
 	s_Shaders[ShaderType::NORMAL_MAP_SHADER] = make_shared<AutoShader>(L"Shaders\\NormalMapVertexShader.cso", L"Shaders\\NormalMapPixelShader.cso");
 	s_Shaders[ShaderType::ANIMATION_NORMAL_MAP_SHADER] = make_shared<AutoShader>(L"Shaders\\AnimationNormalMapVertexShader.cso", L"Shaders\\NormalMapPixelShader.cso");
+	s_Shaders[ShaderType::ANIMATION_NORMAL_MAP_INSTANCED_SHADER] = make_shared<AutoShader>(L"Shaders\\AnimationNormalMapInstancedVertexShader.cso", L"Shaders\\NormalMapPixelShader.cso");
 	s_Shaders[ShaderType::PLAYGROUND_SHADER] = make_shared<AutoShader>(L"Shaders\\PlaygroundVertexShader.cso", L"Shaders\\PlaygroundPixelShader.cso");
 	s_Shaders[ShaderType::INFINITE_GROUND_SHADER] = make_shared<AutoShader>(L"Shaders\\InfiniteGroundVertexShader.cso", L"Shaders\\NormalMapPixelShader.cso");
 	s_Shaders[ShaderType::LASER_SHADER] = make_shared<AutoShader>(L"Shaders\\LaserVertexShader.cso", L"Shaders\\LaserPixelShader.cso");
 
+	s_Shaders[ShaderType::ANIMATION_NORMAL_MAP_SHADER]->m_InstancedVariant = s_Shaders[ShaderType::ANIMATION_NORMAL_MAP_INSTANCED_SHADER].get();
+
 	Assert(s_Shaders.size() == ShaderType::SHADER_COUNT);
 }
\ No newline at end of file
@@ -10,6 +10,7 @@ enum ShaderType
 	LIGHTING_SHADER,
 	NORMAL_MAP_SHADER,
 	ANIMATION_NORMAL_MAP_SHADER,
+	ANIMATION_NORMAL_MAP_INSTANCED_SHADER,
 	PLAYGROUND_SHADER,
 	INFINITE_GROUND_SHADER,
 	LASER_SHADER,
@@ -23,6 +24,10 @@ protected:
 
 private:
 	static vector<shared_ptr<IShader>> s_Shaders;
+	static unsigned int s_NextSortId;
+
+	IShader* m_InstancedVariant;
+	unsigned int m_SortId;
 
 	IShader(IShader& other);
 	IShader& operator=(const IShader& other);
@@ -36,7 +41,13 @@ public:
 	virtual void UploadVertexData(ID3D11Buffer* vertexBuffer, unsigned int vertexCount, const VertexParameters vertices[], unsigned int semanticIndex) const = 0;
 
 	virtual void SetRenderParameters(const RenderParameters& renderParameters) = 0;
+	virtual void StageRenderParameters(const RenderParameters& renderParameters) = 0;		// Writes a draw's constants ahead of it, see ConstantRingBuffer::BeginBatch
+	virtual unsigned int GetConstantRingSize() const = 0;
 	virtual const unsigned int* GetInputLayoutStrides() const = 0;
+
+	// Shader that draws the same thing, but reads per instance data from the vertex buffer after this shader's ones. Null if there isn't one
+	inline IShader* GetInstancedVariant() const { return m_InstancedVariant; }
+	inline unsigned int GetSortId() const { return m_SortId; }
 	
 	static void LoadShaders();
 	static IShader& GetShader(ShaderType shaderType) { return *s_Shaders[shaderType]; }
@@ -3,15 +3,20 @@
 #include "Parameters.h"
 #include "Tools.h"
 
+// Inputs whose semantic starts with this step once per instance instead of once per vertex. They are filled from
+// per instance structs rather than VertexParameters, so they don't have a parameter offset
+static const char kInstanceSemanticPrefix[] = "INSTANCE";
+
 InputLayoutItem::InputLayoutItem(const string& semanticName, unsigned int semanticIndex, DXGI_FORMAT dxgiFormat, 
 									unsigned int itemSize, unsigned int parameterOffset) :
 	m_Name(semanticName),
 	m_SemanticIndex(semanticIndex),
 	m_Format(dxgiFormat),
 	m_Size(itemSize),
-	m_ParameterOffset(parameterOffset)
+	m_ParameterOffset(parameterOffset),
+	m_IsPerInstance(_strnicmp(semanticName.c_str(), kInstanceSemanticPrefix, sizeof(kInstanceSemanticPrefix) - 1) == 0)
 {
-	Assert(m_ParameterOffset != 0xFFFFFFFF);
+	Assert(m_IsPerInstance || m_ParameterOffset != 0xFFFFFFFF);
 }
 
 InputLayoutItem::~InputLayoutItem()
@@ -23,7 +28,8 @@ InputLayoutItem::InputLayoutItem(InputLayoutItem&& other) :
 	m_SemanticIndex(other.m_SemanticIndex),
 	m_Format(other.m_Format),
 	m_Size(other.m_Size),
-	m_ParameterOffset(other.m_ParameterOffset)
+	m_ParameterOffset(other.m_ParameterOffset),
+	m_IsPerInstance(other.m_IsPerInstance)
 {
 }
 
@@ -34,6 +40,6 @@ void InputLayoutItem::FillInputElementDescription(D3D11_INPUT_ELEMENT_DESC& elem
 	elementDescription.Format = m_Format;
 	elementDescription.InputSlot = m_SemanticIndex;
 	elementDescription.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	elementDescription.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	elementDescription.InstanceDataStepRate = 0;
+	elementDescription.InputSlotClass = m_IsPerInstance ? D3D11_INPUT_PER_INSTANCE_DATA : D3D11_INPUT_PER_VERTEX_DATA;
+	elementDescription.InstanceDataStepRate = m_IsPerInstance ? 1 : 0;
 }
\ No newline at end of file
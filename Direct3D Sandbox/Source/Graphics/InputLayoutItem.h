@@ -8,6 +8,7 @@ private:
 	DXGI_FORMAT m_Format;
 	unsigned int m_Size;
 	unsigned int m_ParameterOffset;
+	bool m_IsPerInstance;
 	
 	InputLayoutItem(const InputLayoutItem& other);
 
@@ -21,6 +22,7 @@ public:
 	DXGI_FORMAT GetFormat() const { return m_Format; }
 	unsigned int GetSize() const { return m_Size; }
 	unsigned int GetParameterOffset() const { return m_ParameterOffset; }
+	bool IsPerInstance() const { return m_IsPerInstance; }
 
 	void FillInputElementDescription(D3D11_INPUT_ELEMENT_DESC& elementDescription) const;
 };
@@ -42,7 +42,7 @@ Model::~Model()
 void Model::CreateBuffers(const ModelData& modelData)
 {
 	m_VertexCount = static_cast<unsigned int>(modelData.vertexCount);
-	m_VertexBuffer = m_Shader.CreateVertexBuffer(m_VertexCount, modelData.vertices.get(), 0);
+	m_VertexBuffer = m_Shader.CreateVertexBuffer(m_VertexCount, modelData.GetVertices(), 0);
 	Assert(m_VertexBuffer != nullptr);
 
 	InitializeIndexBuffer(modelData);
@@ -1,4 +1,5 @@
 #include "PrecompiledHeader.h"
+#include "ConstantRingBuffer.h"
 #include "Direct3D.h"
 #include "Parameters.h"
 #include "PixelShader.h"
@@ -34,14 +35,25 @@ void PixelShader::SetRenderParameters(const RenderParameters& renderParameters)
 	}
 }
 
-void PixelShader::SetConstantBuffersImpl() const
+void PixelShader::SetConstantBuffersImpl(bool haveOffsetsChanged) const
 {
 	static const PixelShader* shaderWhichLastSet = nullptr;
 
-	if (shaderWhichLastSet != this)
+	if (shaderWhichLastSet != this || haveOffsetsChanged)
 	{
 		shaderWhichLastSet = this;
-		GetD3D11DeviceContext()->PSSetConstantBuffers(0, static_cast<UINT>(m_ConstantBufferPtrs.size()), m_ConstantBufferPtrs.data());
+		auto bufferCount = static_cast<UINT>(m_ConstantBufferPtrs.size());
+
+		if (ConstantRingBuffer::IsSupported())
+		{
+			// The runtime skips rebinding a buffer that's already bound, even at a different offset, unless it gets unbound first
+			GetD3D11DeviceContext()->PSSetConstantBuffers(0, bufferCount, ConstantRingBuffer::kNullBuffers);
+			GetD3D11DeviceContext()->PSSetConstantBuffers1(0, bufferCount, m_ConstantBufferPtrs.data(), m_FirstConstants.data(), m_ConstantCounts.data());
+		}
+		else
+		{
+			GetD3D11DeviceContext()->PSSetConstantBuffers(0, bufferCount, m_ConstantBufferPtrs.data());
+		}
 	}
 }
 
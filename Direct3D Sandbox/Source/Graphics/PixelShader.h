@@ -7,7 +7,7 @@ class PixelShader :
 private:
 	ComPtr<ID3D11PixelShader> m_Shader;
 	
-	virtual void SetConstantBuffersImpl() const;
+	virtual void SetConstantBuffersImpl(bool haveOffsetsChanged) const;
 	virtual void SetTexturesImpl();
 	virtual void SetSamplersImpl() const;
 	
@@ -0,0 +1,547 @@
+#include "PrecompiledHeader.h"
+#include "RecordingDeviceContext.h"
+#include "Tools.h"
+
+const char* const RecordingDeviceContext::kCallNames[DEVICE_CONTEXT_CALL_COUNT] = 
+{
+	"IASetInputLayout",
+	"IASetVertexBuffers",
+	"IASetIndexBuffer",
+	"IASetPrimitiveTopology",
+	"VSSetShader",
+	"VSSetConstantBuffers",
+	"VSSetShaderResources",
+	"VSSetSamplers",
+	"PSSetShader",
+	"PSSetConstantBuffers",
+	"PSSetShaderResources",
+	"PSSetSamplers",
+	"RSSetState",
+	"RSSetViewports",
+	"OMSetBlendState",
+	"OMSetDepthStencilState",
+	"OMSetRenderTargets",
+	"ClearRenderTargetView",
+	"ClearDepthStencilView",
+	"Map",
+	"Unmap",
+	"Draw",
+	"DrawIndexed",
+	"DrawIndexedInstanced"
+};
+
+DeviceContextStatistics::DeviceContextStatistics() :
+	frameCount(0), uploadedByteCount(0)
+{
+	ZeroMemory(callCounts, sizeof(callCounts));
+	ZeroMemory(redundantCallCounts, sizeof(redundantCallCounts));
+}
+
+void DeviceContextStatistics::Add(const DeviceContextStatistics& other)
+{
+	frameCount += other.frameCount;
+	uploadedByteCount += other.uploadedByteCount;
+
+	for (int i = 0; i < DEVICE_CONTEXT_CALL_COUNT; i++)
+	{
+		callCounts[i] += other.callCounts[i];
+		redundantCallCounts[i] += other.redundantCallCounts[i];
+	}
+}
+
+unsigned int DeviceContextStatistics::GetDrawCount() const
+{
+	return callCounts[DRAW] + callCounts[DRAW_INDEXED] + callCounts[DRAW_INDEXED_INSTANCED];
+}
+
+unsigned int DeviceContextStatistics::GetStateCallCount() const
+{
+	unsigned int count = 0;
+
+	for (int i = IA_SET_INPUT_LAYOUT; i <= OM_SET_RENDER_TARGETS; i++)
+	{
+		count += callCounts[i];
+	}
+
+	return count;
+}
+
+unsigned int DeviceContextStatistics::GetRedundantCallCount() const
+{
+	unsigned int count = 0;
+
+	for (int i = 0; i < DEVICE_CONTEXT_CALL_COUNT; i++)
+	{
+		count += redundantCallCounts[i];
+	}
+
+	return count;
+}
+
+// Returns whether any of the slots got a different value
+template <typename T, size_t N>
+static bool SetSlots(T (&boundValues)[N], UINT startSlot, UINT count, const T* values)
+{
+	Assert(startSlot + count <= N);
+	auto hasChanged = false;
+
+	for (UINT i = 0; i < count; i++)
+	{
+		if (boundValues[startSlot + i] != values[i])
+		{
+			boundValues[startSlot + i] = values[i];
+			hasChanged = true;
+		}
+	}
+
+	return hasChanged;
+}
+
+template <typename T>
+static inline bool SetValue(T& boundValue, const T& value)
+{
+	if (boundValue == value)
+	{
+		return false;
+	}
+
+	boundValue = value;
+	return true;
+}
+
+RecordingDeviceContext::RecordingDeviceContext(unique_ptr<IDeviceContext> target) :
+	m_Target(std::move(target))
+{
+	ZeroMemory(&m_BoundState, sizeof(m_BoundState));
+}
+
+RecordingDeviceContext::~RecordingDeviceContext()
+{
+}
+
+void RecordingDeviceContext::Record(DeviceContextCall call, bool hasChangedState, unsigned int startSlot, unsigned int count, const void* object, unsigned int instanceCount)
+{
+	DeviceContextCallRecord record;
+
+	record.call = call;
+	record.startSlot = startSlot;
+	record.count = count;
+	record.instanceCount = instanceCount;
+	record.object = object;
+	record.isRedundant = !hasChangedState;
+
+	m_FrameLog.push_back(record);
+	m_FrameStatistics.callCounts[call]++;
+
+	if (!hasChangedState)
+	{
+		m_FrameStatistics.redundantCallCounts[call]++;
+	}
+}
+
+// Binding without offsets binds the whole buffer
+bool RecordingDeviceContext::SetConstantBuffers(ShaderStageState& stage, UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, 
+	const UINT* firstConstants, const UINT* constantCounts)
+{
+	auto hasChanged = SetSlots(stage.constantBuffers, startSlot, bufferCount, constantBuffers);
+
+	for (UINT i = 0; i < bufferCount; i++)
+	{
+		hasChanged |= SetValue(stage.firstConstants[startSlot + i], firstConstants != nullptr ? firstConstants[i] : 0u);
+		hasChanged |= SetValue(stage.constantCounts[startSlot + i], constantCounts != nullptr ? constantCounts[i] : static_cast<UINT>(D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT));
+	}
+
+	return hasChanged;
+}
+
+size_t RecordingDeviceContext::GetBufferSize(ID3D11Resource* resource)
+{
+	D3D11_RESOURCE_DIMENSION dimension;
+	D3D11_BUFFER_DESC bufferDescription;
+
+	if (resource == nullptr)
+	{
+		return 0;
+	}
+
+	resource->GetType(&dimension);
+
+	if (dimension != D3D11_RESOURCE_DIMENSION_BUFFER)
+	{
+		return 0;
+	}
+
+	static_cast<ID3D11Buffer*>(resource)->GetDesc(&bufferDescription);
+	return bufferDescription.ByteWidth;
+}
+
+void RecordingDeviceContext::IASetInputLayout(ID3D11InputLayout* inputLayout)
+{
+	Record(IA_SET_INPUT_LAYOUT, SetValue(m_BoundState.inputLayout, inputLayout), 0, 1, inputLayout);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->IASetInputLayout(inputLayout);
+	}
+}
+
+void RecordingDeviceContext::IASetVertexBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* vertexBuffers, const UINT* strides, const UINT* offsets)
+{
+	auto hasChanged = SetSlots(m_BoundState.vertexBuffers, startSlot, bufferCount, vertexBuffers);
+	hasChanged |= SetSlots(m_BoundState.vertexStrides, startSlot, bufferCount, strides);
+	hasChanged |= SetSlots(m_BoundState.vertexOffsets, startSlot, bufferCount, offsets);
+
+	Record(IA_SET_VERTEX_BUFFERS, hasChanged, startSlot, bufferCount, bufferCount > 0 ? vertexBuffers[0] : nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->IASetVertexBuffers(startSlot, bufferCount, vertexBuffers, strides, offsets);
+	}
+}
+
+void RecordingDeviceContext::IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset)
+{
+	auto hasChanged = SetValue(m_BoundState.indexBuffer, indexBuffer);
+	hasChanged |= SetValue(m_BoundState.indexFormat, format);
+	hasChanged |= SetValue(m_BoundState.indexOffset, offset);
+
+	Record(IA_SET_INDEX_BUFFER, hasChanged, 0, 1, indexBuffer);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->IASetIndexBuffer(indexBuffer, format, offset);
+	}
+}
+
+void RecordingDeviceContext::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+	Record(IA_SET_PRIMITIVE_TOPOLOGY, SetValue(m_BoundState.topology, topology), 0, 1, nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->IASetPrimitiveTopology(topology);
+	}
+}
+
+void RecordingDeviceContext::VSSetShader(ID3D11VertexShader* vertexShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount)
+{
+	Record(VS_SET_SHADER, SetValue(m_BoundState.vertexShader, vertexShader), 0, 1, vertexShader);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->VSSetShader(vertexShader, classInstances, classInstanceCount);
+	}
+}
+
+void RecordingDeviceContext::VSSetConstantBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers)
+{
+	auto hasChanged = SetConstantBuffers(m_BoundState.vertexStage, startSlot, bufferCount, constantBuffers, nullptr, nullptr);
+	Record(VS_SET_CONSTANT_BUFFERS, hasChanged, startSlot, bufferCount, bufferCount > 0 ? constantBuffers[0] : nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->VSSetConstantBuffers(startSlot, bufferCount, constantBuffers);
+	}
+}
+
+void RecordingDeviceContext::VSSetConstantBuffers1(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts)
+{
+	auto hasChanged = SetConstantBuffers(m_BoundState.vertexStage, startSlot, bufferCount, constantBuffers, firstConstants, constantCounts);
+	Record(VS_SET_CONSTANT_BUFFERS, hasChanged, startSlot, bufferCount, bufferCount > 0 ? constantBuffers[0] : nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->VSSetConstantBuffers1(startSlot, bufferCount, constantBuffers, firstConstants, constantCounts);
+	}
+}
+
+void RecordingDeviceContext::VSSetShaderResources(UINT startSlot, UINT viewCount, ID3D11ShaderResourceView* const* shaderResourceViews)
+{
+	auto hasChanged = SetSlots(m_BoundState.vertexStage.shaderResourceViews, startSlot, viewCount, shaderResourceViews);
+	Record(VS_SET_SHADER_RESOURCES, hasChanged, startSlot, viewCount, viewCount > 0 ? shaderResourceViews[0] : nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->VSSetShaderResources(startSlot, viewCount, shaderResourceViews);
+	}
+}
+
+void RecordingDeviceContext::VSSetSamplers(UINT startSlot, UINT samplerCount, ID3D11SamplerState* const* samplers)
+{
+	auto hasChanged = SetSlots(m_BoundState.vertexStage.samplers, startSlot, samplerCount, samplers);
+	Record(VS_SET_SAMPLERS, hasChanged, startSlot, samplerCount, samplerCount > 0 ? samplers[0] : nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->VSSetSamplers(startSlot, samplerCount, samplers);
+	}
+}
+
+void RecordingDeviceContext::PSSetShader(ID3D11PixelShader* pixelShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount)
+{
+	Record(PS_SET_SHADER, SetValue(m_BoundState.pixelShader, pixelShader), 0, 1, pixelShader);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->PSSetShader(pixelShader, classInstances, classInstanceCount);
+	}
+}
+
+void RecordingDeviceContext::PSSetConstantBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers)
+{
+	auto hasChanged = SetConstantBuffers(m_BoundState.pixelStage, startSlot, bufferCount, constantBuffers, nullptr, nullptr);
+	Record(PS_SET_CONSTANT_BUFFERS, hasChanged, startSlot, bufferCount, bufferCount > 0 ? constantBuffers[0] : nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->PSSetConstantBuffers(startSlot, bufferCount, constantBuffers);
+	}
+}
+
+void RecordingDeviceContext::PSSetConstantBuffers1(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts)
+{
+	auto hasChanged = SetConstantBuffers(m_BoundState.pixelStage, startSlot, bufferCount, constantBuffers, firstConstants, constantCounts);
+	Record(PS_SET_CONSTANT_BUFFERS, hasChanged, startSlot, bufferCount, bufferCount > 0 ? constantBuffers[0] : nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->PSSetConstantBuffers1(startSlot, bufferCount, constantBuffers, firstConstants, constantCounts);
+	}
+}
+
+void RecordingDeviceContext::PSSetShaderResources(UINT startSlot, UINT viewCount, ID3D11ShaderResourceView* const* shaderResourceViews)
+{
+	auto hasChanged = SetSlots(m_BoundState.pixelStage.shaderResourceViews, startSlot, viewCount, shaderResourceViews);
+	Record(PS_SET_SHADER_RESOURCES, hasChanged, startSlot, viewCount, viewCount > 0 ? shaderResourceViews[0] : nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->PSSetShaderResources(startSlot, viewCount, shaderResourceViews);
+	}
+}
+
+void RecordingDeviceContext::PSSetSamplers(UINT startSlot, UINT samplerCount, ID3D11SamplerState* const* samplers)
+{
+	auto hasChanged = SetSlots(m_BoundState.pixelStage.samplers, startSlot, samplerCount, samplers);
+	Record(PS_SET_SAMPLERS, hasChanged, startSlot, samplerCount, samplerCount > 0 ? samplers[0] : nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->PSSetSamplers(startSlot, samplerCount, samplers);
+	}
+}
+
+void RecordingDeviceContext::RSSetState(ID3D11RasterizerState* rasterizerState)
+{
+	Record(RS_SET_STATE, SetValue(m_BoundState.rasterizerState, rasterizerState), 0, 1, rasterizerState);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->RSSetState(rasterizerState);
+	}
+}
+
+// Only the first viewport is tracked, nothing here uses more
+void RecordingDeviceContext::RSSetViewports(UINT viewportCount, const D3D11_VIEWPORT* viewports)
+{
+	auto hasChanged = viewportCount != 1 || memcmp(&m_BoundState.viewport, viewports, sizeof(D3D11_VIEWPORT)) != 0;
+
+	if (viewportCount > 0)
+	{
+		m_BoundState.viewport = viewports[0];
+	}
+
+	Record(RS_SET_VIEWPORTS, hasChanged, 0, viewportCount, nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->RSSetViewports(viewportCount, viewports);
+	}
+}
+
+void RecordingDeviceContext::OMSetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask)
+{
+	static const FLOAT kDefaultBlendFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	auto hasChanged = SetValue(m_BoundState.blendState, blendState);
+	hasChanged |= SetSlots(m_BoundState.blendFactor, 0, 4, blendFactor != nullptr ? blendFactor : kDefaultBlendFactor);
+	hasChanged |= SetValue(m_BoundState.sampleMask, sampleMask);
+
+	Record(OM_SET_BLEND_STATE, hasChanged, 0, 1, blendState);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->OMSetBlendState(blendState, blendFactor, sampleMask);
+	}
+}
+
+void RecordingDeviceContext::OMSetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef)
+{
+	auto hasChanged = SetValue(m_BoundState.depthStencilState, depthStencilState);
+	hasChanged |= SetValue(m_BoundState.stencilRef, stencilRef);
+
+	Record(OM_SET_DEPTH_STENCIL_STATE, hasChanged, 0, 1, depthStencilState);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->OMSetDepthStencilState(depthStencilState, stencilRef);
+	}
+}
+
+// Render targets past the ones given get unbound
+void RecordingDeviceContext::OMSetRenderTargets(UINT viewCount, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView)
+{
+	static ID3D11RenderTargetView* const kNullViews[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT] = { nullptr };
+	auto hasChanged = SetSlots(m_BoundState.renderTargetViews, 0, viewCount, renderTargetViews);
+	hasChanged |= SetSlots(m_BoundState.renderTargetViews, viewCount, D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT - viewCount, kNullViews);
+	hasChanged |= SetValue(m_BoundState.depthStencilView, depthStencilView);
+
+	Record(OM_SET_RENDER_TARGETS, hasChanged, 0, viewCount, viewCount > 0 ? renderTargetViews[0] : nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->OMSetRenderTargets(viewCount, renderTargetViews, depthStencilView);
+	}
+}
+
+void RecordingDeviceContext::ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT color[4])
+{
+	Record(CLEAR_RENDER_TARGET_VIEW, true, 0, 1, renderTargetView);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->ClearRenderTargetView(renderTargetView, color);
+	}
+}
+
+void RecordingDeviceContext::ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil)
+{
+	Record(CLEAR_DEPTH_STENCIL_VIEW, true, 0, 1, depthStencilView);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->ClearDepthStencilView(depthStencilView, clearFlags, depth, stencil);
+	}
+}
+
+// Buffers mapped to be written from scratch count as uploaded whole. What gets appended to a buffer without overwriting
+// is only as big as what the caller writes, which can't be seen from here, so those maps are only counted
+HRESULT RecordingDeviceContext::Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource)
+{
+	auto size = GetBufferSize(resource);
+
+	if (mapType == D3D11_MAP_WRITE_DISCARD || mapType == D3D11_MAP_WRITE)
+	{
+		m_FrameStatistics.uploadedByteCount += size;
+	}
+
+	Record(MAP, true, subresource, static_cast<unsigned int>(size), resource);
+
+	if (m_Target != nullptr)
+	{
+		return m_Target->Map(resource, subresource, mapType, mapFlags, mappedResource);
+	}
+
+	// Only buffers get mapped, and their contents are kept between maps, like no overwrite maps expect
+	Assert(size > 0);
+	auto& memory = m_ScratchMemory[resource];
+
+	if (memory.size() < size)
+	{
+		memory.resize(size);
+	}
+
+	mappedResource->pData = memory.data();
+	mappedResource->RowPitch = static_cast<UINT>(size);
+	mappedResource->DepthPitch = static_cast<UINT>(size);
+	return S_OK;
+}
+
+void RecordingDeviceContext::Unmap(ID3D11Resource* resource, UINT subresource)
+{
+	Record(UNMAP, true, subresource, 0, resource);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->Unmap(resource, subresource);
+	}
+}
+
+void RecordingDeviceContext::Draw(UINT vertexCount, UINT startVertexLocation)
+{
+	Record(DRAW, true, startVertexLocation, vertexCount, nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->Draw(vertexCount, startVertexLocation);
+	}
+}
+
+void RecordingDeviceContext::DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation)
+{
+	Record(DRAW_INDEXED, true, startIndexLocation, indexCount, nullptr);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->DrawIndexed(indexCount, startIndexLocation, baseVertexLocation);
+	}
+}
+
+void RecordingDeviceContext::DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation)
+{
+	Record(DRAW_INDEXED_INSTANCED, true, startIndexLocation, indexCountPerInstance, nullptr, instanceCount);
+
+	if (m_Target != nullptr)
+	{
+		m_Target->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
+	}
+}
+
+// Bound state carries over to the next frame, just like it does on the device context
+void RecordingDeviceContext::EndFrame()
+{
+	m_FrameStatistics.frameCount = 1;
+	m_TotalStatistics.Add(m_FrameStatistics);
+	m_LastFrameStatistics = m_FrameStatistics;
+	m_FrameStatistics = DeviceContextStatistics();
+
+	swap(m_FrameLog, m_LastFrameLog);
+	m_FrameLog.clear();
+}
+
+// Returns statistics of the frames since the last call
+DeviceContextStatistics RecordingDeviceContext::ConsumeStatistics()
+{
+	auto statistics = m_TotalStatistics;
+	m_TotalStatistics = DeviceContextStatistics();
+
+	return statistics;
+}
+
+void RecordingDeviceContext::WriteLastFrameLog(wostream& output) const
+{
+	for (const auto& record : m_LastFrameLog)
+	{
+		output << kCallNames[record.call] << L"(" << record.startSlot << L", " << record.count;
+
+		if (record.instanceCount != 1)
+		{
+			output << L", " << record.instanceCount << L" instances";
+		}
+
+		if (record.object != nullptr)
+		{
+			output << L", " << record.object;
+		}
+
+		output << L")" << (record.isRedundant ? L" redundant" : L"") << endl;
+	}
+
+	output << endl;
+
+	for (int i = 0; i < DEVICE_CONTEXT_CALL_COUNT; i++)
+	{
+		output << kCallNames[i] << L": " << m_LastFrameStatistics.callCounts[i] << L" calls, " << m_LastFrameStatistics.redundantCallCounts[i] << L" redundant" << endl;
+	}
+
+	output << L"Uploaded: " << m_LastFrameStatistics.uploadedByteCount << L" bytes" << endl;
+}
\ No newline at end of file
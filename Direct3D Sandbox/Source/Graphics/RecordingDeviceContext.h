@@ -0,0 +1,161 @@
+#pragma once
+
+#include "IDeviceContext.h"
+
+enum DeviceContextCall
+{
+	IA_SET_INPUT_LAYOUT = 0,
+	IA_SET_VERTEX_BUFFERS,
+	IA_SET_INDEX_BUFFER,
+	IA_SET_PRIMITIVE_TOPOLOGY,
+	VS_SET_SHADER,
+	VS_SET_CONSTANT_BUFFERS,		// Bound by offset or not
+	VS_SET_SHADER_RESOURCES,
+	VS_SET_SAMPLERS,
+	PS_SET_SHADER,
+	PS_SET_CONSTANT_BUFFERS,
+	PS_SET_SHADER_RESOURCES,
+	PS_SET_SAMPLERS,
+	RS_SET_STATE,
+	RS_SET_VIEWPORTS,
+	OM_SET_BLEND_STATE,
+	OM_SET_DEPTH_STENCIL_STATE,
+	OM_SET_RENDER_TARGETS,
+	CLEAR_RENDER_TARGET_VIEW,
+	CLEAR_DEPTH_STENCIL_VIEW,
+	MAP,
+	UNMAP,
+	DRAW,
+	DRAW_INDEXED,
+	DRAW_INDEXED_INSTANCED,
+	DEVICE_CONTEXT_CALL_COUNT
+};
+
+struct DeviceContextCallRecord
+{
+	DeviceContextCall call;
+	unsigned int startSlot;
+	unsigned int count;				// Slots bound, vertices or indices drawn per instance, or bytes mapped
+	unsigned int instanceCount;
+	const void* object;				// First thing bound, or the mapped resource
+	bool isRedundant;				// Didn't change anything that was bound
+};
+
+struct DeviceContextStatistics
+{
+	unsigned int frameCount;
+	unsigned int callCounts[DEVICE_CONTEXT_CALL_COUNT];
+	unsigned int redundantCallCounts[DEVICE_CONTEXT_CALL_COUNT];
+	size_t uploadedByteCount;		// Bytes of buffers mapped for writing from scratch
+
+	DeviceContextStatistics();
+
+	void Add(const DeviceContextStatistics& other);
+	unsigned int GetDrawCount() const;
+	unsigned int GetStateCallCount() const;
+	unsigned int GetRedundantCallCount() const;
+};
+
+// Counts and logs every call made in a frame before passing it on, and tells which binds left the bound state as it was.
+// Without a target nothing gets passed on, and maps hand out memory of the recorder's own, so it can stand in for a device context
+class RecordingDeviceContext : public IDeviceContext
+{
+private:
+	struct ShaderStageState
+	{
+		ID3D11Buffer* constantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+		UINT firstConstants[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+		UINT constantCounts[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+		ID3D11ShaderResourceView* shaderResourceViews[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+		ID3D11SamplerState* samplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
+	};
+
+	// What the recorder believes is bound. With a target, the context holds references to whatever is bound, so pointers can't get reused while they're here.
+	// Without one nothing holds them: an object created where a released one used to be looks like the same binding, so redundancy counts are approximate
+	struct BoundState
+	{
+		ID3D11InputLayout* inputLayout;
+		ID3D11Buffer* vertexBuffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+		UINT vertexStrides[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+		UINT vertexOffsets[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+		ID3D11Buffer* indexBuffer;
+		DXGI_FORMAT indexFormat;
+		UINT indexOffset;
+		D3D11_PRIMITIVE_TOPOLOGY topology;
+		ID3D11VertexShader* vertexShader;
+		ID3D11PixelShader* pixelShader;
+		ShaderStageState vertexStage;
+		ShaderStageState pixelStage;
+		ID3D11RasterizerState* rasterizerState;
+		D3D11_VIEWPORT viewport;
+		ID3D11BlendState* blendState;
+		FLOAT blendFactor[4];
+		UINT sampleMask;
+		ID3D11DepthStencilState* depthStencilState;
+		UINT stencilRef;
+		ID3D11RenderTargetView* renderTargetViews[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
+		ID3D11DepthStencilView* depthStencilView;
+	};
+
+	unique_ptr<IDeviceContext> m_Target;
+	BoundState m_BoundState;
+	unordered_map<ID3D11Resource*, vector<uint8_t>> m_ScratchMemory;
+
+	vector<DeviceContextCallRecord> m_FrameLog;
+	vector<DeviceContextCallRecord> m_LastFrameLog;
+	DeviceContextStatistics m_FrameStatistics;
+	DeviceContextStatistics m_LastFrameStatistics;
+	DeviceContextStatistics m_TotalStatistics;
+
+	void Record(DeviceContextCall call, bool hasChangedState, unsigned int startSlot, unsigned int count, const void* object, unsigned int instanceCount = 1);
+	bool SetConstantBuffers(ShaderStageState& stage, UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts);
+	static size_t GetBufferSize(ID3D11Resource* resource);
+
+public:
+	static const char* const kCallNames[DEVICE_CONTEXT_CALL_COUNT];
+
+	// Target may be null
+	RecordingDeviceContext(unique_ptr<IDeviceContext> target);
+	virtual ~RecordingDeviceContext();
+
+	virtual void IASetInputLayout(ID3D11InputLayout* inputLayout);
+	virtual void IASetVertexBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* vertexBuffers, const UINT* strides, const UINT* offsets);
+	virtual void IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset);
+	virtual void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
+
+	virtual void VSSetShader(ID3D11VertexShader* vertexShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount);
+	virtual void VSSetConstantBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers);
+	virtual void VSSetConstantBuffers1(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts);
+	virtual void VSSetShaderResources(UINT startSlot, UINT viewCount, ID3D11ShaderResourceView* const* shaderResourceViews);
+	virtual void VSSetSamplers(UINT startSlot, UINT samplerCount, ID3D11SamplerState* const* samplers);
+
+	virtual void PSSetShader(ID3D11PixelShader* pixelShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount);
+	virtual void PSSetConstantBuffers(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers);
+	virtual void PSSetConstantBuffers1(UINT startSlot, UINT bufferCount, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts);
+	virtual void PSSetShaderResources(UINT startSlot, UINT viewCount, ID3D11ShaderResourceView* const* shaderResourceViews);
+	virtual void PSSetSamplers(UINT startSlot, UINT samplerCount, ID3D11SamplerState* const* samplers);
+
+	virtual void RSSetState(ID3D11RasterizerState* rasterizerState);
+	virtual void RSSetViewports(UINT viewportCount, const D3D11_VIEWPORT* viewports);
+	virtual void OMSetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask);
+	virtual void OMSetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef);
+	virtual void OMSetRenderTargets(UINT viewCount, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView);
+
+	virtual void ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT color[4]);
+	virtual void ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil);
+
+	virtual HRESULT Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource);
+	virtual void Unmap(ID3D11Resource* resource, UINT subresource);
+
+	virtual void Draw(UINT vertexCount, UINT startVertexLocation);
+	virtual void DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation);
+	virtual void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation);
+
+	void EndFrame();
+
+	inline const vector<DeviceContextCallRecord>& GetLastFrameLog() const { return m_LastFrameLog; }
+	inline const DeviceContextStatistics& GetLastFrameStatistics() const { return m_LastFrameStatistics; }
+	DeviceContextStatistics ConsumeStatistics();
+
+	void WriteLastFrameLog(wostream& output) const;
+};
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "PrecompiledHeader.h"
+#include "ConstantRingBuffer.h"
+#include "IShader.h"
+#include "Parameters.h"
+#include "Profiler.h"
+#include "RenderQueue.h"
+#include "Source\Models\IModelInstance.h"
+#include "Tools.h"
+
+const unsigned int RenderQueue::kPassBits = 4;
+const unsigned int RenderQueue::kShaderBits = 8;
+const unsigned int RenderQueue::kTextureBits = 16;
+const unsigned int RenderQueue::kModelBits = 16;
+const unsigned int RenderQueue::kDepthBits = 20;
+
+static_assert(RenderQueue::kPassBits + RenderQueue::kShaderBits + RenderQueue::kTextureBits + RenderQueue::kModelBits + RenderQueue::kDepthBits == 64,
+			  "Sort key fields have to fill exactly 64 bits");
+
+static const unsigned int kRadixBits = 8;
+static const unsigned int kRadixSize = 1 << kRadixBits;
+
+RenderQueue::RenderQueue()
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+// Textures don't have ids of their own, so their pointers get hashed. Textures that hash the same only sort less well,
+// state diffing looks at the real pointers. Squared distance is positive, so its float bits order the same way as its value
+uint64_t RenderQueue::MakeSortKey(unsigned int pass, unsigned int shaderId, ID3D11ShaderResourceView* texture, unsigned int modelId, float distanceSqr)
+{
+	Assert(pass < (1u << kPassBits) && shaderId < (1u << kShaderBits) && modelId < (1u << kModelBits));
+	Assert(distanceSqr >= 0.0f);
+
+	auto texturePointer = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(texture));
+	auto textureHash = static_cast<unsigned int>((texturePointer * 0x9E3779B97F4A7C15ull) >> (64 - kTextureBits));
+
+	uint32_t distanceBits;
+	memcpy(&distanceBits, &distanceSqr, sizeof(distanceBits));
+	auto depth = distanceBits >> (32 - 1 - kDepthBits);
+
+	auto key = static_cast<uint64_t>(pass);
+	key = (key << kShaderBits) | shaderId;
+	key = (key << kTextureBits) | textureHash;
+	key = (key << kModelBits) | modelId;
+	key = (key << kDepthBits) | depth;
+
+	return key;
+}
+
+// Least significant digit first radix sort, one byte of the key per pass. It's stable, so packets with equal keys keep the order
+// they were added in. Passes over bytes that are the same in every key don't change the order and get skipped
+void RenderQueue::Sort()
+{
+	auto count = static_cast<unsigned int>(m_Packets.size());
+	unsigned int histogram[kRadixSize];
+
+	m_SortEntries.resize(count);
+	m_SortScratch.resize(count);
+
+	for (auto i = 0u; i < count; i++)
+	{
+		m_SortEntries[i].key = m_Packets[i].sortKey;
+		m_SortEntries[i].packetIndex = i;
+	}
+
+	for (auto shift = 0u; shift < 64; shift += kRadixBits)
+	{
+		memset(histogram, 0, sizeof(histogram));
+
+		for (const auto& entry : m_SortEntries)
+		{
+			histogram[(entry.key >> shift) & (kRadixSize - 1)]++;
+		}
+
+		if (histogram[(m_SortEntries[0].key >> shift) & (kRadixSize - 1)] == count)
+		{
+			continue;
+		}
+
+		auto offset = 0u;
+
+		for (auto digit = 0u; digit < kRadixSize; digit++)
+		{
+			auto digitCount = histogram[digit];
+			histogram[digit] = offset;
+			offset += digitCount;
+		}
+
+		for (const auto& entry : m_SortEntries)
+		{
+			m_SortScratch[histogram[(entry.key >> shift) & (kRadixSize - 1)]++] = entry;
+		}
+
+		m_SortEntries.swap(m_SortScratch);
+	}
+}
+
+void RenderQueue::CountStateChanges(const DrawPacket& previous, const DrawPacket& current)
+{
+	if (previous.shader != current.shader)
+	{
+		m_Statistics.shaderChanges++;
+	}
+	else
+	{
+		m_Statistics.avoidedStateChanges++;
+	}
+
+	if (previous.texture != current.texture)
+	{
+		m_Statistics.textureChanges++;
+	}
+	else
+	{
+		m_Statistics.avoidedStateChanges++;
+	}
+
+	if (previous.model != current.model)
+	{
+		m_Statistics.modelChanges++;
+	}
+	else
+	{
+		m_Statistics.avoidedStateChanges++;
+	}
+}
+
+// Stages the constants of as many packets from first on as the constant ring buffer fits at once, all with one map, and returns where they end.
+// The packets then have to be drawn from the same render parameters, so that they change the same way and every draw binds the constants staged for it
+unsigned int RenderQueue::StageConstants(unsigned int first, RenderParameters& renderParameters)
+{
+	auto count = static_cast<unsigned int>(m_SortEntries.size());
+	auto last = first;
+	auto size = 0u;
+
+	while (last < count)
+	{
+		auto packetSize = m_Packets[m_SortEntries[last].packetIndex].shader->GetConstantRingSize();
+
+		if (last > first && size + packetSize > ConstantRingBuffer::kSize)
+		{
+			break;
+		}
+
+		size += packetSize;
+		last++;
+	}
+
+	m_SavedParameters.resize(sizeof(RenderParameters));
+	memcpy(m_SavedParameters.data(), &renderParameters, sizeof(RenderParameters));
+
+	ConstantRingBuffer::BeginBatch(size);
+
+	for (auto i = first; i < last; i++)
+	{
+		m_Packets[m_SortEntries[i].packetIndex].instance->Stage3D(renderParameters);
+	}
+
+	ConstantRingBuffer::EndBatch();
+	m_Statistics.constantBatchCount++;
+
+	memcpy(&renderParameters, m_SavedParameters.data(), sizeof(RenderParameters));
+	return last;
+}
+
+void RenderQueue::Draw(unsigned int first, unsigned int last, RenderParameters& renderParameters)
+{
+	for (auto i = first; i < last; i++)
+	{
+		const auto& packet = m_Packets[m_SortEntries[i].packetIndex];
+
+		if (i > 0)
+		{
+			CountStateChanges(m_Packets[m_SortEntries[i - 1].packetIndex], packet);
+		}
+		else
+		{
+			m_Statistics.shaderChanges++;
+			m_Statistics.textureChanges++;
+			m_Statistics.modelChanges++;
+		}
+
+		packet.instance->Render3D(renderParameters);
+	}
+}
+
+// Draws every packet added since the last call and empties the queue. Without the constant ring buffer every draw uploads its own constants
+void RenderQueue::Submit(RenderParameters& renderParameters)
+{
+	PROFILE_SCOPE("Render queue");
+
+	if (m_Packets.empty())
+	{
+		return;
+	}
+
+	Sort();
+
+	auto count = static_cast<unsigned int>(m_SortEntries.size());
+	auto first = 0u;
+
+	while (first < count)
+	{
+		auto last = ConstantRingBuffer::IsSupported() ? StageConstants(first, renderParameters) : count;
+
+		Draw(first, last, renderParameters);
+		first = last;
+	}
+
+	m_Statistics.drawCount += count;
+	m_Packets.clear();
+}
+
+RenderQueueStatistics RenderQueue::ConsumeStatistics()
+{
+	auto statistics = m_Statistics;
+	m_Statistics = RenderQueueStatistics();
+
+	return statistics;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+class IModel;
+class IModelInstance;
+class IShader;
+struct RenderParameters;
+
+struct DrawPacket
+{
+	uint64_t sortKey;
+	IModelInstance* instance;
+	const IShader* shader;
+	const IModel* model;
+	ID3D11ShaderResourceView* texture;
+};
+
+struct RenderQueueStatistics
+{
+	unsigned int drawCount;
+	unsigned int shaderChanges;
+	unsigned int textureChanges;
+	unsigned int modelChanges;
+	unsigned int avoidedStateChanges;		// Shaders, textures and models that the previous draw had already set
+	unsigned int constantBatchCount;		// Maps of the constant ring buffer that staged the constants of the packets
+
+	RenderQueueStatistics() : drawCount(0), shaderChanges(0), textureChanges(0), modelChanges(0), avoidedStateChanges(0), constantBatchCount(0) {}
+};
+
+// 3D models don't draw themselves as they get rendered, they add a draw packet instead. Once the whole scene has been added,
+// packets get radix sorted by their key and drawn in that order, so draws sharing a shader, texture and model end up next to each other,
+// and front to back within those. Sort key from the most significant bits: pass, shader, texture, model, depth.
+// Constants of every packet get staged first and written to the constant ring buffer with a single map, then the packets get drawn binding them by offset.
+// Binding is still done by the shaders and models, which skip what is already bound; the queue diffs packets to count state changes
+class RenderQueue
+{
+private:
+	struct SortEntry
+	{
+		uint64_t key;
+		unsigned int packetIndex;
+	};
+
+	vector<DrawPacket> m_Packets;
+	vector<SortEntry> m_SortEntries;
+	vector<SortEntry> m_SortScratch;
+	vector<uint8_t> m_SavedParameters;
+	RenderQueueStatistics m_Statistics;
+
+	void Sort();
+	unsigned int StageConstants(unsigned int first, RenderParameters& renderParameters);
+	void Draw(unsigned int first, unsigned int last, RenderParameters& renderParameters);
+	void CountStateChanges(const DrawPacket& previous, const DrawPacket& current);
+
+	RenderQueue(const RenderQueue& other);				// Not implemented (no copying allowed)
+	RenderQueue& operator=(const RenderQueue& other);	// Not implemented (no copying allowed)
+
+public:
+	static const unsigned int kPassBits;
+	static const unsigned int kShaderBits;
+	static const unsigned int kTextureBits;
+	static const unsigned int kModelBits;
+	static const unsigned int kDepthBits;
+
+	RenderQueue();
+	~RenderQueue();
+
+	static uint64_t MakeSortKey(unsigned int pass, unsigned int shaderId, ID3D11ShaderResourceView* texture, unsigned int modelId, float distanceSqr);
+
+	inline void Add(const DrawPacket& packet) { m_Packets.push_back(packet); }
+	void Submit(RenderParameters& renderParameters);
+
+	RenderQueueStatistics ConsumeStatistics();
+};
\ No newline at end of file
@@ -4,7 +4,10 @@
 #include "ShaderProgram.h"
 #include "Tools.h"
 
-ShaderProgram::ShaderProgram()
+ShaderProgram::ShaderProgram() :
+	m_HaveConstantBufferOffsetsChanged(false),
+	m_StagedDrawCount(0),
+	m_NextStagedDraw(0)
 {	
 }
 
@@ -33,6 +36,8 @@ void ShaderProgram::ReflectConstantBuffers(const vector<uint8_t>& metadataBuffer
 	{
 		m_ConstantBuffers.emplace_back(metadataBuffer, byteOffset);
 		m_ConstantBufferPtrs.push_back(m_ConstantBuffers[i].GetPtr());
+		m_FirstConstants.push_back(0);
+		m_ConstantCounts.push_back(m_ConstantBuffers[i].GetConstantCount());
 	}
 }
 
@@ -52,7 +57,7 @@ void ShaderProgram::ReflectOtherResources(const vector<uint8_t>& metadataBuffer)
 		switch (resourceType)
 		{
 		case D3D_SIT_TEXTURE:
-			AddTextureOffset(resourceName);
+			AddTextureField(resourceName);
 			break;
 
 		case D3D_SIT_SAMPLER:
@@ -61,15 +66,12 @@ void ShaderProgram::ReflectOtherResources(const vector<uint8_t>& metadataBuffer)
 		}
 	}
 
-	m_Textures.resize(m_TextureOffsets.size());
+	m_Textures.resize(m_TextureFields.size());
 }
 
-void ShaderProgram::AddTextureOffset(const string& name)
+void ShaderProgram::AddTextureField(const string& name)
 {
-	auto offset = RenderParameters::GetFieldByteOffset(name);
-	Assert(offset != 0xFFFFFFFF);
-
-	m_TextureOffsets.push_back(offset);
+	m_TextureFields.push_back(RenderParameters::GetField<ID3D11ShaderResourceView*>(name));
 }
 
 void ShaderProgram::AddSamplerState(const string& name)
@@ -78,29 +80,103 @@ void ShaderProgram::AddSamplerState(const string& name)
 	m_SamplerStates.push_back(samplerState.Get());
 }
 
-void ShaderProgram::SetRenderParameters(const RenderParameters& renderParameters)
+// The most bytes of the constant ring buffer that the program can need for a single draw
+unsigned int ShaderProgram::GetConstantRingSize() const
 {
+	auto size = 0u;
+
+	for (const auto& buffer : m_ConstantBuffers)
+	{
+		size += buffer.GetRingSize();
+	}
+
+	return size;
+}
+
+// Returns how many bytes of the constant ring buffer the constant buffers that have to be uploaded need
+unsigned int ShaderProgram::StageConstantBuffers(const RenderParameters& renderParameters)
+{
+	auto size = 0u;
+
 	for (auto& buffer : m_ConstantBuffers)
 	{
-		buffer.SetRenderParameters(renderParameters);
+		if (buffer.StageRenderParameters(renderParameters))
+		{
+			size += buffer.GetRingSize();
+		}
+	}
+
+	return size;
+}
+
+void ShaderProgram::UploadConstantBuffers(uint8_t*& destination, unsigned int& firstConstant)
+{
+	for (auto i = 0u; i < m_ConstantBuffers.size(); i++)
+	{
+		auto& buffer = m_ConstantBuffers[i];
+
+		if (buffer.NeedsRingUpload())
+		{
+			buffer.UploadToRing(destination, firstConstant);
+			m_FirstConstants[i] = buffer.GetFirstConstant();
+			m_HaveConstantBufferOffsetsChanged = true;
+		}
+	}
+}
+
+// Remembers where the constant buffers just uploaded are, for a draw that only gets made once everything staged with it is uploaded
+void ShaderProgram::SaveStagedDraw()
+{
+	m_StagedFirstConstants.insert(m_StagedFirstConstants.end(), m_FirstConstants.begin(), m_FirstConstants.end());
+	m_StagedDrawCount++;
+}
+
+// Draws get made in the order they were staged in, so each one takes the offsets of the next staged draw
+void ShaderProgram::RestoreNextStagedDraw()
+{
+	Assert(HasStagedDraws());
+
+	auto staged = m_StagedFirstConstants.begin() + m_NextStagedDraw * m_FirstConstants.size();
+
+	if (!equal(m_FirstConstants.begin(), m_FirstConstants.end(), staged))
+	{
+		copy(staged, staged + m_FirstConstants.size(), m_FirstConstants.begin());
+		m_HaveConstantBufferOffsetsChanged = true;
 	}
-	
+
+	if (++m_NextStagedDraw == m_StagedDrawCount)
+	{
+		ClearStagedDraws();
+	}
+}
+
+void ShaderProgram::ClearStagedDraws()
+{
+	m_StagedFirstConstants.clear();
+	m_StagedDrawCount = 0;
+	m_NextStagedDraw = 0;
+}
+
+// Constant buffers have to be staged and uploaded before this
+void ShaderProgram::SetRenderParameters(const RenderParameters& renderParameters)
+{
 	SetConstantBuffers();
 	SetTextures(renderParameters);
 	SetSamplers();
 }
 
-void ShaderProgram::SetConstantBuffers() const
+void ShaderProgram::SetConstantBuffers()
 {
 	if (m_ConstantBufferPtrs.size() > 0)
 	{
-		SetConstantBuffersImpl();
+		SetConstantBuffersImpl(m_HaveConstantBufferOffsetsChanged);
+		m_HaveConstantBufferOffsetsChanged = false;
 	}
 }
 
 void ShaderProgram::SetTextures(const RenderParameters& renderParameters)
 {	
-	const auto textureCount = m_TextureOffsets.size();
+	const auto textureCount = m_TextureFields.size();
 	static ShaderProgram* shaderWhichLastSet = nullptr;
 
 	if (textureCount > 0)
@@ -109,10 +185,12 @@ void ShaderProgram::SetTextures(const RenderParameters& renderParameters)
 
 		for (auto i = 0u; i < textureCount; i++)
 		{
-			if (memcmp(&m_Textures[i], reinterpret_cast<const uint8_t*>(&renderParameters) + m_TextureOffsets[i], sizeof(ID3D11ShaderResourceView*)) != 0)
+			auto texture = m_TextureFields[i].Get(renderParameters);
+
+			if (m_Textures[i] != texture)
 			{
 				textureChanged = true;
-				memcpy(&m_Textures[i], reinterpret_cast<const uint8_t*>(&renderParameters) + m_TextureOffsets[i], sizeof(ID3D11ShaderResourceView*));
+				m_Textures[i] = texture;
 			}
 		}
 
@@ -1,13 +1,20 @@
 #pragma once
 
 #include "ConstantBuffer.h"
+#include "Parameters.h"
 
 class ShaderProgram
 {
 protected:
 	vector<ConstantBuffer> m_ConstantBuffers;
 	vector<ID3D11Buffer*> m_ConstantBufferPtrs;
-	vector<unsigned int> m_TextureOffsets;
+	vector<UINT> m_FirstConstants;
+	vector<UINT> m_ConstantCounts;
+	bool m_HaveConstantBufferOffsetsChanged;
+	vector<UINT> m_StagedFirstConstants;		// Where the constant buffers of every draw staged ahead are, one draw after another
+	unsigned int m_StagedDrawCount;
+	unsigned int m_NextStagedDraw;
+	vector<ParameterField<RenderParameters, ID3D11ShaderResourceView*>> m_TextureFields;
 	
 	vector<ID3D11ShaderResourceView*> m_Textures;
 	vector<ID3D11SamplerState*> m_SamplerStates;
@@ -15,7 +22,7 @@ protected:
 	ShaderProgram();
 	virtual void Reflect(const vector<uint8_t>& shaderBuffer, const vector<uint8_t>& metadataBuffer);
 
-	virtual void SetConstantBuffersImpl() const = 0;
+	virtual void SetConstantBuffersImpl(bool haveOffsetsChanged) const = 0;
 	virtual void SetTexturesImpl() = 0;
 	virtual void SetSamplersImpl() const = 0;
 
@@ -23,16 +30,25 @@ private:
 	void ReflectConstantBuffers(const vector<uint8_t>& metadataBuffer);
 	void ReflectOtherResources(const vector<uint8_t>& metadataBuffer);
 
-	void AddTextureOffset(const string& name);
+	void AddTextureField(const string& name);
 	void AddSamplerState(const string& name);
 		
-	void SetConstantBuffers() const;
+	void SetConstantBuffers();
 	void SetTextures(const RenderParameters& renderParameters);
 	void SetSamplers() const;
 
 public:
 	virtual ~ShaderProgram();
 	
+	unsigned int GetConstantRingSize() const;
+	unsigned int StageConstantBuffers(const RenderParameters& renderParameters);
+	void UploadConstantBuffers(uint8_t*& destination, unsigned int& firstConstant);
+
+	void SaveStagedDraw();
+	void RestoreNextStagedDraw();
+	void ClearStagedDraws();
+	inline bool HasStagedDraws() const { return m_NextStagedDraw < m_StagedDrawCount; }
+
 	virtual void SetRenderParameters(const RenderParameters& renderParameters);
 };
 
@@ -1,23 +1,75 @@
 #include "PrecompiledHeader.h"
+#include "AssetStreamer.h"
 #include "Direct3D.h"
 #include "Source\External\DirectXTK\DDSTextureLoader.h"
 #include "Texture.h"
 #include "Tools.h"
 
-unordered_map<wstring, ComPtr<ID3D11ShaderResourceView>> Texture::s_Textures;
+unordered_map<wstring, TextureHandle> Texture::s_Textures;
+ComPtr<ID3D11ShaderResourceView> Texture::s_Placeholders[TextureKind::TextureKindCount];
 
-void Texture::LoadTexture(const wstring& path)
+// Colors are RGBA, least significant byte first
+static const uint32_t kPlaceholderColors[TextureKind::TextureKindCount] =
+{
+	0xFF808080,		// Gray
+	0xFFFF8080		// Normal pointing straight out of the surface
+};
+
+ComPtr<ID3D11ShaderResourceView> Texture::CreateSolidColorTexture(uint32_t color)
 {
 	HRESULT result;
+	ComPtr<ID3D11Texture2D> texture2D;
 	ComPtr<ID3D11ShaderResourceView> texture;
+	D3D11_TEXTURE2D_DESC textureDescription;
+	D3D11_SUBRESOURCE_DATA textureData;
+
+	textureDescription.Width = 1;
+	textureDescription.Height = 1;
+	textureDescription.MipLevels = 1;
+	textureDescription.ArraySize = 1;
+	textureDescription.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDescription.SampleDesc.Count = 1;
+	textureDescription.SampleDesc.Quality = 0;
+	textureDescription.Usage = D3D11_USAGE_IMMUTABLE;
+	textureDescription.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	textureDescription.CPUAccessFlags = 0;
+	textureDescription.MiscFlags = 0;
+
+	textureData.pSysMem = &color;
+	textureData.SysMemPitch = sizeof(uint32_t);
+	textureData.SysMemSlicePitch = 0;
 
-	result = DirectX::CreateDDSTextureFromFile(GetD3D11Device(), path.c_str(), nullptr, &texture);
+	result = GetD3D11Device()->CreateTexture2D(&textureDescription, &textureData, &texture2D);
 	Assert(result == S_OK);
 
+	result = GetD3D11Device()->CreateShaderResourceView(texture2D.Get(), nullptr, &texture);
+	Assert(result == S_OK);
+
+	return texture;
+}
+
+// The texture is read and created on a worker thread, Get returns its placeholder until then
+void Texture::LoadTexture(const wstring& path, TextureKind kind)
+{
+	if (s_Placeholders[kind] == nullptr)
+	{
+		s_Placeholders[kind] = CreateSolidColorTexture(kPlaceholderColors[kind]);
+	}
+
+	auto texture = AssetStreamer::Load([path]() -> ComPtr<ID3D11ShaderResourceView>
+	{
+		ComPtr<ID3D11ShaderResourceView> texture;
+
+		auto result = DirectX::CreateDDSTextureFromFile(GetD3D11Device(), path.c_str(), nullptr, &texture);
+		Assert(result == S_OK);
+
+		return texture;
+	}, s_Placeholders[kind]);
+
 	s_Textures.emplace(Tools::ToLower(path), texture);
 }
 
-ComPtr<ID3D11ShaderResourceView> Texture::Get(const wstring& path)
+TextureHandle Texture::Get(const wstring& path)
 {
 	auto texturePath = Tools::ToLower(path);
 	auto texture = s_Textures.find(texturePath);
@@ -1,15 +1,29 @@
 #pragma once
 
+#include "AssetHandle.h"
+
+typedef AssetHandle<ComPtr<ID3D11ShaderResourceView>> TextureHandle;
+
+// Decides what gets drawn while the texture is still loading
+enum TextureKind
+{
+	ColorTexture = 0,
+	NormalMapTexture,
+	TextureKindCount
+};
+
 class Texture
 {
 private:
-	static unordered_map<wstring, ComPtr<ID3D11ShaderResourceView>> s_Textures;
+	static unordered_map<wstring, TextureHandle> s_Textures;
+	static ComPtr<ID3D11ShaderResourceView> s_Placeholders[TextureKind::TextureKindCount];
+
+	static ComPtr<ID3D11ShaderResourceView> CreateSolidColorTexture(uint32_t color);
 
 	Texture();
 	~Texture();
 
 public:	
-	static void LoadTexture(const wstring& path);
-	static ComPtr<ID3D11ShaderResourceView> Get(const wstring& path);
+	static void LoadTexture(const wstring& path, TextureKind kind = TextureKind::ColorTexture);
+	static TextureHandle Get(const wstring& path);
 };
-
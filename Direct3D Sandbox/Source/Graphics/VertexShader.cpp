@@ -1,7 +1,9 @@
 #include "PrecompiledHeader.h"
+#include "ConstantRingBuffer.h"
 #include "Direct3D.h"
 #include "Parameters.h"
 #include "Tools.h"
+#include "VertexPacking.h"
 #include "VertexShader.h"
 
 VertexShader::VertexShader(wstring path)
@@ -109,9 +111,18 @@ unique_ptr<uint8_t[]> VertexShader::ArrangeVertexBufferData(unsigned int vertexC
 		for (auto j = 0u; j < inputLayoutItems.size(); j++)
 		{
 			const auto& item = inputLayoutItems[j];
-
-			memcpy(vertexInput.get() + i * layoutSize + destinationFieldOffsets[j], 
-				reinterpret_cast<const uint8_t*>(&vertices[i]) + item.GetParameterOffset(), item.GetSize());
+			auto destination = vertexInput.get() + i * layoutSize + destinationFieldOffsets[j];
+			auto source = reinterpret_cast<const uint8_t*>(&vertices[i]) + item.GetParameterOffset();
+
+			// Shader reflection picks 16-bit normalized formats for direction vectors, everything else is a prefix of the field
+			if (item.GetFormat() == DXGI_FORMAT_R16G16B16A16_SNORM)
+			{
+				VertexPacking::PackDirectionSnorm(*reinterpret_cast<const DirectX::XMFLOAT3*>(source), reinterpret_cast<int16_t*>(destination));
+			}
+			else
+			{
+				memcpy(destination, source, item.GetSize());
+			}
 		}
 	}
 	
@@ -194,14 +205,25 @@ void VertexShader::SetRenderParameters(const RenderParameters& renderParameters)
 	}
 }
 
-void VertexShader::SetConstantBuffersImpl() const
+void VertexShader::SetConstantBuffersImpl(bool haveOffsetsChanged) const
 {
 	static const VertexShader* shaderWhichLastSet = nullptr;
 
-	if (shaderWhichLastSet != this)
+	if (shaderWhichLastSet != this || haveOffsetsChanged)
 	{
 		shaderWhichLastSet = this;
-		GetD3D11DeviceContext()->VSSetConstantBuffers(0, static_cast<UINT>(m_ConstantBufferPtrs.size()), m_ConstantBufferPtrs.data());
+		auto bufferCount = static_cast<UINT>(m_ConstantBufferPtrs.size());
+
+		if (ConstantRingBuffer::IsSupported())
+		{
+			// The runtime skips rebinding a buffer that's already bound, even at a different offset, unless it gets unbound first
+			GetD3D11DeviceContext()->VSSetConstantBuffers(0, bufferCount, ConstantRingBuffer::kNullBuffers);
+			GetD3D11DeviceContext()->VSSetConstantBuffers1(0, bufferCount, m_ConstantBufferPtrs.data(), m_FirstConstants.data(), m_ConstantCounts.data());
+		}
+		else
+		{
+			GetD3D11DeviceContext()->VSSetConstantBuffers(0, bufferCount, m_ConstantBufferPtrs.data());
+		}
 	}
 }
 
@@ -18,7 +18,7 @@ private:
 	
 	void ReflectInputLayout(const vector<uint8_t>& shaderBuffer, const vector<uint8_t>& metadataBuffer);
 	
-	virtual void SetConstantBuffersImpl() const;
+	virtual void SetConstantBuffersImpl(bool haveOffsetsChanged) const;
 	virtual void SetTexturesImpl();
 	virtual void SetSamplersImpl() const;
 
@@ -30,7 +30,8 @@ CameraPositionLockedModelInstance::~CameraPositionLockedModelInstance()
 {
 }
 
-void CameraPositionLockedModelInstance::Render3D(RenderParameters& renderParameters)
+// Culling is the first thing to look at the position every frame, so this is where the model catches up with the camera
+bool CameraPositionLockedModelInstance::GetBoundingSphere(const RenderParameters& renderParameters, DirectX::XMFLOAT3& center, float& radius)
 {
 	if (m_LockedDimensions.x)
 	{
@@ -48,5 +49,5 @@ void CameraPositionLockedModelInstance::Render3D(RenderParameters& renderParamet
 	}
 
 	DirtyWorldMatrix();
-	ModelInstance3D::Render3D(renderParameters);
+	return ModelInstance3D::GetBoundingSphere(renderParameters, center, radius);
 }
\ No newline at end of file
@@ -19,5 +19,5 @@ public:
 	virtual ~CameraPositionLockedModelInstance();
 	
 	virtual void Update(const RenderParameters& renderParameters) { }
-	virtual void Render3D(RenderParameters& renderParameters);
+	virtual bool GetBoundingSphere(const RenderParameters& renderParameters, DirectX::XMFLOAT3& center, float& radius);
 };
\ No newline at end of file
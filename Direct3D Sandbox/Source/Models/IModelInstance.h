@@ -1,9 +1,16 @@
 #pragma once
 
+#include "SlotMap.h"
+
+typedef SlotMapId ModelId;
+
+class RenderQueue;
 struct RenderParameters;
 class IModelInstance
 {
 private:
+	ModelId m_ModelId;		// Assigned by System when the model is queued to be added to the scene
+
 	IModelInstance(const IModelInstance& other);				// Not implemented (copying is not allowed)
 	IModelInstance& operator=(const IModelInstance& other);		// Not implemented (copying is not allowed)
 
@@ -12,7 +19,14 @@ public:
 	virtual ~IModelInstance();
 	
 	virtual void Update(const RenderParameters& renderParameters) = 0;
+	virtual bool GetBoundingSphere(const RenderParameters& renderParameters, DirectX::XMFLOAT3& center, float& radius) { return false; }	// False if never culled
+	virtual void Submit3D(RenderQueue& renderQueue, const RenderParameters& renderParameters) = 0;		// Adds draw packets for whatever Render3D would draw
+	virtual void Stage3D(RenderParameters& renderParameters) { }										// Writes the constants Render3D will draw with ahead of it
 	virtual void Render3D(RenderParameters& renderParameters) = 0;
 	virtual void Render2D(RenderParameters& renderParameters) = 0;
+
+	inline const ModelId& GetModelId() const { return m_ModelId; }
+
+	friend class System;
 };
 
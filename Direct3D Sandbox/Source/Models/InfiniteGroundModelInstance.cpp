@@ -16,10 +16,10 @@ InfiniteGroundModelInstance::~InfiniteGroundModelInstance()
 {
 }
 
-void InfiniteGroundModelInstance::Render3D(RenderParameters& renderParameters)
+void InfiniteGroundModelInstance::SetRenderParameters(RenderParameters& renderParameters)
 {
 	renderParameters.groundScale = m_Scale;
 	renderParameters.uvTiling = m_uvTiling;
 
-	CameraPositionLockedModelInstance::Render3D(renderParameters);
+	ModelInstance3D::SetRenderParameters(renderParameters);
 }
\ No newline at end of file
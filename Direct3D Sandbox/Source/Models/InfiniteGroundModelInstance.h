@@ -9,11 +9,13 @@ private:
 	DirectX::XMFLOAT2 m_Scale;
 	DirectX::XMFLOAT2 m_uvTiling;
 
+protected:
+	virtual void SetRenderParameters(RenderParameters& renderParameters);
+
 public:
 	InfiniteGroundModelInstance(const ModelParameters& modelParameters, const wstring& texturePath, const wstring& normalMapPath, DirectX::XMFLOAT2 uvTiling);
 	virtual ~InfiniteGroundModelInstance();
 
 	virtual void Update(const RenderParameters& renderParameters) { }
-	virtual void Render3D(RenderParameters& renderParameters);
 };
 
@@ -7,9 +7,11 @@
 static const float kRayWidth = 0.3f;
 static const float kRayLifetime = 0.4f;
 
+static ObjectPool<LaserProjectileInstance> s_ProjectilePool;
+
 LaserProjectileInstance::LaserProjectileInstance(const ModelParameters& modelParameters, const DirectX::XMVECTOR& rayDirection) :
 	ModelInstance3D(IShader::GetShader(ShaderType::LASER_SHADER), L"Assets\\Models\\Laser.model", modelParameters),
-	m_SpawnedAt(static_cast<float>(Tools::GetTime()))
+	m_SpawnedAt(System::GetInstance().GetSimulationTime())
 {
 	m_Parameters.color = DirectX::XMFLOAT4(0.8f, 0.0f, 0.0f, 1.0f);
 
@@ -31,7 +33,7 @@ void LaserProjectileInstance::Update(const RenderParameters& renderParameters)
 	}
 }
 
-void LaserProjectileInstance::Render3D(RenderParameters& renderParameters)
+void LaserProjectileInstance::SetRenderParameters(RenderParameters& renderParameters)
 {	
 	using namespace DirectX;
 	
@@ -43,7 +45,7 @@ void LaserProjectileInstance::Render3D(RenderParameters& renderParameters)
 	XMStoreFloat3(&renderParameters.rayViewDirection, XMVector3Normalize(rayViewDirection));
 	
 	renderParameters.transitionProgress = m_TransitionProgress;
-	ModelInstance3D::Render3D(renderParameters);
+	ModelInstance3D::SetRenderParameters(renderParameters);
 }
 
 void LaserProjectileInstance::Spawn(const DirectX::XMVECTOR& source, const DirectX::XMVECTOR& target)
@@ -64,6 +66,20 @@ void LaserProjectileInstance::Spawn(const DirectX::XMVECTOR& source, const Direc
 	
 	XMStoreFloat3(&rayParameters.position, (source + target) / 2.0f);
 	
-	shared_ptr<IModelInstance> projectile(new LaserProjectileInstance(rayParameters, rayVector));
-	System::GetInstance().AddModel(projectile);
+	System::GetInstance().AddModel(unique_ptr<IModelInstance>(new LaserProjectileInstance(rayParameters, rayVector)));
+}
+
+void* LaserProjectileInstance::operator new(size_t size)
+{
+	return s_ProjectilePool.Allocate(size);
+}
+
+void LaserProjectileInstance::operator delete(void* projectile)
+{
+	s_ProjectilePool.Free(projectile);
+}
+
+ObjectPoolStatistics LaserProjectileInstance::GetPoolStatistics()
+{
+	return s_ProjectilePool.GetStatistics();
 }
\ No newline at end of file
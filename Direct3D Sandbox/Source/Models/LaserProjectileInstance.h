@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ModelInstance3D.h"
+#include "ObjectPool.h"
 
 class LaserProjectileInstance :
 	public ModelInstance3D
@@ -12,11 +13,18 @@ private:
 
 	LaserProjectileInstance(const ModelParameters& modelParameters, const DirectX::XMVECTOR& rayDirection);
 
+protected:
+	virtual void SetRenderParameters(RenderParameters& renderParameters);
+
 public:
 	virtual ~LaserProjectileInstance();
 
 	virtual void Update(const RenderParameters& renderParameters);
-	virtual void Render3D(RenderParameters& renderParameters);
 	static void Spawn(const DirectX::XMVECTOR& source, const DirectX::XMVECTOR& target);
+
+	// Every shot spawns a projectile, so they're recycled through a pool instead of the heap
+	void* operator new(size_t size);
+	void operator delete(void* projectile);
+	static ObjectPoolStatistics GetPoolStatistics();
 };
 
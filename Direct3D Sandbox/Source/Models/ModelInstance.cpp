@@ -1,12 +1,20 @@
 #include "PrecompiledHeader.h"
 #include "ModelInstance.h"
 #include "Parameters.h"
+#include "Source\Graphics\IShader.h"
+#include "Source\Graphics\RenderQueue.h"
 #include "Source\Graphics\Texture.h"
+#include "System.h"
+
+static const unsigned int kNeverMoved = 0xFFFFFFFF;
 
 ModelInstance::ModelInstance(IShader& shader, const wstring& modelPath, const ModelParameters& modelParameters) :
 	m_Model(IModel::Get(modelPath, shader)),
 	m_Parameters(modelParameters),
-	m_DirtyWorldMatrix(true)
+	m_DirtyWorldMatrix(true),
+	m_PreviousTickPosition(modelParameters.position),
+	m_MovedOnTick(kNeverMoved),
+	m_WorldMatrixTickInterpolation(1.0f)
 {
 }
 
@@ -15,7 +23,10 @@ ModelInstance::ModelInstance(IShader& shader, const wstring& modelPath, const Mo
 	m_Model(IModel::Get(modelPath, shader)),
 	m_Parameters(modelParameters),
 	m_Texture(Texture::Get(texturePath)),
-	m_DirtyWorldMatrix(true)
+	m_DirtyWorldMatrix(true),
+	m_PreviousTickPosition(modelParameters.position),
+	m_MovedOnTick(kNeverMoved),
+	m_WorldMatrixTickInterpolation(1.0f)
 {
 }
 
@@ -23,9 +34,10 @@ ModelInstance::~ModelInstance()
 {
 }
 
-void ModelInstance::RecalculateWorldMatrix()
+void ModelInstance::RecalculateWorldMatrix(float tickInterpolation)
 {
-	DirectX::XMMATRIX position = DirectX::XMMatrixTranslation(m_Parameters.position.x, m_Parameters.position.y, m_Parameters.position.z);
+	DirectX::XMVECTOR interpolatedPosition = DirectX::XMVectorLerp(DirectX::XMLoadFloat3(&m_PreviousTickPosition), DirectX::XMLoadFloat3(&m_Parameters.position), tickInterpolation);
+	DirectX::XMMATRIX position = DirectX::XMMatrixTranslationFromVector(interpolatedPosition);
 	DirectX::XMMATRIX rotation = DirectX::XMMatrixRotationRollPitchYaw(m_Parameters.rotation.x, m_Parameters.rotation.y, m_Parameters.rotation.z);
 	DirectX::XMMATRIX scale = DirectX::XMMatrixScaling(m_Parameters.scale.x, m_Parameters.scale.y, m_Parameters.scale.z);
 
@@ -35,30 +47,47 @@ void ModelInstance::RecalculateWorldMatrix()
 	m_InversedTransposedWorldMatrix = DirectX::XMMatrixInverse(nullptr, worldMatrix);
 }
 
-const DirectX::XMMATRIX& ModelInstance::GetWorldMatrix()
+// Models that moved on the last simulation tick are drawn between where the tick found and left them,
+// as frames usually land somewhere between ticks. The rest are drawn where they are
+void ModelInstance::UpdateWorldMatrix(const RenderParameters& renderParameters)
 {
-	if (m_DirtyWorldMatrix)
+	auto tickInterpolation = 1.0f;
+
+	if (m_MovedOnTick == System::GetInstance().GetTickIndex())
+	{
+		tickInterpolation = renderParameters.tickInterpolation;
+	}
+
+	if (m_DirtyWorldMatrix || tickInterpolation != m_WorldMatrixTickInterpolation)
 	{
-		RecalculateWorldMatrix();
+		RecalculateWorldMatrix(tickInterpolation);
+		m_WorldMatrixTickInterpolation = tickInterpolation;
 		m_DirtyWorldMatrix = false;
 	}
-	
+}
+
+const DirectX::XMMATRIX& ModelInstance::GetWorldMatrix(const RenderParameters& renderParameters)
+{
+	UpdateWorldMatrix(renderParameters);
 	return m_WorldMatrix;
 }
 
-const DirectX::XMMATRIX& ModelInstance::GetInversedTransposedWorldMatrix()
+const DirectX::XMMATRIX& ModelInstance::GetInversedTransposedWorldMatrix(const RenderParameters& renderParameters)
 {
-	if (m_DirtyWorldMatrix)
-	{
-		RecalculateWorldMatrix();
-		m_DirtyWorldMatrix = false;
-	}
-	
+	UpdateWorldMatrix(renderParameters);
 	return m_InversedTransposedWorldMatrix;
 }
 
 void ModelInstance::SetPosition(const DirectX::XMFLOAT3& position)
 {
+	auto tickIndex = System::GetInstance().GetTickIndex();
+
+	if (m_MovedOnTick != tickIndex)
+	{
+		m_PreviousTickPosition = m_Parameters.position;
+		m_MovedOnTick = tickIndex;
+	}
+
 	m_Parameters.position = position;
 	m_DirtyWorldMatrix = true;
 }
@@ -90,11 +119,30 @@ float ModelInstance::HorizontalDistanceSqrTo(const DirectX::XMFLOAT2& position)
 
 void ModelInstance::SetRenderParameters(RenderParameters& renderParameters)
 {
-	auto& worldMatrix = GetWorldMatrix();
+	auto& worldMatrix = GetWorldMatrix(renderParameters);
 
 	memcpy(&renderParameters.worldMatrix, &worldMatrix, sizeof(DirectX::XMMATRIX));
 	renderParameters.worldViewProjectionMatrix = renderParameters.viewProjectionMatrix * worldMatrix;
 
 	renderParameters.color = m_Parameters.color;
-	renderParameters.texture = m_Texture.Get();
+	renderParameters.texture = m_Texture.Resolve().Get();
+}
+
+// Queues the model to be drawn with this instance's Render3D once the render queue is submitted
+void ModelInstance::SubmitModel(RenderQueue& renderQueue, const RenderParameters& renderParameters, unsigned int pass)
+{
+	DrawPacket packet;
+	auto texture = m_Texture.Resolve().Get();
+	auto deltaX = renderParameters.cameraPosition.x - m_Parameters.position.x;
+	auto deltaY = renderParameters.cameraPosition.y - m_Parameters.position.y;
+	auto deltaZ = renderParameters.cameraPosition.z - m_Parameters.position.z;
+	auto distanceSqr = deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ;
+
+	packet.instance = this;
+	packet.shader = &m_Model.GetShader();
+	packet.model = &m_Model;
+	packet.texture = texture;
+	packet.sortKey = RenderQueue::MakeSortKey(pass, packet.shader->GetSortId(), texture, m_Model.GetSortId(), distanceSqr);
+
+	renderQueue.Add(packet);
 }
\ No newline at end of file
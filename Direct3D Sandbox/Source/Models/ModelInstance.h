@@ -3,6 +3,7 @@
 #include "AlignedClass.h"
 #include "IModelInstance.h"
 #include "Source\Graphics\Model.h"
+#include "Source\Graphics\Texture.h"
 
 struct ModelParameters
 {
@@ -24,22 +25,29 @@ private:
 	DirectX::XMMATRIX m_InversedTransposedWorldMatrix;
 	bool m_DirtyWorldMatrix;
 
+	DirectX::XMFLOAT3 m_PreviousTickPosition;		// Where the model was before the tick it last moved on
+	unsigned int m_MovedOnTick;
+	float m_WorldMatrixTickInterpolation;			// How far between the ticks the world matrix puts the model
+
 	IModel& m_Model;
-	ComPtr<ID3D11ShaderResourceView> m_Texture;
+	TextureHandle m_Texture;
 
-	void RecalculateWorldMatrix();
+	void RecalculateWorldMatrix(float tickInterpolation);
+	void UpdateWorldMatrix(const RenderParameters& renderParameters);
 
 	ModelInstance(const ModelInstance& other);
 
 protected:
 	ModelParameters m_Parameters;
 
-	const DirectX::XMMATRIX& GetWorldMatrix();
-	const DirectX::XMMATRIX& GetInversedTransposedWorldMatrix();
+	const DirectX::XMMATRIX& GetWorldMatrix(const RenderParameters& renderParameters);
+	const DirectX::XMMATRIX& GetInversedTransposedWorldMatrix(const RenderParameters& renderParameters);
 	float GetModelRadius() const { return m_Model.GetRadius(); }
 	
 	virtual void SetRenderParameters(RenderParameters& renderParameters);
+	inline void StageModel(RenderParameters& renderParameters) { m_Model.StageRenderParameters(renderParameters); }
 	inline void RenderModel(RenderParameters& renderParameters) { m_Model.Render(renderParameters); }
+	void SubmitModel(RenderQueue& renderQueue, const RenderParameters& renderParameters, unsigned int pass = 0);
 
 	void DirtyWorldMatrix() { m_DirtyWorldMatrix = true; }
 	
@@ -57,6 +65,7 @@ public:
 	const DirectX::XMFLOAT3& GetRotation() const { return m_Parameters.rotation; }
 	const DirectX::XMFLOAT3& GetScale() const { return m_Parameters.scale; }
 	const DirectX::XMFLOAT4& GetColor() const { return m_Parameters.color; }
+	DirectX::XMFLOAT2 GetHorizontalPosition() const { return DirectX::XMFLOAT2(m_Parameters.position.x, m_Parameters.position.z); }
 
 	float HorizontalDistanceSqrTo(const DirectX::XMFLOAT2& position);
 };
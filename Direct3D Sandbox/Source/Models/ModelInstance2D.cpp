@@ -1,6 +1,7 @@
 #include "PrecompiledHeader.h"
 #include "ModelInstance2D.h"
 
+static ObjectPool<ModelInstance2D> s_ModelInstance2DPool;
 
 ModelInstance2D::ModelInstance2D(IShader& shader, const wstring& modelPath, const ModelParameters& modelParameters, const wstring& texturePath) :
 	ModelInstance(shader, modelPath, modelParameters, texturePath)
@@ -15,4 +16,19 @@ void ModelInstance2D::Render2D(RenderParameters& renderParameters)
 {
 	SetRenderParameters(renderParameters);
 	RenderModel(renderParameters);
+}
+
+void* ModelInstance2D::operator new(size_t size)
+{
+	return s_ModelInstance2DPool.Allocate(size);
+}
+
+void ModelInstance2D::operator delete(void* model)
+{
+	s_ModelInstance2DPool.Free(model);
+}
+
+ObjectPoolStatistics ModelInstance2D::GetPoolStatistics()
+{
+	return s_ModelInstance2DPool.GetStatistics();
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "ModelInstance.h"
+#include "ObjectPool.h"
 
 class ModelInstance2D :
 	public ModelInstance
@@ -9,7 +10,13 @@ public:
 	virtual ~ModelInstance2D();
 	
 	virtual void Update(const RenderParameters& RenderParameters) { }
+	virtual void Submit3D(RenderQueue& renderQueue, const RenderParameters& renderParameters) { }
 	virtual void Render3D(RenderParameters& renderParameters) { }
 	virtual void Render2D(RenderParameters& renderParameters);
+
+	// Crosshairs come and go with the weapon every game, so they're recycled through a pool instead of the heap
+	void* operator new(size_t size);
+	void operator delete(void* model);
+	static ObjectPoolStatistics GetPoolStatistics();
 };
 
@@ -26,41 +26,34 @@ ModelInstance3D::~ModelInstance3D()
 {
 }
 
-bool ModelInstance3D::IsInCameraFrustum(const RenderParameters& renderParameters) const
+bool ModelInstance3D::GetBoundingSphere(const RenderParameters& renderParameters, DirectX::XMFLOAT3& center, float& radius)
 {
-	auto radius = GetModelRadius() * max(max(m_Parameters.scale.x, m_Parameters.scale.y), m_Parameters.scale.z);
-	auto radiusSqr = radius * radius;
-	auto positionVector = DirectX::XMVectorSet(m_Parameters.position.x, m_Parameters.position.y, m_Parameters.position.z, 1.0f);
-
-	for (int i = 0; i < 6; i++)
-	{
-		auto dotResult = DirectX::XMVector4Dot(renderParameters.frustumPlanes[i], positionVector);
-
-		if (DirectX::XMVectorGetX(dotResult) + radius < 0.0f)
-		{
-			return false;
-		}
-	}
+	center = m_Parameters.position;
+	radius = GetModelRadius() * max(max(m_Parameters.scale.x, m_Parameters.scale.y), m_Parameters.scale.z);
 
 	return true;
 }
 
 void ModelInstance3D::SetRenderParameters(RenderParameters& renderParameters)
 {
-	memcpy(&renderParameters.inversedTransposedWorldMatrix, &GetInversedTransposedWorldMatrix(), sizeof(DirectX::XMMATRIX));
-	renderParameters.normalMap = m_NormalMap.Get();
+	memcpy(&renderParameters.inversedTransposedWorldMatrix, &GetInversedTransposedWorldMatrix(renderParameters), sizeof(DirectX::XMMATRIX));
+	renderParameters.normalMap = m_NormalMap.Resolve().Get();
 	ModelInstance::SetRenderParameters(renderParameters);
 }
 
-void ModelInstance3D::Render3D(RenderParameters& renderParameters)
+void ModelInstance3D::Submit3D(RenderQueue& renderQueue, const RenderParameters& renderParameters)
+{
+	SubmitModel(renderQueue, renderParameters);
+}
+
+void ModelInstance3D::Stage3D(RenderParameters& renderParameters)
 {
-#if ENABLE_FRUSTUM_CULLING
-	if (!IsInCameraFrustum(renderParameters))
-	{
-		return;
-	}
-#endif
+	SetRenderParameters(renderParameters);
+	StageModel(renderParameters);
+}
 
+void ModelInstance3D::Render3D(RenderParameters& renderParameters)
+{
 	SetRenderParameters(renderParameters);
 	RenderModel(renderParameters);
 }
\ No newline at end of file
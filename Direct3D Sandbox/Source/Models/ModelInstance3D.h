@@ -6,10 +6,10 @@ class ModelInstance3D :
 	public ModelInstance
 {
 private:
-	ComPtr<ID3D11ShaderResourceView> m_NormalMap;
-	
-	bool IsInCameraFrustum(const RenderParameters& renderParameters) const;	
-	virtual void SetRenderParameters(RenderParameters& renderParameters);
+	TextureHandle m_NormalMap;
+
+protected:
+	virtual void SetRenderParameters(RenderParameters& renderParameters);		// Everything Stage3D and Render3D set before reaching the model goes here
 
 public:
 	ModelInstance3D(IShader& shader, const wstring& modelPath, const ModelParameters& modelParameters);
@@ -18,6 +18,9 @@ public:
 	virtual ~ModelInstance3D();
 
 	virtual void Update(const RenderParameters& RenderParameters) { }
+	virtual bool GetBoundingSphere(const RenderParameters& renderParameters, DirectX::XMFLOAT3& center, float& radius);
+	virtual void Submit3D(RenderQueue& renderQueue, const RenderParameters& renderParameters);
+	virtual void Stage3D(RenderParameters& renderParameters);
 	virtual void Render3D(RenderParameters& renderParameters);
 	virtual void Render2D(RenderParameters& renderParameters) { }
 };
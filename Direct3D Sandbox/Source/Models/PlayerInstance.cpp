@@ -2,6 +2,7 @@
 #include "PlayerInstance.h"
 
 #include "Constants.h"
+#include "RandomGenerator.h"
 #include "Source\Graphics\Font.h"
 #include "Source\Graphics\IShader.h"
 #include "System.h"
@@ -15,6 +16,9 @@ static const float kHealthRegenerationRate = 0.02f;
 
 PlayerInstance::PlayerInstance(Camera& playerCamera) :
 	m_CameraController(playerCamera),
+	m_Weapon(nullptr),
+	m_ZombieCrowd(make_shared<ZombieCrowd>()),
+	m_IsInvulnerable(false),
 	m_GameState(GameState::NotStarted),
 	m_BoldFont(Font::Get(L"Assets\\Fonts\\Segoe UI.font")),
 	m_SmallFont(Font::Get(L"Assets\\Fonts\\Calibri.font")),
@@ -23,24 +27,40 @@ PlayerInstance::PlayerInstance(Camera& playerCamera) :
 	m_Highscore(Highscore::Load()),
 	m_AchievedHighscore(false)
 {
+	m_Zombies.reserve(Constants::MaxZombies);
 	m_AmbientSound.Play();
 }
 
 PlayerInstance::~PlayerInstance()
 {
-	for (auto& zombie : m_Zombies)
+	for (const auto& zombieHandle : m_Zombies)
 	{
-		System::GetInstance().RemoveModel(zombie.get());
+		auto zombie = ZombieInstanceBase::Resolve(zombieHandle);
+
+		if (zombie != nullptr)
+		{
+			System::GetInstance().RemoveModel(zombie);
+		}
 	}
 
 	if (m_GameState == GameState::Playing)
 	{
-		System::GetInstance().RemoveModel(m_Weapon.get());
+		System::GetInstance().RemoveModel(m_Weapon);
 	}
 }
 
 void PlayerInstance::Update(const RenderParameters& renderParameters)
 {
+	// Zombie instances update after the player, so simulate all of them now for them to pick up
+	m_ZombieCrowd->Update(renderParameters.frameTime, renderParameters.time, GetPosition(), m_GameState == GameState::Playing);
+	
+	auto damage = m_ZombieCrowd->ConsumeDamageToPlayer();
+
+	if (damage > 0.0f)
+	{
+		TakeDamage(damage);
+	}
+
 	switch (m_GameState)
 	{
 	case GameState::NotStarted:
@@ -115,7 +135,9 @@ void PlayerInstance::UpdateStatePlaying(const RenderParameters& renderParameters
 	// Remove destroyed/dead zombies
 	for (auto i = 0u; i < m_Zombies.size(); i++)
 	{
-		if (m_Zombies[i]->IsDead())
+		auto zombie = ZombieInstanceBase::Resolve(m_Zombies[i]);
+
+		if (zombie == nullptr || zombie->IsDead())
 		{
 			m_Zombies[i] = m_Zombies[m_Zombies.size() - 1];
 			m_Zombies.pop_back();
@@ -125,11 +147,7 @@ void PlayerInstance::UpdateStatePlaying(const RenderParameters& renderParameters
 
 	if (renderParameters.time - m_LastSpawnTime >= m_SpawnInterval && static_cast<int>(m_Zombies.size()) < Constants::MaxZombies)
 	{
-		for (int i = 0; i < m_SpawnCount; i++)
-		{
-			SpawnRandomZombie();
-		}
-
+		SpawnZombies(static_cast<int>(m_SpawnCount));
 		m_LastSpawnTime = renderParameters.time;
 		m_SpawnInterval -= 0.1f / m_SpawnCount;
 
@@ -181,12 +199,18 @@ void PlayerInstance::UpdateStateGameOver(const RenderParameters& renderParameter
 	{
 		auto& systemInstance = System::GetInstance();
 
-		for (auto& zombie : m_Zombies)
+		for (const auto& zombieHandle : m_Zombies)
 		{
-			systemInstance.RemoveModel(zombie.get());
+			auto zombie = ZombieInstanceBase::Resolve(zombieHandle);
+
+			if (zombie != nullptr)
+			{
+				systemInstance.RemoveModel(zombie);
+			}
 		}
 
 		m_Zombies.clear();
+		m_ZombieCrowd->ExpireAll();
 		StartGame();
 	}
 }
@@ -251,16 +275,13 @@ void PlayerInstance::StartGame()
 {
 	UpdateInput(0.001f);
 
-	for (int i = 0; i < Constants::StartingZombieCount; i++)
-	{
-		SpawnRandomZombie();
-	}
+	SpawnRandomZombies(Constants::StartingZombieCount);
 
-	m_Weapon = shared_ptr<WeaponInstance>(new WeaponInstance);
-	System::GetInstance().AddModel(m_Weapon);
+	m_Weapon = new WeaponInstance;
+	System::GetInstance().AddModel(unique_ptr<IModelInstance>(m_Weapon));
 
 	m_GameState = GameState::Playing;
-	m_LastSpawnTime = m_StartTime = static_cast<float>(Tools::GetTime());
+	m_LastSpawnTime = m_StartTime = System::GetInstance().GetSimulationTime();
 	m_SpawnInterval = Constants::ZombieSpawnIntervalInSeconds;
 	m_SpawnCount = 1;
 	m_Health = 1.0f;
@@ -269,43 +290,74 @@ void PlayerInstance::StartGame()
 
 void PlayerInstance::GameOver()
 {
-	System::GetInstance().RemoveModel(m_Weapon.get());
+	System::GetInstance().RemoveModel(m_Weapon);
 	m_Weapon = nullptr;
 
 	m_GameState = GameState::GameOver;
-	m_DeathTime = static_cast<float>(Tools::GetTime());
+	m_DeathTime = System::GetInstance().GetSimulationTime();
 	m_GameOverSound.Play();
 	m_AchievedHighscore = m_Highscore.SubmitScore(m_DeathTime - m_StartTime, m_ZombiesKilled);
 }
 
-void PlayerInstance::SpawnRandomZombie()
+bool PlayerInstance::SpawnRandomZombie()
 {
-	auto randomValue = Tools::Random::GetNextInteger(1, 10);
+	auto randomValue = Tools::Random::GetGenerator(Tools::Random::Stream::Spawning).NextInteger(1, 10);
 
 	if (randomValue > 0)
 	{
-		SpawnZombie();
+		return SpawnZombie();
 	}
 	else
 	{
-		SpawnSuperZombie();
+		return SpawnSuperZombie();
 	}
 }
 
-void PlayerInstance::SpawnZombie()
+// Returns how many zombies spawned. It's never more than the game allows at once, and fewer if the player is packed in too tightly
+int PlayerInstance::SpawnZombies(int count)
 {
-	auto zombie = ZombieInstance::Spawn(*this, m_Zombies);
-	
-	System::GetInstance().AddModel(zombie);
-	m_Zombies.push_back(zombie);
+	return SpawnRandomZombies(min(count, Constants::MaxZombies - static_cast<int>(m_Zombies.size())));
 }
 
-void PlayerInstance::SpawnSuperZombie()
+// Random numbers for the whole batch are drawn together up front
+int PlayerInstance::SpawnRandomZombies(int count)
 {
-	auto zombie = SuperZombieInstance::Spawn(*this);
-	
-	System::GetInstance().AddModel(zombie);
-	m_Zombies.push_back(zombie);
+	int spawnedCount = 0;
+
+	m_ZombieCrowd->PrepareToAdd(max(count, 0));
+
+	for (int i = 0; i < count; i++)
+	{
+		if (SpawnRandomZombie())
+		{
+			spawnedCount++;
+		}
+	}
+
+	return spawnedCount;
+}
+
+bool PlayerInstance::SpawnZombie()
+{
+	return AddZombie(ZombieInstance::Spawn(*this, m_ZombieCrowd));
+}
+
+bool PlayerInstance::SpawnSuperZombie()
+{
+	return AddZombie(SuperZombieInstance::Spawn(*this, m_ZombieCrowd));
+}
+
+// Spawning gives up when there's no room for the zombie, in which case there's nothing to add
+bool PlayerInstance::AddZombie(ZombieInstanceBase* zombie)
+{
+	if (zombie == nullptr)
+	{
+		return false;
+	}
+
+	m_Zombies.push_back(ZombieInstanceBase::GetHandle(zombie));
+	System::GetInstance().AddModel(unique_ptr<IModelInstance>(zombie));
+	return true;
 }
 
 void PlayerInstance::UpdateInput(float frameTime)
@@ -315,7 +367,7 @@ void PlayerInstance::UpdateInput(float frameTime)
 
 	m_CameraController.Update(frameTime, [this](const DirectX::XMFLOAT2& position) -> bool
 	{
-		return ZombieInstance::CanMoveTo(position, m_Zombies, nullptr);
+		return m_ZombieCrowd->CanMoveTo(position, ZombieCrowd::kNoZombie);
 	});
 }
 
@@ -352,6 +404,11 @@ void PlayerInstance::UpdateWeapon()
 
 void PlayerInstance::TakeDamage(float damage)
 {
+	if (m_IsInvulnerable)
+	{
+		return;
+	}
+
 	m_Health -= damage;
 
 	if (m_Health <= 0.0f && m_GameState == GameState::Playing)
@@ -5,6 +5,7 @@
 #include "Source\Audio\Sound.h"
 #include "Source\CameraControllers\FPSController.h"
 #include "Source\Games\ZombieSurvival\Highscore.h"
+#include "Source\Games\ZombieSurvival\ZombieCrowd.h"
 
 class WeaponInstance;
 
@@ -21,8 +22,9 @@ class PlayerInstance :
 {
 private:
 	FPSController m_CameraController;
-	shared_ptr<WeaponInstance> m_Weapon;
-	vector<shared_ptr<ZombieInstanceBase>> m_Zombies;
+	WeaponInstance* m_Weapon;			// Owned by the scene, like the zombies
+	vector<PoolHandle> m_Zombies;		// Zombies can be removed from the scene before the player notices, so they're kept by handle
+	shared_ptr<ZombieCrowd> m_ZombieCrowd;
 	float m_StartTime;
 	float m_DeathTime;
 	float m_LastSpawnTime;
@@ -32,6 +34,7 @@ private:
 
 	float m_Health;
 	int m_ZombiesKilled;
+	bool m_IsInvulnerable;
 	
 	GameState m_GameState;
 	Font& m_BoldFont;
@@ -46,9 +49,11 @@ private:
 	void UpdateInput(float frameTime);
 	void UpdateWeapon();
 
-	void SpawnRandomZombie();
-	void SpawnZombie();
-	void SpawnSuperZombie();
+	int SpawnRandomZombies(int count);
+	bool SpawnRandomZombie();
+	bool SpawnZombie();
+	bool SpawnSuperZombie();
+	bool AddZombie(ZombieInstanceBase* zombie);
 	
 	void UpdateStateNotStarted(const RenderParameters& renderParameters);
 	void UpdateStatePlaying(const RenderParameters& renderParameters);
@@ -68,11 +73,17 @@ public:
 	virtual ~PlayerInstance();
 	
 	virtual void Update(const RenderParameters& renderParameters);
+	virtual void Submit3D(RenderQueue& renderQueue, const RenderParameters& renderParameters) { }
 	virtual void Render3D(RenderParameters& renderParameters) { }
 	virtual void Render2D(RenderParameters& renderParameters);
 
 	inline GameState GetGameState() const { return m_GameState; }
 	inline const DirectX::XMFLOAT3& GetPosition() const { return m_CameraController.GetPosition(); }
+	inline size_t GetZombieCount() const { return m_Zombies.size(); }
 	void TakeDamage(float damage);
+
+	// Used by benchmark scenarios
+	int SpawnZombies(int count);
+	inline void SetInvulnerable(bool isInvulnerable) { m_IsInvulnerable = isInvulnerable; }
 };
 
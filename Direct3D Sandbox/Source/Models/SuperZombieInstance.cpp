@@ -3,16 +3,17 @@
 #include "PlayerInstance.h"
 #include "Source\\Graphics\\IShader.h"
 #include "SuperZombieInstance.h"
+#include "System.h"
 
 
-SuperZombieInstance::SuperZombieInstance(const ModelParameters& modelParameters, PlayerInstance& targetPlayer) :
+SuperZombieInstance::SuperZombieInstance(const ModelParameters& modelParameters, shared_ptr<ZombieCrowd> crowd, unsigned int id) :
 	ZombieInstanceBase(IShader::GetShader(ShaderType::LIGHTING_SHADER), 
 						L"Assets\\Models\\SuperZombie.model",
 						L"Assets\\Textures\\SuperZombie.dds",
 						L"Assets\\Normal Maps\\SuperZombie.dds", 
 						modelParameters, 
-						targetPlayer,
-						0.0f)
+						crowd,
+						id)
 {
 }
 
@@ -25,7 +26,12 @@ void SuperZombieInstance::Render3D(RenderParameters& renderParameters)
 	ZombieInstanceBase::Render3D(renderParameters);
 }
 
-shared_ptr<ZombieInstanceBase> SuperZombieInstance::Spawn(PlayerInstance& targetPlayer)
+// Super zombies don't move or animate, the crowd only tracks their health and keeps other zombies away from them
+ZombieInstanceBase* SuperZombieInstance::Spawn(PlayerInstance& targetPlayer, shared_ptr<ZombieCrowd> crowd)
 {
-	return shared_ptr<ZombieInstanceBase>(new SuperZombieInstance(GetRandomZombieParameters(targetPlayer), targetPlayer));
+	auto zombieParameters = GetRandomZombieParameters(targetPlayer);
+	auto id = crowd->Add(DirectX::XMFLOAT2(zombieParameters.position.x, zombieParameters.position.z), zombieParameters.rotation.y, 
+		0.0f, false, System::GetInstance().GetSimulationTime());
+
+	return new SuperZombieInstance(zombieParameters, crowd, id);
 }
\ No newline at end of file
@@ -10,12 +10,11 @@ class SuperZombieInstance :
 	SuperZombieInstance& operator=(const ModelInstance& other);		// Not implemented (no copying allowed)
 
 public:
-	SuperZombieInstance(const ModelParameters& modelParameters, PlayerInstance& targetPlayer);
+	SuperZombieInstance(const ModelParameters& modelParameters, shared_ptr<ZombieCrowd> crowd, unsigned int id);
 	virtual ~SuperZombieInstance();
 	
 	virtual void Update(const RenderParameters& renderParameters) { }
 	virtual void Render3D(RenderParameters& renderParameters);
 
-	static shared_ptr<ZombieInstanceBase> Spawn(PlayerInstance& targetPlayer);
+	static ZombieInstanceBase* Spawn(PlayerInstance& targetPlayer, shared_ptr<ZombieCrowd> crowd);
 };
-
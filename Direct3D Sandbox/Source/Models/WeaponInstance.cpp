@@ -22,7 +22,7 @@ WeaponInstance::WeaponInstance() :
 	m_AudioEmitter(0.0f)
 {
 	m_Crosshair.SetScale(DirectX::XMFLOAT3(50.0f, 50.0f, 50.0f));
-	System::GetInstance().AddModel(shared_ptr<IModelInstance>(&m_Crosshair));
+	System::GetInstance().AddModel(unique_ptr<IModelInstance>(&m_Crosshair));
 }
 
 WeaponInstance::~WeaponInstance()
@@ -31,11 +31,11 @@ WeaponInstance::~WeaponInstance()
 }
 
 // Returns number of zombies killed
-int WeaponInstance::Fire(const vector<shared_ptr<ZombieInstanceBase>>& zombies, const DirectX::XMFLOAT3& playerPosition)
+int WeaponInstance::Fire(const vector<PoolHandle>& zombies, const DirectX::XMFLOAT3& playerPosition)
 {
 	using namespace DirectX;
 	
-	auto time = static_cast<float>(Tools::GetTime());
+	auto time = System::GetInstance().GetSimulationTime();
 
 	if (time - m_LastShot < kShootingInterval)
 	{
@@ -85,11 +85,11 @@ int WeaponInstance::Fire(const vector<shared_ptr<ZombieInstanceBase>>& zombies,
 	XMVECTOR delta = target - source;
 	auto zombiesKilled = 0;
 
-	for (auto& zombieRef : zombies)
+	for (const auto& zombieHandle : zombies)
 	{
-		auto zombie = zombieRef.get();
+		auto zombie = ZombieInstanceBase::Resolve(zombieHandle);
 
-		if (zombie->IsDead())
+		if (zombie == nullptr || zombie->IsDead())
 		{
 			continue;
 		}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ModelInstance3D.h"
+#include "ObjectPool.h"
 #include "Source\Audio\AudioEmitter.h"
 #include "Source\Audio\Sound.h"
 
@@ -19,7 +20,7 @@ public:
 	WeaponInstance();
 	virtual ~WeaponInstance();
 
-	int Fire(const vector<shared_ptr<ZombieInstanceBase>>& zombies, const DirectX::XMFLOAT3& playerPosition);
+	int Fire(const vector<PoolHandle>& zombies, const DirectX::XMFLOAT3& playerPosition);
 
 	static const DirectX::XMFLOAT3 kWeaponPositionOffset;
 };
@@ -1,6 +1,5 @@
 #pragma once
 
-#include "AnimationStateMachine.h"
 #include "Source\Audio\AudioEmitter.h"
 #include "ZombieInstanceBase.h"
 
@@ -8,47 +7,22 @@ class PlayerInstance;
 class ZombieInstance :
 	public ZombieInstanceBase
 {	
-	enum ZombieStates
-	{
-		Idle = 0,
-		Running,
-		Hitting,
-		Death,
-		StateCount
-	};
-	
-	static const float kAnimationPeriods[ZombieStates::StateCount];
-	static const bool kDoesAnimationLoop[ZombieStates::StateCount];
-	static const float kAnimationTransitionLength;
-	static const float kZombieDistancePerRunningAnimationTime;
-	static const float kZombieBodyLastingTime;
-	static const float kZombieHitInterval;
-	
-	const vector<shared_ptr<ZombieInstanceBase>>& m_Zombies;
-	float m_LastHitPlayerAt;
-	
-	float m_LastMadeNearPlayerSound;
 	Sound& m_NearPlayerSound;
-	float m_LastFootStep;
 	Sound& m_FootStepSound;
 	Sound& m_PunchSound;
 
-	AnimationStateMachine<ZombieStates, ZombieStates::StateCount, kAnimationPeriods, kDoesAnimationLoop, kAnimationTransitionLength> m_AnimationStateMachine;
-
 	ZombieInstance(const ModelInstance& other);					// Not implemented (no copying allowed)
 	ZombieInstance& operator=(const ModelInstance& other);		// Not implemented (no copying allowed)
 	
-	ZombieInstance(const ModelParameters& modelParameters, PlayerInstance& targetPlayer, 
-		const vector<shared_ptr<ZombieInstanceBase>>& zombies);
+	ZombieInstance(const ModelParameters& modelParameters, shared_ptr<ZombieCrowd> crowd, unsigned int id);
+
+protected:
+	virtual void SetRenderParameters(RenderParameters& renderParameters);
 
 public:
 	virtual ~ZombieInstance();
 	
 	virtual void Update(const RenderParameters& renderParameters);
-	virtual void Render3D(RenderParameters& renderParameters);
 	
-	static bool CanMoveTo(const DirectX::XMFLOAT2& position, const vector<shared_ptr<ZombieInstanceBase>>& zombies,
-		const ZombieInstanceBase* thisPtr);
-	static shared_ptr<ZombieInstanceBase> Spawn(PlayerInstance& targetPlayer, const vector<shared_ptr<ZombieInstanceBase>>& zombies);
+	static ZombieInstanceBase* Spawn(PlayerInstance& targetPlayer, shared_ptr<ZombieCrowd> crowd);
 };
-
@@ -1,19 +1,22 @@
 #include "PrecompiledHeader.h"
 #include "Constants.h"
 #include "PlayerInstance.h"
+#include "RandomGenerator.h"
 #include "Source\Audio\AudioManager.h"
 #include "Source\Graphics\IShader.h"
+#include "SuperZombieInstance.h"
+#include "System.h"
+#include "ZombieInstance.h"
 #include "ZombieInstanceBase.h"
 
+static const size_t kZombieSize = sizeof(ZombieInstance) > sizeof(SuperZombieInstance) ? sizeof(ZombieInstance) : sizeof(SuperZombieInstance);
+static ObjectPool<ZombieInstanceBase, kZombieSize> s_ZombiePool;
 
 ZombieInstanceBase::ZombieInstanceBase(IShader& shader, const wstring& modelPath, const wstring& texturePath, const wstring& normalMapPath,
-		const ModelParameters& modelParameters, PlayerInstance& targetPlayer, float speed) :
+		const ModelParameters& modelParameters, shared_ptr<ZombieCrowd> crowd, unsigned int id) :
 	ModelInstance3D(shader, modelPath, modelParameters, texturePath, normalMapPath),
-	m_TargetPlayer(targetPlayer),
-	m_Speed(speed),
-	m_IsDead(false),
-	m_Health(1.0f),
-	m_SpawnTime(static_cast<float>(Tools::GetTime())),
+	m_Crowd(crowd),
+	m_Id(id),
 	m_AudioEmitter(0.5f),
 	m_DeathSound(AudioManager::GetCachedSound(L"Assets\\Sounds\\ZombieDeath.wav", false, true))
 {
@@ -21,6 +24,33 @@ ZombieInstanceBase::ZombieInstanceBase(IShader& shader, const wstring& modelPath
 
 ZombieInstanceBase::~ZombieInstanceBase()
 {
+	m_Crowd->Remove(m_Id);
+}
+
+void* ZombieInstanceBase::operator new(size_t size)
+{
+	return s_ZombiePool.Allocate(size);
+}
+
+void ZombieInstanceBase::operator delete(void* zombie)
+{
+	s_ZombiePool.Free(zombie);
+}
+
+PoolHandle ZombieInstanceBase::GetHandle(const ZombieInstanceBase* zombie)
+{
+	return s_ZombiePool.GetHandle(zombie);
+}
+
+// Returns nullptr if the zombie has been removed from the scene since the handle was taken
+ZombieInstanceBase* ZombieInstanceBase::Resolve(const PoolHandle& handle)
+{
+	return s_ZombiePool.Resolve(handle);
+}
+
+ObjectPoolStatistics ZombieInstanceBase::GetPoolStatistics()
+{
+	return s_ZombiePool.GetStatistics();
 }
 
 void ZombieInstanceBase::Render3D(RenderParameters& renderParameters)
@@ -31,24 +61,24 @@ void ZombieInstanceBase::Render3D(RenderParameters& renderParameters)
 // Returns whether the zombie is dead after taking damage
 bool ZombieInstanceBase::TakeDamage(float damage)
 {
-	m_Health -= damage;
+	auto wasDead = m_Crowd->IsDead(m_Id);
+	auto isDead = m_Crowd->TakeDamage(m_Id, damage, System::GetInstance().GetSimulationTime());
 
-	if (m_Health <= 0.0f)
+	if (isDead && !wasDead)
 	{
-		m_DeathTime = static_cast<float>(Tools::GetTime());
-		m_IsDead = true;
 		m_DeathSound.Play3D(m_AudioEmitter);
 	}
 
-	return m_IsDead;
+	return isDead;
 }
 
 ModelParameters ZombieInstanceBase::GetRandomZombieParameters(const PlayerInstance& targetPlayer)
 {
 	ModelParameters modelParameters;
 
-	auto radius = Tools::Random::GetNextReal(5.0f, 20.0f);
-	auto angle = Tools::Random::GetNextReal(0.0f, 2 * DirectX::XM_PI);
+	auto& random = Tools::Random::GetGenerator(Tools::Random::Stream::Spawning);
+	auto radius = random.NextReal(5.0f, 20.0f);
+	auto angle = random.NextReal(0.0f, 2 * DirectX::XM_PI);
 	auto playerPosition = targetPlayer.GetPosition();
 
 	modelParameters.position = DirectX::XMFLOAT3(playerPosition.x + radius * cos(angle), 0.0f, playerPosition.z + radius * sin(angle));
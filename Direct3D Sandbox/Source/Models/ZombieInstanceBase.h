@@ -1,28 +1,26 @@
 #pragma once
 
 #include "ModelInstance3D.h"
+#include "ObjectPool.h"
 #include "Source\Audio\AudioEmitter.h"
+#include "Source\Games\ZombieSurvival\ZombieCrowd.h"
 
 class PlayerInstance;
 class Sound;
 
+// Scene side of a zombie. Its simulation state lives in the ZombieCrowd, under m_Id
 class ZombieInstanceBase :
 	public ModelInstance3D
 {	
 protected:
-	PlayerInstance& m_TargetPlayer;
-	const float m_Speed;
-
-	bool m_IsDead;
-	float m_Health;
-	float m_SpawnTime;
-	float m_DeathTime;
+	shared_ptr<ZombieCrowd> m_Crowd;
+	const unsigned int m_Id;
 
 	AudioEmitter m_AudioEmitter;
 	Sound& m_DeathSound;
 
 	ZombieInstanceBase(IShader& shader, const wstring& modelPath, const wstring& texturePath, const wstring& normalMapPath,
-		const ModelParameters& modelParameters, PlayerInstance& targetPlayer, float speed);
+		const ModelParameters& modelParameters, shared_ptr<ZombieCrowd> crowd, unsigned int id);
 
 	static ModelParameters GetRandomZombieParameters(const PlayerInstance& targetPlayer);
 
@@ -34,7 +32,14 @@ public:
 	virtual ~ZombieInstanceBase();
 	virtual void Render3D(RenderParameters& renderParameters);
 
-	bool IsDead() const { return m_IsDead; }
+	// Every kind of zombie is allocated from one pool, so handles work the same for all of them
+	void* operator new(size_t size);
+	void operator delete(void* zombie);
+
+	static PoolHandle GetHandle(const ZombieInstanceBase* zombie);
+	static ZombieInstanceBase* Resolve(const PoolHandle& handle);
+	static ObjectPoolStatistics GetPoolStatistics();
+
+	bool IsDead() const { return m_Crowd->IsDead(m_Id); }
 	bool TakeDamage(float damage);
 };
-
@@ -0,0 +1,22 @@
+#include "PrecompiledHeader.h"
+
+#include "HeadlessWindowing.h"
+#include "Input.h"
+
+#if HEADLESS
+
+HeadlessWindowing::HeadlessWindowing(int width, int height) :
+	m_Width(width), m_Height(height)
+{
+}
+
+HeadlessWindowing::~HeadlessWindowing()
+{
+}
+
+void HeadlessWindowing::DispatchMessages() const
+{
+	Input::GetInstance().KeyDown(VK_RETURN);
+}
+
+#endif	// HEADLESS
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#if HEADLESS
+
+// Stands in for a window where there's no display. There are no messages to dispatch and no input comes from anywhere,
+// other than Enter being held down, so that the game starts right away and starts over whenever the player dies
+class HeadlessWindowing
+{
+private:
+	int m_Width;
+	int m_Height;
+
+public:
+	HeadlessWindowing(int width = 1280, int height = 720);
+	~HeadlessWindowing();
+
+	void DispatchMessages() const;
+
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+	inline float GetAspectRatio() const { return static_cast<float>(m_Width) / static_cast<float>(m_Height); }
+	inline bool IsFullscreen() const { return false; }
+	inline HWND GetWindowHandle() const { return nullptr; }
+};
+
+typedef HeadlessWindowing Windowing;
+
+#endif	// HEADLESS
\ No newline at end of file
@@ -5,7 +5,7 @@
 #include "Input.h"
 #include "Tools.h"
 
-#if !WINDOWS_PHONE
+#if !WINDOWS_PHONE && !HEADLESS
 
 DesktopWindowing::DesktopWindowing(int width, int height, bool fullscreen) :
 	m_WindowHandle(nullptr), m_ProgramInstance(GetModuleHandle(nullptr)), m_Fullscreen(fullscreen)
@@ -225,4 +225,4 @@ LRESULT DesktopWindowing::HandleRawInput(WPARAM wParam, LPARAM lParam) const
 	return DefRawInputProc(&raw, 1, sizeof(RAWINPUTHEADER));
 }
 
-#endif	// !WINDOWS_PHONE
\ No newline at end of file
+#endif	// !WINDOWS_PHONE && !HEADLESS
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 
-#if !WINDOWS_PHONE
+#if !WINDOWS_PHONE && !HEADLESS
 
 class DesktopWindowing
 {
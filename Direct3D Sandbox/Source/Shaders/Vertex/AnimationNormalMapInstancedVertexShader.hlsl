@@ -0,0 +1,57 @@
+cbuffer MatrixBuffer
+{
+    matrix viewProjectionMatrix;
+};
+
+// Per vertex inputs are laid out the same way as in AnimationNormalMapVertexShader, so both shaders share vertex buffers.
+// Everything that differs between zombies comes from the instance buffer at slot 3, which steps once per instance.
+// Its layout has to match AnimatedInstanceData. Rows of the world matrix transform the position one component at a time
+struct VertexInput
+{
+    float4 position : POSITION;
+	float3 normal : NORMAL;
+    float3 tangent : TANGENT;
+    float3 binormal : BINORMAL;
+	
+	float4 position2 : POSITION1;
+	float3 normal2 : NORMAL1;
+	float3 tangent2 : TANGENT1;
+	float3 binormal2 : BINORMAL1;
+
+	float2 tex : TEXTURECOORDINATES2;
+
+	float4 worldX : INSTANCEWORLDX3;
+	float4 worldY : INSTANCEWORLDY3;
+	float4 worldZ : INSTANCEWORLDZ3;
+	float3 normalX : INSTANCENORMALX3;
+	float3 normalY : INSTANCENORMALY3;
+	float3 normalZ : INSTANCENORMALZ3;
+	float frameProgress : INSTANCEFRAMEPROGRESS3;
+};
+
+struct PixelInput
+{
+    float4 position : SV_POSITION;
+    float2 tex : TEXTURECOORDINATES;
+	float3 normal : NORMAL;
+    float3 tangent : TANGENT;
+    float3 binormal : BINORMAL;
+};
+
+PixelInput main(VertexInput input)
+{
+    PixelInput output;
+
+	float4 position = lerp(input.position, input.position2, input.frameProgress);
+	float4 worldPosition = float4(dot(position, input.worldX), dot(position, input.worldY), dot(position, input.worldZ), 1.0f);
+	float3x3 normalMatrix = float3x3(input.normalX, input.normalY, input.normalZ);
+
+	output.position = mul(worldPosition, viewProjectionMatrix);
+
+    output.tex = input.tex;
+    output.normal = -mul(normalMatrix, lerp(input.normal, input.normal2, input.frameProgress));
+	output.tangent = mul(normalMatrix, lerp(input.tangent, input.tangent2, input.frameProgress));
+	output.binormal = mul(normalMatrix, lerp(input.binormal, input.binormal2, input.frameProgress));
+
+    return output;
+}
\ No newline at end of file
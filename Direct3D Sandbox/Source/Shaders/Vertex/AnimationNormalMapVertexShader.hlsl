@@ -5,10 +5,11 @@ cbuffer MatrixBuffer
 	float currentFrameProgress;
 };
 
+// Slots 0 and 1 hold the two frames being blended and share a layout. All frames live in one vertex buffer, which both slots bind
+// at the offsets of their frames. Texture coordinates don't change between frames and come from their own buffer at slot 2
 struct VertexInput
 {
     float4 position : POSITION;
-	float2 tex : TEXTURECOORDINATES;
 	float3 normal : NORMAL;
     float3 tangent : TANGENT;
     float3 binormal : BINORMAL;
@@ -17,6 +18,8 @@ struct VertexInput
 	float3 normal2 : NORMAL1;
 	float3 tangent2 : TANGENT1;
 	float3 binormal2 : BINORMAL1;
+
+	float2 tex : TEXTURECOORDINATES2;
 };
 
 struct PixelInput
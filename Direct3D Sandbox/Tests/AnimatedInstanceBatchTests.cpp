@@ -0,0 +1,133 @@
+#include "PrecompiledHeader.h"
+#include "RandomGenerator.h"
+#include "Source\Graphics\AnimatedInstanceBatch.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+// Instance told apart by its frame progress
+static AnimatedInstanceData MakeInstance(float frameProgress)
+{
+	AnimatedInstanceData instance;
+
+	memset(&instance, 0, sizeof(instance));
+	instance.frameProgress = frameProgress;
+
+	return instance;
+}
+
+TEST(AnimatedInstanceBatchGroupsByMaterialAndFrames)
+{
+	AnimatedInstanceBatch batch;
+
+	batch.Add(1, 5, 6, MakeInstance(0.0f));
+	batch.Add(0, 7, 8, MakeInstance(1.0f));
+	batch.Add(1, 5, 6, MakeInstance(2.0f));
+	batch.Add(1, 5, 7, MakeInstance(3.0f));
+	batch.Add(0, 7, 8, MakeInstance(4.0f));
+	batch.Add(1, 5, 6, MakeInstance(5.0f));
+	batch.Build();
+
+	const auto& buckets = batch.GetBuckets();
+	const auto& instances = batch.GetPackedInstances();
+
+	CHECK(batch.GetInstanceCount() == 6);
+	CHECK(instances.size() == 6);
+	CHECK(buckets.size() == 3);
+
+	if (buckets.size() != 3 || instances.size() != 6)
+	{
+		return;
+	}
+
+	CHECK(buckets[0].material == 0 && buckets[0].currentFrame == 7 && buckets[0].nextFrame == 8);
+	CHECK(buckets[0].firstInstance == 0 && buckets[0].instanceCount == 2);
+	CHECK(buckets[1].material == 1 && buckets[1].currentFrame == 5 && buckets[1].nextFrame == 6);
+	CHECK(buckets[1].firstInstance == 2 && buckets[1].instanceCount == 3);
+	CHECK(buckets[2].material == 1 && buckets[2].currentFrame == 5 && buckets[2].nextFrame == 7);
+	CHECK(buckets[2].firstInstance == 5 && buckets[2].instanceCount == 1);
+
+	// Instances of a bucket stay in the order they were added in
+	float expectedProgress[] = { 1.0f, 4.0f, 0.0f, 2.0f, 5.0f, 3.0f };
+
+	for (int i = 0; i < 6; i++)
+	{
+		CHECK(instances[i].frameProgress == expectedProgress[i]);
+	}
+}
+
+// Largest values of every sort key field come back out of it unchanged
+TEST(AnimatedInstanceBatchKeyFieldsDontOverlap)
+{
+	const auto kLastFrame = AnimatedInstanceBatch::kMaxFrameCount - 1;
+	const auto kLastMaterial = AnimatedInstanceBatch::kMaxMaterialCount - 1;
+
+	AnimatedInstanceBatch batch;
+	batch.Add(kLastMaterial, kLastFrame, 0, MakeInstance(0.0f));
+	batch.Add(0, 0, kLastFrame, MakeInstance(1.0f));
+	batch.Add(0, kLastFrame, kLastFrame, MakeInstance(2.0f));
+	batch.Build();
+
+	const auto& buckets = batch.GetBuckets();
+	CHECK(buckets.size() == 3);
+
+	if (buckets.size() != 3)
+	{
+		return;
+	}
+
+	CHECK(buckets[0].material == 0 && buckets[0].currentFrame == 0 && buckets[0].nextFrame == kLastFrame);
+	CHECK(buckets[1].material == 0 && buckets[1].currentFrame == kLastFrame && buckets[1].nextFrame == kLastFrame);
+	CHECK(buckets[2].material == kLastMaterial && buckets[2].currentFrame == kLastFrame && buckets[2].nextFrame == 0);
+}
+
+TEST(AnimatedInstanceBatchClear)
+{
+	AnimatedInstanceBatch batch;
+
+	CHECK(batch.IsEmpty());
+	batch.Add(0, 1, 2, MakeInstance(0.0f));
+	batch.Build();
+	CHECK(!batch.IsEmpty());
+
+	batch.Clear();
+	CHECK(batch.IsEmpty());
+	CHECK(batch.GetPackedInstances().empty());
+	CHECK(batch.GetBuckets().empty());
+
+	batch.Add(3, 4, 5, MakeInstance(1.0f));
+	batch.Build();
+	CHECK(batch.GetBuckets().size() == 1);
+	CHECK(batch.GetBuckets()[0].material == 3);
+}
+
+// A crowd of zombies animated with random frames of a 34 frame animation and a handful of materials
+BENCHMARK(AnimatedInstanceBatchBuild)
+{
+	const int kInstanceCount = 10000;
+	const int kFrameCount = 34;
+	const int kMaterialCount = 4;
+	const int kRepeatCount = 100;
+
+	AnimatedInstanceBatch batch;
+	RandomGenerator random(1);
+	auto totalTime = 0.0;
+
+	for (int repeat = 0; repeat < kRepeatCount; repeat++)
+	{
+		batch.Clear();
+
+		for (int i = 0; i < kInstanceCount; i++)
+		{
+			auto frame = random.NextUInt(kFrameCount);
+			batch.Add(random.NextUInt(kMaterialCount), frame, (frame + 1) % kFrameCount, MakeInstance(random.NextFloat()));
+		}
+
+		auto startTime = Tools::GetTime();
+		batch.Build();
+		totalTime += Tools::GetTime() - startTime;
+	}
+
+	UnitTest::ReportTime("Build", totalTime / kRepeatCount, kInstanceCount);
+	cout << "\t" << kInstanceCount << " instances in " << batch.GetBuckets().size() << " instanced draws" << endl;
+	CHECK(batch.GetBuckets().size() <= kFrameCount * kMaterialCount);
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "PrecompiledHeader.h"
+#include "Source\Graphics\AnimationFrameLayout.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+static const unsigned int kFrameByteSize = 1000;
+static const unsigned int kTotalFrameCount = 12;
+
+// Three states of 4, 3 and 5 frames, laid out one after another
+static void MakeStates(AnimatedModelState states[3])
+{
+	states[0].frameCount = 4;
+	states[0].frameOffset = 0;
+	states[1].frameCount = 3;
+	states[1].frameOffset = 4;
+	states[2].frameCount = 5;
+	states[2].frameOffset = 7;
+}
+
+static RenderParameters MakeParameters(int currentState, float currentProgress)
+{
+	RenderParameters renderParameters;
+
+	memset(&renderParameters, 0, sizeof(renderParameters));
+	renderParameters.currentAnimationState = currentState;
+	renderParameters.currentStateAnimationProgress = currentProgress;
+
+	return renderParameters;
+}
+
+TEST(AnimationFrameLayoutByteOffsets)
+{
+	AnimatedModelState states[3];
+	MakeStates(states);
+	AnimationFrameLayout layout(states, kTotalFrameCount, kFrameByteSize);
+
+	CHECK(layout.GetFrameByteOffset(0) == 0);
+	CHECK(layout.GetFrameByteOffset(1) == kFrameByteSize);
+	CHECK(layout.GetFrameByteOffset(7) == 7 * kFrameByteSize);
+	CHECK(layout.GetFrameByteOffset(kTotalFrameCount - 1) == (kTotalFrameCount - 1) * kFrameByteSize);
+}
+
+TEST(AnimationFrameLayoutFramesWithinState)
+{
+	AnimatedModelState states[3];
+	MakeStates(states);
+	AnimationFrameLayout layout(states, kTotalFrameCount, kFrameByteSize);
+	int currentFrame, nextFrame;
+
+	// 0.5 of 3 frames is half way between the second and the third frame of state 1
+	auto renderParameters = MakeParameters(1, 0.5f);
+	layout.GetFrames(renderParameters, currentFrame, nextFrame);
+
+	CHECK(currentFrame == 5);
+	CHECK(nextFrame == 6);
+	CHECK(fabs(renderParameters.currentFrameProgress - 0.5f) < 1e-5f);
+
+	renderParameters = MakeParameters(0, 0.0f);
+	layout.GetFrames(renderParameters, currentFrame, nextFrame);
+
+	CHECK(currentFrame == 0);
+	CHECK(nextFrame == 1);
+	CHECK(renderParameters.currentFrameProgress == 0.0f);
+}
+
+TEST(AnimationFrameLayoutWrapsWithinState)
+{
+	AnimatedModelState states[3];
+	MakeStates(states);
+	AnimationFrameLayout layout(states, kTotalFrameCount, kFrameByteSize);
+	int currentFrame, nextFrame;
+
+	// The last frame of a state blends into its own first frame, not into the next state's
+	auto renderParameters = MakeParameters(1, 0.9f);
+	layout.GetFrames(renderParameters, currentFrame, nextFrame);
+
+	CHECK(currentFrame == 6);
+	CHECK(nextFrame == 4);
+	CHECK(fabs(renderParameters.currentFrameProgress - 0.7f) < 1e-5f);
+
+	renderParameters = MakeParameters(2, 0.9f);
+	layout.GetFrames(renderParameters, currentFrame, nextFrame);
+
+	CHECK(currentFrame == 11);
+	CHECK(nextFrame == 7);
+	CHECK(static_cast<unsigned int>(nextFrame) < kTotalFrameCount);
+}
+
+TEST(AnimationFrameLayoutFramesWhileTransitioning)
+{
+	AnimatedModelState states[3];
+	MakeStates(states);
+	AnimationFrameLayout layout(states, kTotalFrameCount, kFrameByteSize);
+	int currentFrame, nextFrame;
+
+	// Blends from the current state's frame into the target state's, by how far the transition is
+	auto renderParameters = MakeParameters(0, 0.75f);
+	renderParameters.isTransitioningAnimationStates = true;
+	renderParameters.targetAnimationState = 2;
+	renderParameters.targetStateAnimationProgress = 0.4f;
+	renderParameters.transitionProgress = 0.25f;
+	layout.GetFrames(renderParameters, currentFrame, nextFrame);
+
+	CHECK(currentFrame == 3);
+	CHECK(nextFrame == 9);
+	CHECK(renderParameters.currentFrameProgress == 0.25f);
+	CHECK(layout.GetFrameByteOffset(nextFrame) == 9 * kFrameByteSize);
+}
\ No newline at end of file
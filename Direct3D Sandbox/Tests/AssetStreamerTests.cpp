@@ -0,0 +1,96 @@
+#include "PrecompiledHeader.h"
+#include "AssetStreamer.h"
+#include "Source\Audio\AudioManager.h"
+#include "Source\Graphics\Font.h"
+#include "Source\Graphics\IModel.h"
+#include "Source\Graphics\Texture.h"
+#include "TestDevice.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+// Starts loading every matching file under the directory the way System does at startup, and adds their paths to the list
+static void StreamAssets(const wstring& directory, const wstring& searchPattern, void (*load)(const wstring& path), vector<wstring>& paths)
+{
+	for (const auto& file : Tools::GetFilesInDirectory(directory, searchPattern, true))
+	{
+		load(file);
+		paths.push_back(file);
+	}
+}
+
+static void LoadColorTexture(const wstring& path)
+{
+	Texture::LoadTexture(path, TextureKind::ColorTexture);
+}
+
+static void LoadNormalMap(const wstring& path)
+{
+	Texture::LoadTexture(path, TextureKind::NormalMapTexture);
+}
+
+// Streams everything under the game's Assets through the same loaders as the game, on a headless device and without audio output.
+// The time until AssetStreamer goes idle is what the game waits for before every asset has replaced its placeholder
+BENCHMARK(AssetStreamerStreamAllAssets)
+{
+	// Models and fonts only exist once the postprocessor has written them into the game's output directory
+	auto gameDirectory = UnitTest::GetGameDirectory();
+	CHECK(!gameDirectory.empty());
+
+	if (gameDirectory.empty())
+	{
+		return;
+	}
+
+	wchar_t testDirectory[MAX_PATH];
+	GetCurrentDirectoryW(MAX_PATH, testDirectory);
+	SetCurrentDirectoryW(gameDirectory.c_str());
+
+	TestDevice::GetRecorder();
+	AudioManager::Initialize();
+
+	vector<wstring> textures, fonts, models, sounds;
+	auto startTime = Tools::GetTime();
+
+	StreamAssets(L"Assets\\Textures", L"*.dds", LoadColorTexture, textures);
+	StreamAssets(L"Assets\\Normal Maps", L"*.dds", LoadNormalMap, textures);
+	StreamAssets(L"Assets\\Fonts", L"*.font", Font::LoadFont, fonts);
+	StreamAssets(L"Assets\\Models", L"*.model", IModel::Prefetch, models);
+	StreamAssets(L"Assets\\Animated Models", L"*.animatedModel", IModel::Prefetch, models);
+	StreamAssets(L"Assets\\Sounds", L"*.wav", AudioManager::PrefetchSound, sounds);
+
+	auto startedTime = Tools::GetTime();
+
+	while (!AssetStreamer::IsIdle())
+	{
+		Sleep(1);
+	}
+
+	auto readyTime = Tools::GetTime();
+	AssetStreamer::Update();
+
+	auto fileCount = textures.size() + fonts.size() + models.size() + sounds.size();
+	Tools::Report(L"\tStreamed " + to_wstring(textures.size()) + L" textures, " + to_wstring(fonts.size()) + L" fonts, " + to_wstring(models.size()) + 
+		L" models and " + to_wstring(sounds.size()) + L" sounds");
+	Tools::Report(L"\tStarting the loads took " + to_wstring(1000.0 * (startedTime - startTime)) + L" ms, all of them were ready after " + 
+		to_wstring(1000.0 * (readyTime - startTime)) + L" ms (" + to_wstring(1000.0 * (readyTime - startTime) / fileCount) + L" ms per file)");
+
+	CHECK(!textures.empty() && !fonts.empty() && !models.empty() && !sounds.empty());
+
+	for (const auto& texture : textures)
+	{
+		CHECK(Texture::Get(texture).IsReady() && Texture::Get(texture).Resolve() != nullptr);
+	}
+
+	// Fonts assert when they fail to load
+	for (const auto& font : fonts)
+	{
+		Font::Get(font);
+	}
+
+	for (const auto& model : models)
+	{
+		CHECK(IModel::GetModelData(model).vertexCount > 0);
+	}
+
+	SetCurrentDirectoryW(testDirectory);
+}
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "PrecompiledHeader.h"
+#include "Parameters.h"
+#include "Source\Graphics\ConstantBuffer.h"
+#include "Source\Graphics\ConstantRingBuffer.h"
+#include "TestDevice.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+struct FieldPlacement
+{
+	const char* name;
+	unsigned int byteOffset;
+};
+
+static void AddUInt(vector<uint8_t>& metadata, unsigned int value)
+{
+	auto position = metadata.size();
+
+	metadata.resize(position + 4);
+	memcpy(&metadata[position], &value, 4);
+}
+
+// Writes the metadata the postprocessor would for a constant buffer reading the given render parameters at the given offsets
+static vector<uint8_t> MakeMetadata(const FieldPlacement fields[], size_t fieldCount, unsigned int bufferSize)
+{
+	vector<uint8_t> metadata;
+
+	AddUInt(metadata, static_cast<unsigned int>(fieldCount));
+	AddUInt(metadata, bufferSize);
+
+	for (auto i = 0u; i < fieldCount; i++)
+	{
+		auto description = RenderParameters::GetFieldDescription(fields[i].name);
+		Assert(description != nullptr);
+
+		AddUInt(metadata, description->offset);
+		AddUInt(metadata, fields[i].byteOffset);
+		AddUInt(metadata, description->shaderSize);
+	}
+
+	return metadata;
+}
+
+static ConstantBuffer MakeConstantBuffer(const FieldPlacement fields[], size_t fieldCount, unsigned int bufferSize)
+{
+	TestDevice::GetRecorder();
+
+	auto metadata = MakeMetadata(fields, fieldCount, bufferSize);
+	auto byteOffset = 0u;
+
+	return ConstantBuffer(metadata, byteOffset);
+}
+
+// Stages the parameters the way the renderer does, uploading to the ring buffer when there is one
+static void Stage(ConstantBuffer& constantBuffer, const RenderParameters& renderParameters)
+{
+	if (constantBuffer.StageRenderParameters(renderParameters))
+	{
+		vector<uint8_t> ringMemory(constantBuffer.GetRingSize());
+		auto destination = ringMemory.data();
+		auto firstConstant = 0u;
+
+		constantBuffer.UploadToRing(destination, firstConstant);
+	}
+}
+
+static void InitializeRenderParameters(RenderParameters& renderParameters)
+{
+	memset(&renderParameters, 0, sizeof(renderParameters));
+
+	renderParameters.time = 1.0f;
+	renderParameters.frameTime = 2.0f;
+	renderParameters.tickInterpolation = 3.0f;
+	renderParameters.color = DirectX::XMFLOAT4(4.0f, 5.0f, 6.0f, 7.0f);
+	renderParameters.lightDirection = DirectX::XMFLOAT3(8.0f, 9.0f, 10.0f);
+}
+
+// Laid out like HLSL would: the three floats share a register, the others start registers of their own
+static const FieldPlacement kSeparateFields[] = 
+{
+	{ "time", 0 },
+	{ "frameTime", 4 },
+	{ "tickInterpolation", 8 },
+	{ "color", 16 },
+	{ "lightDirection", 32 }
+};
+
+static const unsigned int kSeparateFieldsBufferSize = 48;
+
+TEST(ConstantBufferSkipsUnchangedParameters)
+{
+	RenderParameters renderParameters;
+	InitializeRenderParameters(renderParameters);
+
+	auto constantBuffer = MakeConstantBuffer(kSeparateFields, ARRAYSIZE(kSeparateFields), kSeparateFieldsBufferSize);
+	const auto& statistics = constantBuffer.GetStatistics();
+
+	// Every field read differs from the zeroed image at first
+	Stage(constantBuffer, renderParameters);
+	CHECK(statistics.stagedByteCount == 3 * 4 + 16 + 12);
+	CHECK(statistics.uploadCount == 1);
+	CHECK(statistics.uploadedByteCount == kSeparateFieldsBufferSize);
+
+	Stage(constantBuffer, renderParameters);
+	Stage(constantBuffer, renderParameters);
+	CHECK(statistics.stagedByteCount == 3 * 4 + 16 + 12);
+	CHECK(statistics.uploadCount == 1);
+
+	// Parameters the buffer doesn't read change nothing
+	renderParameters.screenWidth = 1280;
+	renderParameters.ambientColor = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
+	Stage(constantBuffer, renderParameters);
+	CHECK(statistics.stagedByteCount == 3 * 4 + 16 + 12);
+	CHECK(statistics.uploadCount == 1);
+}
+
+TEST(ConstantBufferStagesOnlyChangedField)
+{
+	RenderParameters renderParameters;
+	InitializeRenderParameters(renderParameters);
+
+	auto constantBuffer = MakeConstantBuffer(kSeparateFields, ARRAYSIZE(kSeparateFields), kSeparateFieldsBufferSize);
+	const auto& statistics = constantBuffer.GetStatistics();
+
+	Stage(constantBuffer, renderParameters);
+	auto stagedByteCount = statistics.stagedByteCount;
+
+	// A run shorter than a block gets compared a word at a time
+	renderParameters.frameTime = 20.0f;
+	Stage(constantBuffer, renderParameters);
+	CHECK(statistics.stagedByteCount == stagedByteCount + 4);
+	CHECK(statistics.uploadCount == 2);
+	CHECK(statistics.uploadedByteCount == 2 * kSeparateFieldsBufferSize);
+
+	// A whole block goes when any of it changed
+	renderParameters.color.y = 50.0f;
+	Stage(constantBuffer, renderParameters);
+	CHECK(statistics.stagedByteCount == stagedByteCount + 4 + 16);
+	CHECK(statistics.uploadCount == 3);
+
+	// Setting a field back to what the image holds is a change as well
+	renderParameters.color.y = 5.0f;
+	Stage(constantBuffer, renderParameters);
+	CHECK(statistics.stagedByteCount == stagedByteCount + 4 + 16 + 16);
+	CHECK(statistics.uploadCount == 4);
+
+	Stage(constantBuffer, renderParameters);
+	CHECK(statistics.uploadCount == 4);
+}
+
+// Fields that follow each other both in RenderParameters and in the buffer get compared as one run, 16 bytes at a time
+TEST(ConstantBufferMergesContiguousFields)
+{
+	const FieldPlacement kContiguousFields[] = 
+	{
+		{ "color", 12 },
+		{ "time", 0 },
+		{ "tickInterpolation", 8 },
+		{ "frameTime", 4 }
+	};
+
+	// The same fields with a gap in the buffer, which keeps color apart from the floats
+	const FieldPlacement kGappedFields[] = 
+	{
+		{ "time", 0 },
+		{ "frameTime", 4 },
+		{ "tickInterpolation", 8 },
+		{ "color", 16 }
+	};
+
+	CHECK(offsetof(RenderParameters, color) == offsetof(RenderParameters, time) + 12);
+
+	RenderParameters renderParameters;
+	InitializeRenderParameters(renderParameters);
+
+	auto mergedBuffer = MakeConstantBuffer(kContiguousFields, ARRAYSIZE(kContiguousFields), 32);
+	auto gappedBuffer = MakeConstantBuffer(kGappedFields, ARRAYSIZE(kGappedFields), 32);
+
+	Stage(mergedBuffer, renderParameters);
+	Stage(gappedBuffer, renderParameters);
+	CHECK(mergedBuffer.GetStatistics().stagedByteCount == 28);
+	CHECK(gappedBuffer.GetStatistics().stagedByteCount == 28);
+
+	// The merged run's first block holds time, frameTime, tickInterpolation and color.x
+	renderParameters.frameTime = 20.0f;
+	Stage(mergedBuffer, renderParameters);
+	Stage(gappedBuffer, renderParameters);
+	CHECK(mergedBuffer.GetStatistics().stagedByteCount == 28 + 16);
+	CHECK(gappedBuffer.GetStatistics().stagedByteCount == 28 + 4);
+
+	// The rest of the merged run is shorter than a block
+	renderParameters.color.w = 70.0f;
+	Stage(mergedBuffer, renderParameters);
+	Stage(gappedBuffer, renderParameters);
+	CHECK(mergedBuffer.GetStatistics().stagedByteCount == 28 + 16 + 4);
+	CHECK(gappedBuffer.GetStatistics().stagedByteCount == 28 + 4 + 16);
+
+	CHECK(mergedBuffer.GetStatistics().uploadCount == 3);
+	CHECK(gappedBuffer.GetStatistics().uploadCount == 3);
+}
+
+TEST(ConstantBufferTotalStatistics)
+{
+	RenderParameters renderParameters;
+	InitializeRenderParameters(renderParameters);
+
+	auto firstBuffer = MakeConstantBuffer(kSeparateFields, ARRAYSIZE(kSeparateFields), kSeparateFieldsBufferSize);
+	auto secondBuffer = MakeConstantBuffer(kSeparateFields, 3, 16);
+	ConstantBuffer::ConsumeTotalStatistics();
+
+	Stage(firstBuffer, renderParameters);
+	Stage(secondBuffer, renderParameters);
+	Stage(secondBuffer, renderParameters);
+
+	auto statistics = ConstantBuffer::ConsumeTotalStatistics();
+	CHECK(statistics.stagedByteCount == 3 * 4 + 16 + 12 + 3 * 4);
+	CHECK(statistics.uploadCount == 2);
+	CHECK(statistics.uploadedByteCount == kSeparateFieldsBufferSize + 16);
+
+	statistics = ConstantBuffer::ConsumeTotalStatistics();
+	CHECK(statistics.stagedByteCount == 0 && statistics.uploadCount == 0 && statistics.uploadedByteCount == 0);
+}
\ No newline at end of file
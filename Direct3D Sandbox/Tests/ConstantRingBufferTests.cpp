@@ -0,0 +1,141 @@
+#include "PrecompiledHeader.h"
+#include "Source\Graphics\ConstantRingBuffer.h"
+#include "Source\Graphics\Direct3D.h"
+#include "Source\Graphics\RecordingDeviceContext.h"
+#include "TestDevice.h"
+#include "UnitTest.h"
+
+// Returns null if the device can't bind constant buffers by offset. Otherwise something has been written to the ring buffer already,
+// so that the test's first map isn't the one that discards it, and the recorder starts a new frame
+static RecordingDeviceContext* BeginRingBufferTest()
+{
+	auto& recorder = TestDevice::GetRecorder();
+
+	if (!ConstantRingBuffer::IsSupported())
+	{
+		cout << "\tSkipped: the device can't bind constant buffers by offset" << endl;
+		return nullptr;
+	}
+
+	unsigned int firstConstant;
+	ConstantRingBuffer::Reserve(ConstantRingBuffer::kAlignment);
+	ConstantRingBuffer::Map(ConstantRingBuffer::kAlignment, firstConstant);
+	ConstantRingBuffer::Unmap();
+
+	recorder.EndFrame();
+	return &recorder;
+}
+
+TEST(ConstantRingBufferAlign)
+{
+	CHECK(ConstantRingBuffer::Align(0) == 0);
+	CHECK(ConstantRingBuffer::Align(1) == ConstantRingBuffer::kAlignment);
+	CHECK(ConstantRingBuffer::Align(ConstantRingBuffer::kAlignment) == ConstantRingBuffer::kAlignment);
+	CHECK(ConstantRingBuffer::Align(ConstantRingBuffer::kAlignment + 1) == 2 * ConstantRingBuffer::kAlignment);
+}
+
+TEST(ConstantRingBufferMapsAppend)
+{
+	auto recorder = BeginRingBufferTest();
+
+	if (recorder == nullptr)
+	{
+		return;
+	}
+
+	auto generation = ConstantRingBuffer::GetGeneration();
+	unsigned int firstConstant, secondConstant;
+
+	ConstantRingBuffer::Reserve(2 * ConstantRingBuffer::kAlignment);
+	ConstantRingBuffer::Map(ConstantRingBuffer::kAlignment, firstConstant);
+	ConstantRingBuffer::Unmap();
+	ConstantRingBuffer::Map(ConstantRingBuffer::kAlignment, secondConstant);
+	ConstantRingBuffer::Unmap();
+	recorder->EndFrame();
+
+	const auto& statistics = recorder->GetLastFrameStatistics();
+
+	CHECK(ConstantRingBuffer::GetGeneration() == generation);
+	CHECK(firstConstant % 16 == 0);
+	CHECK(secondConstant == firstConstant + ConstantRingBuffer::kAlignment / 16);
+	CHECK(statistics.callCounts[MAP] == 2);
+	CHECK(statistics.uploadedByteCount == 0);
+}
+
+// Reserving more than is left before the end starts over from the beginning, which discards the buffer once
+TEST(ConstantRingBufferWrapsAround)
+{
+	auto recorder = BeginRingBufferTest();
+
+	if (recorder == nullptr)
+	{
+		return;
+	}
+
+	auto generation = ConstantRingBuffer::GetGeneration();
+	unsigned int firstConstant, secondConstant;
+
+	ConstantRingBuffer::Reserve(ConstantRingBuffer::kSize);
+	ConstantRingBuffer::Map(ConstantRingBuffer::kAlignment, firstConstant);
+	ConstantRingBuffer::Unmap();
+	ConstantRingBuffer::Map(ConstantRingBuffer::kAlignment, secondConstant);
+	ConstantRingBuffer::Unmap();
+	recorder->EndFrame();
+
+	CHECK(ConstantRingBuffer::GetGeneration() == generation + 1);
+	CHECK(firstConstant == 0);
+	CHECK(secondConstant == ConstantRingBuffer::kAlignment / 16);
+	CHECK(recorder->GetLastFrameStatistics().uploadedByteCount == ConstantRingBuffer::kSize);
+}
+
+// Maps between BeginBatch and EndBatch don't touch the buffer, EndBatch writes all of them with one map
+TEST(ConstantRingBufferBatchMapsOnce)
+{
+	const unsigned int kMapCount = 3;
+	auto recorder = BeginRingBufferTest();
+
+	if (recorder == nullptr)
+	{
+		return;
+	}
+
+	auto batchIndex = ConstantRingBuffer::GetBatchIndex();
+	unsigned int firstConstants[kMapCount];
+
+	ConstantRingBuffer::BeginBatch(kMapCount * ConstantRingBuffer::kAlignment);
+
+	for (auto i = 0u; i < kMapCount; i++)
+	{
+		auto destination = ConstantRingBuffer::Map(ConstantRingBuffer::kAlignment, firstConstants[i]);
+		memset(destination, i + 1, ConstantRingBuffer::kAlignment);
+		ConstantRingBuffer::Unmap();
+	}
+
+	recorder->EndFrame();
+	CHECK(recorder->GetLastFrameStatistics().callCounts[MAP] == 0);
+
+	ConstantRingBuffer::EndBatch();
+	recorder->EndFrame();
+
+	CHECK(recorder->GetLastFrameStatistics().callCounts[MAP] == 1);
+	CHECK(recorder->GetLastFrameStatistics().callCounts[UNMAP] == 1);
+	CHECK(ConstantRingBuffer::GetBatchIndex() == batchIndex + 1);
+
+	for (auto i = 1u; i < kMapCount; i++)
+	{
+		CHECK(firstConstants[i] == firstConstants[i - 1] + ConstantRingBuffer::kAlignment / 16);
+	}
+
+	// The recorder keeps what was written between maps, like the buffer would
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	GetD3D11DeviceContext()->Map(ConstantRingBuffer::GetBuffer(), 0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedResource);
+	auto data = static_cast<const uint8_t*>(mappedResource.pData);
+
+	for (auto i = 0u; i < kMapCount; i++)
+	{
+		CHECK(data[16 * firstConstants[i]] == i + 1);
+		CHECK(data[16 * firstConstants[i] + ConstantRingBuffer::kAlignment - 1] == i + 1);
+	}
+
+	GetD3D11DeviceContext()->Unmap(ConstantRingBuffer::GetBuffer(), 0);
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "PrecompiledHeader.h"
+#include "FrameDeltaCoding.h"
+#include "RandomGenerator.h"
+#include "Tools.h"
+#include "UnitTest.h"
+#include "VertexPacking.h"
+
+// Frames of a mesh whose vertices drift a little every frame, plus a few channels that jump across their whole range
+static vector<PackedVertexParameters> MakeFrames(size_t vertexCount, size_t frameCount, uint64_t seed)
+{
+	RandomGenerator random(seed);
+	vector<PackedVertexParameters> frames(vertexCount * frameCount);
+
+	for (auto i = 0u; i < vertexCount; i++)
+	{
+		PackedVertexParameters vertex;
+
+		for (int j = 0; j < 3; j++)
+		{
+			vertex.position[j] = static_cast<uint16_t>(random.NextUInt());
+		}
+
+		for (int j = 0; j < 2; j++)
+		{
+			vertex.textureCoordinates[j] = static_cast<uint16_t>(random.NextUInt());
+			vertex.normal[j] = static_cast<int16_t>(random.NextUInt());
+			vertex.tangent[j] = static_cast<int16_t>(random.NextUInt());
+			vertex.binormal[j] = static_cast<int16_t>(random.NextUInt());
+		}
+
+		for (auto frame = 0u; frame < frameCount; frame++)
+		{
+			auto& frameVertex = frames[frame * vertexCount + i];
+			frameVertex = vertex;
+
+			for (int j = 0; j < 3; j++)
+			{
+				frameVertex.position[j] = static_cast<uint16_t>(frameVertex.position[j] + random.NextInteger(-200, 200));
+			}
+
+			frameVertex.normal[0] = static_cast<int16_t>(frameVertex.normal[0] + random.NextInteger(-50, 50));
+			frameVertex.binormal[1] = static_cast<int16_t>(random.NextUInt());
+		}
+	}
+
+	return frames;
+}
+
+// Decodes into vertices that already hold the texture coordinates, the way model loading does
+static bool Decode(const vector<uint8_t>& data, const vector<PackedVertexParameters>& frames, size_t vertexCount, size_t frameCount, vector<PackedVertexParameters>& decodedFrames)
+{
+	decodedFrames.assign(frames.size(), PackedVertexParameters());
+
+	for (auto i = 0u; i < frames.size(); i++)
+	{
+		memcpy(decodedFrames[i].textureCoordinates, frames[i].textureCoordinates, sizeof(frames[i].textureCoordinates));
+	}
+
+	return FrameDeltaCoding::Decode(data.data(), data.size(), vertexCount, frameCount, decodedFrames.data());
+}
+
+TEST(FrameDeltaCodingRoundTrip)
+{
+	// Not a multiple of the block size, so the last block of every channel is a short one
+	const size_t kVertexCount = 37;
+	const size_t kFrameCount = 5;
+
+	auto frames = MakeFrames(kVertexCount, kFrameCount, 1);
+	vector<uint8_t> data;
+	vector<PackedVertexParameters> decodedFrames;
+
+	FrameDeltaCoding::Encode(frames.data(), kVertexCount, kFrameCount, data);
+
+	CHECK(Decode(data, frames, kVertexCount, kFrameCount, decodedFrames));
+	CHECK(memcmp(decodedFrames.data(), frames.data(), frames.size() * sizeof(PackedVertexParameters)) == 0);
+	CHECK(data.size() >= FrameDeltaCoding::GetMinimumEncodedSize(kVertexCount, kFrameCount));
+}
+
+TEST(FrameDeltaCodingStillFramesTakeMinimumSize)
+{
+	const size_t kVertexCount = 40;
+	const size_t kFrameCount = 3;
+
+	vector<PackedVertexParameters> frames(kVertexCount * kFrameCount);
+	memset(frames.data(), 0, frames.size() * sizeof(PackedVertexParameters));
+
+	vector<uint8_t> data;
+	vector<PackedVertexParameters> decodedFrames;
+
+	FrameDeltaCoding::Encode(frames.data(), kVertexCount, kFrameCount, data);
+
+	CHECK(data.size() == FrameDeltaCoding::GetMinimumEncodedSize(kVertexCount, kFrameCount));
+	CHECK(Decode(data, frames, kVertexCount, kFrameCount, decodedFrames));
+	CHECK(memcmp(decodedFrames.data(), frames.data(), frames.size() * sizeof(PackedVertexParameters)) == 0);
+}
+
+TEST(FrameDeltaCodingRejectsBadData)
+{
+	const size_t kVertexCount = 20;
+	const size_t kFrameCount = 2;
+
+	auto frames = MakeFrames(kVertexCount, kFrameCount, 2);
+	vector<uint8_t> data;
+	vector<PackedVertexParameters> decodedFrames;
+
+	FrameDeltaCoding::Encode(frames.data(), kVertexCount, kFrameCount, data);
+
+	auto truncatedData = data;
+	truncatedData.pop_back();
+	CHECK(!Decode(truncatedData, frames, kVertexCount, kFrameCount, decodedFrames));
+
+	auto paddedData = data;
+	paddedData.push_back(0);
+	CHECK(!Decode(paddedData, frames, kVertexCount, kFrameCount, decodedFrames));
+
+	auto corruptData = data;
+	corruptData[0] = 17;
+	CHECK(!Decode(corruptData, frames, kVertexCount, kFrameCount, decodedFrames));
+
+	CHECK(!Decode(vector<uint8_t>(), frames, kVertexCount, kFrameCount, decodedFrames));
+}
+
+// Frames the size of the zombie model's animation
+BENCHMARK(FrameDeltaCodingDecode)
+{
+	const size_t kVertexCount = 8857;
+	const size_t kFrameCount = 34;
+
+	auto frames = MakeFrames(kVertexCount, kFrameCount, 3);
+	vector<uint8_t> data;
+	vector<PackedVertexParameters> decodedFrames;
+
+	auto startTime = Tools::GetTime();
+	FrameDeltaCoding::Encode(frames.data(), kVertexCount, kFrameCount, data);
+	UnitTest::ReportTime("Encode", Tools::GetTime() - startTime, frames.size());
+
+	startTime = Tools::GetTime();
+	auto isDecoded = Decode(data, frames, kVertexCount, kFrameCount, decodedFrames);
+	UnitTest::ReportTime("Decode", Tools::GetTime() - startTime, frames.size());
+
+	cout << "\tEncoded size: " << data.size() << " bytes, " << 100.0 * data.size() / (frames.size() * sizeof(PackedVertexParameters)) << "% of packed frames" << endl;
+	CHECK(isDecoded);
+}
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include "PrecompiledHeader.h"
+#include "Input.h"
+#include "InputRecording.h"
+#include "RandomGenerator.h"
+#include "UnitTest.h"
+
+#include <limits>
+
+static const wchar_t kRecordingPath[] = L"InputRecordingTests.rec";
+static const unsigned int kSeed = 4321;
+static const float kTickRate = 60.0f;
+
+// The header is four 32-bit fields: magic, version, seed and tick rate. The first tick entry follows, starting with its tick index and change count
+static const size_t kVersionOffset = 4;
+static const size_t kTickRateOffset = 12;
+static const size_t kFirstEntryChangeCountOffset = 20;
+
+static bool StatesMatch(const InputState& left, const InputState& right)
+{
+	return memcmp(left.keyMap, right.keyMap, sizeof(left.keyMap)) == 0 &&
+		memcmp(left.mouseButtonMap, right.mouseButtonMap, sizeof(left.mouseButtonMap)) == 0 &&
+		left.mouseX == right.mouseX && left.mouseY == right.mouseY &&
+		left.pinchDisplacement == right.pinchDisplacement &&
+		left.mouseWheelDisplacement == right.mouseWheelDisplacement;
+}
+
+// Letter keys and mouse buttons get pressed and released at random, with displacements on some ticks and long stretches where nothing changes.
+// Keys the application handles itself are left alone, as setting input state doesn't change them
+static vector<InputState> MakeSession(size_t tickCount)
+{
+	RandomGenerator random(7);
+	vector<InputState> states(tickCount);
+
+	for (size_t i = 0; i < tickCount; i++)
+	{
+		if (i > 0)
+		{
+			memcpy(states[i].keyMap, states[i - 1].keyMap, sizeof(states[i].keyMap));
+			memcpy(states[i].mouseButtonMap, states[i - 1].mouseButtonMap, sizeof(states[i].mouseButtonMap));
+		}
+
+		if (i % 50 >= 30)
+		{
+			continue;
+		}
+
+		if (random.NextUInt(4) == 0)
+		{
+			auto key = 'A' + random.NextUInt(26);
+			states[i].keyMap[key] = !states[i].keyMap[key];
+		}
+
+		if (random.NextUInt(8) == 0)
+		{
+			auto button = random.NextUInt(InputState::kMouseButtonCount);
+			states[i].mouseButtonMap[button] = !states[i].mouseButtonMap[button];
+		}
+
+		if (random.NextUInt(3) == 0)
+		{
+			states[i].mouseX = static_cast<long>(random.NextUInt(41)) - 20;
+			states[i].mouseY = static_cast<long>(random.NextUInt(41)) - 20;
+		}
+
+		if (random.NextUInt(10) == 0)
+		{
+			states[i].mouseWheelDisplacement = 120;
+			states[i].pinchDisplacement = -3;
+		}
+	}
+
+	return states;
+}
+
+static bool Record(const vector<InputState>& states, unsigned int firstTick)
+{
+	auto& input = Input::GetInstance();
+	auto recording = InputRecording::StartRecording(kRecordingPath, kSeed, kTickRate);
+
+	if (recording == nullptr)
+	{
+		return false;
+	}
+
+	for (auto i = 0u; i < states.size(); i++)
+	{
+		input.SetState(states[i]);
+		recording->Update(input, firstTick + i);
+	}
+
+	input.SetState(InputState());
+	return true;
+}
+
+static vector<char> ReadRecording()
+{
+	ifstream in(kRecordingPath, ios::binary);
+	return vector<char>((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+}
+
+static void WriteRecording(const vector<char>& file)
+{
+	ofstream out(kRecordingPath, ios::binary | ios::trunc);
+	out.write(file.data(), file.size());
+}
+
+template <typename T>
+static void Patch(vector<char>& file, size_t offset, T value)
+{
+	memcpy(file.data() + offset, &value, sizeof(value));
+}
+
+static bool CanReplay(const vector<char>& file)
+{
+	WriteRecording(file);
+	return InputRecording::StartReplaying(kRecordingPath) != nullptr;
+}
+
+// Replays start on a different tick than the recording did, and whatever the window sent in between gets overwritten
+TEST(InputRecordingReplaysRecordedSession)
+{
+	const size_t kTickCount = 500;
+
+	auto& input = Input::GetInstance();
+	auto states = MakeSession(kTickCount);
+
+	CHECK(Record(states, 17));
+
+	auto replay = InputRecording::StartReplaying(kRecordingPath);
+	CHECK(replay != nullptr);
+
+	if (replay != nullptr)
+	{
+		CHECK(replay->GetSeed() == kSeed);
+		CHECK(replay->GetTickRate() == kTickRate);
+
+		auto matchingTicks = 0u;
+
+		for (auto i = 0u; i < kTickCount; i++)
+		{
+			InputState replayed;
+
+			input.KeyDown('Q');
+			input.SetMouseDisplacement(5, 5);
+			replay->Update(input, 1000 + i);
+			input.GetState(replayed);
+
+			matchingTicks += StatesMatch(replayed, states[i]) ? 1 : 0;
+			CHECK(!replay->IsFinished());
+		}
+
+		CHECK(matchingTicks == kTickCount);
+
+		// The tick after the last one recorded ends the replay
+		replay->Update(input, 1000 + kTickCount);
+		CHECK(replay->IsFinished());
+		replay = nullptr;
+	}
+
+	input.SetState(InputState());
+	DeleteFileW(kRecordingPath);
+}
+
+// A recording where nothing was pressed still lasts as many ticks as the session did
+TEST(InputRecordingReplaysIdleSession)
+{
+	const size_t kTickCount = 40;
+
+	auto& input = Input::GetInstance();
+	CHECK(Record(vector<InputState>(kTickCount), 0));
+
+	auto replay = InputRecording::StartReplaying(kRecordingPath);
+	CHECK(replay != nullptr);
+
+	if (replay != nullptr)
+	{
+		for (auto i = 0u; i < kTickCount; i++)
+		{
+			replay->Update(input, i);
+			CHECK(!replay->IsFinished());
+		}
+
+		replay->Update(input, kTickCount);
+		CHECK(replay->IsFinished());
+		replay = nullptr;
+	}
+
+	input.SetState(InputState());
+	DeleteFileW(kRecordingPath);
+}
+
+TEST(InputRecordingRejectsMalformedHeader)
+{
+	CHECK(InputRecording::StartReplaying(L"InputRecordingTests.missing") == nullptr);
+	CHECK(Record(MakeSession(100), 0));
+
+	auto file = ReadRecording();
+	CHECK(CanReplay(file));
+
+	CHECK(!CanReplay(vector<char>()));
+	CHECK(!CanReplay(vector<char>(file.begin(), file.begin() + 15)));
+
+	auto damagedFile = file;
+	damagedFile[0] ^= 1;
+	CHECK(!CanReplay(damagedFile));
+
+	damagedFile = file;
+	Patch<uint32_t>(damagedFile, kVersionOffset, 2);
+	CHECK(!CanReplay(damagedFile));
+
+	const float kBadTickRates[] = { 0.0f, -60.0f, numeric_limits<float>::infinity(), numeric_limits<float>::quiet_NaN() };
+
+	for (auto tickRate : kBadTickRates)
+	{
+		damagedFile = file;
+		Patch(damagedFile, kTickRateOffset, tickRate);
+		CHECK(!CanReplay(damagedFile));
+	}
+
+	DeleteFileW(kRecordingPath);
+}
+
+// Damaged or cut off tick entries end the replay where they start, rather than feeding it garbage
+TEST(InputRecordingStopsAtDamagedEntries)
+{
+	const size_t kTickCount = 100;
+
+	auto& input = Input::GetInstance();
+	auto states = MakeSession(kTickCount);
+
+	CHECK(Record(states, 0));
+	auto file = ReadRecording();
+
+	Patch<uint32_t>(file, kFirstEntryChangeCountOffset, 0xFFFFFFFF);
+	WriteRecording(file);
+
+	auto replay = InputRecording::StartReplaying(kRecordingPath);
+	CHECK(replay != nullptr);
+
+	if (replay != nullptr)
+	{
+		replay->Update(input, 0);
+		CHECK(replay->IsFinished());
+		replay = nullptr;
+	}
+
+	// Cut in the middle of the session, the replay plays what's left and then finishes early
+	CHECK(Record(states, 0));
+	file = ReadRecording();
+	WriteRecording(vector<char>(file.begin(), file.begin() + file.size() / 2));
+
+	replay = InputRecording::StartReplaying(kRecordingPath);
+	CHECK(replay != nullptr);
+
+	if (replay != nullptr)
+	{
+		auto tickCount = 0u;
+
+		for (; tickCount <= kTickCount && !replay->IsFinished(); tickCount++)
+		{
+			replay->Update(input, tickCount);
+		}
+
+		CHECK(tickCount > 0);
+		CHECK(tickCount < kTickCount);
+		replay = nullptr;
+	}
+
+	input.SetState(InputState());
+	DeleteFileW(kRecordingPath);
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "PrecompiledHeader.h"
+#include "Parameters.h"
+#include "RandomGenerator.h"
+#include "Tools.h"
+#include "Tools\Direct3DPostProcessor\MeshOptimizer.h"
+#include "UnitTest.h"
+
+// Indexed grid of size x size quads, with its triangles shuffled so that the original order doesn't help the cache
+static vector<unsigned int> MakeShuffledGrid(int size, uint64_t seed)
+{
+	vector<unsigned int> indices;
+
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			unsigned int topLeft = y * (size + 1) + x;
+			unsigned int quadIndices[] = { topLeft, topLeft + 1, topLeft + size + 1, topLeft + size + 1, topLeft + 1, topLeft + size + 2 };
+			indices.insert(end(indices), quadIndices, quadIndices + 6);
+		}
+	}
+
+	RandomGenerator random(seed);
+
+	for (auto i = indices.size() / 3 - 1; i > 0; i--)
+	{
+		auto j = random.NextUInt(static_cast<uint32_t>(i + 1));
+
+		for (int k = 0; k < 3; k++)
+		{
+			swap(indices[3 * i + k], indices[3 * j + k]);
+		}
+	}
+
+	return indices;
+}
+
+// Triangles rotated to start at their smallest index, which keeps their winding, and sorted
+static vector<uint64_t> GetTriangleSet(const vector<unsigned int>& indices)
+{
+	vector<uint64_t> triangles;
+
+	for (auto i = 0u; i < indices.size(); i += 3)
+	{
+		auto first = indices[i] < indices[i + 1] ? (indices[i] < indices[i + 2] ? 0 : 2) : (indices[i + 1] < indices[i + 2] ? 1 : 2);
+		uint64_t a = indices[i + first];
+		uint64_t b = indices[i + (first + 1) % 3];
+		uint64_t c = indices[i + (first + 2) % 3];
+		triangles.push_back((a << 42) | (b << 21) | c);
+	}
+
+	sort(begin(triangles), end(triangles));
+	return triangles;
+}
+
+TEST(MeshOptimizerAnalyzeVertexCache)
+{
+	unsigned int oneTriangle[] = { 0, 1, 2 };
+	auto statistics = MeshOptimizer::AnalyzeVertexCache(oneTriangle, 3, 3, 16);
+	CHECK(statistics.acmr == 3.0f);
+	CHECK(statistics.atvr == 1.0f);
+
+	unsigned int quad[] = { 0, 1, 2, 2, 1, 3 };
+	statistics = MeshOptimizer::AnalyzeVertexCache(quad, 6, 4, 16);
+	CHECK(statistics.acmr == 2.0f);
+	CHECK(statistics.atvr == 1.0f);
+
+	// With room for only three vertices, the first triangle is gone by the time it comes again
+	unsigned int evicted[] = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+	statistics = MeshOptimizer::AnalyzeVertexCache(evicted, 9, 6, 3);
+	CHECK(statistics.acmr == 3.0f);
+	CHECK(statistics.atvr == 1.5f);
+}
+
+TEST(MeshOptimizerVertexCacheKeepsTriangles)
+{
+	const int kGridSize = 16;
+	const size_t kVertexCount = (kGridSize + 1) * (kGridSize + 1);
+
+	auto indices = MakeShuffledGrid(kGridSize, 1);
+	auto originalTriangles = GetTriangleSet(indices);
+	auto before = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), kVertexCount, 16);
+
+	MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), kVertexCount);
+	auto after = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), kVertexCount, 16);
+
+	CHECK(GetTriangleSet(indices) == originalTriangles);
+	CHECK(after.acmr < before.acmr);
+	CHECK(after.acmr < 1.0f);
+}
+
+TEST(MeshOptimizerVertexFetch)
+{
+	unsigned int indices[] = { 3, 1, 4, 4, 1, 0 };
+	auto remap = MeshOptimizer::OptimizeVertexFetch(indices, 6, 6);
+
+	unsigned int expectedIndices[] = { 0, 1, 2, 2, 1, 3 };
+
+	for (int i = 0; i < 6; i++)
+	{
+		CHECK(indices[i] == expectedIndices[i]);
+	}
+
+	// Vertices 2 and 5 aren't used, and keep their relative order after the used ones
+	CHECK(remap[3] == 0 && remap[1] == 1 && remap[4] == 2 && remap[0] == 3);
+	CHECK(remap[2] == 4 && remap[5] == 5);
+
+	VertexParameters vertices[6];
+
+	for (int i = 0; i < 6; i++)
+	{
+		vertices[i].position = DirectX::XMFLOAT4(static_cast<float>(i), 0.0f, 0.0f, 1.0f);
+	}
+
+	MeshOptimizer::RemapVertices(vertices, 6, remap);
+
+	for (int i = 0; i < 6; i++)
+	{
+		CHECK(vertices[remap[i]].position.x == static_cast<float>(i));
+	}
+}
+
+BENCHMARK(MeshOptimizerVertexCache)
+{
+	const int kGridSize = 256;
+	const size_t kVertexCount = (kGridSize + 1) * (kGridSize + 1);
+
+	auto indices = MakeShuffledGrid(kGridSize, 2);
+	auto before = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), kVertexCount, 16);
+
+	auto startTime = Tools::GetTime();
+	MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), kVertexCount);
+	UnitTest::ReportTime("Optimize", Tools::GetTime() - startTime, indices.size() / 3);
+
+	auto after = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), kVertexCount, 16);
+	cout << "\tACMR: " << before.acmr << " before, " << after.acmr << " after" << endl;
+	CHECK(after.acmr < before.acmr);
+}
\ No newline at end of file
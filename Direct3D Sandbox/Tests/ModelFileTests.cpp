@@ -0,0 +1,237 @@
+#include "PrecompiledHeader.h"
+#include "ModelFile.h"
+#include "Tools.h"
+#include "UnitTest.h"
+#include "VertexPacking.h"
+
+using namespace ModelFile;
+
+// A still model of a quad, with full precision vertices that are just bytes as far as validation is concerned
+static void MakeSections(size_t vertexCount, vector<uint8_t> sections[SectionType::SectionTypeCount], Header& header)
+{
+	const uint32_t kIndices[] = { 0, 1, 2, 2, 1, 3 };
+
+	memset(&header, 0, sizeof(header));
+	header.modelType = ModelType::Still;
+	header.vertexEncoding = VertexEncoding::FullPrecision;
+	header.vertexCount = static_cast<uint32_t>(vertexCount);
+	header.indexCount = sizeof(kIndices) / sizeof(kIndices[0]);
+	header.frameCount = 1;
+	header.radius = 1.0f;
+
+	sections[SectionType::StateData].clear();
+	sections[SectionType::Vertices].resize(vertexCount * sizeof(VertexParameters));
+
+	for (auto i = 0u; i < sections[SectionType::Vertices].size(); i++)
+	{
+		sections[SectionType::Vertices][i] = static_cast<uint8_t>(i * 7);
+	}
+
+	sections[SectionType::Indices].resize(sizeof(kIndices));
+	memcpy(sections[SectionType::Indices].data(), kIndices, sizeof(kIndices));
+}
+
+// Lays the file out the way the postprocessor saves it
+static vector<char> MakeFile(Header header, const vector<uint8_t> sections[SectionType::SectionTypeCount])
+{
+	auto offset = AlignSectionOffset(sizeof(Header));
+
+	for (auto i = 0u; i < SectionType::SectionTypeCount; i++)
+	{
+		header.sections[i].offset = offset;
+		header.sections[i].size = static_cast<uint32_t>(sections[i].size());
+		header.sections[i].checksum = CalculateChecksum(sections[i].data(), sections[i].size());
+
+		offset = AlignSectionOffset(offset + header.sections[i].size);
+	}
+
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.headerChecksum = CalculateHeaderChecksum(header);
+
+	vector<char> file(offset);
+	memcpy(file.data(), &header, sizeof(Header));
+
+	for (auto i = 0u; i < SectionType::SectionTypeCount; i++)
+	{
+		memcpy(file.data() + header.sections[i].offset, sections[i].data(), sections[i].size());
+	}
+
+	return file;
+}
+
+static vector<char> MakeQuadFile()
+{
+	Header header;
+	vector<uint8_t> sections[SectionType::SectionTypeCount];
+
+	MakeSections(4, sections, header);
+	return MakeFile(header, sections);
+}
+
+static Header& GetHeader(vector<char>& file)
+{
+	return *reinterpret_cast<Header*>(file.data());
+}
+
+// Makes the header checksum match again after the test changed a field, so that validation gets as far as the field itself
+static void SealHeader(vector<char>& file)
+{
+	GetHeader(file).headerChecksum = CalculateHeaderChecksum(GetHeader(file));
+}
+
+static bool IsValid(const vector<char>& file)
+{
+	return Validate(file.data(), file.size()).empty();
+}
+
+TEST(ModelFileAcceptsWellFormedFile)
+{
+	auto file = MakeQuadFile();
+
+	CHECK(IsValid(file));
+	CHECK(GetHeader(file).sections[SectionType::StateData].size == 0);
+
+	for (auto i = 0u; i < SectionType::SectionTypeCount; i++)
+	{
+		CHECK(GetHeader(file).sections[i].offset % kSectionAlignment == 0);
+	}
+}
+
+// Every length short of the end of the last section, so that no prefix gets read past its end. Only padding may be cut off
+TEST(ModelFileRejectsTruncatedFile)
+{
+	auto file = MakeQuadFile();
+	auto lastSection = GetHeader(file).sections[SectionType::Indices];
+	auto dataSize = lastSection.offset + lastSection.size;
+
+	for (auto size = 0u; size < dataSize; size++)
+	{
+		vector<char> truncatedFile(file.begin(), file.begin() + size);
+		CHECK(!IsValid(truncatedFile));
+	}
+
+	CHECK(Validate(file.data(), dataSize - 1) == L"the file is truncated.");
+	CHECK(Validate(file.data(), dataSize).empty());
+	CHECK(Validate(file.data(), sizeof(Header) - 1) == L"the file is truncated.");
+
+	GetHeader(file).sections[SectionType::Vertices].offset = 0xFFFFFFF0;
+	SealHeader(file);
+	CHECK(Validate(file.data(), file.size()) == L"the file is truncated.");
+}
+
+TEST(ModelFileRejectsMisalignedSection)
+{
+	for (auto i = 0u; i < SectionType::SectionTypeCount; i++)
+	{
+		auto file = MakeQuadFile();
+
+		GetHeader(file).sections[i].offset += 4;
+		SealHeader(file);
+
+		CHECK(Validate(file.data(), file.size()) == L"section " + to_wstring(i) + L" is misaligned.");
+	}
+}
+
+TEST(ModelFileRejectsBadChecksums)
+{
+	auto file = MakeQuadFile();
+
+	GetHeader(file).radius = 2.0f;
+	CHECK(Validate(file.data(), file.size()) == L"the header is corrupted.");
+
+	file = MakeQuadFile();
+	file[GetHeader(file).sections[SectionType::Vertices].offset + 5] ^= 1;
+	CHECK(Validate(file.data(), file.size()) == L"section 1 is corrupted.");
+
+	file = MakeQuadFile();
+	file[GetHeader(file).sections[SectionType::Indices].offset] ^= 0x40;
+	CHECK(Validate(file.data(), file.size()) == L"section 2 is corrupted.");
+
+	// Padding between sections isn't covered by anything
+	file = MakeQuadFile();
+	file[sizeof(Header)] ^= 1;
+	CHECK(IsValid(file));
+}
+
+TEST(ModelFileRejectsUnknownHeader)
+{
+	auto file = MakeQuadFile();
+	GetHeader(file).magic = 0;
+	SealHeader(file);
+	CHECK(Validate(file.data(), file.size()) == L"not a model file.");
+
+	file = MakeQuadFile();
+	GetHeader(file).version = kVersion + 1;
+	SealHeader(file);
+	CHECK(!IsValid(file));
+
+	file = MakeQuadFile();
+	GetHeader(file).modelType = ModelType::ModelTypeCount;
+	SealHeader(file);
+	CHECK(Validate(file.data(), file.size()) == L"the header describes an unknown kind of model.");
+
+	file = MakeQuadFile();
+	GetHeader(file).vertexEncoding = VertexEncoding::VertexEncodingCount;
+	SealHeader(file);
+	CHECK(!IsValid(file));
+
+	file = MakeQuadFile();
+	GetHeader(file).frameCount = 0;
+	SealHeader(file);
+	CHECK(!IsValid(file));
+}
+
+TEST(ModelFileRejectsOutOfRangeIndices)
+{
+	Header header;
+	vector<uint8_t> sections[SectionType::SectionTypeCount];
+
+	// The quad's last index is 3, so three vertices leave it dangling
+	MakeSections(3, sections, header);
+	auto file = MakeFile(header, sections);
+	CHECK(Validate(file.data(), file.size()) == L"index data refers to vertices that don't exist.");
+
+	MakeSections(4, sections, header);
+	reinterpret_cast<uint32_t*>(sections[SectionType::Indices].data())[2] = 0xFFFFFFFF;
+	file = MakeFile(header, sections);
+	CHECK(!IsValid(file));
+
+	MakeSections(4, sections, header);
+	header.indexCount = 7;
+	file = MakeFile(header, sections);
+	CHECK(Validate(file.data(), file.size()) == L"index data size doesn't match the index count.");
+
+	// Index count times four wraps around to the section's size in 32 bits
+	MakeSections(4, sections, header);
+	header.indexCount = 0x40000006;
+	file = MakeFile(header, sections);
+	CHECK(!IsValid(file));
+}
+
+// Validation reads every byte of the file once, which is most of what loading a full precision model costs on top of mapping it
+BENCHMARK(ModelFileValidate)
+{
+	const size_t kVertexCount = 300000;
+	const int kIterationCount = 10;
+
+	Header header;
+	vector<uint8_t> sections[SectionType::SectionTypeCount];
+
+	MakeSections(kVertexCount, sections, header);
+	auto file = MakeFile(header, sections);
+	auto isValid = true;
+
+	auto startTime = Tools::GetTime();
+
+	for (int i = 0; i < kIterationCount; i++)
+	{
+		isValid &= IsValid(file);
+	}
+
+	auto validationTime = (Tools::GetTime() - startTime) / kIterationCount;
+	UnitTest::ReportTime("Validate", validationTime, kVertexCount);
+
+	cout << "\t" << file.size() / (1024.0 * 1024.0 * validationTime) << " MB/s" << endl;
+	CHECK(isValid);
+}
\ No newline at end of file
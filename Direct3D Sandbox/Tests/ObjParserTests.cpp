@@ -0,0 +1,173 @@
+#include "PrecompiledHeader.h"
+#include "RandomGenerator.h"
+#include "Tools.h"
+#include "Tools\Direct3DPostProcessor\ObjParser.h"
+#include "UnitTest.h"
+
+static float ParseFloat(const string& text, size_t& consumed)
+{
+	auto cursor = text.c_str();
+	auto value = ObjParser::ParseFloat(cursor, text.c_str() + text.length());
+
+	consumed = cursor - text.c_str();
+	return value;
+}
+
+static bool ParsesAs(const string& text, float expected)
+{
+	size_t consumed;
+	return ParseFloat(text, consumed) == expected && consumed == text.length();
+}
+
+static bool IsCorner(const ObjParser::FaceCorner& corner, int coordinate, int texture, int normal)
+{
+	return corner.coordinate == coordinate && corner.texture == texture && corner.normal == normal;
+}
+
+TEST(ObjParserFixedFloats)
+{
+	CHECK(ParsesAs("0", 0.0f));
+	CHECK(ParsesAs("1.5", 1.5f));
+	CHECK(ParsesAs("-0.25", -0.25f));
+	CHECK(ParsesAs("+3.000000", 3.0f));
+	CHECK(ParsesAs(" \t12.125", 12.125f));
+	CHECK(ParsesAs(".5", 0.5f));
+	CHECK(ParsesAs("7.", 7.0f));
+	CHECK(ParsesAs("0.100000", strtof("0.100000", nullptr)));
+	CHECK(ParsesAs("-123.456789", strtof("-123.456789", nullptr)));
+
+	// Digits past what the mantissa holds only scale the value
+	CHECK(ParsesAs("123456789012345678901234", strtof("123456789012345678901234", nullptr)));
+	CHECK(ParsesAs("0.12345678901234567890123", strtof("0.12345678901234567890123", nullptr)));
+
+	size_t consumed;
+	CHECK(ParseFloat("-0.0 2", consumed) == 0.0f && consumed == 4);
+}
+
+TEST(ObjParserScientificFloats)
+{
+	CHECK(ParsesAs("1e3", 1000.0f));
+	CHECK(ParsesAs("1.5e-3", strtof("1.5e-3", nullptr)));
+	CHECK(ParsesAs("-2E+4", -20000.0f));
+	CHECK(ParsesAs("7e0", 7.0f));
+	CHECK(ParsesAs("3.25e-30", strtof("3.25e-30", nullptr)));
+	CHECK(ParsesAs("6.02e23", strtof("6.02e23", nullptr)));
+	CHECK(ParsesAs("1e-45", strtof("1e-45", nullptr)));
+	CHECK(ParsesAs("-4.5e-7", strtof("-4.5e-7", nullptr)));
+}
+
+// Floats printed the way exporters print them parse back to what strtof makes of them
+TEST(ObjParserFloatsMatchStrtof)
+{
+	const int kCount = 100000;
+	const char* const kFormats[] = { "%f", "%.9g", "%e", "%.3f" };
+
+	RandomGenerator random(1);
+	auto mismatchCount = 0;
+
+	for (int i = 0; i < kCount; i++)
+	{
+		char text[64];
+		auto magnitude = static_cast<float>(pow(10.0, random.NextInteger(-8, 8)));
+
+		sprintf_s(text, kFormats[i % 4], random.NextReal(-magnitude, magnitude));
+
+		size_t consumed;
+		auto value = ParseFloat(text, consumed);
+		mismatchCount += value != strtof(text, nullptr) || consumed != strlen(text) ? 1 : 0;
+	}
+
+	CHECK(mismatchCount == 0);
+}
+
+TEST(ObjParserIntegers)
+{
+	string text = "42 -7\t+3 0";
+	auto cursor = text.c_str();
+	auto end = text.c_str() + text.length();
+
+	CHECK(ObjParser::ParseInt(cursor, end) == 42);
+	CHECK(ObjParser::ParseInt(cursor, end) == -7);
+	CHECK(ObjParser::ParseInt(cursor, end) == 3);
+	CHECK(ObjParser::ParseInt(cursor, end) == 0);
+	CHECK(cursor == end);
+}
+
+TEST(ObjParserFaceCorners)
+{
+	string text = "1/2/3 4//5 6 7/8 12/13/14";
+	auto cursor = text.c_str();
+	auto end = text.c_str() + text.length();
+
+	CHECK(IsCorner(ObjParser::ParseFaceCorner(cursor, end), 1, 2, 3));
+	CHECK(IsCorner(ObjParser::ParseFaceCorner(cursor, end), 4, 0, 5));
+	CHECK(IsCorner(ObjParser::ParseFaceCorner(cursor, end), 6, 0, 0));
+	CHECK(IsCorner(ObjParser::ParseFaceCorner(cursor, end), 7, 8, 0));
+	CHECK(IsCorner(ObjParser::ParseFaceCorner(cursor, end), 12, 13, 14));
+	CHECK(cursor == end);
+}
+
+// Lines other than vertices and faces get skipped, whatever line endings the file has
+TEST(ObjParserParsesFile)
+{
+	string text = 
+		"# Exported model\r\n"
+		"mtllib zombie.mtl\r\n"
+		"v 1.0 2.0 -3.0\r\n"
+		"  v\t4 5 6\n"
+		"vt 0.25 0.75\n"
+		"vn 0 1 0\n"
+		"vn 0 0 -1\n"
+		"usemtl skin\n"
+		"s off\n"
+		"f 1/1/1 2/1/2 1/1/1\n"
+		"f 2//2 1//1 2//1\n"
+		"f 1 2 2";
+
+	ObjParser::ObjData obj;
+	ObjParser::Parse(text.c_str(), text.length(), obj);
+
+	CHECK(obj.coordinates.size() == 2);
+	CHECK(obj.textures.size() == 1);
+	CHECK(obj.normals.size() == 2);
+	CHECK(obj.faces.size() == 9);
+
+	if (obj.coordinates.size() != 2 || obj.textures.size() != 1 || obj.normals.size() != 2 || obj.faces.size() != 9)
+	{
+		return;
+	}
+
+	CHECK(obj.coordinates[0].x == 1.0f && obj.coordinates[0].y == 2.0f && obj.coordinates[0].z == -3.0f && obj.coordinates[0].w == 1.0f);
+	CHECK(obj.coordinates[1].x == 4.0f && obj.coordinates[1].z == 6.0f);
+	CHECK(obj.textures[0].x == 0.25f && obj.textures[0].y == 0.25f);
+	CHECK(obj.normals[1].z == -1.0f);
+	CHECK(IsCorner(obj.faces[1], 2, 1, 2));
+	CHECK(IsCorner(obj.faces[3], 2, 0, 2));
+	CHECK(IsCorner(obj.faces[8], 2, 0, 0));
+}
+
+BENCHMARK(ObjParserZombieFrames)
+{
+	auto paths = Tools::GetFilesInDirectory(L"Assets\\Animated Models\\Zombie", L"*.obj", true);
+	size_t byteCount = 0, faceCount = 0;
+	auto totalTime = 0.0;
+
+	CHECK(!paths.empty());
+
+	for (const auto& path : paths)
+	{
+		auto data = Tools::ReadFileToVector(path);
+		ObjParser::ObjData obj;
+
+		auto startTime = Tools::GetTime();
+		ObjParser::Parse(reinterpret_cast<const char*>(data.data()), data.size(), obj);
+		totalTime += Tools::GetTime() - startTime;
+
+		byteCount += data.size();
+		faceCount += obj.faces.size() / 3;
+	}
+
+	UnitTest::ReportTime("Parse", totalTime, paths.size());
+	cout << "\t" << paths.size() << " frames, " << byteCount / (1024 * 1024) << " MB, " << faceCount << " triangles: " 
+		<< byteCount / (1024.0 * 1024.0) / totalTime << " MB/s" << endl;
+}
\ No newline at end of file
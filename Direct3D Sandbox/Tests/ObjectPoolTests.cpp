@@ -0,0 +1,209 @@
+#include "PrecompiledHeader.h"
+#include "ObjectPool.h"
+#include "RandomGenerator.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+struct PooledObject
+{
+	DirectX::XMFLOAT4 position;
+	unsigned int id;
+};
+
+// Two classes of a hierarchy sharing one pool, sized for the bigger one, the way zombies are allocated
+class PooledBase
+{
+public:
+	unsigned int id;
+
+	PooledBase(unsigned int id) : id(id) {}
+	virtual ~PooledBase() {}
+
+	static void* operator new(size_t size);
+	static void operator delete(void* object);
+	static ObjectPoolStatistics GetPoolStatistics();
+};
+
+class PooledDerived : public PooledBase
+{
+public:
+	double values[6];
+
+	PooledDerived(unsigned int id) : PooledBase(id) { memset(values, 0, sizeof(values)); }
+};
+
+static ObjectPool<PooledBase, sizeof(PooledDerived)> s_HierarchyPool;
+
+void* PooledBase::operator new(size_t size)
+{
+	return s_HierarchyPool.Allocate(size);
+}
+
+void PooledBase::operator delete(void* object)
+{
+	s_HierarchyPool.Free(object);
+}
+
+ObjectPoolStatistics PooledBase::GetPoolStatistics()
+{
+	return s_HierarchyPool.GetStatistics();
+}
+
+TEST(ObjectPoolAllocatesAlignedSlots)
+{
+	const int kObjectCount = 100;
+
+	ObjectPool<PooledObject> pool;
+	vector<void*> objects;
+
+	for (int i = 0; i < kObjectCount; i++)
+	{
+		auto object = pool.Allocate(sizeof(PooledObject));
+
+		CHECK(object != nullptr);
+		CHECK(reinterpret_cast<uintptr_t>(object) % 16 == 0);
+		objects.push_back(object);
+	}
+
+	sort(objects.begin(), objects.end());
+	CHECK(unique(objects.begin(), objects.end()) == objects.end());
+
+	auto statistics = pool.GetStatistics();
+	CHECK(statistics.liveCount == kObjectCount);
+	CHECK(statistics.highWaterMark == kObjectCount);
+	CHECK(statistics.slabCount == 2);
+
+	for (auto object : objects)
+	{
+		pool.Free(object);
+	}
+
+	pool.Free(nullptr);
+
+	statistics = pool.GetStatistics();
+	CHECK(statistics.liveCount == 0);
+	CHECK(statistics.highWaterMark == kObjectCount);
+	CHECK(statistics.slabCount == 2);
+}
+
+// Freed slots get handed out again before the pool grows
+TEST(ObjectPoolReusesFreedSlots)
+{
+	ObjectPool<PooledObject> pool;
+	vector<void*> objects;
+
+	for (int i = 0; i < 64; i++)
+	{
+		objects.push_back(pool.Allocate(sizeof(PooledObject)));
+	}
+
+	pool.Free(objects[10]);
+	pool.Free(objects[40]);
+
+	auto first = pool.Allocate(sizeof(PooledObject));
+	auto second = pool.Allocate(sizeof(PooledObject));
+
+	CHECK(first == objects[40]);
+	CHECK(second == objects[10]);
+	CHECK(pool.GetStatistics().slabCount == 1);
+
+	pool.Allocate(sizeof(PooledObject));
+	CHECK(pool.GetStatistics().slabCount == 2);
+}
+
+// Handles stop resolving once their object is freed, even after its slot gets reused
+TEST(ObjectPoolHandlesGoStale)
+{
+	ObjectPool<PooledObject> pool;
+
+	auto object = static_cast<PooledObject*>(pool.Allocate(sizeof(PooledObject)));
+	auto handle = pool.GetHandle(object);
+
+	CHECK(pool.Resolve(handle) == object);
+	CHECK(pool.Resolve(PoolHandle()) == nullptr);
+	CHECK(pool.Resolve(PoolHandle(handle.index + 1, handle.generation)) == nullptr);
+	CHECK(pool.Resolve(PoolHandle(1000000, 0)) == nullptr);
+
+	pool.Free(object);
+	CHECK(pool.Resolve(handle) == nullptr);
+
+	auto reused = static_cast<PooledObject*>(pool.Allocate(sizeof(PooledObject)));
+	auto reusedHandle = pool.GetHandle(reused);
+
+	CHECK(reused == object);
+	CHECK(reusedHandle.index == handle.index);
+	CHECK(reusedHandle.generation != handle.generation);
+	CHECK(pool.Resolve(handle) == nullptr);
+	CHECK(pool.Resolve(reusedHandle) == reused);
+
+	pool.Free(reused);
+}
+
+TEST(ObjectPoolHoldsClassHierarchy)
+{
+	auto liveCount = PooledBase::GetPoolStatistics().liveCount;
+
+	PooledBase* base = new PooledBase(1);
+	PooledBase* derived = new PooledDerived(2);
+
+	CHECK(PooledBase::GetPoolStatistics().liveCount == liveCount + 2);
+	CHECK(s_HierarchyPool.Resolve(s_HierarchyPool.GetHandle(derived)) == derived);
+	CHECK(base->id == 1 && derived->id == 2);
+
+	auto derivedHandle = s_HierarchyPool.GetHandle(derived);
+
+	delete derived;
+	delete base;
+
+	CHECK(PooledBase::GetPoolStatistics().liveCount == liveCount);
+	CHECK(s_HierarchyPool.Resolve(derivedHandle) == nullptr);
+}
+
+// Objects get created and destroyed in a random order, the way projectiles and zombies come and go
+BENCHMARK(ObjectPoolChurn)
+{
+	const int kLiveCount = 1000;
+	const int kOperationCount = 1000000;
+
+	ObjectPool<PooledObject> pool;
+	vector<void*> poolObjects(kLiveCount, nullptr);
+	vector<PooledObject*> heapObjects(kLiveCount, nullptr);
+	RandomGenerator random(1);
+	vector<uint32_t> slots(kOperationCount);
+
+	for (auto& slot : slots)
+	{
+		slot = random.NextUInt(kLiveCount);
+	}
+
+	auto startTime = Tools::GetTime();
+
+	for (auto slot : slots)
+	{
+		pool.Free(poolObjects[slot]);
+		poolObjects[slot] = pool.Allocate(sizeof(PooledObject));
+	}
+
+	auto poolTime = Tools::GetTime() - startTime;
+	startTime = Tools::GetTime();
+
+	for (auto slot : slots)
+	{
+		delete heapObjects[slot];
+		heapObjects[slot] = new PooledObject;
+	}
+
+	auto heapTime = Tools::GetTime() - startTime;
+
+	UnitTest::ReportTime("Pool", poolTime, kOperationCount);
+	UnitTest::ReportTime("Heap", heapTime, kOperationCount);
+
+	for (auto i = 0; i < kLiveCount; i++)
+	{
+		pool.Free(poolObjects[i]);
+		delete heapObjects[i];
+	}
+
+	CHECK(pool.GetStatistics().liveCount == 0);
+	CHECK(pool.GetStatistics().highWaterMark <= kLiveCount);
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "PrecompiledHeader.h"
+#include "Parameters.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+static string ToUpper(string text)
+{
+	transform(text.begin(), text.end(), text.begin(), ::toupper);
+	return text;
+}
+
+// Checks the description against the field's real layout, and that any capitalization of the name finds the same description
+template <typename Parameters>
+static void CheckField(const char* name, size_t offset, size_t size, ParameterFieldType type, unsigned int shaderSize)
+{
+	auto description = Parameters::GetFieldDescription(name);
+	CHECK(description != nullptr);
+
+	if (description == nullptr)
+	{
+		return;
+	}
+
+	CHECK(description->offset == offset);
+	CHECK(description->size == size);
+	CHECK(description->type == type);
+	CHECK(description->shaderSize == shaderSize);
+
+	string capitalizedName(name);
+	capitalizedName[0] = static_cast<char>(toupper(capitalizedName[0]));
+
+	CHECK(Parameters::GetFieldDescription(ToUpper(name)) == description);
+	CHECK(Parameters::GetFieldDescription(Tools::ToLower(name)) == description);
+	CHECK(Parameters::GetFieldDescription(capitalizedName) == description);
+}
+
+TEST(RenderParametersFieldsMatchLayout)
+{
+#define FIELD(type, name) \
+	CheckField<RenderParameters>(#name, offsetof(RenderParameters, name), sizeof(type), ParameterFieldTraits<type>::kType, ParameterFieldTraits<type>::kShaderSize);
+	RENDER_PARAMETERS
+#undef FIELD
+
+	// What the traits say about the types that aren't plain HLSL types
+	CHECK(RenderParameters::GetFieldDescription("frustumPlanes")->type == ParameterFieldType::Vector);
+	CHECK(RenderParameters::GetFieldDescription("frustumPlanes")->shaderSize == 6 * 16);
+	CHECK(RenderParameters::GetFieldDescription("isTransitioningAnimationStates")->type == ParameterFieldType::Bool);
+	CHECK(RenderParameters::GetFieldDescription("isTransitioningAnimationStates")->shaderSize == 0);
+	CHECK(RenderParameters::GetFieldDescription("normalMap")->type == ParameterFieldType::ShaderResource);
+	CHECK(RenderParameters::GetFieldDescription("normalMap")->shaderSize == 0);
+	CHECK(RenderParameters::GetFieldDescription("lightColor")->shaderSize == 12);
+}
+
+TEST(VertexParametersFieldsMatchLayout)
+{
+#define FIELD(type, name) \
+	CheckField<VertexParameters>(#name, offsetof(VertexParameters, name), sizeof(type), ParameterFieldTraits<type>::kType, ParameterFieldTraits<type>::kShaderSize);
+	VERTEX_PARAMETERS
+#undef FIELD
+
+	// Input layouts look fields up by semantic name, which HLSL writes in capitals
+	CHECK(VertexParameters::GetFieldDescription("POSITION")->offset == 0);
+	CHECK(VertexParameters::GetFieldDescription("TEXTURECOORDINATES")->type == ParameterFieldType::Float2);
+}
+
+TEST(ParametersUnknownFieldsAreNotFound)
+{
+	CHECK(RenderParameters::GetFieldDescription("") == nullptr);
+	CHECK(RenderParameters::GetFieldDescription("projection") == nullptr);
+	CHECK(RenderParameters::GetFieldDescription("projectionMatrix2") == nullptr);
+	CHECK(RenderParameters::GetFieldDescription("position") == nullptr);
+	CHECK(VertexParameters::GetFieldDescription("time") == nullptr);
+}
+
+TEST(ParameterFieldReadsByName)
+{
+	RenderParameters renderParameters;
+	renderParameters.time = 12.5f;
+	renderParameters.screenHeight = 720;
+	renderParameters.lightColor = DirectX::XMFLOAT3(0.25f, 0.5f, 0.75f);
+
+	CHECK(RenderParameters::GetField<float>("TIME").Get(renderParameters) == 12.5f);
+	CHECK(RenderParameters::GetField<int>("ScreenHeight").Get(renderParameters) == 720);
+	CHECK(RenderParameters::GetField<DirectX::XMFLOAT3>("lightcolor").Get(renderParameters).z == 0.75f);
+	CHECK(RenderParameters::GetFieldByteOffset("time", ParameterFieldType::Float, sizeof(float)) == offsetof(RenderParameters, time));
+}
\ No newline at end of file
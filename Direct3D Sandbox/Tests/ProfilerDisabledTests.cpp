@@ -0,0 +1,27 @@
+#include "PrecompiledHeader.h"
+#include "Profiler.h"
+#include "UnitTest.h"
+
+// Built without the precompiled header and with ENABLE_PROFILER set to 0, which no other build uses,
+// so that the profiler keeps compiling out entirely
+#if ENABLE_PROFILER
+#error This file has to be built with ENABLE_PROFILER set to 0
+#endif
+
+// These would clash with anything Profiler.h still declared
+typedef int Profiler;
+typedef int ProfileScope;
+typedef int ProfilerStatistics;
+
+TEST(ProfilerCompilesOut)
+{
+	auto iterationCount = 0;
+
+	for (int i = 0; i < 10; i++)
+	{
+		PROFILE_SCOPE("Compiled out");
+		iterationCount++;
+	}
+
+	CHECK(iterationCount == 10);
+}
\ No newline at end of file
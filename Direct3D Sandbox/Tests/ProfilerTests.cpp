@@ -0,0 +1,38 @@
+#include "PrecompiledHeader.h"
+#include "Profiler.h"
+#include "UnitTest.h"
+
+#include <thread>
+
+#if ENABLE_PROFILER
+
+// Only the first 64 threads that record scopes get read. Scopes of any thread after them count as dropped instead of asserting
+TEST(ProfilerCountsScopesOfThreadsPastLimit)
+{
+	const int kThreadCount = 80;
+	const int kScopesPerThread = 10;
+
+	Profiler::EndFrame();
+	Profiler::ConsumeStatistics();
+
+	for (int i = 0; i < kThreadCount; i++)
+	{
+		thread worker([=]()
+		{
+			for (int j = 0; j < kScopesPerThread; j++)
+			{
+				PROFILE_SCOPE("Worker");
+			}
+		});
+
+		worker.join();
+	}
+
+	Profiler::EndFrame();
+	auto statistics = Profiler::ConsumeStatistics();
+
+	CHECK(statistics.droppedScopes >= (kThreadCount - 64) * kScopesPerThread);
+	CHECK(Profiler::ConsumeStatistics().droppedScopes == 0);
+}
+
+#endif
\ No newline at end of file
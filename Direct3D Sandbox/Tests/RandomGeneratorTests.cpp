@@ -0,0 +1,214 @@
+#include "PrecompiledHeader.h"
+#include "RandomGenerator.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+#include <climits>
+#include <random>
+
+// First numbers of the PCG32 reference implementation seeded with 42 on stream 54, so the generator stays the same whatever builds it
+TEST(RandomGeneratorMatchesReference)
+{
+	const uint32_t kExpected[] = { 0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e };
+	RandomGenerator random(42, 54);
+
+	for (auto expected : kExpected)
+	{
+		CHECK(random.NextUInt() == expected);
+	}
+}
+
+TEST(RandomGeneratorSeedsAndStreams)
+{
+	const int kCount = 100;
+
+	RandomGenerator random(7, 3), sameSeed(7, 3), otherSeed(8, 3), otherStream(7, 4);
+	auto sameCount = 0, otherSeedMatches = 0, otherStreamMatches = 0;
+	vector<uint32_t> numbers;
+
+	for (int i = 0; i < kCount; i++)
+	{
+		auto number = random.NextUInt();
+		numbers.push_back(number);
+
+		sameCount += sameSeed.NextUInt() == number ? 1 : 0;
+		otherSeedMatches += otherSeed.NextUInt() == number ? 1 : 0;
+		otherStreamMatches += otherStream.NextUInt() == number ? 1 : 0;
+	}
+
+	CHECK(sameCount == kCount);
+	CHECK(otherSeedMatches < 3);
+	CHECK(otherStreamMatches < 3);
+
+	// Seeding again starts the sequence over
+	random.Seed(7, 3);
+
+	for (int i = 0; i < kCount; i++)
+	{
+		CHECK(random.NextUInt() == numbers[i]);
+	}
+}
+
+TEST(RandomGeneratorBoundedIntegers)
+{
+	const int kBucketCount = 10;
+	const int kCount = 100000;
+
+	RandomGenerator random(1);
+	int buckets[kBucketCount] = {};
+	auto outOfRangeCount = 0;
+
+	for (int i = 0; i < kCount; i++)
+	{
+		auto number = random.NextUInt(kBucketCount);
+
+		if (number < kBucketCount)
+		{
+			buckets[number]++;
+		}
+		else
+		{
+			outOfRangeCount++;
+		}
+	}
+
+	CHECK(outOfRangeCount == 0);
+
+	for (auto bucket : buckets)
+	{
+		CHECK(bucket > kCount / kBucketCount * 9 / 10 && bucket < kCount / kBucketCount * 11 / 10);
+	}
+
+	// A bound just past half the range rejects almost half of the numbers, results have to stay below it anyway
+	for (int i = 0; i < 1000; i++)
+	{
+		outOfRangeCount += random.NextUInt(0x80000001u) > 0x80000000u ? 1 : 0;
+		outOfRangeCount += random.NextUInt(1) != 0 ? 1 : 0;
+	}
+
+	CHECK(outOfRangeCount == 0);
+}
+
+// Both bounds are included, negative ranges work and the whole range of int doesn't overflow
+TEST(RandomGeneratorIntegerRanges)
+{
+	RandomGenerator random(2);
+	auto hitLowerBound = false, hitHigherBound = false, outOfRange = false;
+
+	for (int i = 0; i < 10000; i++)
+	{
+		auto number = random.NextInteger(-3, 2);
+
+		hitLowerBound = hitLowerBound || number == -3;
+		hitHigherBound = hitHigherBound || number == 2;
+		outOfRange = outOfRange || number < -3 || number > 2;
+	}
+
+	CHECK(hitLowerBound && hitHigherBound && !outOfRange);
+	CHECK(random.NextInteger(5, 5) == 5);
+
+	auto hasNegative = false, hasPositive = false;
+
+	for (int i = 0; i < 100; i++)
+	{
+		auto number = random.NextInteger(INT_MIN, INT_MAX);
+
+		hasNegative = hasNegative || number < 0;
+		hasPositive = hasPositive || number > 0;
+	}
+
+	CHECK(hasNegative && hasPositive);
+}
+
+TEST(RandomGeneratorRealRanges)
+{
+	RandomGenerator random(3);
+	auto outOfRange = false;
+	auto sum = 0.0;
+
+	for (int i = 0; i < 100000; i++)
+	{
+		auto zeroToOne = random.NextFloat();
+		auto real = random.NextReal(-2.0f, 6.0f);
+
+		outOfRange = outOfRange || zeroToOne < 0.0f || zeroToOne >= 1.0f || real < -2.0f || real >= 6.0f;
+		sum += zeroToOne;
+	}
+
+	CHECK(!outOfRange);
+	CHECK(fabs(sum / 100000 - 0.5) < 0.01);
+}
+
+// Filling gives the numbers NextReal would, four at a time and for the ones left over
+TEST(RandomGeneratorFillRealsMatchesNextReal)
+{
+	const size_t kCounts[] = { 0, 1, 3, 4, 7, 1001 };
+
+	for (auto count : kCounts)
+	{
+		RandomGenerator filling(4, count), single(4, count);
+		vector<float> values(count + 1, -100.0f);
+
+		filling.FillReals(values.data(), count, -50.0f, 25.0f);
+
+		auto mismatchCount = 0;
+
+		for (auto i = 0u; i < count; i++)
+		{
+			mismatchCount += values[i] != single.NextReal(-50.0f, 25.0f) ? 1 : 0;
+		}
+
+		CHECK(mismatchCount == 0);
+		CHECK(values[count] == -100.0f);
+		CHECK(filling.NextUInt() == single.NextUInt());
+	}
+}
+
+BENCHMARK(RandomGeneratorThroughput)
+{
+	const int kCount = 10000000;
+
+	RandomGenerator random(1);
+	mt19937 mersenneTwister(1);
+	uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+	vector<float> values(kCount);
+	uint32_t sum = 0;
+
+	auto startTime = Tools::GetTime();
+
+	for (int i = 0; i < kCount; i++)
+	{
+		sum += random.NextUInt();
+	}
+
+	auto pcgTime = Tools::GetTime() - startTime;
+	startTime = Tools::GetTime();
+
+	for (int i = 0; i < kCount; i++)
+	{
+		sum += mersenneTwister();
+	}
+
+	auto mersenneTwisterTime = Tools::GetTime() - startTime;
+	startTime = Tools::GetTime();
+
+	random.FillReals(values.data(), kCount, -10.0f, 10.0f);
+
+	auto fillTime = Tools::GetTime() - startTime;
+	startTime = Tools::GetTime();
+
+	for (int i = 0; i < kCount; i++)
+	{
+		values[i] = distribution(mersenneTwister);
+	}
+
+	auto distributionTime = Tools::GetTime() - startTime;
+
+	UnitTest::ReportTime("PCG32 NextUInt", pcgTime, kCount);
+	UnitTest::ReportTime("mt19937", mersenneTwisterTime, kCount);
+	UnitTest::ReportTime("FillReals", fillTime, kCount);
+	UnitTest::ReportTime("mt19937 uniform_real_distribution", distributionTime, kCount);
+	cout << "\tChecksum " << sum << endl;
+
+	CHECK(values[0] >= -10.0f && values[0] < 10.0f);
+}
\ No newline at end of file
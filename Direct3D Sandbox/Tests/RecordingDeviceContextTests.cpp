@@ -0,0 +1,186 @@
+#include "PrecompiledHeader.h"
+#include "Source\Graphics\Direct3D.h"
+#include "Source\Graphics\RecordingDeviceContext.h"
+#include "TestDevice.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+// Without a target nothing behind the pointers that get bound is ever touched, so made up ones do
+template <typename T>
+static T* MakeFakeObject(uintptr_t id)
+{
+	return reinterpret_cast<T*>(id * 16);
+}
+
+static ComPtr<ID3D11Buffer> CreateDynamicBuffer(unsigned int size)
+{
+	ComPtr<ID3D11Buffer> buffer;
+	D3D11_BUFFER_DESC bufferDescription;
+
+	TestDevice::GetRecorder();
+
+	bufferDescription.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDescription.ByteWidth = size;
+	bufferDescription.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	bufferDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDescription.MiscFlags = 0;
+	bufferDescription.StructureByteStride = 0;
+
+	auto result = GetD3D11Device()->CreateBuffer(&bufferDescription, nullptr, &buffer);
+	Assert(result == S_OK);
+
+	return buffer;
+}
+
+TEST(RecordingDeviceContextFlagsRedundantBinds)
+{
+	RecordingDeviceContext recorder((unique_ptr<IDeviceContext>()));
+	auto firstShader = MakeFakeObject<ID3D11VertexShader>(1);
+	auto secondShader = MakeFakeObject<ID3D11VertexShader>(2);
+	auto pixelShader = MakeFakeObject<ID3D11PixelShader>(3);
+	auto texture = MakeFakeObject<ID3D11ShaderResourceView>(4);
+
+	recorder.VSSetShader(firstShader, nullptr, 0);
+	recorder.VSSetShader(firstShader, nullptr, 0);
+	recorder.VSSetShader(secondShader, nullptr, 0);
+	recorder.PSSetShader(pixelShader, nullptr, 0);
+	recorder.PSSetShader(pixelShader, nullptr, 0);
+	recorder.PSSetShaderResources(0, 1, &texture);
+	recorder.PSSetShaderResources(1, 1, &texture);
+	recorder.PSSetShaderResources(1, 1, &texture);
+	recorder.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	recorder.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	recorder.EndFrame();
+
+	const auto& statistics = recorder.GetLastFrameStatistics();
+	CHECK(statistics.frameCount == 1);
+	CHECK(statistics.callCounts[VS_SET_SHADER] == 3);
+	CHECK(statistics.redundantCallCounts[VS_SET_SHADER] == 1);
+	CHECK(statistics.callCounts[PS_SET_SHADER] == 2);
+	CHECK(statistics.redundantCallCounts[PS_SET_SHADER] == 1);
+	CHECK(statistics.callCounts[PS_SET_SHADER_RESOURCES] == 3);
+	CHECK(statistics.redundantCallCounts[PS_SET_SHADER_RESOURCES] == 1);
+	CHECK(statistics.redundantCallCounts[IA_SET_PRIMITIVE_TOPOLOGY] == 1);
+	CHECK(statistics.GetStateCallCount() == 10);
+	CHECK(statistics.GetRedundantCallCount() == 4);
+
+	const auto& log = recorder.GetLastFrameLog();
+	CHECK(log.size() == 10);
+
+	if (log.size() == 10)
+	{
+		CHECK(log[0].call == VS_SET_SHADER && log[0].object == firstShader && !log[0].isRedundant);
+		CHECK(log[1].isRedundant);
+		CHECK(log[2].object == secondShader && !log[2].isRedundant);
+		CHECK(log[6].call == PS_SET_SHADER_RESOURCES && log[6].startSlot == 1 && log[6].count == 1);
+	}
+}
+
+// A constant buffer bound again at another offset changes what the shader reads, so it's not redundant
+TEST(RecordingDeviceContextComparesConstantBufferOffsets)
+{
+	RecordingDeviceContext recorder((unique_ptr<IDeviceContext>()));
+	auto buffer = MakeFakeObject<ID3D11Buffer>(1);
+	UINT firstConstant = 0, secondConstant = 16, constantCount = 16;
+
+	recorder.VSSetConstantBuffers1(0, 1, &buffer, &firstConstant, &constantCount);
+	recorder.VSSetConstantBuffers1(0, 1, &buffer, &firstConstant, &constantCount);
+	recorder.VSSetConstantBuffers1(0, 1, &buffer, &secondConstant, &constantCount);
+	recorder.VSSetConstantBuffers(0, 1, &buffer);
+	recorder.VSSetConstantBuffers(0, 1, &buffer);
+	recorder.PSSetConstantBuffers1(0, 1, &buffer, &secondConstant, &constantCount);
+	recorder.EndFrame();
+
+	const auto& statistics = recorder.GetLastFrameStatistics();
+	CHECK(statistics.callCounts[VS_SET_CONSTANT_BUFFERS] == 5);
+	CHECK(statistics.redundantCallCounts[VS_SET_CONSTANT_BUFFERS] == 2);
+	CHECK(statistics.callCounts[PS_SET_CONSTANT_BUFFERS] == 1);
+	CHECK(statistics.redundantCallCounts[PS_SET_CONSTANT_BUFFERS] == 0);
+}
+
+TEST(RecordingDeviceContextCountsDraws)
+{
+	RecordingDeviceContext recorder((unique_ptr<IDeviceContext>()));
+
+	recorder.Draw(3, 0);
+	recorder.DrawIndexed(36, 6, 0);
+	recorder.DrawIndexedInstanced(12, 50, 0, 0, 0);
+	recorder.DrawIndexedInstanced(12, 20, 0, 0, 50);
+	recorder.EndFrame();
+
+	const auto& statistics = recorder.GetLastFrameStatistics();
+	CHECK(statistics.GetDrawCount() == 4);
+	CHECK(statistics.callCounts[DRAW_INDEXED_INSTANCED] == 2);
+	CHECK(statistics.GetRedundantCallCount() == 0);
+
+	const auto& log = recorder.GetLastFrameLog();
+	CHECK(log.size() == 4);
+
+	if (log.size() == 4)
+	{
+		CHECK(log[1].call == DRAW_INDEXED && log[1].count == 36 && log[1].startSlot == 6);
+		CHECK(log[2].count == 12 && log[2].instanceCount == 50);
+		CHECK(log[3].instanceCount == 20);
+	}
+}
+
+// Without a target, maps hand out memory of the recorder's own that keeps its contents, and only maps that write from scratch count as uploads
+TEST(RecordingDeviceContextMapsScratchMemory)
+{
+	const unsigned int kBufferSize = 256;
+
+	RecordingDeviceContext recorder((unique_ptr<IDeviceContext>()));
+	auto buffer = CreateDynamicBuffer(kBufferSize);
+	auto otherBuffer = CreateDynamicBuffer(kBufferSize);
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+
+	CHECK(recorder.Map(buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource) == S_OK);
+	CHECK(mappedResource.pData != nullptr);
+	memset(mappedResource.pData, 0xAB, kBufferSize);
+	recorder.Unmap(buffer.Get(), 0);
+
+	auto firstData = mappedResource.pData;
+
+	CHECK(recorder.Map(buffer.Get(), 0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedResource) == S_OK);
+	CHECK(mappedResource.pData == firstData);
+	CHECK(static_cast<const uint8_t*>(mappedResource.pData)[kBufferSize - 1] == 0xAB);
+	recorder.Unmap(buffer.Get(), 0);
+
+	CHECK(recorder.Map(otherBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource) == S_OK);
+	CHECK(mappedResource.pData != firstData);
+	recorder.Unmap(otherBuffer.Get(), 0);
+	recorder.EndFrame();
+
+	const auto& statistics = recorder.GetLastFrameStatistics();
+	CHECK(statistics.callCounts[MAP] == 3);
+	CHECK(statistics.callCounts[UNMAP] == 3);
+	CHECK(statistics.uploadedByteCount == 2 * kBufferSize);
+	CHECK(recorder.GetLastFrameLog()[0].count == kBufferSize);
+	CHECK(recorder.GetLastFrameLog()[0].object == buffer.Get());
+}
+
+// Bound state carries over frames, and consumed statistics add up every frame since the last time
+TEST(RecordingDeviceContextKeepsStateAcrossFrames)
+{
+	RecordingDeviceContext recorder((unique_ptr<IDeviceContext>()));
+	auto inputLayout = MakeFakeObject<ID3D11InputLayout>(1);
+
+	recorder.IASetInputLayout(inputLayout);
+	recorder.Draw(3, 0);
+	recorder.EndFrame();
+
+	recorder.IASetInputLayout(inputLayout);
+	recorder.Draw(3, 0);
+	recorder.EndFrame();
+
+	CHECK(recorder.GetLastFrameStatistics().redundantCallCounts[IA_SET_INPUT_LAYOUT] == 1);
+	CHECK(recorder.GetLastFrameLog().size() == 2);
+
+	auto statistics = recorder.ConsumeStatistics();
+	CHECK(statistics.frameCount == 2);
+	CHECK(statistics.callCounts[IA_SET_INPUT_LAYOUT] == 2);
+	CHECK(statistics.redundantCallCounts[IA_SET_INPUT_LAYOUT] == 1);
+	CHECK(statistics.GetDrawCount() == 2);
+
+	CHECK(recorder.ConsumeStatistics().frameCount == 0);
+}
\ No newline at end of file
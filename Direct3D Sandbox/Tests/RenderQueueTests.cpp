@@ -0,0 +1,332 @@
+#include "PrecompiledHeader.h"
+#include "Parameters.h"
+#include "RandomGenerator.h"
+#include "Source\Graphics\ConstantRingBuffer.h"
+#include "Source\Graphics\Direct3D.h"
+#include "Source\Graphics\IShader.h"
+#include "Source\Graphics\RecordingDeviceContext.h"
+#include "Source\Graphics\RenderQueue.h"
+#include "Source\Models\IModelInstance.h"
+#include "TestDevice.h"
+#include "UnitTest.h"
+
+// Shader that doesn't bind anything, it only tells how much of the constant ring buffer its draws take
+class FakeShader : public IShader
+{
+private:
+	unsigned int m_ConstantRingSize;
+
+public:
+	FakeShader(unsigned int constantRingSize) : m_ConstantRingSize(constantRingSize) {}
+
+	virtual ComPtr<ID3D11Buffer> CreateVertexBuffer(unsigned int vertexCount, unsigned int semanticIndex, D3D11_USAGE usage) const { return nullptr; }
+	virtual ComPtr<ID3D11Buffer> CreateVertexBuffer(unsigned int vertexCount, const VertexParameters vertices[], unsigned int semanticIndex, D3D11_USAGE usage) const { return nullptr; }
+	virtual void UploadVertexData(ID3D11Buffer* vertexBuffer, unsigned int vertexCount, const VertexParameters vertices[], unsigned int semanticIndex) const {}
+
+	virtual void SetRenderParameters(const RenderParameters& renderParameters) {}
+	virtual void StageRenderParameters(const RenderParameters& renderParameters) {}
+	virtual unsigned int GetConstantRingSize() const { return m_ConstantRingSize; }
+	virtual const unsigned int* GetInputLayoutStrides() const { return nullptr; }
+};
+
+// Model instance that writes its id as its constants and logs its draws. Staging and drawing both advance the time in the render parameters,
+// the way shaders change per draw parameters, so the time an instance saw tells whether both passes got the same parameters
+class FakeInstance : public IModelInstance
+{
+private:
+	unsigned int m_Id;
+	const FakeShader& m_Shader;
+	vector<unsigned int>& m_DrawLog;
+
+public:
+	unsigned int stagedConstant;
+	float stagedTime;
+	float drawnTime;
+	unsigned int stageCount;
+
+	FakeInstance(unsigned int id, const FakeShader& shader, vector<unsigned int>& drawLog) :
+		m_Id(id), m_Shader(shader), m_DrawLog(drawLog), stagedConstant(0), stagedTime(-1.0f), drawnTime(-1.0f), stageCount(0)
+	{
+	}
+
+	virtual void Update(const RenderParameters& renderParameters) {}
+	virtual void Submit3D(RenderQueue& renderQueue, const RenderParameters& renderParameters) {}
+	virtual void Render2D(RenderParameters& renderParameters) {}
+
+	virtual void Stage3D(RenderParameters& renderParameters)
+	{
+		auto destination = ConstantRingBuffer::Map(m_Shader.GetConstantRingSize(), stagedConstant);
+		memcpy(destination, &m_Id, sizeof(m_Id));
+		ConstantRingBuffer::Unmap();
+
+		stagedTime = renderParameters.time;
+		renderParameters.time += 1.0f;
+		stageCount++;
+	}
+
+	virtual void Render3D(RenderParameters& renderParameters)
+	{
+		m_DrawLog.push_back(m_Id);
+		drawnTime = renderParameters.time;
+		renderParameters.time += 1.0f;
+	}
+};
+
+static DrawPacket MakePacket(FakeInstance& instance, const FakeShader& shader, uint64_t sortKey)
+{
+	DrawPacket packet;
+
+	packet.sortKey = sortKey;
+	packet.instance = &instance;
+	packet.shader = &shader;
+	packet.model = nullptr;
+	packet.texture = nullptr;
+
+	return packet;
+}
+
+// Every packet's constants get staged with a single map before any of them is drawn
+TEST(RenderQueueStagesConstantsWithOneMap)
+{
+	const unsigned int kPacketCount = 50;
+
+	auto& recorder = TestDevice::GetRecorder();
+	FakeShader shader(ConstantRingBuffer::kAlignment);
+	vector<unsigned int> drawLog;
+	vector<unique_ptr<FakeInstance>> instances;
+	RenderQueue renderQueue;
+	RenderParameters renderParameters;
+
+	for (auto i = 0u; i < kPacketCount; i++)
+	{
+		instances.push_back(unique_ptr<FakeInstance>(new FakeInstance(i, shader, drawLog)));
+		renderQueue.Add(MakePacket(*instances.back(), shader, RenderQueue::MakeSortKey(0, 0, nullptr, 0, static_cast<float>(kPacketCount - i))));
+	}
+
+	renderParameters.time = 0.0f;
+	renderQueue.Submit(renderParameters);
+	recorder.EndFrame();
+
+	auto statistics = renderQueue.ConsumeStatistics();
+	CHECK(statistics.drawCount == kPacketCount);
+	CHECK(drawLog.size() == kPacketCount);
+	CHECK(renderParameters.time == static_cast<float>(kPacketCount));
+
+	if (!ConstantRingBuffer::IsSupported())
+	{
+		CHECK(statistics.constantBatchCount == 0);
+		return;
+	}
+
+	CHECK(statistics.constantBatchCount == 1);
+	CHECK(recorder.GetLastFrameStatistics().callCounts[MAP] == 1);
+
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	GetD3D11DeviceContext()->Map(ConstantRingBuffer::GetBuffer(), 0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedResource);
+	auto data = static_cast<const uint8_t*>(mappedResource.pData);
+
+	for (auto i = 0u; i < kPacketCount; i++)
+	{
+		unsigned int stagedId;
+		memcpy(&stagedId, data + 16 * instances[i]->stagedConstant, sizeof(stagedId));
+
+		CHECK(instances[i]->stageCount == 1);
+		CHECK(instances[i]->stagedTime == instances[i]->drawnTime);
+		CHECK(stagedId == i);
+	}
+
+	GetD3D11DeviceContext()->Unmap(ConstantRingBuffer::GetBuffer(), 0);
+}
+
+// Packets whose constants don't fit the ring buffer together get staged and drawn in as many batches as it takes
+TEST(RenderQueueSplitsConstantBatches)
+{
+	const unsigned int kPacketCount = 5;
+
+	auto& recorder = TestDevice::GetRecorder();
+	FakeShader shader(ConstantRingBuffer::kSize / 2);
+	vector<unsigned int> drawLog;
+	vector<unique_ptr<FakeInstance>> instances;
+	RenderQueue renderQueue;
+	RenderParameters renderParameters;
+
+	if (!ConstantRingBuffer::IsSupported())
+	{
+		cout << "\tSkipped: the device can't bind constant buffers by offset" << endl;
+		return;
+	}
+
+	for (auto i = 0u; i < kPacketCount; i++)
+	{
+		instances.push_back(unique_ptr<FakeInstance>(new FakeInstance(i, shader, drawLog)));
+		renderQueue.Add(MakePacket(*instances.back(), shader, i));
+	}
+
+	renderParameters.time = 0.0f;
+	renderQueue.Submit(renderParameters);
+	recorder.EndFrame();
+
+	CHECK(renderQueue.ConsumeStatistics().constantBatchCount == 3);
+	CHECK(recorder.GetLastFrameStatistics().callCounts[MAP] == 3);
+	CHECK(drawLog.size() == kPacketCount);
+
+	for (const auto& instance : instances)
+	{
+		CHECK(instance->stageCount == 1);
+		CHECK(instance->stagedTime == instance->drawnTime);
+	}
+}
+
+// Fields more significant in the key win over everything less significant, and closer draws come first
+TEST(RenderQueueSortKeyFieldOrder)
+{
+	auto key = RenderQueue::MakeSortKey(1, 2, nullptr, 3, 4.0f);
+
+	CHECK(RenderQueue::MakeSortKey(0, 200, nullptr, 60000, 1000.0f) < key);
+	CHECK(RenderQueue::MakeSortKey(1, 1, nullptr, 60000, 1000.0f) < key);
+	CHECK(RenderQueue::MakeSortKey(1, 2, nullptr, 2, 1000.0f) < key);
+	CHECK(RenderQueue::MakeSortKey(1, 2, nullptr, 3, 1.0f) < key);
+	CHECK(RenderQueue::MakeSortKey(1, 2, nullptr, 3, 0.0f) < RenderQueue::MakeSortKey(1, 2, nullptr, 3, 0.001f));
+	CHECK(RenderQueue::MakeSortKey(1, 2, nullptr, 3, 4.0f) == key);
+
+	CHECK(RenderQueue::MakeSortKey(15, 0, nullptr, 0, 0.0f) >> (64 - RenderQueue::kPassBits) == 15);
+	CHECK(RenderQueue::MakeSortKey(0, 0, nullptr, 0, 0.0f) == 0);
+}
+
+// Packets get drawn by ascending key, and the ones with equal keys in the order they were added
+TEST(RenderQueueDrawsInKeyOrder)
+{
+	const uint64_t kKeys[] = { 0x0300000000000000ull, 5, 0x0000000100000000ull, 5, 0, 0x0300000000000000ull, 0x0000000000010000ull, 5 };
+	const unsigned int kExpectedOrder[] = { 4, 1, 3, 7, 6, 2, 0, 5 };
+	const unsigned int kPacketCount = sizeof(kKeys) / sizeof(kKeys[0]);
+
+	TestDevice::GetRecorder();
+	FakeShader shader(ConstantRingBuffer::kAlignment);
+	vector<unsigned int> drawLog;
+	vector<unique_ptr<FakeInstance>> instances;
+	RenderQueue renderQueue;
+	RenderParameters renderParameters;
+
+	for (auto i = 0u; i < kPacketCount; i++)
+	{
+		instances.push_back(unique_ptr<FakeInstance>(new FakeInstance(i, shader, drawLog)));
+		renderQueue.Add(MakePacket(*instances.back(), shader, kKeys[i]));
+	}
+
+	renderParameters.time = 0.0f;
+	renderQueue.Submit(renderParameters);
+
+	CHECK(drawLog.size() == kPacketCount);
+
+	for (auto i = 0u; i < kPacketCount && i < drawLog.size(); i++)
+	{
+		CHECK(drawLog[i] == kExpectedOrder[i]);
+	}
+
+	// The queue is empty after submitting
+	drawLog.clear();
+	renderQueue.Submit(renderParameters);
+	CHECK(drawLog.empty());
+}
+
+// Consecutive packets are diffed by shader, texture and model. The first draw sets all three
+TEST(RenderQueueCountsStateChanges)
+{
+	TestDevice::GetRecorder();
+	FakeShader firstShader(ConstantRingBuffer::kAlignment), secondShader(ConstantRingBuffer::kAlignment);
+	auto firstTexture = reinterpret_cast<ID3D11ShaderResourceView*>(static_cast<uintptr_t>(0x1000));
+	auto secondTexture = reinterpret_cast<ID3D11ShaderResourceView*>(static_cast<uintptr_t>(0x2000));
+	auto firstModel = reinterpret_cast<const IModel*>(static_cast<uintptr_t>(0x3000));
+	auto secondModel = reinterpret_cast<const IModel*>(static_cast<uintptr_t>(0x4000));
+	vector<unsigned int> drawLog;
+	vector<unique_ptr<FakeInstance>> instances;
+	RenderQueue renderQueue;
+	RenderParameters renderParameters;
+
+	struct PacketState { const FakeShader* shader; ID3D11ShaderResourceView* texture; const IModel* model; };
+	const PacketState kStates[] =
+	{
+		{ &firstShader, firstTexture, firstModel },
+		{ &firstShader, firstTexture, firstModel },		// Nothing changes
+		{ &firstShader, firstTexture, secondModel },	// Model
+		{ &firstShader, secondTexture, secondModel },	// Texture
+		{ &secondShader, secondTexture, secondModel },	// Shader
+		{ &firstShader, firstTexture, firstModel },		// All three
+	};
+	const unsigned int kPacketCount = sizeof(kStates) / sizeof(kStates[0]);
+
+	for (auto i = 0u; i < kPacketCount; i++)
+	{
+		instances.push_back(unique_ptr<FakeInstance>(new FakeInstance(i, *kStates[i].shader, drawLog)));
+
+		auto packet = MakePacket(*instances.back(), *kStates[i].shader, i);
+		packet.texture = kStates[i].texture;
+		packet.model = kStates[i].model;
+		renderQueue.Add(packet);
+	}
+
+	renderParameters.time = 0.0f;
+	renderQueue.Submit(renderParameters);
+
+	auto statistics = renderQueue.ConsumeStatistics();
+	CHECK(statistics.drawCount == kPacketCount);
+	CHECK(statistics.shaderChanges == 3);
+	CHECK(statistics.textureChanges == 3);
+	CHECK(statistics.modelChanges == 3);
+	CHECK(statistics.avoidedStateChanges == 3 * (kPacketCount - 1) - 6);
+
+	// Statistics start over once consumed
+	CHECK(renderQueue.ConsumeStatistics().drawCount == 0);
+}
+
+BENCHMARK(RenderQueueSubmit)
+{
+	const unsigned int kPacketCount = 10000;
+	const unsigned int kShaderCount = 8;
+	const unsigned int kModelCount = 64;
+	const int kRepeatCount = 100;
+
+	TestDevice::GetRecorder();
+	FakeShader shader(ConstantRingBuffer::kAlignment);
+	vector<unsigned int> drawLog;
+	vector<unique_ptr<FakeInstance>> instances;
+	vector<DrawPacket> packets;
+	RenderQueue renderQueue;
+	RenderParameters renderParameters;
+	RandomGenerator random(1);
+	auto totalTime = 0.0;
+
+	drawLog.reserve(kPacketCount);
+
+	for (auto i = 0u; i < kPacketCount; i++)
+	{
+		instances.push_back(unique_ptr<FakeInstance>(new FakeInstance(i, shader, drawLog)));
+
+		auto sortKey = RenderQueue::MakeSortKey(0, random.NextUInt(kShaderCount), nullptr, random.NextUInt(kModelCount), random.NextReal(0.0f, 10000.0f));
+		packets.push_back(MakePacket(*instances.back(), shader, sortKey));
+	}
+
+	for (int repeat = 0; repeat < kRepeatCount; repeat++)
+	{
+		drawLog.clear();
+
+		for (const auto& packet : packets)
+		{
+			renderQueue.Add(packet);
+		}
+
+		renderParameters.time = 0.0f;
+
+		auto startTime = Tools::GetTime();
+		renderQueue.Submit(renderParameters);
+		totalTime += Tools::GetTime() - startTime;
+	}
+
+	auto statistics = renderQueue.ConsumeStatistics();
+
+	UnitTest::ReportTime("Sort, stage and draw", totalTime / kRepeatCount, kPacketCount);
+	cout << "\t" << statistics.constantBatchCount / kRepeatCount << " constant batches per submit" << endl;
+
+	CHECK(statistics.drawCount == kPacketCount * kRepeatCount);
+	CHECK(drawLog.size() == kPacketCount);
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "PrecompiledHeader.h"
+#include "Source\Games\ZombieSurvival\Scenario.h"
+#include "UnitTest.h"
+
+static unique_ptr<Scenario> Parse(const wstring& text, wstring& error)
+{
+	wistringstream in(text);
+	return Scenario::Parse(in, error);
+}
+
+// Returns what's wrong with the scenario, or an empty string if it parsed
+static wstring GetError(const wstring& text)
+{
+	wstring error;
+	auto scenario = Parse(text, error);
+
+	CHECK((scenario == nullptr) == !error.empty());
+	return error;
+}
+
+TEST(ScenarioParsesEveryCommand)
+{
+	wstring error;
+	auto scenario = Parse(
+		L"# Comment lines and blank lines are skipped\n"
+		L"\n"
+		L"seed 1234\n"
+		L"duration 60   # Comments can follow commands\n"
+		L"invulnerable\n"
+		L"spawn 10 150\n"
+		L"spawn 1 100\n"
+		L"fire 2 0.25\n"
+		L"hold 0 60 w\n"
+		L"look 0 60 4 -2\n", error);
+
+	CHECK(scenario != nullptr);
+	CHECK(error.empty());
+
+	if (scenario != nullptr)
+	{
+		CHECK(scenario->GetSeed() == 1234);
+		CHECK(scenario->GetDuration() == 60.0f);
+		CHECK(!scenario->IsFinished(59.9f));
+		CHECK(scenario->IsFinished(60.0f));
+		CHECK(scenario->GetDroppedSpawnCount() == 0);
+	}
+}
+
+// Scenarios get copied next to the game along with the rest of its assets
+TEST(ScenarioParsesShippedScenario)
+{
+	auto gameDirectory = UnitTest::GetGameDirectory();
+
+	if (gameDirectory.empty())
+	{
+		return;
+	}
+
+	wifstream in(gameDirectory + L"\\Assets\\Scenarios\\Horde.scenario");
+	wstring error;
+
+	CHECK(in.is_open());
+	CHECK(Scenario::Parse(in, error) != nullptr);
+	CHECK(error.empty());
+}
+
+TEST(ScenarioRejectsUnknownCommand)
+{
+	CHECK(GetError(L"duration 10\nspawn 1 5\nexplode 3\n") == L"line 3: unknown command \"explode\"");
+	CHECK(GetError(L"duration 10\nSeed 4\n") == L"line 2: unknown command \"Seed\"");
+}
+
+TEST(ScenarioRejectsMissingArguments)
+{
+	CHECK(GetError(L"duration\n") == L"line 1: missing or malformed arguments to \"duration\"");
+	CHECK(GetError(L"duration 10\nspawn 1\n") == L"line 2: missing or malformed arguments to \"spawn\"");
+	CHECK(GetError(L"duration 10\nfire 2\n") == L"line 2: missing or malformed arguments to \"fire\"");
+	CHECK(GetError(L"duration 10\nhold 0 5\n") == L"line 2: missing or malformed arguments to \"hold\"");
+	CHECK(GetError(L"duration 10\nlook 0 5 4\n") == L"line 2: missing or malformed arguments to \"look\"");
+	CHECK(GetError(L"duration 10\nspawn 1 # 5\n") == L"line 2: missing or malformed arguments to \"spawn\"");
+}
+
+TEST(ScenarioRejectsMalformedArguments)
+{
+	CHECK(GetError(L"duration ten\n") == L"line 1: missing or malformed arguments to \"duration\"");
+	CHECK(GetError(L"duration 10\nseed x\n") == L"line 2: missing or malformed arguments to \"seed\"");
+	CHECK(GetError(L"duration 10\nspawn 1 many\n") == L"line 2: missing or malformed arguments to \"spawn\"");
+	CHECK(GetError(L"duration 10\nlook 0 5 4 up\n") == L"line 2: missing or malformed arguments to \"look\"");
+}
+
+TEST(ScenarioRejectsExtraArguments)
+{
+	CHECK(GetError(L"duration 10 20\n") == L"line 1: too many arguments to \"duration\"");
+	CHECK(GetError(L"duration 10\ninvulnerable yes\n") == L"line 2: too many arguments to \"invulnerable\"");
+	CHECK(GetError(L"duration 10\nhold 0 5 W A\n") == L"line 2: too many arguments to \"hold\"");
+}
+
+TEST(ScenarioRejectsOutOfRangeValues)
+{
+	CHECK(GetError(L"duration 10\nspawn 1 0\n") == L"line 2: spawn count has to be positive");
+	CHECK(GetError(L"duration 10\nspawn 1 -5\n") == L"line 2: spawn count has to be positive");
+	CHECK(GetError(L"duration 10\nfire 0 0\n") == L"line 2: fire interval has to be positive");
+	CHECK(GetError(L"duration 10\nfire 0 -1\n") == L"line 2: fire interval has to be positive");
+	CHECK(GetError(L"duration 10\nhold 0 5 WA\n") == L"line 2: keys are given by a single character");
+	CHECK(GetError(L"duration 10\nhold 0 5 \x0100\n") == L"line 2: keys are given by a single character");
+}
+
+TEST(ScenarioRejectsMissingDuration)
+{
+	CHECK(GetError(L"") == L"it has no duration");
+	CHECK(GetError(L"seed 5\nspawn 1 10\n") == L"it has no duration");
+	CHECK(GetError(L"duration 0\n") == L"it has no duration");
+	CHECK(GetError(L"duration -3\n") == L"it has no duration");
+}
\ No newline at end of file
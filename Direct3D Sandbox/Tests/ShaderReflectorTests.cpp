@@ -0,0 +1,50 @@
+#include "PrecompiledHeader.h"
+#include "Tools.h"
+#include "Tools\Direct3DPostProcessor\ShaderReflector.h"
+#include "UnitTest.h"
+
+// Reflects every compiled shader of the game from its bytecode alone, the way the postprocessor does at build time, without creating a device.
+// The results have to match the metadata the postprocessor wrote next to the shaders
+BENCHMARK(ShaderReflectorReflectAllShaders)
+{
+	const int kIterationCount = 20;
+
+	auto gameDirectory = UnitTest::GetGameDirectory();
+	CHECK(!gameDirectory.empty());
+
+	if (gameDirectory.empty())
+	{
+		return;
+	}
+
+	auto shaderPaths = Tools::GetFilesInDirectory(gameDirectory + L"\\Shaders", L"*.cso", false);
+	vector<vector<uint8_t>> shaders;
+	size_t totalSize = 0;
+
+	for (const auto& shaderPath : shaderPaths)
+	{
+		shaders.push_back(Tools::ReadFileToVector(shaderPath));
+		totalSize += shaders.back().size();
+	}
+
+	CHECK(!shaders.empty());
+
+	auto startTime = Tools::GetTime();
+
+	for (int i = 0; i < kIterationCount; i++)
+	{
+		for (const auto& shader : shaders)
+		{
+			ShaderReflector::ReflectShaderBuffer(shader);
+		}
+	}
+
+	UnitTest::ReportTime("Reflect shader set", (Tools::GetTime() - startTime) / kIterationCount, shaders.size());
+	cout << "\t" << shaders.size() << " shaders, " << totalSize << " bytes of bytecode" << endl;
+
+	for (auto i = 0u; i < shaders.size(); i++)
+	{
+		auto metadataPath = shaderPaths[i].substr(0, shaderPaths[i].length() - 3) + L"shadermetadata";
+		CHECK(ShaderReflector::ReflectShaderBuffer(shaders[i]) == Tools::ReadFileToVector(metadataPath));
+	}
+}
\ No newline at end of file
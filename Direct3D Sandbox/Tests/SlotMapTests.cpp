@@ -0,0 +1,322 @@
+#include "PrecompiledHeader.h"
+#include "RandomGenerator.h"
+#include "SlotMap.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+// Value whose destructor looks itself up in the map it was removed from
+class SelfCheckingValue
+{
+private:
+	SlotMap<SelfCheckingValue>* m_Map;
+	SlotMapId m_Id;
+	int* m_ConsistentDestructionCount;
+
+	SelfCheckingValue(const SelfCheckingValue& other);				// Not implemented (no copying allowed)
+
+public:
+	SelfCheckingValue(SlotMap<SelfCheckingValue>* map, int* consistentDestructionCount) :
+		m_Map(map), m_ConsistentDestructionCount(consistentDestructionCount)
+	{
+	}
+
+	SelfCheckingValue(SelfCheckingValue&& other) :
+		m_Map(other.m_Map), m_Id(other.m_Id), m_ConsistentDestructionCount(other.m_ConsistentDestructionCount)
+	{
+		other.m_Map = nullptr;
+	}
+
+	SelfCheckingValue& operator=(SelfCheckingValue&& other)
+	{
+		m_Map = other.m_Map;
+		m_Id = other.m_Id;
+		m_ConsistentDestructionCount = other.m_ConsistentDestructionCount;
+		other.m_Map = nullptr;
+
+		return *this;
+	}
+
+	~SelfCheckingValue()
+	{
+		if (m_Map == nullptr)
+		{
+			return;
+		}
+
+		auto isConsistent = m_Map->Get(m_Id) == nullptr;
+
+		for (auto& value : *m_Map)
+		{
+			isConsistent = isConsistent && m_Map->Get(value.m_Id) == &value;
+		}
+
+		if (isConsistent)
+		{
+			(*m_ConsistentDestructionCount)++;
+		}
+	}
+
+	inline void SetId(const SlotMapId& id) { m_Id = id; }
+};
+
+TEST(SlotMapAddGetRemove)
+{
+	SlotMap<int> map;
+
+	auto first = map.Add(10);
+	auto second = map.Add(20);
+	auto third = map.Add(30);
+
+	CHECK(map.GetCount() == 3);
+	CHECK(first.IsValid() && second.IsValid() && third.IsValid());
+	CHECK(*map.Get(first) == 10 && *map.Get(second) == 20 && *map.Get(third) == 30);
+	CHECK(map.Get(SlotMapId()) == nullptr);
+	CHECK(!SlotMapId().IsValid());
+
+	// The last value moves into the hole, ids of the others keep resolving
+	CHECK(map.Remove(first));
+	CHECK(map.GetCount() == 2);
+	CHECK(map.Get(first) == nullptr);
+	CHECK(*map.Get(second) == 20 && *map.Get(third) == 30);
+	CHECK(map[0] == 30 && map[1] == 20);
+
+	CHECK(!map.Remove(first));
+	CHECK(map.GetCount() == 2);
+
+	// The freed slot gets reused with a new generation, so the old id stays stale
+	auto fourth = map.Add(40);
+	CHECK(fourth.index == first.index);
+	CHECK(fourth.generation != first.generation);
+	CHECK(map.Get(first) == nullptr);
+	CHECK(*map.Get(fourth) == 40);
+
+	auto sum = 0;
+
+	for (auto value : map)
+	{
+		sum += value;
+	}
+
+	CHECK(sum == 90);
+}
+
+// Reserved ids don't resolve until their value is inserted, and can be removed before that
+TEST(SlotMapReserveThenInsert)
+{
+	SlotMap<int> map;
+
+	auto reserved = map.Reserve();
+	auto added = map.Add(1);
+
+	CHECK(map.Get(reserved) == nullptr);
+	CHECK(map.GetCount() == 1);
+
+	map.Insert(reserved, 2);
+	CHECK(*map.Get(reserved) == 2);
+	CHECK(*map.Get(added) == 1);
+	CHECK(map.GetCount() == 2);
+
+	auto removedBeforeInsert = map.Reserve();
+	CHECK(map.Remove(removedBeforeInsert));
+	CHECK(map.GetCount() == 2);
+	CHECK(map.Get(removedBeforeInsert) == nullptr);
+	CHECK(*map.Get(reserved) == 2 && *map.Get(added) == 1);
+}
+
+TEST(SlotMapDestroysValuesAfterRemoving)
+{
+	SlotMap<SelfCheckingValue> map;
+	vector<SlotMapId> ids;
+	auto consistentDestructionCount = 0;
+
+	for (int i = 0; i < 5; i++)
+	{
+		auto id = map.Reserve();
+		SelfCheckingValue value(&map, &consistentDestructionCount);
+
+		value.SetId(id);
+		map.Insert(id, move(value));
+		ids.push_back(id);
+	}
+
+	map.Remove(ids[1]);
+	map.Remove(ids[4]);
+	map.Remove(ids[0]);
+
+	CHECK(consistentDestructionCount == 3);
+	CHECK(map.GetCount() == 2);
+}
+
+// Random adds and removes checked against a map from ids to the values they were added with
+TEST(SlotMapMatchesReference)
+{
+	SlotMap<uint32_t> map;
+	vector<pair<SlotMapId, uint32_t>> live;
+	vector<SlotMapId> removed;
+	RandomGenerator random(1);
+
+	for (int i = 0; i < 20000; i++)
+	{
+		if (live.empty() || random.NextUInt(3) != 0)
+		{
+			auto value = random.NextUInt();
+			live.push_back(make_pair(map.Add(move(value)), value));
+		}
+		else
+		{
+			auto index = random.NextUInt(static_cast<uint32_t>(live.size()));
+
+			CHECK(map.Remove(live[index].first));
+			removed.push_back(live[index].first);
+			live[index] = live.back();
+			live.pop_back();
+		}
+	}
+
+	CHECK(map.GetCount() == live.size());
+
+	auto mismatchCount = 0;
+
+	for (const auto& entry : live)
+	{
+		auto value = map.Get(entry.first);
+		mismatchCount += value == nullptr || *value != entry.second ? 1 : 0;
+	}
+
+	for (const auto& id : removed)
+	{
+		mismatchCount += map.Get(id) != nullptr ? 1 : 0;
+	}
+
+	CHECK(mismatchCount == 0);
+}
+
+// Looks up values by id the way model instances get looked up every frame
+BENCHMARK(SlotMapLookup)
+{
+	const int kValueCount = 10000;
+	const int kLookupCount = 1000000;
+
+	SlotMap<uint64_t> map;
+	unordered_map<uint64_t, uint64_t> hashMap;
+	vector<SlotMapId> ids;
+	vector<uint64_t> keys;
+	RandomGenerator random(1);
+
+	for (int i = 0; i < kValueCount; i++)
+	{
+		uint64_t value = i;
+		ids.push_back(map.Add(move(value)));
+		keys.push_back(random.NextUInt() | (static_cast<uint64_t>(random.NextUInt()) << 32));
+		hashMap[keys.back()] = i;
+	}
+
+	vector<uint32_t> lookups(kLookupCount);
+
+	for (auto& lookup : lookups)
+	{
+		lookup = random.NextUInt(kValueCount);
+	}
+
+	uint64_t slotMapSum = 0;
+	auto startTime = Tools::GetTime();
+
+	for (auto lookup : lookups)
+	{
+		slotMapSum += *map.Get(ids[lookup]);
+	}
+
+	auto slotMapTime = Tools::GetTime() - startTime;
+
+	uint64_t hashMapSum = 0;
+	startTime = Tools::GetTime();
+
+	for (auto lookup : lookups)
+	{
+		hashMapSum += hashMap.find(keys[lookup])->second;
+	}
+
+	auto hashMapTime = Tools::GetTime() - startTime;
+
+	UnitTest::ReportTime("Slot map", slotMapTime, kLookupCount);
+	UnitTest::ReportTime("Hash map", hashMapTime, kLookupCount);
+	CHECK(slotMapSum == hashMapSum);
+}
+
+// Waves of models queued, added and then all removed in random order, the way a game over clears the scene.
+// Compared against the vector System kept before, where removing a model meant scanning for its pointer
+BENCHMARK(SlotMapBulkSpawnDespawn)
+{
+	const int kModelCount = 5000;
+	const int kWaveCount = 10;
+
+	vector<uint64_t> models(kModelCount);
+	vector<uint32_t> removalOrder(kModelCount);
+	RandomGenerator random(2);
+
+	for (auto i = 0u; i < removalOrder.size(); i++)
+	{
+		removalOrder[i] = i;
+	}
+
+	for (auto i = removalOrder.size() - 1; i > 0; i--)
+	{
+		swap(removalOrder[i], removalOrder[random.NextUInt(static_cast<uint32_t>(i + 1))]);
+	}
+
+	SlotMap<uint64_t*> map;
+	vector<SlotMapId> ids(kModelCount);
+	auto startTime = Tools::GetTime();
+
+	for (int wave = 0; wave < kWaveCount; wave++)
+	{
+		for (int i = 0; i < kModelCount; i++)
+		{
+			ids[i] = map.Reserve();
+		}
+
+		for (int i = 0; i < kModelCount; i++)
+		{
+			map.Insert(ids[i], &models[i]);
+		}
+
+		for (auto index : removalOrder)
+		{
+			map.Remove(ids[index]);
+		}
+	}
+
+	auto slotMapTime = Tools::GetTime() - startTime;
+
+	vector<uint64_t*> scanned;
+	startTime = Tools::GetTime();
+
+	for (int wave = 0; wave < kWaveCount; wave++)
+	{
+		for (int i = 0; i < kModelCount; i++)
+		{
+			scanned.push_back(&models[i]);
+		}
+
+		for (auto index : removalOrder)
+		{
+			for (auto i = 0u; i < scanned.size(); i++)
+			{
+				if (scanned[i] == &models[index])
+				{
+					scanned[i] = scanned.back();
+					scanned.pop_back();
+					break;
+				}
+			}
+		}
+	}
+
+	auto scanTime = Tools::GetTime() - startTime;
+
+	UnitTest::ReportTime("Slot map", slotMapTime / kWaveCount, kModelCount);
+	UnitTest::ReportTime("Linear scan", scanTime / kWaveCount, kModelCount);
+
+	CHECK(map.GetCount() == 0 && scanned.empty());
+	CHECK(map.Get(ids[0]) == nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,320 @@
+#include "PrecompiledHeader.h"
+#include "Constants.h"
+#include "ObjectPool.h"
+#include "RandomGenerator.h"
+#include "SlotMap.h"
+#include "Source\Games\ZombieSurvival\ZombieCrowd.h"
+#include "Source\Models\IModelInstance.h"
+#include "UnitTest.h"
+
+#include <crtdbg.h>
+
+using DirectX::XMFLOAT2;
+using DirectX::XMFLOAT3;
+
+// Zombies, projectiles and the scene registry are driven the way PlayerInstance, WeaponInstance and System drive them.
+// The instances themselves need shaders, models and sounds, so stand-ins are allocated from pools the way they are
+static const float kSessionLength = 5.0f * 60.0f;
+static const float kShootingInterval = 0.5f;
+static const float kProjectileLifetime = 0.4f;
+static const float kSmallestSpawnInterval = 0.5f;
+
+static bool s_CountAllocations = false;
+static size_t s_AllocationCount = 0;
+
+static int CountAllocations(int allocationType, void* userData, size_t size, int blockType, long requestNumber, const unsigned char* fileName, int lineNumber)
+{
+	if (s_CountAllocations && allocationType != _HOOK_FREE && blockType != _CRT_BLOCK)
+	{
+		s_AllocationCount++;
+	}
+
+	return TRUE;
+}
+
+class TestScene;
+
+class TestModel : public IModelInstance
+{
+public:
+	ModelId id;
+
+	// Stands in for Update, which needs render parameters
+	virtual void Tick(TestScene& scene, float time) = 0;
+
+	virtual void Update(const RenderParameters& renderParameters) { }
+	virtual void Submit3D(RenderQueue& renderQueue, const RenderParameters& renderParameters) { }
+	virtual void Render3D(RenderParameters& renderParameters) { }
+	virtual void Render2D(RenderParameters& renderParameters) { }
+};
+
+// What System does with scene models: ids are reserved when a model is queued, and the queue gets applied once a tick
+class TestScene
+{
+private:
+	struct QueueItem
+	{
+		ModelId id;
+		TestModel* modelToAdd;		// nullptr to remove
+	};
+
+	SlotMap<unique_ptr<TestModel>> m_Models;
+	vector<QueueItem> m_Queue;
+
+public:
+	void AddModel(TestModel* model)
+	{
+		QueueItem item;
+		item.id = model->id = m_Models.Reserve();
+		item.modelToAdd = model;
+		m_Queue.push_back(item);
+	}
+
+	void RemoveModel(const TestModel* model)
+	{
+		QueueItem item;
+		item.id = model->id;
+		item.modelToAdd = nullptr;
+		m_Queue.push_back(item);
+	}
+
+	void AddAndRemoveModels()
+	{
+		for (auto i = 0u; i < m_Queue.size(); i++)
+		{
+			if (m_Queue[i].modelToAdd != nullptr)
+			{
+				m_Models.Insert(m_Queue[i].id, unique_ptr<TestModel>(m_Queue[i].modelToAdd));
+			}
+			else
+			{
+				m_Models.Remove(m_Queue[i].id);
+			}
+		}
+
+		m_Queue.clear();
+	}
+
+	void Tick(float time)
+	{
+		for (auto& model : m_Models)
+		{
+			model->Tick(*this, time);
+		}
+	}
+
+	void RemoveAll()
+	{
+		for (auto& model : m_Models)
+		{
+			RemoveModel(model.get());
+		}
+
+		AddAndRemoveModels();
+	}
+};
+
+class TestZombie : public TestModel
+{
+public:
+	ZombieCrowd& crowd;
+	unsigned int crowdId;
+
+	TestZombie(ZombieCrowd& crowd, unsigned int crowdId) : crowd(crowd), crowdId(crowdId) {}
+	virtual ~TestZombie() { crowd.Remove(crowdId); }
+
+	virtual void Tick(TestScene& scene, float time)
+	{
+		if (crowd.GetEvents(crowdId) & ZombieCrowd::ZombieEvents::Expired)
+		{
+			scene.RemoveModel(this);
+		}
+	}
+
+	void* operator new(size_t size);
+	void operator delete(void* zombie);
+};
+
+class TestSuperZombie : public TestZombie
+{
+public:
+	float extraHealth[4];
+
+	TestSuperZombie(ZombieCrowd& crowd, unsigned int crowdId) : TestZombie(crowd, crowdId) { memset(extraHealth, 0, sizeof(extraHealth)); }
+};
+
+class TestProjectile : public TestModel
+{
+public:
+	float spawnedAt;
+
+	TestProjectile(float spawnedAt) : spawnedAt(spawnedAt) {}
+
+	virtual void Tick(TestScene& scene, float time)
+	{
+		if (time - spawnedAt > kProjectileLifetime)
+		{
+			scene.RemoveModel(this);
+		}
+	}
+
+	void* operator new(size_t size);
+	void operator delete(void* projectile);
+};
+
+static ObjectPool<TestZombie, sizeof(TestSuperZombie)> s_ZombiePool;
+static ObjectPool<TestProjectile> s_ProjectilePool;
+
+void* TestZombie::operator new(size_t size) { return s_ZombiePool.Allocate(size); }
+void TestZombie::operator delete(void* zombie) { s_ZombiePool.Free(zombie); }
+void* TestProjectile::operator new(size_t size) { return s_ProjectilePool.Allocate(size); }
+void TestProjectile::operator delete(void* projectile) { s_ProjectilePool.Free(projectile); }
+
+struct SessionStatistics
+{
+	int spawnedCount;
+	int killedCount;
+	int firedCount;
+};
+
+// Five minutes of the player standing still, shooting at zombies that keep spawning around them.
+// Allocations are counted everywhere but in the crowd simulation, which isn't part of spawning and removing
+static SessionStatistics PlaySession(ZombieCrowd& crowd, TestScene& scene, vector<PoolHandle>& zombies, bool countAllocations)
+{
+	const auto kTickLength = 1.0f / Constants::SimulationTickRate;
+	const XMFLOAT3 kPlayerPosition(0.0f, 1.5f, 0.0f);
+
+	RandomGenerator random(1);
+	SessionStatistics statistics = { 0, 0, 0 };
+
+	auto spawnInterval = Constants::ZombieSpawnIntervalInSeconds;
+	auto spawnCount = 1;
+	auto lastSpawnTime = 0.0f;
+	auto lastShot = -kShootingInterval;
+
+	// Like PlayerInstance::SpawnZombies, never more than the game allows at once
+	auto spawnZombies = [&](int count, float time)
+	{
+		count = min(count, Constants::MaxZombies - static_cast<int>(zombies.size()));
+		crowd.PrepareToAdd(count);
+
+		for (int i = 0; i < count; i++)
+		{
+			auto radius = random.NextReal(5.0f, 20.0f);
+			auto angle = random.NextReal(0.0f, 2 * DirectX::XM_PI);
+			XMFLOAT2 position(radius * cos(angle), radius * sin(angle));
+
+			if (!crowd.CanMoveTo(position, ZombieCrowd::kNoZombie))
+			{
+				continue;
+			}
+
+			auto crowdId = crowd.Add(position, -angle - DirectX::XM_PI / 2.0f, ZombieCrowd::kZombieSpeed, true, time);
+			TestZombie* zombie = random.NextInteger(1, 10) <= 8 ? new TestZombie(crowd, crowdId) : new TestSuperZombie(crowd, crowdId);
+
+			scene.AddModel(zombie);
+			zombies.push_back(s_ZombiePool.GetHandle(zombie));
+			statistics.spawnedCount++;
+		}
+	};
+
+	s_CountAllocations = countAllocations;
+	spawnZombies(Constants::StartingZombieCount, 0.0f);
+
+	for (auto tick = 0; tick * kTickLength < kSessionLength; tick++)
+	{
+		auto time = tick * kTickLength;
+
+		s_CountAllocations = false;
+		crowd.Update(kTickLength, time, kPlayerPosition, true);
+		s_CountAllocations = countAllocations;
+
+		scene.AddAndRemoveModels();
+		scene.Tick(time);
+
+		for (auto i = 0u; i < zombies.size(); i++)
+		{
+			auto zombie = s_ZombiePool.Resolve(zombies[i]);
+
+			if (zombie == nullptr || crowd.IsDead(zombie->crowdId))
+			{
+				zombies[i] = zombies.back();
+				zombies.pop_back();
+				i--;
+			}
+		}
+
+		if (time - lastSpawnTime >= spawnInterval && static_cast<int>(zombies.size()) < Constants::MaxZombies)
+		{
+			spawnZombies(spawnCount, time);
+			lastSpawnTime = time;
+			spawnInterval -= 0.1f / spawnCount;
+
+			if (spawnInterval < kSmallestSpawnInterval)
+			{
+				spawnInterval *= 2;
+				spawnCount *= 2;
+			}
+		}
+
+		if (time - lastShot >= kShootingInterval)
+		{
+			scene.AddModel(new TestProjectile(time));
+			lastShot = time;
+			statistics.firedCount++;
+
+			if (!zombies.empty())
+			{
+				auto zombie = s_ZombiePool.Resolve(zombies[random.NextUInt(static_cast<uint32_t>(zombies.size()))]);
+
+				if (zombie != nullptr && crowd.TakeDamage(zombie->crowdId, random.NextReal(0.4f, 1.2f), time))
+				{
+					statistics.killedCount++;
+				}
+			}
+		}
+	}
+
+	// Game over takes every zombie out of the scene, and the crowd goes with them
+	zombies.clear();
+	scene.AddAndRemoveModels();
+	scene.RemoveAll();
+	s_CountAllocations = false;
+
+	return statistics;
+}
+
+// The first game grows the pools, the scene registry and the crowd to what the session needs.
+// A restarted game spawns, shoots and removes just as much, so it has to run without touching the heap
+TEST(SpawningAndFiringDoesNotAllocate)
+{
+#if DEBUG
+	ZombieCrowd crowd;
+	TestScene scene;
+	vector<PoolHandle> zombies;
+
+	zombies.reserve(Constants::MaxZombies);		// As PlayerInstance does
+
+	auto previousHook = _CrtSetAllocHook(CountAllocations);
+
+	PlaySession(crowd, scene, zombies, false);
+	auto statistics = PlaySession(crowd, scene, zombies, true);
+
+	_CrtSetAllocHook(previousHook);
+
+	auto zombieStatistics = s_ZombiePool.GetStatistics();
+	auto projectileStatistics = s_ProjectilePool.GetStatistics();
+
+	cout << "\t" << statistics.spawnedCount << " zombies spawned, " << statistics.killedCount << " killed, " << statistics.firedCount << " shots fired" << endl;
+	cout << "\tZombie high-water mark: " << zombieStatistics.highWaterMark << ", projectile high-water mark: " << projectileStatistics.highWaterMark << endl;
+
+	CHECK(statistics.spawnedCount > Constants::MaxZombies);
+	CHECK(statistics.killedCount > 0);
+	CHECK(s_AllocationCount == 0);
+	CHECK(zombieStatistics.liveCount == 0);
+	CHECK(projectileStatistics.liveCount == 0);
+	CHECK(crowd.GetCount() == 0);
+#else
+	cout << "\tCounting allocations needs the debug CRT, skipped" << endl;
+#endif
+}
\ No newline at end of file
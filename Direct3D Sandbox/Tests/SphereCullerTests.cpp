@@ -0,0 +1,220 @@
+#include "PrecompiledHeader.h"
+#include "Camera.h"
+#include "Constants.h"
+#include "Parameters.h"
+#include "RandomGenerator.h"
+#include "SphereCuller.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+using DirectX::XMFLOAT3;
+using DirectX::XMFLOAT4;
+
+// Planes of an axis aligned box, facing inwards like the camera's frustum planes
+static void MakeBoxPlanes(const XMFLOAT3& minimum, const XMFLOAT3& maximum, FrustumPlanes& planes)
+{
+	planes[0] = DirectX::XMVectorSet(1.0f, 0.0f, 0.0f, -minimum.x);
+	planes[1] = DirectX::XMVectorSet(-1.0f, 0.0f, 0.0f, maximum.x);
+	planes[2] = DirectX::XMVectorSet(0.0f, -1.0f, 0.0f, maximum.y);
+	planes[3] = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, -minimum.y);
+	planes[4] = DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, -minimum.z);
+	planes[5] = DirectX::XMVectorSet(0.0f, 0.0f, -1.0f, maximum.z);
+}
+
+// One sphere against one plane at a time, the way spheres got culled before
+static bool IsVisible(const XMFLOAT4& sphere, const FrustumPlanes& planes)
+{
+	for (int i = 0; i < 6; i++)
+	{
+		XMFLOAT4 plane;
+		DirectX::XMStoreFloat4(&plane, planes[i]);
+
+		if (plane.x * sphere.x + plane.y * sphere.y + plane.z * sphere.z + plane.w + sphere.w < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static vector<XMFLOAT4> MakeSpheres(size_t count, float extent, uint64_t seed)
+{
+	RandomGenerator random(seed);
+	vector<XMFLOAT4> spheres(count);
+
+	for (auto& sphere : spheres)
+	{
+		sphere = XMFLOAT4(random.NextReal(-extent, extent), random.NextReal(-5.0f, 5.0f), random.NextReal(-extent, extent), random.NextReal(0.1f, 3.0f));
+	}
+
+	return spheres;
+}
+
+TEST(SphereCullerClassifiesSpheres)
+{
+	SphereCuller culler;
+	FrustumPlanes planes;
+	MakeBoxPlanes(XMFLOAT3(-10.0f, -10.0f, -10.0f), XMFLOAT3(10.0f, 10.0f, 10.0f), planes);
+
+	auto inside = culler.Add(XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f);
+	auto crossing = culler.Add(XMFLOAT3(10.5f, 0.0f, 0.0f), 1.0f);
+	auto outside = culler.Add(XMFLOAT3(11.5f, 0.0f, 0.0f), 1.0f);
+	auto outsideCorner = culler.Add(XMFLOAT3(-12.0f, 0.0f, -12.0f), 1.5f);
+	auto outsideAbove = culler.Add(XMFLOAT3(0.0f, 20.0f, 0.0f), 5.0f);
+
+	culler.Cull(planes);
+
+	CHECK(inside == 0 && outsideAbove == 4);
+	CHECK(culler.IsVisible(inside));
+	CHECK(culler.IsVisible(crossing));
+	CHECK(!culler.IsVisible(outside));
+	CHECK(!culler.IsVisible(outsideCorner));
+	CHECK(!culler.IsVisible(outsideAbove));
+}
+
+// Clusters that are inside, outside and crossing the frustum all have to give the same answers as testing every sphere on its own
+TEST(SphereCullerMatchesPerSphereTest)
+{
+	const size_t kSphereCount = 5000;
+
+	SphereCuller culler;
+	FrustumPlanes planes;
+	MakeBoxPlanes(XMFLOAT3(-30.0f, -2.0f, -45.0f), XMFLOAT3(25.0f, 2.0f, 10.0f), planes);
+
+	auto spheres = MakeSpheres(kSphereCount, 100.0f, 1);
+
+	for (const auto& sphere : spheres)
+	{
+		culler.Add(XMFLOAT3(sphere.x, sphere.y, sphere.z), sphere.w);
+	}
+
+	culler.Cull(planes);
+	CHECK(culler.GetClusterCount() > 1);
+
+	auto mismatchCount = 0;
+	auto visibleCount = 0;
+
+	for (auto i = 0u; i < kSphereCount; i++)
+	{
+		mismatchCount += culler.IsVisible(i) != IsVisible(spheres[i], planes) ? 1 : 0;
+		visibleCount += culler.IsVisible(i) ? 1 : 0;
+	}
+
+	CHECK(mismatchCount == 0);
+	CHECK(visibleCount > 0 && visibleCount < static_cast<int>(kSphereCount));
+}
+
+// Cells are floored, so coordinates either side of zero end up in different clusters
+TEST(SphereCullerClustersByCell)
+{
+	SphereCuller culler(1.0f);
+	FrustumPlanes planes;
+	MakeBoxPlanes(XMFLOAT3(-10.0f, -10.0f, -10.0f), XMFLOAT3(10.0f, 10.0f, 10.0f), planes);
+
+	culler.Add(XMFLOAT3(-0.5f, 0.0f, 0.5f), 0.1f);
+	culler.Add(XMFLOAT3(0.5f, 0.0f, 0.5f), 0.1f);
+	culler.Add(XMFLOAT3(0.25f, 3.0f, 0.75f), 0.1f);
+	culler.Add(XMFLOAT3(0.5f, 0.0f, -0.5f), 0.1f);
+	culler.Cull(planes);
+
+	CHECK(culler.GetClusterCount() == 3);
+}
+
+// The culler gets cleared and refilled every frame, with sphere indices starting over
+TEST(SphereCullerReusedAfterClear)
+{
+	SphereCuller culler;
+	FrustumPlanes planes;
+	MakeBoxPlanes(XMFLOAT3(-20.0f, -20.0f, -20.0f), XMFLOAT3(20.0f, 20.0f, 20.0f), planes);
+
+	auto spheres = MakeSpheres(1000, 60.0f, 2);
+
+	for (const auto& sphere : spheres)
+	{
+		culler.Add(XMFLOAT3(sphere.x, sphere.y, sphere.z), sphere.w);
+	}
+
+	culler.Cull(planes);
+	culler.Clear();
+	culler.Cull(planes);
+
+	auto fewerSpheres = MakeSpheres(7, 60.0f, 3);
+
+	for (auto i = 0u; i < fewerSpheres.size(); i++)
+	{
+		CHECK(culler.Add(XMFLOAT3(fewerSpheres[i].x, fewerSpheres[i].y, fewerSpheres[i].z), fewerSpheres[i].w) == i);
+	}
+
+	culler.Cull(planes);
+
+	for (auto i = 0u; i < fewerSpheres.size(); i++)
+	{
+		CHECK(culler.IsVisible(i) == IsVisible(fewerSpheres[i], planes));
+	}
+
+	CHECK(culler.GetClusterCount() <= fewerSpheres.size());
+}
+
+// Culls a crowd the size of a busy level against the frustum the game camera hands to the renderer
+BENCHMARK(SphereCullerCull)
+{
+	const size_t kSphereCount = 100000;
+	const int kRepeatCount = 100;
+
+	unique_ptr<Camera> camera(new Camera(true, Constants::VerticalFieldOfView, 16.0f / 9.0f, 0, 0));
+	RenderParameters renderParameters;
+
+	camera->SetPosition(0.0f, 1.5f, 0.0f);
+	camera->SetRotation(0.1f, 0.6f, 0.0f);
+	camera->SetRenderParameters(renderParameters);
+
+	const auto& planes = renderParameters.frustumPlanes;
+
+	SphereCuller culler;
+	auto spheres = MakeSpheres(kSphereCount, 200.0f, 4);
+	auto visibleCount = 0;
+	auto cullTime = 0.0;
+
+	for (int repeat = 0; repeat < kRepeatCount; repeat++)
+	{
+		culler.Clear();
+
+		auto startTime = Tools::GetTime();
+
+		for (const auto& sphere : spheres)
+		{
+			culler.Add(XMFLOAT3(sphere.x, sphere.y, sphere.z), sphere.w);
+		}
+
+		culler.Cull(planes);
+		cullTime += Tools::GetTime() - startTime;
+	}
+
+	auto startTime = Tools::GetTime();
+
+	for (int repeat = 0; repeat < kRepeatCount; repeat++)
+	{
+		visibleCount = 0;
+
+		for (const auto& sphere : spheres)
+		{
+			visibleCount += IsVisible(sphere, planes) ? 1 : 0;
+		}
+	}
+
+	auto perSphereTime = Tools::GetTime() - startTime;
+
+	UnitTest::ReportTime("Clustered", cullTime / kRepeatCount, kSphereCount);
+	UnitTest::ReportTime("Per sphere", perSphereTime / kRepeatCount, kSphereCount);
+	cout << "\t" << visibleCount << " visible spheres in " << culler.GetClusterCount() << " clusters" << endl;
+
+	CHECK(visibleCount > 0 && visibleCount < static_cast<int>(kSphereCount));
+
+	for (auto i = 0u; i < kSphereCount; i++)
+	{
+		visibleCount -= culler.IsVisible(i) ? 1 : 0;
+	}
+
+	CHECK(visibleCount == 0);
+}
\ No newline at end of file
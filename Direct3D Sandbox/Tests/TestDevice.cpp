@@ -0,0 +1,21 @@
+#include "PrecompiledHeader.h"
+#include "Source\Graphics\ConstantRingBuffer.h"
+#include "Source\Graphics\Direct3D.h"
+#include "Source\Graphics\RecordingDeviceContext.h"
+#include "TestDevice.h"
+
+static unique_ptr<Direct3D> s_Direct3D;
+
+RecordingDeviceContext& TestDevice::GetRecorder()
+{
+	if (s_Direct3D == nullptr)
+	{
+		s_Direct3D.reset(new Direct3D(nullptr, 800, 600, false));
+		ConstantRingBuffer::Initialize();
+	}
+
+	auto& recorder = *Direct3D::GetRecordingContext();
+	recorder.EndFrame();
+
+	return recorder;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+class RecordingDeviceContext;
+
+// Headless Direct3D shared by every test that needs a device. It's created on the software rasterizer the first time it's asked for,
+// and the renderer's calls go to a recorder without a target, so nothing is drawn and maps write to memory of the recorder's own
+namespace TestDevice
+{
+	// Ends the recorder's frame, so that the statistics of the next one only count what the test does
+	RecordingDeviceContext& GetRecorder();
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "PrecompiledHeader.h"
+#include "UnitTest.h"
+
+// Constant initialized, so registrations made before main can rely on it whatever order translation units get initialized in
+static UnitTest::Registration* s_FirstRegistration = nullptr;
+static int s_FailedCheckCount = 0;
+
+UnitTest::Registration::Registration(const char* name, Function function, bool isBenchmark) :
+	name(name), function(function), isBenchmark(isBenchmark), next(s_FirstRegistration)
+{
+	s_FirstRegistration = this;
+}
+
+void UnitTest::Check(bool condition, const char* expression, const char* file, int line)
+{
+	if (!condition)
+	{
+		cout << file << "(" << line << "): check failed: " << expression << endl;
+		s_FailedCheckCount++;
+	}
+}
+
+void UnitTest::ReportTime(const char* what, double seconds, size_t itemCount)
+{
+	cout << "\t" << what << ": " << 1000.0 * seconds << " ms";
+
+	if (itemCount > 0)
+	{
+		cout << " (" << 1000000000.0 * seconds / itemCount << " ns per item)";
+	}
+
+	cout << endl;
+}
+
+int UnitTest::RunAll(bool runBenchmarks)
+{
+	auto testCount = 0;
+	auto failedTestCount = 0;
+
+	for (auto registration = s_FirstRegistration; registration != nullptr; registration = registration->next)
+	{
+		if (registration->isBenchmark)
+		{
+			continue;
+		}
+
+		s_FailedCheckCount = 0;
+		registration->function();
+		testCount++;
+
+		if (s_FailedCheckCount > 0)
+		{
+			cout << "FAILED: " << registration->name << endl;
+			failedTestCount++;
+		}
+	}
+
+	cout << testCount - failedTestCount << " of " << testCount << " tests passed." << endl;
+
+	if (runBenchmarks)
+	{
+		for (auto registration = s_FirstRegistration; registration != nullptr; registration = registration->next)
+		{
+			if (registration->isBenchmark)
+			{
+				cout << registration->name << ":" << endl;
+				registration->function();
+			}
+		}
+	}
+
+	return failedTestCount;
+}
+
+#if _WIN64
+	#define GAME_PLATFORM L"x64"
+#else
+	#define GAME_PLATFORM L"Win32"
+#endif
+
+#if _DEBUG
+	#define GAME_CONFIGURATION L"Debug"
+#else
+	#define GAME_CONFIGURATION L"Release"
+#endif
+
+wstring UnitTest::GetGameDirectory()
+{
+	const wstring kGameDirectory = L"..\\Bin\\" GAME_PLATFORM L"\\" GAME_CONFIGURATION;
+	auto attributes = GetFileAttributesW(kGameDirectory.c_str());
+
+	if (attributes == INVALID_FILE_ATTRIBUTES || (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+	{
+		wcout << L"\tThe game's output directory \"" << kGameDirectory << L"\" doesn't exist. Build the game in the same configuration first." << endl;
+		return wstring();
+	}
+
+	return kGameDirectory;
+}
\ No newline at end of file
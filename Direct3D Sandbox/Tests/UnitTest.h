@@ -0,0 +1,40 @@
+#pragma once
+
+// Tests and benchmarks register themselves before main runs. A test keeps going after a failed check, so that one run reports every failure.
+// Benchmarks only run when asked for, as they take a while and their numbers mean little in debug builds
+namespace UnitTest
+{
+	typedef void (*Function)();
+
+	struct Registration
+	{
+		const char* name;
+		Function function;
+		bool isBenchmark;
+		Registration* next;
+
+		Registration(const char* name, Function function, bool isBenchmark);
+	};
+
+	void Check(bool condition, const char* expression, const char* file, int line);
+	void ReportTime(const char* what, double seconds, size_t itemCount);
+
+	// Returns how many tests failed
+	int RunAll(bool runBenchmarks);
+
+	// Output directory of the game built in the same platform and configuration, relative to the directory the tests run in.
+	// Built assets such as models, fonts and compiled shaders only exist there. Returns an empty string, after saying why, if there's no such build
+	wstring GetGameDirectory();
+}
+
+#define TEST(name) \
+	static void name(); \
+	static UnitTest::Registration name##Registration(#name, name, false); \
+	static void name()
+
+#define BENCHMARK(name) \
+	static void name(); \
+	static UnitTest::Registration name##Registration(#name, name, true); \
+	static void name()
+
+#define CHECK(condition) UnitTest::Check((condition), #condition, __FILE__, __LINE__)
\ No newline at end of file
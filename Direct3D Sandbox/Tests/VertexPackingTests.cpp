@@ -0,0 +1,229 @@
+#include "PrecompiledHeader.h"
+#include "Parameters.h"
+#include "RandomGenerator.h"
+#include "UnitTest.h"
+#include "VertexPacking.h"
+
+#include <limits>
+
+using DirectX::XMFLOAT2;
+using DirectX::XMFLOAT3;
+using DirectX::XMFLOAT4;
+
+// Largest angle between the directions octahedral and SNORM packing may give back, in radians: a little over 0.005 degrees
+static const float kMaxDirectionError = 0.0001f;
+
+static void MakeVertex(const XMFLOAT3& position, const XMFLOAT2& textureCoordinates, const XMFLOAT3& normal, VertexParameters& vertex)
+{
+	memset(&vertex, 0, sizeof(vertex));
+	vertex.position = XMFLOAT4(position.x, position.y, position.z, 1.0f);
+	vertex.textureCoordinates = textureCoordinates;
+	vertex.normal = normal;
+	vertex.tangent = normal;
+	vertex.binormal = normal;
+}
+
+static XMFLOAT3 MakeDirection(RandomGenerator& random)
+{
+	XMFLOAT3 direction;
+	float lengthSqr;
+
+	do
+	{
+		direction = XMFLOAT3(random.NextReal(-1.0f, 1.0f), random.NextReal(-1.0f, 1.0f), random.NextReal(-1.0f, 1.0f));
+		lengthSqr = direction.x * direction.x + direction.y * direction.y + direction.z * direction.z;
+	}
+	while (lengthSqr > 1.0f || lengthSqr < 0.0001f);
+
+	return direction;
+}
+
+// Angle between two directions of any length
+static float AngleBetween(const XMFLOAT3& first, const XMFLOAT3& second)
+{
+	auto dot = static_cast<double>(first.x) * second.x + static_cast<double>(first.y) * second.y + static_cast<double>(first.z) * second.z;
+	auto firstLength = sqrt(static_cast<double>(first.x) * first.x + static_cast<double>(first.y) * first.y + static_cast<double>(first.z) * first.z);
+	auto secondLength = sqrt(static_cast<double>(second.x) * second.x + static_cast<double>(second.y) * second.y + static_cast<double>(second.z) * second.z);
+
+	return static_cast<float>(acos(max(-1.0, min(1.0, dot / (firstLength * secondLength)))));
+}
+
+static XMFLOAT3 RoundTripDirection(const XMFLOAT3& direction)
+{
+	VertexBounds bounds;
+	VertexParameters vertex, unpackedVertex;
+	PackedVertexParameters packedVertex;
+
+	bounds.minimum = bounds.extent = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	MakeVertex(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT2(0.0f, 0.0f), direction, vertex);
+	VertexPacking::Pack(vertex, bounds, packedVertex);
+	VertexPacking::Unpack(packedVertex, bounds, unpackedVertex);
+
+	return unpackedVertex.normal;
+}
+
+static XMFLOAT3 RoundTripDirectionSnorm(const XMFLOAT3& direction)
+{
+	int16_t packedDirection[4];
+	VertexPacking::PackDirectionSnorm(direction, packedDirection);
+
+	return XMFLOAT3(packedDirection[0] / 32767.0f, packedDirection[1] / 32767.0f, packedDirection[2] / 32767.0f);
+}
+
+// Positions come back within half a quantization step of the bounding box, with texture coordinates as exact as half floats are
+TEST(VertexPackingPositionsAndTextureCoordinates)
+{
+	const int kVertexCount = 10000;
+
+	RandomGenerator random(1);
+	unique_ptr<VertexParameters[]> vertices(new VertexParameters[kVertexCount]);
+
+	for (int i = 0; i < kVertexCount; i++)
+	{
+		XMFLOAT3 position(random.NextReal(-40.0f, 25.0f), random.NextReal(0.0f, 180.0f), random.NextReal(-3.0f, -1.0f));
+		XMFLOAT2 textureCoordinates(random.NextFloat(), random.NextFloat());
+		MakeVertex(position, textureCoordinates, MakeDirection(random), vertices[i]);
+	}
+
+	auto bounds = VertexPacking::CalculateBounds(vertices.get(), kVertexCount);
+	float maxPositionError[3] = {}, maxTextureCoordinateError = 0.0f;
+
+	CHECK(bounds.minimum.x >= -40.0f && bounds.minimum.x + bounds.extent.x <= 25.0f);
+	CHECK(bounds.minimum.z >= -3.0f && bounds.minimum.z + bounds.extent.z <= -1.0f);
+
+	for (int i = 0; i < kVertexCount; i++)
+	{
+		const auto& vertex = vertices[i];
+		PackedVertexParameters packedVertex;
+		VertexParameters unpackedVertex;
+
+		VertexPacking::Pack(vertex, bounds, packedVertex);
+		VertexPacking::Unpack(packedVertex, bounds, unpackedVertex);
+
+		maxPositionError[0] = max(maxPositionError[0], abs(vertex.position.x - unpackedVertex.position.x));
+		maxPositionError[1] = max(maxPositionError[1], abs(vertex.position.y - unpackedVertex.position.y));
+		maxPositionError[2] = max(maxPositionError[2], abs(vertex.position.z - unpackedVertex.position.z));
+		maxTextureCoordinateError = max(maxTextureCoordinateError, abs(vertex.textureCoordinates.x - unpackedVertex.textureCoordinates.x));
+		maxTextureCoordinateError = max(maxTextureCoordinateError, abs(vertex.textureCoordinates.y - unpackedVertex.textureCoordinates.y));
+
+		CHECK(unpackedVertex.position.w == 1.0f);
+	}
+
+	// Half a step, plus some for float rounding
+	CHECK(maxPositionError[0] <= 0.5f * 1.0001f * bounds.extent.x / 65535.0f + 1e-5f);
+	CHECK(maxPositionError[1] <= 0.5f * 1.0001f * bounds.extent.y / 65535.0f + 1e-5f);
+	CHECK(maxPositionError[2] <= 0.5f * 1.0001f * bounds.extent.z / 65535.0f + 1e-6f);
+
+	// Half floats have 11 significant bits, texture coordinates under 1 lose at most half of the last one
+	CHECK(maxTextureCoordinateError <= 1.0f / 4096.0f);
+}
+
+// The corners of the bounding box come back exactly, and a box flat along an axis keeps that coordinate exactly
+TEST(VertexPackingBoundsEdgeCases)
+{
+	VertexParameters vertices[3];
+	XMFLOAT3 normal(0.0f, 1.0f, 0.0f);
+
+	MakeVertex(XMFLOAT3(-2.5f, 7.0f, 0.1f), XMFLOAT2(0.0f, 1.0f), normal, vertices[0]);
+	MakeVertex(XMFLOAT3(3.5f, 7.0f, 0.3f), XMFLOAT2(1.0f, 0.0f), normal, vertices[1]);
+	MakeVertex(XMFLOAT3(0.0f, 7.0f, 0.2f), XMFLOAT2(16.0f, -2.0f), normal, vertices[2]);
+
+	auto bounds = VertexPacking::CalculateBounds(vertices, 3);
+
+	CHECK(bounds.minimum.x == -2.5f && bounds.extent.x == 6.0f);
+	CHECK(bounds.minimum.y == 7.0f && bounds.extent.y == 0.0f);
+
+	for (const auto& vertex : vertices)
+	{
+		PackedVertexParameters packedVertex;
+		VertexParameters unpackedVertex;
+
+		VertexPacking::Pack(vertex, bounds, packedVertex);
+		VertexPacking::Unpack(packedVertex, bounds, unpackedVertex);
+
+		CHECK(unpackedVertex.position.y == 7.0f);
+		CHECK(unpackedVertex.textureCoordinates.x == vertex.textureCoordinates.x);
+		CHECK(unpackedVertex.textureCoordinates.y == vertex.textureCoordinates.y);
+	}
+
+	PackedVertexParameters packedVertex;
+	VertexPacking::Pack(vertices[0], bounds, packedVertex);
+	CHECK(packedVertex.position[0] == 0 && packedVertex.position[1] == 0);
+
+	VertexPacking::Pack(vertices[1], bounds, packedVertex);
+	CHECK(packedVertex.position[0] == 65535);
+
+	auto emptyBounds = VertexPacking::CalculateBounds(nullptr, 0);
+	CHECK(emptyBounds.extent.x == 0.0f && emptyBounds.extent.y == 0.0f && emptyBounds.extent.z == 0.0f);
+}
+
+TEST(VertexPackingOctahedralDirections)
+{
+	const int kDirectionCount = 100000;
+
+	RandomGenerator random(2);
+	auto maxError = 0.0f;
+
+	for (int i = 0; i < kDirectionCount; i++)
+	{
+		auto direction = MakeDirection(random);
+		maxError = max(maxError, AngleBetween(direction, RoundTripDirection(direction)));
+	}
+
+	CHECK(maxError < kMaxDirectionError);
+
+	// Axes, including the negative z ones that get folded over onto the corners of the square
+	const XMFLOAT3 kAxes[] = 
+	{
+		XMFLOAT3(1.0f, 0.0f, 0.0f), XMFLOAT3(-1.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT3(0.0f, -1.0f, 0.0f),
+		XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT3(0.0f, 0.0f, -1.0f), XMFLOAT3(-0.0f, -0.0f, -1.0f), XMFLOAT3(0.0f, 0.0f, -7.0f),
+		XMFLOAT3(0.6f, 0.0f, -0.8f), XMFLOAT3(0.0f, -0.8f, -0.6f)
+	};
+
+	for (const auto& axis : kAxes)
+	{
+		auto unpacked = RoundTripDirection(axis);
+
+		CHECK(AngleBetween(axis, unpacked) < kMaxDirectionError);
+		CHECK(abs(sqrt(unpacked.x * unpacked.x + unpacked.y * unpacked.y + unpacked.z * unpacked.z) - 1.0f) < 1e-5f);
+	}
+
+	auto negativeZ = RoundTripDirection(XMFLOAT3(0.0f, 0.0f, -1.0f));
+	CHECK(negativeZ.x == 0.0f && negativeZ.y == 0.0f && negativeZ.z == -1.0f);
+
+	// Zero length vectors of either sign can't be normalized, they come back as +Z
+	const XMFLOAT3 kZeroes[] = { XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(-0.0f, -0.0f, -0.0f), XMFLOAT3(0.0f, -0.0f, 0.0f) };
+
+	for (const auto& zero : kZeroes)
+	{
+		auto unpacked = RoundTripDirection(zero);
+		CHECK(unpacked.x == 0.0f && unpacked.y == 0.0f && unpacked.z == 1.0f);
+	}
+}
+
+TEST(VertexPackingSnormDirections)
+{
+	const int kDirectionCount = 100000;
+
+	RandomGenerator random(3);
+	auto maxError = 0.0f;
+
+	for (int i = 0; i < kDirectionCount; i++)
+	{
+		auto direction = MakeDirection(random);
+		maxError = max(maxError, AngleBetween(direction, RoundTripDirectionSnorm(direction)));
+	}
+
+	CHECK(maxError < kMaxDirectionError);
+
+	int16_t packedDirection[4];
+
+	VertexPacking::PackDirectionSnorm(XMFLOAT3(0.0f, 0.0f, -3.0f), packedDirection);
+	CHECK(packedDirection[0] == 0 && packedDirection[1] == 0 && packedDirection[2] == -32767 && packedDirection[3] == 0);
+
+	VertexPacking::PackDirectionSnorm(XMFLOAT3(-0.0f, 0.0f, -0.0f), packedDirection);
+	CHECK(packedDirection[0] == 0 && packedDirection[1] == 0 && packedDirection[2] == 0 && packedDirection[3] == 0);
+
+	VertexPacking::PackDirectionSnorm(XMFLOAT3(numeric_limits<float>::infinity(), 0.0f, 0.0f), packedDirection);
+	CHECK(packedDirection[0] == 0 && packedDirection[1] == 0 && packedDirection[2] == 0);
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "PrecompiledHeader.h"
+#include "Parameters.h"
+#include "Tools.h"
+#include "Tools\Direct3DPostProcessor\VertexWelder.h"
+#include "UnitTest.h"
+
+#include <limits>
+
+using DirectX::XMFLOAT2;
+using DirectX::XMFLOAT3;
+using DirectX::XMFLOAT4;
+
+// Model with a vertex per position and the given indices; every other attribute is zero
+static void MakeModel(const vector<XMFLOAT3>& positions, const vector<unsigned int>& indices, ModelData& model)
+{
+	model.vertexCount = positions.size();
+	model.vertices.reset(new VertexParameters[positions.size()]);
+	memset(model.vertices.get(), 0, positions.size() * sizeof(VertexParameters));
+
+	for (auto i = 0u; i < positions.size(); i++)
+	{
+		model.vertices[i].position = XMFLOAT4(positions[i].x, positions[i].y, positions[i].z, 1.0f);
+	}
+
+	model.indexCount = indices.size();
+	model.indices.reset(new unsigned int[indices.size()]);
+	memcpy(model.indices.get(), indices.data(), indices.size() * sizeof(unsigned int));
+}
+
+TEST(VertexWelderMergesDuplicatesInOrderOfFirstUse)
+{
+	vector<XMFLOAT3> positions;
+	positions.push_back(XMFLOAT3(0.0f, 0.0f, 0.0f));
+	positions.push_back(XMFLOAT3(1.0f, 0.0f, 0.0f));
+	positions.push_back(XMFLOAT3(0.0f, 1.0f, 0.0f));
+	positions.push_back(XMFLOAT3(1.0f, 0.0f, 0.0f));
+	positions.push_back(XMFLOAT3(1.0f, 1.0f, 0.0f));
+	positions.push_back(XMFLOAT3(0.0f, 1.0f, 0.0f));
+
+	unsigned int indices[] = { 0, 1, 2, 3, 4, 5 };
+	ModelData model;
+	MakeModel(positions, vector<unsigned int>(indices, indices + 6), model);
+
+	auto statistics = VertexWelder::WeldVertices(model);
+
+	CHECK(statistics.vertexCountBefore == 6);
+	CHECK(statistics.vertexCountAfter == 4);
+	CHECK(model.vertexCount == 4);
+	CHECK(model.vertices[3].position.x == 1.0f && model.vertices[3].position.y == 1.0f);
+
+	unsigned int expectedIndices[] = { 0, 1, 2, 1, 3, 2 };
+
+	for (int i = 0; i < 6; i++)
+	{
+		CHECK(model.indices[i] == expectedIndices[i]);
+	}
+}
+
+TEST(VertexWelderComparesAllAttributes)
+{
+	vector<XMFLOAT3> positions(3, XMFLOAT3(2.0f, 3.0f, 4.0f));
+	unsigned int indices[] = { 0, 1, 2 };
+	ModelData model;
+	MakeModel(positions, vector<unsigned int>(indices, indices + 3), model);
+
+	model.vertices[1].textureCoordinates = XMFLOAT2(0.5f, 0.0f);
+	model.vertices[2].normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
+
+	VertexWelder::WeldVertices(model);
+	CHECK(model.vertexCount == 3);
+}
+
+TEST(VertexWelderMergesSignedZeroes)
+{
+	vector<XMFLOAT3> positions;
+	positions.push_back(XMFLOAT3(0.0f, 1.0f, 0.0f));
+	positions.push_back(XMFLOAT3(-0.0f, 1.0f, -0.0f));
+
+	unsigned int indices[] = { 0, 1, 1 };
+	ModelData model;
+	MakeModel(positions, vector<unsigned int>(indices, indices + 3), model);
+
+	VertexWelder::WeldVertices(model);
+	CHECK(model.vertexCount == 1);
+	CHECK(model.indices[1] == 0 && model.indices[2] == 0);
+}
+
+TEST(VertexWelderEpsilon)
+{
+	vector<XMFLOAT3> positions;
+	positions.push_back(XMFLOAT3(1.0f, 2.0f, 3.0f));
+	positions.push_back(XMFLOAT3(1.00001f, 2.0f, 2.99999f));
+	positions.push_back(XMFLOAT3(1.1f, 2.0f, 3.0f));
+
+	unsigned int indices[] = { 0, 1, 2 };
+	ModelData exactModel;
+	ModelData weldedModel;
+	MakeModel(positions, vector<unsigned int>(indices, indices + 3), exactModel);
+	MakeModel(positions, vector<unsigned int>(indices, indices + 3), weldedModel);
+
+	VertexWelder::WeldVertices(exactModel);
+	VertexWelder::WeldVertices(weldedModel, 0.001f);
+
+	CHECK(exactModel.vertexCount == 3);
+	CHECK(weldedModel.vertexCount == 2);
+	CHECK(weldedModel.indices[1] == 0);
+	CHECK(weldedModel.indices[2] == 1);
+}
+
+// Coordinates billions of epsilons away from zero, infinities and NaNs snap without overflowing, and only merge with what they equal
+TEST(VertexWelderEpsilonOutOfIntegerRange)
+{
+	auto infinity = numeric_limits<float>::infinity();
+	auto nan = numeric_limits<float>::quiet_NaN();
+
+	vector<XMFLOAT3> positions;
+	positions.push_back(XMFLOAT3(10000.0f, -30000.0f, 0.0f));
+	positions.push_back(XMFLOAT3(10000.0f, -30000.0f, 0.0f));
+	positions.push_back(XMFLOAT3(10000.5f, -30000.0f, 0.0f));
+	positions.push_back(XMFLOAT3(10000.0f, -30000.5f, 0.0f));
+	positions.push_back(XMFLOAT3(infinity, 0.0f, 0.0f));
+	positions.push_back(XMFLOAT3(infinity, 0.0f, 0.0f));
+	positions.push_back(XMFLOAT3(-infinity, 0.0f, 0.0f));
+	positions.push_back(XMFLOAT3(nan, 0.0f, 0.0f));
+	positions.push_back(XMFLOAT3(3.0e38f, 0.0f, 0.0f));
+
+	unsigned int indices[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+	ModelData model;
+	MakeModel(positions, vector<unsigned int>(indices, indices + 9), model);
+
+	VertexWelder::WeldVertices(model, 1e-6f);
+
+	CHECK(model.vertexCount == 7);
+	CHECK(model.indices[1] == 0);
+	CHECK(model.indices[2] == 1 && model.indices[3] == 2);
+	CHECK(model.indices[5] == model.indices[4]);
+	CHECK(model.indices[6] != model.indices[4]);
+	CHECK(model.vertices[model.indices[2]].position.x == 10000.5f);
+	CHECK(model.vertices[model.indices[8]].position.x == 3.0e38f);
+}
+
+// An unindexed triangle soup of a grid, the way exporters write models out, welded back into a shared vertex grid
+BENCHMARK(VertexWelderTriangleSoup)
+{
+	const int kGridSize = 256;
+
+	vector<XMFLOAT3> positions;
+	vector<unsigned int> indices;
+
+	for (int y = 0; y < kGridSize; y++)
+	{
+		for (int x = 0; x < kGridSize; x++)
+		{
+			XMFLOAT3 corners[] = 
+			{
+				XMFLOAT3(static_cast<float>(x), static_cast<float>(y), 0.0f),
+				XMFLOAT3(static_cast<float>(x + 1), static_cast<float>(y), 0.0f),
+				XMFLOAT3(static_cast<float>(x), static_cast<float>(y + 1), 0.0f),
+				XMFLOAT3(static_cast<float>(x + 1), static_cast<float>(y + 1), 0.0f)
+			};
+
+			int quadIndices[] = { 0, 1, 2, 2, 1, 3 };
+
+			for (int i = 0; i < 6; i++)
+			{
+				indices.push_back(static_cast<unsigned int>(positions.size()));
+				positions.push_back(corners[quadIndices[i]]);
+			}
+		}
+	}
+
+	ModelData model;
+	MakeModel(positions, indices, model);
+
+	auto statistics = VertexWelder::WeldVertices(model);
+
+	UnitTest::ReportTime("Weld", statistics.seconds, statistics.vertexCountBefore);
+	CHECK(statistics.vertexCountAfter == (kGridSize + 1) * (kGridSize + 1));
+}
\ No newline at end of file
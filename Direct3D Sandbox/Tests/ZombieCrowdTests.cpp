@@ -0,0 +1,199 @@
+#include "PrecompiledHeader.h"
+#include "RandomGenerator.h"
+#include "Source\Games\ZombieSurvival\ZombieCrowd.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+#include <concrt.h>
+
+using DirectX::XMFLOAT2;
+using DirectX::XMFLOAT3;
+
+TEST(ZombieCrowdIdsSurviveRemoval)
+{
+	ZombieCrowd crowd;
+	auto first = crowd.Add(XMFLOAT2(1.0f, 1.0f), 0.0f, ZombieCrowd::kZombieSpeed, true, 0.0f);
+	auto second = crowd.Add(XMFLOAT2(2.0f, 2.0f), 0.5f, ZombieCrowd::kZombieSpeed, true, 0.0f);
+	auto third = crowd.Add(XMFLOAT2(3.0f, 3.0f), 1.0f, ZombieCrowd::kZombieSpeed, true, 0.0f);
+
+	crowd.Remove(first);
+	CHECK(crowd.GetCount() == 2);
+	CHECK(crowd.GetPosition(second).x == 2.0f);
+	CHECK(crowd.GetPosition(third).y == 3.0f);
+	CHECK(crowd.GetRotationY(third) == 1.0f);
+	CHECK(crowd.CanMoveTo(XMFLOAT2(1.0f, 1.0f), second));
+
+	auto fourth = crowd.Add(XMFLOAT2(4.0f, 4.0f), 0.0f, ZombieCrowd::kZombieSpeed, true, 0.0f);
+	CHECK(fourth == first);
+	CHECK(crowd.GetPosition(fourth).x == 4.0f);
+	CHECK(crowd.GetPosition(second).x == 2.0f);
+}
+
+TEST(ZombieCrowdDeadZombiesDontBlock)
+{
+	ZombieCrowd crowd;
+	auto zombie = crowd.Add(XMFLOAT2(0.5f, 0.5f), 0.0f, ZombieCrowd::kZombieSpeed, true, 0.0f);
+
+	CHECK(!crowd.CanMoveTo(XMFLOAT2(0.6f, 0.5f), ZombieCrowd::kNoZombie));
+	CHECK(!crowd.TakeDamage(zombie, 0.5f, 1.0f));
+	CHECK(!crowd.IsDead(zombie));
+	CHECK(crowd.TakeDamage(zombie, 0.5f, 2.0f));
+	CHECK(crowd.IsDead(zombie));
+	CHECK(crowd.CanMoveTo(XMFLOAT2(0.6f, 0.5f), ZombieCrowd::kNoZombie));
+
+	crowd.Remove(zombie);
+	CHECK(crowd.GetCount() == 0);
+}
+
+TEST(ZombieCrowdRunsTowardsPlayer)
+{
+	ZombieCrowd crowd;
+	XMFLOAT3 playerPosition(0.0f, 0.0f, 0.0f);
+	auto zombie = crowd.Add(XMFLOAT2(10.0f, 0.0f), 0.0f, ZombieCrowd::kZombieSpeed, true, 0.0f);
+
+	crowd.Update(0.1f, 0.1f, playerPosition, false);
+	CHECK(crowd.GetPosition(zombie).x == 10.0f);
+
+	crowd.Update(0.1f, 0.2f, playerPosition, true);
+	CHECK(crowd.GetPosition(zombie).x < 10.0f);
+	CHECK(fabs(crowd.GetPosition(zombie).y) < 0.0001f);
+	CHECK(crowd.GetEvents(zombie) == ZombieCrowd::NoEvents);
+}
+
+TEST(ZombieCrowdDespawnsFarZombies)
+{
+	ZombieCrowd crowd;
+	XMFLOAT3 playerPosition(0.0f, 0.0f, 0.0f);
+	auto nearZombie = crowd.Add(XMFLOAT2(10.0f, 0.0f), 0.0f, ZombieCrowd::kZombieSpeed, true, 0.0f);
+	auto farZombie = crowd.Add(XMFLOAT2(200.0f, 0.0f), 0.0f, ZombieCrowd::kZombieSpeed, true, 0.0f);
+
+	crowd.Update(0.1f, 0.1f, playerPosition, true);
+	CHECK((crowd.GetEvents(farZombie) & ZombieCrowd::Expired) != 0);
+	CHECK((crowd.GetEvents(nearZombie) & ZombieCrowd::Expired) == 0);
+	CHECK(crowd.IsDead(farZombie));
+	CHECK(crowd.CanMoveTo(XMFLOAT2(200.0f, 0.0f), ZombieCrowd::kNoZombie));
+
+	crowd.ExpireAll();
+	CHECK(crowd.IsDead(nearZombie));
+	CHECK(crowd.CanMoveTo(crowd.GetPosition(nearZombie), ZombieCrowd::kNoZombie));
+}
+
+// Drawing animation progress for a whole wave ahead has to hand out the numbers adding zombies one by one would
+TEST(ZombieCrowdPrepareToAddKeepsRandomNumbers)
+{
+	const int kZombieCount = 37;
+
+	ZombieCrowd oneByOne;
+	ZombieCrowd prepared;
+	vector<unsigned int> oneByOneIds;
+	vector<unsigned int> preparedIds;
+
+	Tools::Random::Seed(12345);
+
+	for (int i = 0; i < kZombieCount; i++)
+	{
+		oneByOneIds.push_back(oneByOne.Add(XMFLOAT2(2.0f * i, 0.0f), 0.0f, ZombieCrowd::kZombieSpeed, true, 0.0f));
+	}
+
+	Tools::Random::Seed(12345);
+	prepared.PrepareToAdd(10);
+
+	for (int i = 0; i < kZombieCount; i++)
+	{
+		if (i == 10)
+		{
+			prepared.PrepareToAdd(kZombieCount - 10);
+		}
+
+		preparedIds.push_back(prepared.Add(XMFLOAT2(2.0f * i, 0.0f), 0.0f, ZombieCrowd::kZombieSpeed, true, 0.0f));
+	}
+
+	for (int i = 0; i < kZombieCount; i++)
+	{
+		CHECK(oneByOne.GetAnimation(oneByOneIds[i]).GetCurrentStateAnimationProgress() == prepared.GetAnimation(preparedIds[i]).GetCurrentStateAnimationProgress());
+	}
+}
+
+// A crowd running at the player from all sides, as dense as a wave of 10000 zombies within 90 meters of them
+static void AddCrowd(ZombieCrowd& crowd, int zombieCount)
+{
+	RandomGenerator random(1);
+	auto radius = 90.0f * sqrt(zombieCount / 10000.0f);
+
+	crowd.PrepareToAdd(zombieCount);
+
+	for (int i = 0; i < zombieCount; i++)
+	{
+		auto angle = random.NextReal(0.0f, 2.0f * DirectX::XM_PI);
+		auto distance = random.NextReal(5.0f, radius);
+		XMFLOAT2 position(distance * cos(angle), distance * sin(angle));
+
+		if (crowd.CanMoveTo(position, ZombieCrowd::kNoZombie))
+		{
+			crowd.Add(position, 0.0f, ZombieCrowd::kZombieSpeed, true, 0.0f);
+		}
+	}
+}
+
+// Returns seconds per frame
+static double TimeUpdates(ZombieCrowd& crowd, int frameCount)
+{
+	const float kFrameTime = 1.0f / 60.0f;
+
+	XMFLOAT3 playerPosition(0.0f, 0.0f, 0.0f);
+	auto startTime = Tools::GetTime();
+
+	for (int i = 0; i < frameCount; i++)
+	{
+		crowd.Update(kFrameTime, i * kFrameTime, playerPosition, true);
+	}
+
+	return (Tools::GetTime() - startTime) / frameCount;
+}
+
+BENCHMARK(ZombieCrowdUpdate)
+{
+	const int kZombieCount = 10000;
+	const int kFrameCount = 100;
+
+	ZombieCrowd crowd;
+	AddCrowd(crowd, kZombieCount);
+
+	UnitTest::ReportTime("Update", TimeUpdates(crowd, kFrameCount), crowd.GetCount());
+	CHECK(crowd.ConsumeDamageToPlayer() >= 0.0f);
+}
+
+// Runs the same frames on schedulers limited to 1..N cores. Each run starts from the same crowd, so the work done is identical
+BENCHMARK(ZombieCrowdUpdateScaling)
+{
+	const int kZombieCounts[] = { 1000, 10000, 40000 };
+	const int kFrameCount = 60;
+
+	auto coreCount = concurrency::GetProcessorCount();
+
+	for (auto zombieCount : kZombieCounts)
+	{
+		double singleCoreTime = 0.0;
+
+		for (auto cores = 1u; cores <= coreCount; cores++)
+		{
+			auto scheduler = concurrency::Scheduler::Create(concurrency::SchedulerPolicy(2, concurrency::MinConcurrency, cores, concurrency::MaxConcurrency, cores));
+			scheduler->Attach();
+
+			ZombieCrowd crowd;
+			AddCrowd(crowd, zombieCount);
+			auto frameTime = TimeUpdates(crowd, kFrameCount);
+
+			concurrency::CurrentScheduler::Detach();
+			scheduler->Release();
+
+			if (cores == 1)
+			{
+				singleCoreTime = frameTime;
+			}
+
+			cout << "\t" << crowd.GetCount() << " zombies on " << cores << (cores == 1 ? " core: " : " cores: ") << 1000.0 * frameTime << 
+				" ms per frame, " << singleCoreTime / frameTime << "x speed-up" << endl;
+		}
+	}
+}
\ No newline at end of file
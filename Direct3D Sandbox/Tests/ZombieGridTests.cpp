@@ -0,0 +1,205 @@
+#include "PrecompiledHeader.h"
+#include "RandomGenerator.h"
+#include "Source\Games\ZombieSurvival\ZombieGrid.h"
+#include "Tools.h"
+#include "UnitTest.h"
+
+using DirectX::XMFLOAT2;
+
+TEST(ZombieGridEmptyIsFree)
+{
+	ZombieGrid grid;
+
+	CHECK(grid.GetCount() == 0);
+	CHECK(grid.IsFree(XMFLOAT2(0.0f, 0.0f), 0));
+	CHECK(grid.IsFree(XMFLOAT2(-123.5f, 456.25f), 0));
+}
+
+TEST(ZombieGridBlocksCloserThanCellSize)
+{
+	ZombieGrid grid;
+	grid.Add(1, XMFLOAT2(10.5f, 10.5f));
+
+	CHECK(grid.GetCount() == 1);
+	CHECK(!grid.IsFree(XMFLOAT2(10.5f, 10.5f), 0));
+	CHECK(!grid.IsFree(XMFLOAT2(11.4f, 10.5f), 0));
+	CHECK(!grid.IsFree(XMFLOAT2(10.5f, 9.6f), 0));
+	CHECK(grid.IsFree(XMFLOAT2(11.6f, 10.5f), 0));
+	CHECK(grid.IsFree(XMFLOAT2(11.3f, 11.3f), 0));
+	CHECK(grid.IsFree(XMFLOAT2(10.5f, 10.5f), 1));
+}
+
+// Positions on both sides of cell borders, including the one at zero where coordinates change sign
+TEST(ZombieGridBlocksAcrossCellBorders)
+{
+	ZombieGrid grid;
+	grid.Add(1, XMFLOAT2(0.95f, 3.0f));
+	grid.Add(2, XMFLOAT2(-0.05f, -7.0f));
+	grid.Add(3, XMFLOAT2(4.0f, -0.05f));
+
+	CHECK(!grid.IsFree(XMFLOAT2(1.05f, 3.0f), 0));
+	CHECK(!grid.IsFree(XMFLOAT2(0.05f, -7.0f), 0));
+	CHECK(!grid.IsFree(XMFLOAT2(-0.9f, -7.0f), 0));
+	CHECK(!grid.IsFree(XMFLOAT2(4.0f, 0.05f), 0));
+	CHECK(grid.IsFree(XMFLOAT2(4.0f, 1.0f), 0));
+}
+
+TEST(ZombieGridCellsDontAlias)
+{
+	ZombieGrid grid;
+	grid.Add(1, XMFLOAT2(0.5f, -0.5f));
+
+	CHECK(grid.IsFree(XMFLOAT2(-0.5f, -100000.0f), 0));
+	CHECK(grid.IsFree(XMFLOAT2(0.5f, 100000.0f), 0));
+	CHECK(grid.IsFree(XMFLOAT2(-100000.0f, -0.5f), 0));
+}
+
+TEST(ZombieGridMove)
+{
+	ZombieGrid grid;
+	grid.Add(1, XMFLOAT2(0.5f, 0.5f));
+	grid.Add(2, XMFLOAT2(0.7f, 0.6f));
+
+	grid.Move(1, XMFLOAT2(0.5f, 0.5f), XMFLOAT2(0.2f, 0.3f));
+	CHECK(!grid.IsFree(XMFLOAT2(-0.5f, 0.3f), 0));
+	CHECK(grid.IsFree(XMFLOAT2(1.4f, 0.5f), 2));
+
+	grid.Move(1, XMFLOAT2(0.2f, 0.3f), XMFLOAT2(20.0f, 20.0f));
+	CHECK(grid.IsFree(XMFLOAT2(0.0f, 0.0f), 2));
+	CHECK(!grid.IsFree(XMFLOAT2(20.5f, 20.5f), 0));
+	CHECK(!grid.IsFree(XMFLOAT2(0.0f, 0.0f), 0));
+	CHECK(grid.GetCount() == 2);
+}
+
+TEST(ZombieGridRemoveAndClear)
+{
+	ZombieGrid grid;
+	grid.Add(1, XMFLOAT2(0.5f, 0.5f));
+	grid.Add(2, XMFLOAT2(0.6f, 0.5f));
+	grid.Add(3, XMFLOAT2(5.0f, 5.0f));
+
+	grid.Remove(1, XMFLOAT2(0.5f, 0.5f));
+	CHECK(grid.GetCount() == 2);
+	CHECK(!grid.IsFree(XMFLOAT2(0.5f, 0.5f), 0));
+	CHECK(grid.IsFree(XMFLOAT2(0.5f, 0.5f), 2));
+
+	grid.Clear();
+	CHECK(grid.GetCount() == 0);
+	CHECK(grid.IsFree(XMFLOAT2(0.6f, 0.5f), 0));
+	CHECK(grid.IsFree(XMFLOAT2(5.0f, 5.0f), 0));
+
+	grid.Add(4, XMFLOAT2(5.0f, 5.0f));
+	CHECK(!grid.IsFree(XMFLOAT2(5.0f, 5.0f), 0));
+}
+
+// An arena with many more cells than the grid has buckets, so that plenty of cells share one
+TEST(ZombieGridSharedBucketsMatchScan)
+{
+	const int kZombieCount = 3000;
+	const int kQueryCount = 20000;
+	const float kArenaSize = 400.0f;
+
+	ZombieGrid grid;
+	RandomGenerator random(2);
+	vector<XMFLOAT2> zombies;
+
+	for (int i = 0; i < kZombieCount; i++)
+	{
+		zombies.push_back(XMFLOAT2(random.NextReal(-kArenaSize, kArenaSize), random.NextReal(-kArenaSize, kArenaSize)));
+		grid.Add(i, zombies.back());
+	}
+
+	for (int i = 0; i < kZombieCount; i += 2)
+	{
+		XMFLOAT2 position(random.NextReal(-kArenaSize, kArenaSize), random.NextReal(-kArenaSize, kArenaSize));
+		grid.Move(i, zombies[i], position);
+		zombies[i] = position;
+	}
+
+	auto mismatchCount = 0;
+
+	for (int i = 0; i < kQueryCount; i++)
+	{
+		auto query = zombies[random.NextUInt(kZombieCount)];
+		query.x += random.NextReal(-1.5f, 1.5f);
+		query.y += random.NextReal(-1.5f, 1.5f);
+
+		auto isFree = true;
+
+		for (const auto& zombie : zombies)
+		{
+			auto deltaX = query.x - zombie.x;
+			auto deltaZ = query.y - zombie.y;
+
+			if (deltaX * deltaX + deltaZ * deltaZ < ZombieGrid::kCellSize * ZombieGrid::kCellSize)
+			{
+				isFree = false;
+				break;
+			}
+		}
+
+		mismatchCount += grid.IsFree(query, kZombieCount) != isFree ? 1 : 0;
+	}
+
+	CHECK(mismatchCount == 0);
+	CHECK(grid.GetCount() == kZombieCount);
+}
+
+// Grid queries against the brute force scan over every zombie that the grid replaced
+BENCHMARK(ZombieGridIsFree)
+{
+	const int kZombieCount = 2000;
+	const int kQueryCount = 100000;
+	const float kArenaSize = 100.0f;
+
+	ZombieGrid grid;
+	RandomGenerator random(1);
+	vector<XMFLOAT2> zombies;
+	vector<XMFLOAT2> queries;
+
+	for (int i = 0; i < kZombieCount; i++)
+	{
+		zombies.push_back(XMFLOAT2(random.NextReal(0.0f, kArenaSize), random.NextReal(0.0f, kArenaSize)));
+		grid.Add(i, zombies.back());
+	}
+
+	for (int i = 0; i < kQueryCount; i++)
+	{
+		queries.push_back(XMFLOAT2(random.NextReal(0.0f, kArenaSize), random.NextReal(0.0f, kArenaSize)));
+	}
+
+	auto startTime = Tools::GetTime();
+	auto gridFreeCount = 0;
+
+	for (const auto& query : queries)
+	{
+		gridFreeCount += grid.IsFree(query, kZombieCount) ? 1 : 0;
+	}
+
+	UnitTest::ReportTime("Grid", Tools::GetTime() - startTime, kQueryCount);
+
+	startTime = Tools::GetTime();
+	auto scanFreeCount = 0;
+
+	for (const auto& query : queries)
+	{
+		auto isFree = true;
+
+		for (const auto& zombie : zombies)
+		{
+			auto deltaX = query.x - zombie.x;
+			auto deltaZ = query.y - zombie.y;
+
+			if (deltaX * deltaX + deltaZ * deltaZ < ZombieGrid::kCellSize * ZombieGrid::kCellSize)
+			{
+				isFree = false;
+				break;
+			}
+		}
+
+		scanFreeCount += isFree ? 1 : 0;
+	}
+
+	UnitTest::ReportTime("Scan", Tools::GetTime() - startTime, kQueryCount);
+	CHECK(gridFreeCount == scanFreeCount);
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include "PrecompiledHeader.h"
+#include "UnitTest.h"
+
+// Runs every test, and every benchmark too when started with -benchmarks. Returns how many tests failed, so that the build fails with them.
+// Assets are loaded by the same relative paths the game uses, so it has to run in the game's directory, like the build runs it
+int wmain(int argc, wchar_t* argv[])
+{
+	auto runBenchmarks = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (wstring(argv[i]) == L"-benchmarks")
+		{
+			runBenchmarks = true;
+		}
+		else
+		{
+			wcout << L"Unknown argument: \"" << argv[i] << L"\". Usage: " << argv[0] << L" [-benchmarks]" << endl;
+			return -1;
+		}
+	}
+
+	return UnitTest::RunAll(runBenchmarks);
+}
\ No newline at end of file
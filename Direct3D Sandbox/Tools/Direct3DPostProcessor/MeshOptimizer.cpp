@@ -0,0 +1,250 @@
+#include "PrecompiledHeader.h"
+#include "MeshOptimizer.h"
+#include "Parameters.h"
+
+static const unsigned int kNoTriangle = 0xFFFFFFFF;
+static const unsigned int kUnusedVertex = 0xFFFFFFFF;
+
+// Scoring constants from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+static const int kMaxCacheSize = 32;
+static const float kCacheDecayPower = 1.5f;
+static const float kLastTriangleScore = 0.75f;
+static const float kValenceBoostScale = 2.0f;
+static const float kValenceBoostPower = 0.5f;
+
+static float ScoreVertex(int cachePosition, unsigned int remainingTriangles)
+{
+	if (remainingTriangles == 0)
+	{
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+
+	if (cachePosition >= 0)
+	{
+		if (cachePosition < 3)
+		{
+			// Vertices of the last triangle get a fixed score, so that triangles sharing an edge with it don't win too easily
+			score = kLastTriangleScore;
+		}
+		else
+		{
+			const float scaler = 1.0f / (kMaxCacheSize - 3);
+			score = pow(1.0f - (cachePosition - 3) * scaler, kCacheDecayPower);
+		}
+	}
+
+	// Prefer vertices with few triangles left, so that they can leave the cache for good sooner
+	score += kValenceBoostScale * pow(static_cast<float>(remainingTriangles), -kValenceBoostPower);
+	return score;
+}
+
+void MeshOptimizer::OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount)
+{
+	auto triangleCount = indexCount / 3;
+
+	// Triangles using each vertex: the ones not emitted yet are kept at the front of each vertex's range
+	vector<unsigned int> remainingTriangles(vertexCount);
+	vector<unsigned int> triangleOffsets(vertexCount + 1);
+	vector<unsigned int> vertexTriangles(indexCount);
+
+	for (auto i = 0u; i < indexCount; i++)
+	{
+		remainingTriangles[indices[i]]++;
+	}
+
+	for (auto i = 0u; i < vertexCount; i++)
+	{
+		triangleOffsets[i + 1] = triangleOffsets[i] + remainingTriangles[i];
+	}
+
+	vector<unsigned int> writeOffsets(begin(triangleOffsets), end(triangleOffsets) - 1);
+
+	for (auto i = 0u; i < indexCount; i++)
+	{
+		vertexTriangles[writeOffsets[indices[i]]++] = i / 3;
+	}
+
+	vector<int> cachePositions(vertexCount, -1);
+	vector<float> vertexScores(vertexCount);
+	vector<float> triangleScores(triangleCount);
+	vector<uint8_t> isTriangleEmitted(triangleCount);
+
+	for (auto i = 0u; i < vertexCount; i++)
+	{
+		vertexScores[i] = ScoreVertex(-1, remainingTriangles[i]);
+	}
+
+	auto bestTriangle = kNoTriangle;
+	auto bestScore = -1.0f;
+
+	for (auto i = 0u; i < triangleCount; i++)
+	{
+		triangleScores[i] = vertexScores[indices[3 * i]] + vertexScores[indices[3 * i + 1]] + vertexScores[indices[3 * i + 2]];
+
+		if (triangleScores[i] > bestScore)
+		{
+			bestScore = triangleScores[i];
+			bestTriangle = i;
+		}
+	}
+
+	vector<unsigned int> output(indexCount);
+	vector<unsigned int> cache, newCache;
+	cache.reserve(kMaxCacheSize + 3);
+	newCache.reserve(kMaxCacheSize + 3);
+	auto scanPosition = 0u;
+
+	for (auto emittedCount = 0u; emittedCount < triangleCount; emittedCount++)
+	{
+		// Nothing in the cache is connected to any remaining triangle, so start over from the next unused triangle
+		if (bestTriangle == kNoTriangle)
+		{
+			while (isTriangleEmitted[scanPosition])
+			{
+				scanPosition++;
+			}
+
+			bestTriangle = scanPosition;
+		}
+
+		auto triangle = &indices[3 * bestTriangle];
+		memcpy(&output[3 * emittedCount], triangle, 3 * sizeof(unsigned int));
+		isTriangleEmitted[bestTriangle] = 1;
+
+		newCache.clear();
+
+		for (int i = 0; i < 3; i++)
+		{
+			auto vertex = triangle[i];
+
+			// Move the triangle out of the vertex's remaining range
+			auto rangeStart = &vertexTriangles[triangleOffsets[vertex]];
+			auto rangeEnd = rangeStart + remainingTriangles[vertex];
+			auto position = find(rangeStart, rangeEnd, bestTriangle);
+			swap(*position, *(rangeEnd - 1));
+			remainingTriangles[vertex]--;
+
+			if (find(begin(newCache), end(newCache), vertex) == end(newCache))
+			{
+				newCache.push_back(vertex);
+			}
+		}
+
+		for (auto vertex : cache)
+		{
+			if (find(begin(newCache), end(newCache), vertex) == end(newCache))
+			{
+				newCache.push_back(vertex);
+			}
+		}
+
+		// Vertices that got pushed out of the cache have to be rescored as well
+		for (auto i = 0u; i < newCache.size(); i++)
+		{
+			auto vertex = newCache[i];
+			cachePositions[vertex] = i < static_cast<unsigned int>(kMaxCacheSize) ? static_cast<int>(i) : -1;
+			vertexScores[vertex] = ScoreVertex(cachePositions[vertex], remainingTriangles[vertex]);
+		}
+
+		bestTriangle = kNoTriangle;
+		bestScore = -1.0f;
+
+		for (auto vertex : newCache)
+		{
+			auto rangeStart = triangleOffsets[vertex];
+			auto rangeEnd = rangeStart + remainingTriangles[vertex];
+
+			for (auto i = rangeStart; i < rangeEnd; i++)
+			{
+				auto candidate = vertexTriangles[i];
+				auto candidateIndices = &indices[3 * candidate];
+
+				triangleScores[candidate] = vertexScores[candidateIndices[0]] + vertexScores[candidateIndices[1]] + vertexScores[candidateIndices[2]];
+
+				if (triangleScores[candidate] > bestScore)
+				{
+					bestScore = triangleScores[candidate];
+					bestTriangle = candidate;
+				}
+			}
+		}
+
+		if (newCache.size() > static_cast<size_t>(kMaxCacheSize))
+		{
+			newCache.resize(kMaxCacheSize);
+		}
+
+		swap(cache, newCache);
+	}
+
+	memcpy(indices, output.data(), indexCount * sizeof(unsigned int));
+}
+
+vector<unsigned int> MeshOptimizer::OptimizeVertexFetch(unsigned int* indices, size_t indexCount, size_t vertexCount)
+{
+	vector<unsigned int> remap(vertexCount, kUnusedVertex);
+	auto nextVertex = 0u;
+
+	for (auto i = 0u; i < indexCount; i++)
+	{
+		auto& index = indices[i];
+
+		if (remap[index] == kUnusedVertex)
+		{
+			remap[index] = nextVertex++;
+		}
+
+		index = remap[index];
+	}
+
+	// Vertices no triangle uses go to the end
+	for (auto& newIndex : remap)
+	{
+		if (newIndex == kUnusedVertex)
+		{
+			newIndex = nextVertex++;
+		}
+	}
+
+	return remap;
+}
+
+void MeshOptimizer::RemapVertices(VertexParameters* vertices, size_t vertexCount, const vector<unsigned int>& remap)
+{
+	unique_ptr<VertexParameters[]> remappedVertices(new VertexParameters[vertexCount]);
+
+	for (auto i = 0u; i < vertexCount; i++)
+	{
+		memcpy(&remappedVertices[remap[i]], &vertices[i], sizeof(VertexParameters));
+	}
+
+	memcpy(vertices, remappedVertices.get(), vertexCount * sizeof(VertexParameters));
+}
+
+MeshOptimizer::CacheStatistics MeshOptimizer::AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize)
+{
+	CacheStatistics statistics;
+
+	// A vertex is in the FIFO cache if fewer than cacheSize misses happened since it was last loaded into it
+	vector<unsigned int> loadTimes(vertexCount, 0);
+	auto time = cacheSize + 1;
+	auto missCount = 0u;
+
+	for (auto i = 0u; i < indexCount; i++)
+	{
+		auto index = indices[i];
+
+		if (time - loadTimes[index] > cacheSize)
+		{
+			loadTimes[index] = time++;
+			missCount++;
+		}
+	}
+
+	statistics.acmr = indexCount > 0 ? static_cast<float>(missCount) / (indexCount / 3) : 0.0f;
+	statistics.atvr = vertexCount > 0 ? static_cast<float>(missCount) / vertexCount : 0.0f;
+
+	return statistics;
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+struct VertexParameters;
+
+namespace MeshOptimizer
+{
+	struct CacheStatistics
+	{
+		float acmr;		// Average cache miss ratio: transformed vertices per triangle, 0.5 at best, 3.0 at worst
+		float atvr;		// Average transformed vertex ratio: transformed vertices per vertex, 1.0 at best
+	};
+
+	// Reorders triangles so that consecutive triangles reuse vertices still in the post-transform cache (Forsyth's algorithm)
+	void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+	// Renumbers vertices in the order indices first reference them and returns the remap from old to new vertex index
+	vector<unsigned int> OptimizeVertexFetch(unsigned int* indices, size_t indexCount, size_t vertexCount);
+	void RemapVertices(VertexParameters* vertices, size_t vertexCount, const vector<unsigned int>& remap);
+
+	// Runs indices through a simulated FIFO post-transform cache of the given size
+	CacheStatistics AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize);
+}
\ No newline at end of file
@@ -1,6 +1,15 @@
 #include "PrecompiledHeader.h"
 #include "..\..\Source\Core\Tools.h"
+#include "FrameDeltaCoding.h"
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+#include "ModelFile.h"
 #include "ModelProcessor.h"
+#include "ObjParser.h"
+#include "VertexPacking.h"
+#include "VertexWelder.h"
+
+#include <ppl.h>
 
 // edge1 = u1 * tangent + v1 * binormal
 // edge2 = u2 * tangent + v2 * binormal
@@ -60,61 +69,47 @@ static void CalculateRadius(ModelData& model)
 	});
 }
 
+// Snap distance used when welding vertices. Zero only merges vertices that are exactly the same,
+// which is required for animated models, as every frame has to end up with the same index buffer
+static const float kVertexWeldEpsilon = 0.0f;
+
 static void OptimizeModel(ModelData& model)
 {
-	auto vertexPtrHash = [](const VertexParameters* value) -> size_t
-	{
-		return hash<VertexParameters>()(*value);
-	};
-
-	auto compareVertexPtrValues = [](const VertexParameters* first, const VertexParameters* second) -> bool
-	{
-		return *first == *second;
-	};
-
-	unordered_map<const VertexParameters*, int, size_t(*)(const VertexParameters*), 
-		bool(*)(const VertexParameters*, const VertexParameters*)> vertexMap(16, vertexPtrHash, compareVertexPtrValues);
-
-	map<int, int> indexChanges;
-
-	for (auto i = 0u; i < model.vertexCount; i++)
-	{
-		vertexMap.emplace(&model.vertices[i], i);
-	}
-
-	int i = 0;
-	cout << "Optimizing model..." << endl;
-	cout << "\tVertex count before: " << model.vertexCount << endl;
-	cout << "\tVertex count after:  " << vertexMap.size() << endl << endl;
+	auto statistics = VertexWelder::WeldVertices(model, kVertexWeldEpsilon);
+	auto ratio = statistics.vertexCountBefore > 0 ? static_cast<double>(statistics.vertexCountAfter) / statistics.vertexCountBefore : 1.0;
+
+	// Frames are optimized in parallel, so write the whole report at once to keep it from interleaving
+	stringstream report;
+	report << "Optimizing model..." << endl;
+	report << "\tVertex count before: " << statistics.vertexCountBefore << endl;
+	report << "\tVertex count after:  " << statistics.vertexCountAfter << " (" << 100.0 * ratio << "%)" << endl;
+	report << "\tWelding took " << 1000.0 * statistics.seconds << " ms" << endl << endl;
+	cout << report.str();
+}
 
-	// Preserve original order by sorting by index
-	vector<pair<const VertexParameters*, int>> vertexVector(begin(vertexMap), end(vertexMap));
-	sort(begin(vertexVector), end(vertexVector), [](const pair<const VertexParameters*, int>& left, const pair<const VertexParameters*, int>& right) -> bool
-	{
-		return left.second < right.second;
-	});
+// Size of the post-transform cache the reordering is evaluated against, which is what most GPUs have had
+static const unsigned int kSimulatedVertexCacheSize = 16;
 
-	unique_ptr<VertexParameters[]> optimizedVertices(new VertexParameters[vertexMap.size()]);
+// Reorders triangles for the post-transform vertex cache and then vertices to match the order they're fetched in.
+// Returns the vertex remap, which has to be applied to every set of vertices that uses these indices
+static vector<unsigned int> OptimizeIndexOrder(unsigned int* indices, size_t indexCount, size_t vertexCount)
+{
+	auto before = MeshOptimizer::AnalyzeVertexCache(indices, indexCount, vertexCount, kSimulatedVertexCacheSize);
 
-	for (auto& vertex : vertexVector)
-	{
-		memcpy(&optimizedVertices[i], &*vertex.first, sizeof(VertexParameters));
-		indexChanges[vertex.second] = i;
+	MeshOptimizer::OptimizeVertexCache(indices, indexCount, vertexCount);
+	auto remap = MeshOptimizer::OptimizeVertexFetch(indices, indexCount, vertexCount);
 
-		i++;
-	}
+	auto after = MeshOptimizer::AnalyzeVertexCache(indices, indexCount, vertexCount, kSimulatedVertexCacheSize);
 
-	for (auto i = 0u; i < model.indexCount; i++)
-	{
-		model.indices[i] = indexChanges[vertexMap[&model.vertices[model.indices[i]]]];
-	}
+	cout << "Optimizing index order..." << endl;
+	cout << "\tACMR before: " << before.acmr << ", ATVR before: " << before.atvr << endl;
+	cout << "\tACMR after:  " << after.acmr << ", ATVR after:  " << after.atvr << endl << endl;
 
-	model.vertices = std::move(optimizedVertices);
-	model.vertexCount = vertexMap.size();
+	return remap;
 }
 
 static ModelData ParseFaces(const vector<DirectX::XMFLOAT4>& coordinates, const vector<DirectX::XMFLOAT2>& textures,
-							const vector<DirectX::XMFLOAT3>& normals, vector<string>& faces)
+							const vector<DirectX::XMFLOAT3>& normals, const vector<ObjParser::FaceCorner>& faces)
 {
 	auto const facesCount = faces.size();
 	ModelData model;
@@ -127,27 +122,14 @@ static ModelData ParseFaces(const vector<DirectX::XMFLOAT4>& coordinates, const
 	{
 		for (int j = 0; j < 3; j++, i++)
 		{
-			char* cStr = &faces[i][0];
-			long int v, t, n;
-
-			v = strtol(cStr, &cStr, 10);
-			cStr++;
-			
-			auto hasTexture = *cStr != '/';
-			if (hasTexture)
-			{
-				t = strtol(cStr, &cStr, 10);
-			}
-			cStr++;
-
-			n = strtol(cStr, nullptr, 10);
+			const auto& corner = faces[i];
 
-			model.vertices[i].position = coordinates[v - 1];
-			model.vertices[i].normal = normals[n - 1];
+			model.vertices[i].position = coordinates[corner.coordinate - 1];
+			model.vertices[i].normal = normals[corner.normal - 1];
 
-			if (hasTexture)
+			if (corner.texture != 0)
 			{
-				model.vertices[i].textureCoordinates = textures[t - 1];
+				model.vertices[i].textureCoordinates = textures[corner.texture - 1];
 			}
 			else
 			{
@@ -168,110 +150,255 @@ static ModelData ParseFaces(const vector<DirectX::XMFLOAT4>& coordinates, const
 
 static ModelData LoadModel(const wstring& path)
 {
-	vector<DirectX::XMFLOAT4> coordinates;
-	vector<DirectX::XMFLOAT2> textures;
-	vector<DirectX::XMFLOAT3> normals;
-	vector<string> faces;
-	
-	float x, y, z;
-	string input;
+	ObjParser::ObjData obj;
+
+	{
+		MappedFile file(path);
+		ObjParser::Parse(file.GetData(), file.GetSize(), obj);
+	}
+
+	auto model = ParseFaces(obj.coordinates, obj.textures, obj.normals, obj.faces);
+
+	OptimizeModel(model);
+	CalculateTangentsAndBinormals(model);
+	CalculateRadius(model);
 
-	ifstream in(path);
-	Assert(in.is_open());
+	return model;
+}
+
+// Packs vertices against their bounding box and reports how much precision got lost
+static VertexBounds PackVertices(const VertexParameters vertices[], size_t vertexCount, PackedVertexParameters packedVertices[])
+{
+	auto bounds = VertexPacking::CalculateBounds(vertices, vertexCount);
 
-	while (!in.eof())
+	float maxPositionError = 0.0f, maxTextureCoordinateError = 0.0f, maxDirectionError = 0.0f;
+	VertexParameters unpackedVertex;
+
+	auto directionError = [](const DirectX::XMFLOAT3& original, const DirectX::XMFLOAT3& unpacked) -> float
 	{
-		in >> input;
+		// Only directions survive packing, so compare angles between them
+		using namespace DirectX;
+		auto originalVector = XMLoadFloat3(&original);
 
-		if (!in.fail())
+		if (XMVectorGetX(XMVector3LengthSq(originalVector)) == 0.0f)
 		{
-			if (input == "v")
-			{
-				in >> x >> y >> z;
-				coordinates.emplace_back(x, y, z, 1.0f);
-			}
-			else if (input == "vt")
-			{
-				in >> x >> y;
-				textures.emplace_back(x, 1.0f - y);
-			}
-			else if (input == "vn")
-			{
-				in >> x >> y >> z;
-				normals.emplace_back(x, y, z);
-			}
-			else if (input == "f")
+			return 0.0f;
+		}
+
+		return XMVectorGetX(XMVector3AngleBetweenVectors(originalVector, XMLoadFloat3(&unpacked)));
+	};
+
+	for (auto i = 0u; i < vertexCount; i++)
+	{
+		const auto& vertex = vertices[i];
+
+		VertexPacking::Pack(vertex, bounds, packedVertices[i]);
+		VertexPacking::Unpack(packedVertices[i], bounds, unpackedVertex);
+
+		maxPositionError = max(maxPositionError, abs(vertex.position.x - unpackedVertex.position.x));
+		maxPositionError = max(maxPositionError, abs(vertex.position.y - unpackedVertex.position.y));
+		maxPositionError = max(maxPositionError, abs(vertex.position.z - unpackedVertex.position.z));
+		maxTextureCoordinateError = max(maxTextureCoordinateError, abs(vertex.textureCoordinates.x - unpackedVertex.textureCoordinates.x));
+		maxTextureCoordinateError = max(maxTextureCoordinateError, abs(vertex.textureCoordinates.y - unpackedVertex.textureCoordinates.y));
+		maxDirectionError = max(maxDirectionError, directionError(vertex.normal, unpackedVertex.normal));
+		maxDirectionError = max(maxDirectionError, directionError(vertex.tangent, unpackedVertex.tangent));
+		maxDirectionError = max(maxDirectionError, directionError(vertex.binormal, unpackedVertex.binormal));
+	}
+
+	cout << "Packing vertices..." << endl;
+	cout << "\tMax position error: " << maxPositionError << endl;
+	cout << "\tMax texture coordinate error: " << maxTextureCoordinateError << endl;
+	cout << "\tMax normal/tangent/binormal error: " << DirectX::XMConvertToDegrees(maxDirectionError) << " degrees" << endl;
+
+	return bounds;
+}
+
+static void AppendBytes(vector<uint8_t>& output, const void* data, size_t size)
+{
+	auto bytes = static_cast<const uint8_t*>(data);
+	output.insert(output.end(), bytes, bytes + size);
+}
+
+static void WriteVertices(vector<uint8_t>& output, const VertexParameters vertices[], size_t vertexCount, VertexEncoding vertexEncoding)
+{
+	if (vertexEncoding == VertexEncoding::FullPrecision)
+	{
+		AppendBytes(output, vertices, vertexCount * sizeof(VertexParameters));
+		return;
+	}
+
+	unique_ptr<PackedVertexParameters[]> packedVertices(new PackedVertexParameters[vertexCount]);
+	auto bounds = PackVertices(vertices, vertexCount, packedVertices.get());
+
+	AppendBytes(output, &bounds, sizeof(VertexBounds));
+	AppendBytes(output, packedVertices.get(), vertexCount * sizeof(PackedVertexParameters));
+
+	auto fullSize = vertexCount * sizeof(VertexParameters);
+	auto packedSize = sizeof(VertexBounds) + vertexCount * sizeof(PackedVertexParameters);
+
+	cout << "\tVertex data size: " << fullSize << " -> " << packedSize << " bytes (" << 100.0 * packedSize / fullSize << "%)" << endl << endl;
+}
+
+// Delta coding needs texture coordinates to be the same in every frame, as they're only stored once
+static bool HasStaticTextureCoordinates(const AnimatedModelData& model)
+{
+	for (auto frame = 1u; frame < model.totalFrameCount; frame++)
+	{
+		auto frameVertices = model.vertices.get() + frame * model.vertexCount;
+
+		for (auto i = 0u; i < model.vertexCount; i++)
+		{
+			if (frameVertices[i].textureCoordinates.x != model.vertices[i].textureCoordinates.x ||
+				frameVertices[i].textureCoordinates.y != model.vertices[i].textureCoordinates.y)
 			{
-				for (int i = 0; i < 3; i++)
-				{
-					in >> input;
-					faces.push_back(input);
-				}
+				return false;
 			}
 		}
 	}
-	
-	in.close();
 
-	auto model = ParseFaces(coordinates, textures, normals, faces);
+	return true;
+}
 
-	OptimizeModel(model);
-	CalculateTangentsAndBinormals(model);
-	CalculateRadius(model);
+static void WriteDeltaCodedFrames(vector<uint8_t>& output, const VertexParameters vertices[], size_t vertexCount, size_t frameCount)
+{
+	auto totalVertexCount = frameCount * vertexCount;
+	unique_ptr<PackedVertexParameters[]> packedVertices(new PackedVertexParameters[totalVertexCount]);
+	auto bounds = PackVertices(vertices, totalVertexCount, packedVertices.get());
 
-	return model;
+	vector<uint16_t> textureCoordinates(2 * vertexCount);
+
+	for (auto i = 0u; i < vertexCount; i++)
+	{
+		textureCoordinates[2 * i] = packedVertices[i].textureCoordinates[0];
+		textureCoordinates[2 * i + 1] = packedVertices[i].textureCoordinates[1];
+	}
+
+	vector<uint8_t> encodedFrames;
+	FrameDeltaCoding::Encode(packedVertices.get(), vertexCount, frameCount, encodedFrames);
+
+	// Decode everything back to make sure the game gets exactly the packed vertices, and to see how long loading will take
+	unique_ptr<PackedVertexParameters[]> decodedVertices(new PackedVertexParameters[totalVertexCount]);
+	memcpy(decodedVertices.get(), packedVertices.get(), totalVertexCount * sizeof(PackedVertexParameters));
+
+	auto startTime = Tools::GetTime();
+	auto decoded = FrameDeltaCoding::Decode(encodedFrames.data(), encodedFrames.size(), vertexCount, frameCount, decodedVertices.get());
+	auto decodingTime = Tools::GetTime() - startTime;
+
+	if (!decoded || memcmp(decodedVertices.get(), packedVertices.get(), totalVertexCount * sizeof(PackedVertexParameters)) != 0)
+	{
+		cout << "ERROR: delta coded animation frames don't decode back to the packed vertices." << endl;
+		exit(1);
+	}
+
+	// The encoded frames take the rest of the vertex section
+	AppendBytes(output, &bounds, sizeof(VertexBounds));
+	AppendBytes(output, textureCoordinates.data(), textureCoordinates.size() * sizeof(uint16_t));
+	AppendBytes(output, encodedFrames.data(), encodedFrames.size());
+
+	auto fullSize = totalVertexCount * sizeof(VertexParameters);
+	auto packedSize = sizeof(VertexBounds) + totalVertexCount * sizeof(PackedVertexParameters);
+	auto deltaCodedSize = sizeof(VertexBounds) + textureCoordinates.size() * sizeof(uint16_t) + encodedFrames.size();
+
+	cout << "\tVertex data size: " << fullSize << " -> " << deltaCodedSize << " bytes (" << 100.0 * deltaCodedSize / fullSize << "%)" << endl;
+	cout << "\tPacked frames without delta coding: " << packedSize << " bytes (" << 100.0 * deltaCodedSize / packedSize << "% of it after delta coding)" << endl;
+	cout << "\tDelta decoding speed: " << totalVertexCount * sizeof(PackedVertexParameters) / (1024.0 * 1024.0 * decodingTime) << " MB/s" << endl << endl;
 }
 
-static void SaveModel(const wstring& path, const ModelData& model)
-{	
-	ofstream out(path, ios::binary);
+// Fills in section offsets and checksums, then writes the header followed by the sections padded to their alignment
+static void SaveModelFile(const wstring& path, ModelFile::Header& header, const vector<uint8_t> sections[ModelFile::SectionType::SectionTypeCount])
+{
+	using namespace ModelFile;
 
-	// Model type
-	auto modelType = ModelType::Still;
-	out.write(reinterpret_cast<const char*>(&modelType), sizeof(ModelType));
+	auto offset = AlignSectionOffset(sizeof(Header));
 
-	// Vertices
-	out.write(reinterpret_cast<const char*>(&model.vertexCount), sizeof(int));
-	out.write(reinterpret_cast<const char*>(model.vertices.get()), model.vertexCount * sizeof(VertexParameters));
+	for (auto i = 0u; i < SectionType::SectionTypeCount; i++)
+	{
+		header.sections[i].offset = offset;
+		header.sections[i].size = static_cast<uint32_t>(sections[i].size());
+		header.sections[i].checksum = CalculateChecksum(sections[i].data(), sections[i].size());
 
-	// Indices
-	out.write(reinterpret_cast<const char*>(&model.indexCount), sizeof(int));
-	out.write(reinterpret_cast<const char*>(model.indices.get()), model.indexCount * sizeof(unsigned int));
-	
-	// Radius
-	out.write(reinterpret_cast<const char*>(&model.radius), sizeof(float));
+		offset = AlignSectionOffset(offset + header.sections[i].size);
+	}
+
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.headerChecksum = CalculateHeaderChecksum(header);
+
+	const char padding[kSectionAlignment] = {};
+	ofstream out(path, ios::binary);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+	for (auto i = 0u; i < SectionType::SectionTypeCount; i++)
+	{
+		out.write(padding, header.sections[i].offset - static_cast<uint32_t>(out.tellp()));
+		out.write(reinterpret_cast<const char*>(sections[i].data()), sections[i].size());
+	}
 
 	out.close();
 }
 
-static void SaveAnimatedModel(const wstring& path, const AnimatedModelData& model)
+static void SaveModel(const wstring& path, const ModelData& model, VertexEncoding vertexEncoding)
 {
-	ofstream out(path, ios::binary);
-	
-	// Model type
-	auto modelType = ModelType::Animated;
-	out.write(reinterpret_cast<const char*>(&modelType), sizeof(ModelType));
-	out.write(reinterpret_cast<const char*>(&model.totalFrameCount), sizeof(int));
-	out.write(reinterpret_cast<const char*>(&model.stateCount), sizeof(int));
+	ModelFile::Header header;
+	vector<uint8_t> sections[ModelFile::SectionType::SectionTypeCount];
+
+	header.modelType = ModelType::Still;
+	header.vertexEncoding = vertexEncoding;
+	header.vertexCount = static_cast<uint32_t>(model.vertexCount);
+	header.indexCount = static_cast<uint32_t>(model.indexCount);
+	header.frameCount = 1;
+	header.stateCount = 0;
+	header.radius = model.radius;
+
+	WriteVertices(sections[ModelFile::SectionType::Vertices], model.vertices.get(), model.vertexCount, vertexEncoding);
+	AppendBytes(sections[ModelFile::SectionType::Indices], model.indices.get(), model.indexCount * sizeof(unsigned int));
+
+	SaveModelFile(path, header, sections);
+}
+
+static void SaveAnimatedModel(const wstring& path, const AnimatedModelData& model, VertexEncoding vertexEncoding)
+{
+	ModelFile::Header header;
+	vector<uint8_t> sections[ModelFile::SectionType::SectionTypeCount];
+
+	header.modelType = ModelType::Animated;
+	header.vertexEncoding = vertexEncoding;
+	header.vertexCount = static_cast<uint32_t>(model.vertexCount);
+	header.indexCount = static_cast<uint32_t>(model.indexCount);
+	header.frameCount = static_cast<uint32_t>(model.totalFrameCount);
+	header.stateCount = static_cast<uint32_t>(model.stateCount);
+	header.radius = model.radius;
+
+	if (vertexEncoding == VertexEncoding::Packed && HasStaticTextureCoordinates(model))
+	{
+		header.vertexEncoding = VertexEncoding::PackedDeltaFrames;
+	}
 
 	// Frame data for each state
-	out.write(reinterpret_cast<const char*>(model.stateData.get()), model.stateCount * sizeof(AnimatedModelState));
+	for (auto i = 0u; i < model.stateCount; i++)
+	{
+		ModelFile::StateRecord stateRecord;
+		stateRecord.frameCount = static_cast<uint32_t>(model.stateData[i].frameCount);
+		stateRecord.frameOffset = static_cast<uint32_t>(model.stateData[i].frameOffset);
 
-	// Vertices
-	out.write(reinterpret_cast<const char*>(&model.vertexCount), sizeof(int));
-	out.write(reinterpret_cast<const char*>(model.vertices.get()), model.totalFrameCount * model.vertexCount * sizeof(VertexParameters));
+		AppendBytes(sections[ModelFile::SectionType::StateData], &stateRecord, sizeof(ModelFile::StateRecord));
+	}
 
-	// Indices
-	out.write(reinterpret_cast<const char*>(&model.indexCount), sizeof(int));
-	out.write(reinterpret_cast<const char*>(model.indices.get()), model.indexCount * sizeof(unsigned int));
+	if (header.vertexEncoding == VertexEncoding::PackedDeltaFrames)
+	{
+		WriteDeltaCodedFrames(sections[ModelFile::SectionType::Vertices], model.vertices.get(), model.vertexCount, model.totalFrameCount);
+	}
+	else
+	{
+		WriteVertices(sections[ModelFile::SectionType::Vertices], model.vertices.get(), model.totalFrameCount * model.vertexCount, vertexEncoding);
+	}
 
-	// Radius
-	out.write(reinterpret_cast<const char*>(&model.radius), sizeof(float));
+	AppendBytes(sections[ModelFile::SectionType::Indices], model.indices.get(), model.indexCount * sizeof(unsigned int));
 
-	out.close();
+	SaveModelFile(path, header, sections);
 }
 
-void ModelProcessor::ProcessModel(const wstring& path, const wstring& outputPath)
+void ModelProcessor::ProcessModel(const wstring& path, const wstring& outputPath, VertexEncoding vertexEncoding)
 {
 	auto modelName = path.substr(path.find_last_of(L'\\') + 1);		// Remove folder
 	modelName = modelName.substr(0, modelName.length() - 4);		// Remove extension
@@ -287,7 +414,10 @@ void ModelProcessor::ProcessModel(const wstring& path, const wstring& outputPath
 	
 	auto model = LoadModel(path);
 
-	SaveModel(modelName + L".model", model);
+	auto remap = OptimizeIndexOrder(model.indices.get(), model.indexCount, model.vertexCount);
+	MeshOptimizer::RemapVertices(model.vertices.get(), model.vertexCount, remap);
+
+	SaveModel(modelName + L".model", model, vertexEncoding);
 }
 
 static vector<vector<ModelData>> LoadModelStates(const wstring& rootPath)
@@ -306,12 +436,23 @@ static vector<vector<ModelData>> LoadModelStates(const wstring& rootPath)
 		}
 
 		sort(begin(frames), end(frames));
+		wcout << L"Loading " << frames.size() << L" frames of state " << modelStates.size() << L"..." << endl;
+
+		// Frames don't depend on each other, so parse them all at once. ModelData can't be move assigned,
+		// so every frame gets its own slot which is moved into place afterwards, to keep frame order intact
+		vector<unique_ptr<ModelData>> loadedFrames(frames.size());
+
+		concurrency::parallel_for(size_t(0), frames.size(), [&frames, &loadedFrames](size_t i)
+		{
+			loadedFrames[i] = unique_ptr<ModelData>(new ModelData(LoadModel(frames[i])));
+		});
+
 		vector<ModelData> modelFrames;
+		modelFrames.reserve(frames.size());
 
-		for (auto i = 0u; i < frames.size(); i++)
+		for (auto& frame : loadedFrames)
 		{
-			wcout << L"Loading frame " << i << L" of state " << modelStates.size() << L"..." << endl;
-			modelFrames.push_back(LoadModel(frames[i]));
+			modelFrames.push_back(std::move(*frame));
 		}
 		
 		modelStates.push_back(std::move(modelFrames));
@@ -419,7 +560,7 @@ static void SerializeAnimatedModel(const vector<vector<ModelData>>& modelStates,
 	}
 }
 
-void ModelProcessor::ProcessAnimatedModel(const wstring& rootPath, const wstring& outputPath)
+void ModelProcessor::ProcessAnimatedModel(const wstring& rootPath, const wstring& outputPath, VertexEncoding vertexEncoding)
 {
 	auto modelStates = LoadModelStates(rootPath);
 
@@ -448,6 +589,17 @@ void ModelProcessor::ProcessAnimatedModel(const wstring& rootPath, const wstring
 	// Check all frames actually match
 	ValidateModel(modelStates, animatedModelData.indexCount);
 
+	// All frames share the index buffer, so the reordering is computed once and applied to the vertices of every frame
+	auto remap = OptimizeIndexOrder(modelStates[0][0].indices.get(), animatedModelData.indexCount, animatedModelData.vertexCount);
+
+	for (auto& modelFrames : modelStates)
+	{
+		for (auto& frame : modelFrames)
+		{
+			MeshOptimizer::RemapVertices(frame.vertices.get(), frame.vertexCount, remap);
+		}
+	}
+
 	animatedModelData.indices = std::move(modelStates[0][0].indices);
 	animatedModelData.vertices = unique_ptr<VertexParameters[]>(new VertexParameters[modelStates[0][0].vertexCount * animatedModelData.totalFrameCount]);
 
@@ -457,6 +609,6 @@ void ModelProcessor::ProcessAnimatedModel(const wstring& rootPath, const wstring
 	auto modelPath = outputPath + L"\\" + modelName;
 
 	wcout << L"Saving animated model to \"" << modelPath << "\"...";
-	SaveAnimatedModel(modelPath, animatedModelData);
+	SaveAnimatedModel(modelPath, animatedModelData, vertexEncoding);
 	wcout << " Done!" << endl << endl;
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "VertexPacking.h"
+
+// FullPrecision vertices are used straight from the mapped file, Packed ones take 22 bytes instead of 60 but get unpacked on load
 namespace ModelProcessor
 {
-	void ProcessModel(const wstring& path, const wstring& outputPath);
-	void ProcessAnimatedModel(const wstring& rootPath, const wstring& outputPath);
+	void ProcessModel(const wstring& path, const wstring& outputPath, VertexEncoding vertexEncoding);
+	void ProcessAnimatedModel(const wstring& rootPath, const wstring& outputPath, VertexEncoding vertexEncoding);
 }
\ No newline at end of file
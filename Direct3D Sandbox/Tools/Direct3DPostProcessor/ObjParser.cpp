@@ -0,0 +1,205 @@
+#include "PrecompiledHeader.h"
+#include "ObjParser.h"
+
+static inline void SkipBlanks(const char*& cursor, const char* end)
+{
+	while (cursor < end && (*cursor == ' ' || *cursor == '\t'))
+	{
+		cursor++;
+	}
+}
+
+static inline void SkipLine(const char*& cursor, const char* end)
+{
+	while (cursor < end && *cursor != '\n')
+	{
+		cursor++;
+	}
+
+	if (cursor < end)
+	{
+		cursor++;
+	}
+}
+
+int ObjParser::ParseInt(const char*& cursor, const char* end)
+{
+	SkipBlanks(cursor, end);
+
+	bool isNegative = false;
+	if (cursor < end && (*cursor == '-' || *cursor == '+'))
+	{
+		isNegative = *cursor == '-';
+		cursor++;
+	}
+
+	int value = 0;
+
+	while (cursor < end && *cursor >= '0' && *cursor <= '9')
+	{
+		value = 10 * value + (*cursor - '0');
+		cursor++;
+	}
+
+	return isNegative ? -value : value;
+}
+
+float ObjParser::ParseFloat(const char*& cursor, const char* end)
+{
+	static const double kPowersOfTen[] = 
+	{ 
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 
+	};
+	const int kMaxPower = sizeof(kPowersOfTen) / sizeof(kPowersOfTen[0]) - 1;
+
+	SkipBlanks(cursor, end);
+
+	bool isNegative = false;
+	if (cursor < end && (*cursor == '-' || *cursor == '+'))
+	{
+		isNegative = *cursor == '-';
+		cursor++;
+	}
+
+	unsigned long long mantissa = 0;
+	int exponent = 0;
+	int digitCount = 0;
+
+	while (cursor < end && *cursor >= '0' && *cursor <= '9')
+	{
+		if (digitCount < 19)
+		{
+			mantissa = 10 * mantissa + (*cursor - '0');
+			digitCount++;
+		}
+		else
+		{
+			exponent++;
+		}
+
+		cursor++;
+	}
+
+	if (cursor < end && *cursor == '.')
+	{
+		cursor++;
+
+		while (cursor < end && *cursor >= '0' && *cursor <= '9')
+		{
+			if (digitCount < 19)
+			{
+				mantissa = 10 * mantissa + (*cursor - '0');
+				digitCount++;
+				exponent--;
+			}
+
+			cursor++;
+		}
+	}
+
+	if (cursor < end && (*cursor == 'e' || *cursor == 'E'))
+	{
+		cursor++;
+		exponent += ParseInt(cursor, end);
+	}
+
+	auto value = static_cast<double>(mantissa);
+
+	while (exponent > kMaxPower)
+	{
+		value *= kPowersOfTen[kMaxPower];
+		exponent -= kMaxPower;
+	}
+
+	while (exponent < -kMaxPower)
+	{
+		value /= kPowersOfTen[kMaxPower];
+		exponent += kMaxPower;
+	}
+
+	value = exponent >= 0 ? value * kPowersOfTen[exponent] : value / kPowersOfTen[-exponent];
+	return static_cast<float>(isNegative ? -value : value);
+}
+
+ObjParser::FaceCorner ObjParser::ParseFaceCorner(const char*& cursor, const char* end)
+{
+	FaceCorner corner;
+
+	corner.coordinate = ParseInt(cursor, end);
+	corner.texture = 0;
+	corner.normal = 0;
+
+	if (cursor < end && *cursor == '/')
+	{
+		cursor++;
+
+		if (cursor < end && *cursor != '/')
+		{
+			corner.texture = ParseInt(cursor, end);
+		}
+
+		if (cursor < end && *cursor == '/')
+		{
+			cursor++;
+			corner.normal = ParseInt(cursor, end);
+		}
+	}
+
+	return corner;
+}
+
+void ObjParser::Parse(const char* data, size_t size, ObjData& obj)
+{
+	auto cursor = data;
+	auto end = data + size;
+
+	// Every line is at least ~20 bytes long, so this avoids most of the reallocations without overcommitting too much
+	auto expectedLineCount = size / 32;
+	obj.coordinates.reserve(expectedLineCount / 4);
+	obj.textures.reserve(expectedLineCount / 4);
+	obj.normals.reserve(expectedLineCount / 4);
+	obj.faces.reserve(3 * expectedLineCount / 4);
+	
+	float x, y, z;
+
+	while (cursor < end)
+	{
+		SkipBlanks(cursor, end);
+
+		if (end - cursor >= 2 && cursor[0] == 'v' && (cursor[1] == ' ' || cursor[1] == '\t'))
+		{
+			cursor += 2;
+			x = ParseFloat(cursor, end);
+			y = ParseFloat(cursor, end);
+			z = ParseFloat(cursor, end);
+			obj.coordinates.emplace_back(x, y, z, 1.0f);
+		}
+		else if (end - cursor >= 3 && cursor[0] == 'v' && cursor[1] == 't' && (cursor[2] == ' ' || cursor[2] == '\t'))
+		{
+			cursor += 3;
+			x = ParseFloat(cursor, end);
+			y = ParseFloat(cursor, end);
+			obj.textures.emplace_back(x, 1.0f - y);
+		}
+		else if (end - cursor >= 3 && cursor[0] == 'v' && cursor[1] == 'n' && (cursor[2] == ' ' || cursor[2] == '\t'))
+		{
+			cursor += 3;
+			x = ParseFloat(cursor, end);
+			y = ParseFloat(cursor, end);
+			z = ParseFloat(cursor, end);
+			obj.normals.emplace_back(x, y, z);
+		}
+		else if (end - cursor >= 2 && cursor[0] == 'f' && (cursor[1] == ' ' || cursor[1] == '\t'))
+		{
+			cursor += 2;
+
+			for (int i = 0; i < 3; i++)
+			{
+				obj.faces.push_back(ParseFaceCorner(cursor, end));
+			}
+		}
+
+		SkipLine(cursor, end);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+// Reads the parts of Wavefront OBJ files that models are made of, working directly on the file contents, without going through
+// locale aware strtod. Every token parse function skips leading blanks, consumes its token and advances the cursor past it
+namespace ObjParser
+{
+	struct FaceCorner
+	{
+		int coordinate, texture, normal;		// One based, zero if missing
+	};
+
+	struct ObjData
+	{
+		vector<DirectX::XMFLOAT4> coordinates;
+		vector<DirectX::XMFLOAT2> textures;
+		vector<DirectX::XMFLOAT3> normals;
+		vector<FaceCorner> faces;				// Three corners per triangle
+	};
+
+	int ParseInt(const char*& cursor, const char* end);
+
+	// Handles the fixed and scientific notations exporters write
+	float ParseFloat(const char*& cursor, const char* end);
+
+	// Parses "v/t/n", "v//n" or "v"
+	FaceCorner ParseFaceCorner(const char*& cursor, const char* end);
+
+	// Reads coordinates, texture coordinates flipped to Direct3D's convention, normals and triangles, and skips every other line
+	void Parse(const char* data, size_t size, ObjData& obj);
+}
\ No newline at end of file
@@ -88,12 +88,35 @@ static void GetDXGIFormatAndSize(int mask, D3D_REGISTER_COMPONENT_TYPE component
 	}
 }
 
+// Vertex inputs that don't need full 32-bit floats get fed through narrower formats, which the input assembler expands:
+// position's w is always 1, which is also what the input assembler fills in for a missing component,
+// and normals, tangents and binormals only need their direction, as shaders normalize them
+static void GetCompactDXGIFormatAndSize(const string& semanticName, D3D_REGISTER_COMPONENT_TYPE componentType, 
+										DXGI_FORMAT& dxgiFormat, unsigned int& size)
+{
+	if (componentType != D3D_REGISTER_COMPONENT_FLOAT32)
+	{
+		return;
+	}
+
+	if (_stricmp(semanticName.c_str(), "POSITION") == 0 && dxgiFormat == DXGI_FORMAT_R32G32B32A32_FLOAT)
+	{
+		dxgiFormat = DXGI_FORMAT_R32G32B32_FLOAT;
+		size = 12;
+	}
+	else if ((_stricmp(semanticName.c_str(), "NORMAL") == 0 || _stricmp(semanticName.c_str(), "TANGENT") == 0 || 
+			 _stricmp(semanticName.c_str(), "BINORMAL") == 0) && dxgiFormat == DXGI_FORMAT_R32G32B32_FLOAT)
+	{
+		dxgiFormat = DXGI_FORMAT_R16G16B16A16_SNORM;
+		size = 8;
+	}
+}
+
 static void ReflectOnConstantBuffer(vector<uint8_t>& metadataBuffer, ID3D11ShaderReflectionConstantBuffer* bufferReflection)
 {	
 	HRESULT result;
 	D3D11_SHADER_BUFFER_DESC bufferDescription;
 	D3D11_SHADER_VARIABLE_DESC fieldDescription;
-	unsigned int parameterOffset;
 	
 	result = bufferReflection->GetDesc(&bufferDescription);
 	Assert(result == S_OK);
@@ -110,10 +133,22 @@ static void ReflectOnConstantBuffer(vector<uint8_t>& metadataBuffer, ID3D11Shade
 		result = field->GetDesc(&fieldDescription);
 		Assert(result == S_OK);
 		
-		parameterOffset = RenderParameters::GetFieldByteOffset(fieldDescription.Name);
-		Assert(parameterOffset != 0xFFFFFFFF);
+		auto parameterField = RenderParameters::GetFieldDescription(fieldDescription.Name);
+
+		if (parameterField == nullptr)
+		{
+			cout << "ERROR: shader reads render parameter \"" << fieldDescription.Name << "\", which doesn't exist." << endl;
+			exit(1);
+		}
+
+		if (fieldDescription.Size > parameterField->shaderSize)
+		{
+			cout << "ERROR: shader reads " << fieldDescription.Size << " bytes of render parameter \"" << fieldDescription.Name 
+				 << "\", which only has " << parameterField->shaderSize << " bytes that shaders can read." << endl;
+			exit(1);
+		}
 		
-		AddUInt(metadataBuffer, byteOffset, parameterOffset);
+		AddUInt(metadataBuffer, byteOffset, parameterField->offset);
 		AddUInt(metadataBuffer, byteOffset, fieldDescription.StartOffset);
 		AddUInt(metadataBuffer, byteOffset, fieldDescription.Size);
 	}
@@ -137,9 +172,11 @@ static void ReflectOnInputLayout(vector<uint8_t>& metadataBuffer, ComPtr<ID3D11S
 		result = shaderReflection->GetInputParameterDesc(i, &parameterDescription);
 		Assert(result == S_OK);
 
-		GetDXGIFormatAndSize(parameterDescription.Mask, parameterDescription.ComponentType, dxgiFormat, itemSize);
 		semanticName = parameterDescription.SemanticName;
-		parameterOffset = VertexParameters::GetFieldByteOffset(semanticName);
+		GetDXGIFormatAndSize(parameterDescription.Mask, parameterDescription.ComponentType, dxgiFormat, itemSize);
+		GetCompactDXGIFormatAndSize(semanticName, parameterDescription.ComponentType, dxgiFormat, itemSize);
+		auto parameterField = VertexParameters::GetFieldDescription(semanticName);
+		parameterOffset = parameterField != nullptr ? parameterField->offset : 0xFFFFFFFF;
 
 		metadataBuffer.resize(metadataBuffer.size() + 17 + semanticName.length());
 
@@ -189,7 +226,7 @@ static void ReflectOnOtherResources(vector<uint8_t>& metadataBuffer, ComPtr<ID3D
 	AddUInt(metadataBuffer, positionForResourceCount, numberOfResources);
 }
 
-vector<uint8_t> ReflectShaderImpl(const vector<uint8_t>& shaderBuffer)
+vector<uint8_t> ShaderReflector::ReflectShaderBuffer(const vector<uint8_t>& shaderBuffer)
 {
 	HRESULT result;
 	ComPtr<ID3D11ShaderReflection> shaderReflection;
@@ -258,7 +295,7 @@ void ShaderReflector::ReflectShader(const wstring& path)
 	wstring outputPath = path.substr(0, path.length() - 3) + L"shadermetadata";
 
 	auto shaderBuffer = Tools::ReadFileToVector(path);
-	auto metadataBuffer = ReflectShaderImpl(shaderBuffer);
+	auto metadataBuffer = ReflectShaderBuffer(shaderBuffer);
 
 	ofstream out(outputPath, ios::binary);
 	Assert(out.is_open());
@@ -2,6 +2,9 @@
 
 namespace ShaderReflector
 {
+	// Builds the metadata the game loads next to a compiled shader, in the format described in ShaderReflector.cpp. Needs no device
+	vector<uint8_t> ReflectShaderBuffer(const vector<uint8_t>& shaderBuffer);
+
 	void ReflectShader(const wstring& path);
 };
 
@@ -0,0 +1,137 @@
+#include "PrecompiledHeader.h"
+#include "Parameters.h"
+#include "Tools.h"
+#include "VertexWelder.h"
+
+static const unsigned int kEmptySlot = 0xFFFFFFFF;
+static const size_t kVertexWordCount = sizeof(VertexParameters) / sizeof(uint32_t);
+
+static_assert(sizeof(VertexParameters) % sizeof(uint32_t) == 0, "VertexParameters must consist of 32-bit words only!");
+
+// Vertex as it's compared and hashed: either its raw bits or its attributes snapped to the welding grid
+struct VertexKey
+{
+	uint32_t words[kVertexWordCount];
+};
+
+// Snapped components are kept as the float nearest to their grid point rather than as the grid point's index, which doesn't fit
+// 32 bits once a component is 2^31 epsilons away from zero. Snapping is done in double precision, which infinities and NaNs go through unchanged.
+// Zero and negative zero compare equal, everything else is compared bit by bit
+static inline void MakeKey(const VertexParameters& vertex, double epsilon, double inverseEpsilon, VertexKey& key)
+{
+	if (epsilon > 0.0)
+	{
+		auto components = reinterpret_cast<const float*>(&vertex);
+
+		for (auto i = 0u; i < kVertexWordCount; i++)
+		{
+			auto snapped = static_cast<float>(floor(components[i] * inverseEpsilon + 0.5) * epsilon);
+			memcpy(&key.words[i], &snapped, sizeof(snapped));
+		}
+	}
+	else
+	{
+		memcpy(key.words, &vertex, sizeof(VertexParameters));
+	}
+
+	for (auto i = 0u; i < kVertexWordCount; i++)
+	{
+		if (key.words[i] == 0x80000000)
+		{
+			key.words[i] = 0;
+		}
+	}
+}
+
+// Multiply-rotate over every word followed by a murmur3 finalizer, so that each input bit affects every output bit
+static inline uint32_t HashKey(const VertexKey& key)
+{
+	uint64_t hash = 0x9E3779B97F4A7C15ULL;
+
+	for (auto i = 0u; i < kVertexWordCount; i++)
+	{
+		hash ^= key.words[i];
+		hash *= 0xFF51AFD7ED558CCDULL;
+		hash = (hash << 29) | (hash >> 35);
+	}
+
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+
+	return static_cast<uint32_t>(hash);
+}
+
+VertexWelder::Statistics VertexWelder::WeldVertices(ModelData& model, float epsilon)
+{
+	Statistics statistics;
+	auto startTime = Tools::GetTime();
+
+	auto vertexCount = model.vertexCount;
+	auto inverseEpsilon = epsilon > 0.0f ? 1.0 / epsilon : 0.0;
+
+	// Keep the table at most half full so that linear probe sequences stay short
+	size_t tableSize = 16;
+	while (tableSize < 2 * vertexCount)
+	{
+		tableSize *= 2;
+	}
+
+	auto tableMask = tableSize - 1;
+	vector<unsigned int> table(tableSize, kEmptySlot);
+	vector<uint32_t> tableHashes(tableSize);
+
+	vector<VertexKey> uniqueKeys;
+	vector<unsigned int> remap(vertexCount);
+	unique_ptr<VertexParameters[]> uniqueVertices(new VertexParameters[vertexCount]);
+	unsigned int uniqueCount = 0;
+	VertexKey key;
+
+	uniqueKeys.reserve(vertexCount);
+
+	for (auto i = 0u; i < vertexCount; i++)
+	{
+		MakeKey(model.vertices[i], epsilon, inverseEpsilon, key);
+
+		auto hash = HashKey(key);
+		auto slot = hash & tableMask;
+
+		for (;;)
+		{
+			auto uniqueIndex = table[slot];
+
+			if (uniqueIndex == kEmptySlot)
+			{
+				table[slot] = uniqueCount;
+				tableHashes[slot] = hash;
+				uniqueKeys.push_back(key);
+				memcpy(&uniqueVertices[uniqueCount], &model.vertices[i], sizeof(VertexParameters));
+
+				remap[i] = uniqueCount++;
+				break;
+			}
+
+			if (tableHashes[slot] == hash && memcmp(&uniqueKeys[uniqueIndex], &key, sizeof(VertexKey)) == 0)
+			{
+				remap[i] = uniqueIndex;
+				break;
+			}
+
+			slot = (slot + 1) & tableMask;
+		}
+	}
+
+	for (auto i = 0u; i < model.indexCount; i++)
+	{
+		model.indices[i] = remap[model.indices[i]];
+	}
+
+	statistics.vertexCountBefore = vertexCount;
+	statistics.vertexCountAfter = uniqueCount;
+
+	model.vertices = std::move(uniqueVertices);
+	model.vertexCount = uniqueCount;
+
+	statistics.seconds = Tools::GetTime() - startTime;
+	return statistics;
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+struct ModelData;
+
+namespace VertexWelder
+{
+	struct Statistics
+	{
+		size_t vertexCountBefore;
+		size_t vertexCountAfter;
+		double seconds;
+	};
+
+	// Merges identical vertices and remaps indices to them, keeping vertices in order of their first use.
+	// With a positive epsilon, every vertex attribute is snapped to a grid of that size before comparing,
+	// so vertices that differ only by exporter rounding noise get merged too
+	Statistics WeldVertices(ModelData& model, float epsilon = 0.0f);
+}
\ No newline at end of file
@@ -15,7 +15,7 @@ static void ProcessShaders(wstring shaderDirectory)
 	}
 }
 
-static void ProcessModels(wstring modelInputDirectory, wstring modelOutputDirectory)
+static void ProcessModels(wstring modelInputDirectory, wstring modelOutputDirectory, VertexEncoding vertexEncoding)
 {
 	if (!Tools::DirectoryExists(modelInputDirectory))
 	{
@@ -32,11 +32,11 @@ static void ProcessModels(wstring modelInputDirectory, wstring modelOutputDirect
 	for (auto& modelPath : Tools::GetFilesInDirectory(modelInputDirectory, L"*.obj", true))
 	{
 		wcout << L"Processing model: " << modelPath << endl;
-		ModelProcessor::ProcessModel(modelPath, modelOutputDirectory);
+		ModelProcessor::ProcessModel(modelPath, modelOutputDirectory, vertexEncoding);
 	}
 }
 
-static void ProcessAnimatedModels(wstring modelInputDirectory, wstring modelOutputDirectory)
+static void ProcessAnimatedModels(wstring modelInputDirectory, wstring modelOutputDirectory, VertexEncoding vertexEncoding)
 {
 	if (!Tools::DirectoryExists(modelInputDirectory))
 	{
@@ -53,7 +53,7 @@ static void ProcessAnimatedModels(wstring modelInputDirectory, wstring modelOutp
 	for (auto& animatedModelDirectory : Tools::GetDirectories(modelInputDirectory, false))
 	{
 		wcout << L"Processing animated model: " << animatedModelDirectory << endl << endl;
-		ModelProcessor::ProcessAnimatedModel(animatedModelDirectory, modelOutputDirectory);
+		ModelProcessor::ProcessAnimatedModel(animatedModelDirectory, modelOutputDirectory, vertexEncoding);
 	}
 }
 
@@ -108,6 +108,32 @@ static void ProcessFonts(const wstring& fontOutputDirectory)
 	ProcessFont(L"Calibri", 16, fontOutputDirectory);
 }
 
+static bool ParseVertexEncoding(const wstring& value, VertexEncoding& vertexEncoding)
+{
+	if (value == L"full")
+	{
+		vertexEncoding = VertexEncoding::FullPrecision;
+		return true;
+	}
+	else if (value == L"packed")
+	{
+		vertexEncoding = VertexEncoding::Packed;
+		return true;
+	}
+
+	return false;
+}
+
+static void PrintUsage()
+{
+	wchar_t exeName[MAX_PATH];
+	GetModuleFileName(nullptr, exeName, MAX_PATH);
+
+	wcout << L"Usage: " << exeName << L" <shaderDirectory> <modelInputDirectory> <modelOutputDirectory>" 
+		<< L" <animatedModelInputDirectory> <animatedModelOutputDirectory> <fontOutputDirectory>"
+		<< L" [-modelEncoding full|packed] [-animatedModelEncoding full|packed]" << endl;
+}
+
 int CALLBACK wWinMain(
   _In_  HINSTANCE hInstance,
   _In_  HINSTANCE hPrevInstance,
@@ -125,20 +151,42 @@ int CALLBACK wWinMain(
 	}
 	wcout << endl;
 
-	if (argc != 6)
+	if (argc < 6 || (argc - 6) % 2 != 0)
 	{
-		wchar_t exeName[MAX_PATH];
-		GetModuleFileName(nullptr, exeName, MAX_PATH);
-
-		wcout << L"Invalid number of arguments! Usage: " << exeName << L" <shaderDirectory> <modelInputDirectory> <modelOutputDirectory>" 
-			<< L" <animatedModelInputDirectory> <animatedModelOutputDirectory> <fontOutputDirectory>" << endl;
+		wcout << L"Invalid number of arguments! ";
+		PrintUsage();
 		return -1;
 	}
+
+	auto modelEncoding = VertexEncoding::Packed;
+	auto animatedModelEncoding = VertexEncoding::Packed;
+
+	for (int i = 6; i < argc; i += 2)
+	{
+		wstring option = argv[i];
+		bool isValid = false;
+
+		if (option == L"-modelEncoding")
+		{
+			isValid = ParseVertexEncoding(argv[i + 1], modelEncoding);
+		}
+		else if (option == L"-animatedModelEncoding")
+		{
+			isValid = ParseVertexEncoding(argv[i + 1], animatedModelEncoding);
+		}
+
+		if (!isValid)
+		{
+			wcout << L"Invalid option: \"" << option << L" " << argv[i + 1] << L"\". ";
+			PrintUsage();
+			return -1;
+		}
+	}
 	
 	wcout << endl;
 	ProcessShaders(argv[0]);
-	ProcessModels(argv[1], argv[2]);
-	ProcessAnimatedModels(argv[3], argv[4]);
+	ProcessModels(argv[1], argv[2], modelEncoding);
+	ProcessAnimatedModels(argv[3], argv[4], animatedModelEncoding);
 	ProcessFonts(argv[5]);
 	
 	LocalFree(argv);